@@ -4,6 +4,7 @@
 // are no-ops in the simulator.
 #include "ESPAsyncWebServer.h"
 #include "SdlDriver.h"
+#include "ShotReplay.h"
 #include <Arduino.h>
 #include <cstdlib>
 #include <cstring>
@@ -18,16 +19,36 @@ int main(int argc, char **argv) {
     // Optional: `--screenshot <path> [delayMs]` renders for a bit, saves a BMP, exits.
     const char *shotPath = nullptr;
     unsigned long shotDelayMs = 4000;
+    // Optional: `--replay <file.slog|dir>... [--profile <file.json>] [--tolerance <ms>]`
+    // re-drives recorded shots through BrewProcess headless and exits (see ShotReplay.h).
+    std::vector<String> replayPaths;
+    ShotReplay replay;
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--screenshot") == 0 && i + 1 < argc) {
             shotPath = argv[++i];
             if (i + 1 < argc)
                 shotDelayMs = strtoul(argv[i + 1], nullptr, 10);
+        } else if (strcmp(argv[i], "--replay") == 0) {
+            while (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0)
+                replayPaths.emplace_back(argv[++i]);
+        } else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            replay.setProfilePath(argv[++i]);
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            replay.setToleranceMs(strtoul(argv[++i], nullptr, 10));
         }
     }
+    if (!replayPaths.empty())
+        return replay.run(replayPaths); // shots that differ from their recording, 125 if any failed to replay
 
     controller.setup(); // builds the UI, installs the SDL driver, marks screen ready
 
+#ifdef GAGGIMATE_EVENT_TRACE
+    // Slowest listeners and events so far, after every simulated brew
+    controller.getPluginManager()->on(
+        "controller:brew:end", [&](Event &) { controller.getPluginManager()->getTrace().print(10); },
+        EventDelivery::ASYNC_LOW);
+#endif
+
     // The sim has a real network (the WebUI is reachable), so present as Wi-Fi
     // connected: seeding credentials sends setupWifi() down the STA path, and the
     // WiFi shim's begin() reports WL_CONNECTED. This makes the standby screen show
@@ -47,13 +68,23 @@ int main(int argc, char **argv) {
         controller.loop();      // connection lifecycle, comms pump, plugins
         controller.loopLogic(); // process + control logic (normally a FreeRTOS task)
 
+        // Async event listeners normally run on the PluginManager::events task
+        while (controller.getPluginManager()->dispatchQueued()) {
+        }
+
         // Shot history sampling normally runs in its own FreeRTOS task (a no-op in
-        // the sim), so drive record() here at its native cadence.
+        // the sim), so drive record() and the index write-behind here at its native cadence.
         {
-            static unsigned long lastShotSample = 0;
-            if (millis() - lastShotSample >= SHOT_LOG_SAMPLE_INTERVAL_MS) {
-                lastShotSample = millis();
+            // Absolute cadence like the task's xTaskDelayUntil(); resync after falling a whole interval behind.
+            static unsigned long nextShotSample = 0;
+            if (static_cast<long>(millis() - nextShotSample) >= 0) {
+                nextShotSample += ShotHistory.getSampleInterval();
+                if (static_cast<long>(millis() - nextShotSample) >= 0) {
+                    nextShotSample = millis() + ShotHistory.getSampleInterval();
+                }
                 ShotHistory.record();
+                ShotHistory.writePendingBuffer(); // the writer task's job
+                ShotHistory.flushIndex();
             }
         }
 
@@ -83,6 +83,12 @@ class File : public Stream {
         return fseek(_h->fp, pos, mode == SeekSet ? SEEK_SET : (mode == SeekCur ? SEEK_CUR : SEEK_END)) == 0;
     }
     size_t position() { return _h && _h->fp ? (size_t)ftell(_h->fp) : 0; }
+    time_t getLastWrite() {
+        struct stat st;
+        if (!_h || stat(_h->hostPath.c_str(), &st) != 0)
+            return 0;
+        return st.st_mtime;
+    }
 
     void close() { _h.reset(); }
     bool isDirectory() { return _h && _h->isDir; }
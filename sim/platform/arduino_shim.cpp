@@ -24,26 +24,45 @@ MDNSResponder MDNS;
 WiFiClass WiFi;
 
 static std::chrono::steady_clock::time_point g_start = std::chrono::steady_clock::now();
+// Virtual time in microseconds once gm_sim_clock_manual() was called, else -1.
+static int64_t g_manualUs = -1;
 
-extern "C" {
-
-unsigned long millis(void) {
+static int64_t elapsedUs() {
+    if (g_manualUs >= 0)
+        return g_manualUs;
     auto now = std::chrono::steady_clock::now();
-    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(now - g_start).count();
+    return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(now - g_start).count();
 }
 
-unsigned long micros(void) {
-    auto now = std::chrono::steady_clock::now();
-    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(now - g_start).count();
-}
+extern "C" {
+
+unsigned long millis(void) { return (unsigned long)(elapsedUs() / 1000); }
 
-void delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
-void delayMicroseconds(uint32_t us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+unsigned long micros(void) { return (unsigned long)elapsedUs(); }
+
+void delay(uint32_t ms) {
+    if (g_manualUs >= 0) {
+        g_manualUs += (int64_t)ms * 1000;
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+void delayMicroseconds(uint32_t us) {
+    if (g_manualUs >= 0) {
+        g_manualUs += us;
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
 void yield(void) { std::this_thread::yield(); }
 
-int64_t esp_timer_get_time(void) {
-    auto now = std::chrono::steady_clock::now();
-    return (int64_t)std::chrono::duration_cast<std::chrono::microseconds>(now - g_start).count();
+int64_t esp_timer_get_time(void) { return elapsedUs(); }
+
+void gm_sim_clock_manual(unsigned long startMs) { g_manualUs = (int64_t)startMs * 1000; }
+
+void gm_sim_clock_advance(unsigned long ms) {
+    if (g_manualUs >= 0)
+        g_manualUs += (int64_t)ms * 1000;
 }
 
 } // extern "C"
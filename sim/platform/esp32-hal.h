@@ -13,6 +13,12 @@ void delay(uint32_t ms);
 void delayMicroseconds(uint32_t us);
 void yield(void);
 
+// Simulator only: switches millis()/micros()/esp_timer_get_time() to a virtual
+// clock that starts at startMs and only moves through gm_sim_clock_advance()
+// (and delay()), so shot replays run faster than real time.
+void gm_sim_clock_manual(unsigned long startMs);
+void gm_sim_clock_advance(unsigned long ms);
+
 #ifdef __cplusplus
 }
 #endif
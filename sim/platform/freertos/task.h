@@ -52,3 +52,13 @@ static inline eTaskState eTaskGetState(TaskHandle_t handle) {
 static inline TaskHandle_t xTaskGetCurrentTaskHandle(void) { return GM_SIM_TASK_HANDLE; }
 static inline TickType_t xTaskGetTickCount(void) { return (TickType_t)millis(); }
 static inline void taskYIELD(void) {}
+// Task notifications only wake tasks the simulator never starts.
+static inline BaseType_t xTaskNotifyGive(TaskHandle_t handle) {
+    (void)handle;
+    return pdPASS;
+}
+static inline uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+    (void)clearOnExit;
+    (void)ticks;
+    return 0;
+}
@@ -0,0 +1,314 @@
+#include "ShotReplay.h"
+
+#include <ArduinoJson.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <dirent.h>
+#include <display/core/constants.h>
+#include <display/core/process/BrewProcess.h>
+#include <display/models/shot_log_codec.h>
+#include <display/models/shot_log_timing.h>
+#include <sys/stat.h>
+
+namespace {
+// Virtual millis() at the start of a replayed shot; well clear of 0 so nothing
+// mistakes it for "never happened".
+constexpr unsigned long REPLAY_CLOCK_BASE = 100000;
+// How long the replay may run past the end of the recording before giving up.
+constexpr uint32_t REPLAY_OVERRUN_MS = 2000;
+constexpr uint32_t REPLAY_MIN_TOLERANCE_MS = 500;
+
+const char *reasonName(uint8_t reason) {
+    switch (static_cast<PhaseExitReason>(reason)) {
+    case PhaseExitReason::TARGET_VOLUMETRIC:
+        return "volumetric target";
+    case PhaseExitReason::TARGET_PRESSURE:
+        return "pressure target";
+    case PhaseExitReason::TARGET_FLOW:
+        return "flow target";
+    case PhaseExitReason::TARGET_PUMPED:
+        return "pumped target";
+    case PhaseExitReason::DURATION:
+        return "duration";
+    case PhaseExitReason::SAFETY:
+        return "safety timeout";
+    case PhaseExitReason::ABORTED:
+        return "aborted";
+    default:
+        return "-";
+    }
+}
+
+String format(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+String format(const char *fmt, ...) {
+    char buffer[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+    return String(buffer);
+}
+
+bool readFile(const String &path, std::vector<uint8_t> &out) {
+    FILE *file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        out.insert(out.end(), chunk, chunk + n);
+    fclose(file);
+    return true;
+}
+
+// Sensor value at time t, interpolated between the stored samples around it
+// (the decimator drops samples through steady stretches).
+template <typename Field> float valueAt(const std::vector<ShotReplay::Sample> &samples, size_t i, uint32_t t, Field field) {
+    const auto &a = samples[i];
+    if (i + 1 >= samples.size() || t <= a.timeMs)
+        return field(a.values);
+    const auto &b = samples[i + 1];
+    const float alpha = static_cast<float>(t - a.timeMs) / static_cast<float>(b.timeMs - a.timeMs);
+    return field(a.values) + (field(b.values) - field(a.values)) * alpha;
+}
+} // namespace
+
+bool ShotReplay::loadShot(const String &path, ShotLogHeader &header, std::vector<Sample> &samples, String &error) const {
+    std::vector<uint8_t> data;
+    if (!readFile(path, data)) {
+        error = "cannot read file";
+        return false;
+    }
+    if (data.size() < sizeof(header)) {
+        error = "too small for a v5+ header";
+        return false;
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != SHOT_LOG_MAGIC || header.headerSize != SHOT_LOG_HEADER_SIZE || header.version < 5 ||
+        header.fieldsMask != SHOT_LOG_FIELDS_MASK_ALL) {
+        error = "not a v5+ .slog with all fields (older files have no phase transitions)";
+        return false;
+    }
+
+    ShotLogTimeline timeline;
+    timeline.reset(header);
+    shot_log::Decoder decoder(header.version);
+    decoder.feed(data.data() + header.headerSize, data.size() - header.headerSize, [&](const ShotLogSample &sample) {
+        samples.push_back({timeline.next(sample.t), sample});
+        return true;
+    });
+    if (samples.size() < 2) {
+        error = "fewer than two samples";
+        return false;
+    }
+    return true;
+}
+
+bool ShotReplay::loadProfile(const ShotLogHeader &header, Profile &profile, String &error) const {
+    const String path = profilePath.isEmpty() ? String("sim_data/littlefs/p/") + header.profileId + ".json" : profilePath;
+    std::vector<uint8_t> data;
+    if (!readFile(path, data)) {
+        error = String("profile not found: ") + path + " (pass --profile)";
+        return false;
+    }
+    JsonDocument doc;
+    if (deserializeJson(doc, reinterpret_cast<const char *>(data.data()), data.size()) ||
+        !parseProfile(doc.as<JsonObject>(), profile)) {
+        error = String("cannot parse profile ") + path;
+        return false;
+    }
+    return true;
+}
+
+void ShotReplay::drive(const ShotLogHeader &header, const Profile &profile, const std::vector<Sample> &samples,
+                       ShotReplayResult &result) const {
+    const uint16_t systemInfo = samples.front().values.si;
+    const ProcessTarget target =
+        systemInfo & SYSTEM_INFO_SHOT_STARTED_VOLUMETRIC ? ProcessTarget::VOLUMETRIC : ProcessTarget::TIME;
+    // An aborted shot ran until the user stopped it; anything else should end on its own
+    const bool aborted = result.recordedReason == static_cast<uint8_t>(PhaseExitReason::ABORTED);
+    const uint32_t stopMs = aborted ? result.recordedEndMs : samples.back().timeMs + REPLAY_OVERRUN_MS;
+
+    // Transitions are seen by the recorder at the next sample it takes, so
+    // replayed times are moved to the first sample at or after them.
+    auto sampleTime = [&](uint32_t t) {
+        auto it = std::lower_bound(samples.begin(), samples.end(), t,
+                                   [](const Sample &s, uint32_t value) { return s.timeMs < value; });
+        return it == samples.end() ? t : it->timeMs;
+    };
+
+    gm_sim_clock_manual(REPLAY_CLOCK_BASE);
+    BrewProcess process(profile, target, header.brewDelayMs);
+    result.replayed.push_back({0, 0, 0, process.currentPhase.name});
+
+    size_t volumeIndex = 0; // next sample whose scale reading is delivered
+    size_t segment = 0;     // samples[segment] <= t < samples[segment + 1]
+    for (uint32_t t = 0; t <= stopMs; t += PROGRESS_INTERVAL) {
+        gm_sim_clock_manual(REPLAY_CLOCK_BASE + t);
+        // Scale readings arrive on their own (onVolumetricMeasurement); the sensor
+        // values are pushed right before each progress() (loopLogic)
+        for (; volumeIndex < samples.size() && samples[volumeIndex].timeMs <= t; volumeIndex++) {
+            const ShotLogSample &s = samples[volumeIndex].values;
+            if (s.si & SYSTEM_INFO_BLUETOOTH_SCALE_CONNECTED)
+                process.updateVolume(s.v / 10.0);
+        }
+        while (segment + 1 < samples.size() && samples[segment + 1].timeMs <= t)
+            segment++;
+        process.updatePressure(valueAt(samples, segment, t, [](const ShotLogSample &s) { return s.cp / 10.0f; }));
+        process.updateFlow(valueAt(samples, segment, t, [](const ShotLogSample &s) { return s.fl / 100.0f; }));
+
+        const unsigned int phase = process.phaseIndex;
+        process.progress();
+        if (process.phaseIndex != phase) {
+            result.replayed.push_back({static_cast<uint8_t>(process.phaseIndex), static_cast<uint8_t>(process.lastExitReason),
+                                       sampleTime(t), process.currentPhase.name});
+        }
+        if (!process.isActive()) {
+            result.replayFinished = true;
+            result.replayedEndMs = sampleTime(t);
+            result.replayedReason = static_cast<uint8_t>(process.lastExitReason);
+            break;
+        }
+    }
+}
+
+void ShotReplay::compare(ShotReplayResult &result, uint32_t tolerance) const {
+    const size_t count = std::max(result.recorded.size(), result.replayed.size());
+    for (size_t i = 0; i < count; i++) {
+        if (i >= result.replayed.size()) {
+            const auto &r = result.recorded[i];
+            result.mismatches.push_back(
+                format("phase %u (%s) recorded at %.1f s was never reached", r.phaseNumber, r.phaseName.c_str(), r.timeMs / 1000.0));
+            continue;
+        }
+        if (i >= result.recorded.size()) {
+            const auto &p = result.replayed[i];
+            result.mismatches.push_back(format("replay entered phase %u (%s) at %.1f s (%s), not in the recording", p.phaseNumber,
+                                               p.phaseName.c_str(), p.timeMs / 1000.0, reasonName(p.reason)));
+            continue;
+        }
+        const auto &r = result.recorded[i];
+        const auto &p = result.replayed[i];
+        const uint32_t diff = r.timeMs > p.timeMs ? r.timeMs - p.timeMs : p.timeMs - r.timeMs;
+        // Shots recorded before exit reasons were stored have 0 there
+        const bool reasonDiffers = r.reason != 0 && r.reason != p.reason;
+        if (r.phaseNumber != p.phaseNumber || reasonDiffers || diff > tolerance) {
+            result.mismatches.push_back(format("transition %zu: recorded phase %u at %.1f s (%s), replayed phase %u at %.1f s (%s)",
+                                               i, r.phaseNumber, r.timeMs / 1000.0, reasonName(r.reason), p.phaseNumber,
+                                               p.timeMs / 1000.0, reasonName(p.reason)));
+        }
+    }
+
+    if (result.recordedReason == static_cast<uint8_t>(PhaseExitReason::ABORTED)) {
+        if (result.replayFinished && result.replayedEndMs + tolerance < result.recordedEndMs) {
+            result.mismatches.push_back(format("replay ended at %.1f s (%s), the shot was only stopped at %.1f s",
+                                               result.replayedEndMs / 1000.0, reasonName(result.replayedReason),
+                                               result.recordedEndMs / 1000.0));
+        }
+        return;
+    }
+    if (!result.replayFinished) {
+        result.mismatches.push_back(format("replay still running at the end of the recording (%.1f s)", result.durationMs / 1000.0));
+        return;
+    }
+    const uint32_t diff = result.recordedEndMs > result.replayedEndMs ? result.recordedEndMs - result.replayedEndMs
+                                                                       : result.replayedEndMs - result.recordedEndMs;
+    const bool reasonDiffers = result.recordedReason != 0 && result.recordedReason != result.replayedReason;
+    if (reasonDiffers || diff > tolerance) {
+        result.mismatches.push_back(format("recorded end at %.1f s (%s), replayed end at %.1f s (%s)", result.recordedEndMs / 1000.0,
+                                           reasonName(result.recordedReason), result.replayedEndMs / 1000.0,
+                                           reasonName(result.replayedReason)));
+    }
+}
+
+ShotReplayResult ShotReplay::replay(const String &path) {
+    ShotReplayResult result;
+    const int slash = path.lastIndexOf('/');
+    result.id = path.substring(slash + 1);
+
+    ShotLogHeader header{};
+    std::vector<Sample> samples;
+    Profile profile;
+    if (!loadShot(path, header, samples, result.error) || !loadProfile(header, profile, result.error))
+        return result;
+
+    result.samples = samples.size();
+    result.durationMs = samples.back().timeMs;
+    for (uint8_t i = 0; i < header.phaseTransitionCount && i < 12; i++) {
+        const PhaseTransition &t = header.phaseTransitions[i];
+        const size_t index = std::min<size_t>(t.sampleIndex, samples.size() - 1);
+        result.recorded.push_back({t.phaseNumber, t.transitionReason, samples[index].timeMs, String(t.phaseName)});
+    }
+    // Extended recording (scale settling) starts when the brew ends
+    result.recordedEndMs = samples.back().timeMs;
+    for (const Sample &s : samples) {
+        if (s.values.si & SYSTEM_INFO_EXTENDED_RECORDING) {
+            result.recordedEndMs = s.timeMs;
+            break;
+        }
+    }
+    result.recordedReason = header.finalExitReason;
+
+    const auto started = std::chrono::steady_clock::now();
+    drive(header, profile, samples, result);
+    result.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+    const uint32_t interval = header.sampleInterval ? header.sampleInterval : SHOT_LOG_SAMPLE_INTERVAL_MS;
+    compare(result, toleranceMs ? toleranceMs : std::max<uint32_t>(2u * interval, REPLAY_MIN_TOLERANCE_MS));
+    return result;
+}
+
+void ShotReplay::print(const ShotReplayResult &result) {
+    if (!result.error.isEmpty()) {
+        printf("%s: %s\n", result.id.c_str(), result.error.c_str());
+        return;
+    }
+    const double speed = result.wallMs > 0 ? result.durationMs / result.wallMs : 0;
+    printf("%s: %.1f s, %u samples, replayed in %.2f ms (%.0fx real time) - %s\n", result.id.c_str(), result.durationMs / 1000.0,
+           result.samples, result.wallMs, speed, result.mismatches.empty() ? "ok" : "DIFFERS");
+    for (const String &mismatch : result.mismatches)
+        printf("  %s\n", mismatch.c_str());
+}
+
+int ShotReplay::run(const std::vector<String> &paths) {
+    std::vector<String> files;
+    for (const String &path : paths) {
+        struct stat info {};
+        if (stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+            std::vector<String> found;
+            if (DIR *dir = opendir(path.c_str())) {
+                while (dirent *entry = readdir(dir)) {
+                    String name(entry->d_name);
+                    if (name.endsWith(".slog"))
+                        found.push_back(path + "/" + name);
+                }
+                closedir(dir);
+            }
+            std::sort(found.begin(), found.end(), [](const String &a, const String &b) { return strcmp(a.c_str(), b.c_str()) < 0; });
+            files.insert(files.end(), found.begin(), found.end());
+        } else {
+            files.push_back(path);
+        }
+    }
+
+    int differing = 0, failed = 0;
+    double wallMs = 0, shotMs = 0;
+    for (const String &file : files) {
+        const ShotReplayResult result = replay(file);
+        print(result);
+        if (!result.error.isEmpty()) {
+            failed++;
+        } else if (!result.mismatches.empty()) {
+            differing++;
+        }
+        wallMs += result.wallMs;
+        shotMs += result.durationMs;
+    }
+    printf("%zu shots: %d match, %d differ, %d not replayed; %.1f s of shots in %.1f ms\n", files.size(),
+           static_cast<int>(files.size()) - differing - failed, differing, failed, shotMs / 1000.0, wallMs);
+    if (failed > 0)
+        return EXIT_NOT_REPLAYED; // a shot that was not replayed is not a mismatch
+    return std::min(differing, EXIT_MAX_DIFFERING);
+}
@@ -0,0 +1,75 @@
+// Shot replay: feeds the sensor values of a recorded .slog back into a
+// BrewProcess on a virtual clock, the way Controller::loopLogic() and
+// onVolumetricMeasurement() drive it on the device, and diffs the phase
+// transitions and exit reasons against the recorded PhaseTransition table.
+// Runs headless and much faster than real time, so recorded field shots
+// become a regression and performance harness for the brew logic.
+#pragma once
+
+#include <Arduino.h>
+#include <cstdint>
+#include <display/models/profile.h>
+#include <display/models/shot_log_format.h>
+#include <vector>
+
+struct ShotReplayTransition {
+    uint8_t phaseNumber;
+    uint8_t reason;  // PhaseExitReason that ended the previous phase
+    uint32_t timeMs; // since the shot started
+    String phaseName;
+};
+
+struct ShotReplayResult {
+    String id;
+    String error; // set if the shot could not be replayed
+    uint32_t samples = 0;
+    uint32_t durationMs = 0;
+    std::vector<ShotReplayTransition> recorded;
+    std::vector<ShotReplayTransition> replayed;
+    // When and why the brew ended; the recorded end is where extended recording
+    // started (or the last sample). recordedReason ABORTED means the user stopped it.
+    uint32_t recordedEndMs = 0;
+    uint8_t recordedReason = 0;
+    bool replayFinished = false;
+    uint32_t replayedEndMs = 0;
+    uint8_t replayedReason = 0;
+    std::vector<String> mismatches;
+    double wallMs = 0; // time the replay itself took
+};
+
+class ShotReplay {
+  public:
+    struct Sample {
+        uint32_t timeMs; // since the shot started
+        ShotLogSample values;
+    };
+
+    // Profile JSON to replay against; by default the shot's profile is read
+    // from the simulator's profile store (sim_data/littlefs/p/<profileId>.json).
+    void setProfilePath(const String &path) { profilePath = path; }
+    // Largest difference between a recorded and a replayed transition; 0 uses
+    // twice the shot's sample interval (at least 500 ms).
+    void setToleranceMs(uint32_t ms) { toleranceMs = ms; }
+
+    ShotReplayResult replay(const String &path);
+
+    // `--replay` entry point: replays every .slog given (directories are
+    // scanned), prints a report and returns the number of shots that differ
+    // (at most EXIT_MAX_DIFFERING), or EXIT_NOT_REPLAYED if any shot could not
+    // be replayed at all (unreadable file, missing profile).
+    int run(const std::vector<String> &paths);
+
+    static constexpr int EXIT_MAX_DIFFERING = 124;
+    static constexpr int EXIT_NOT_REPLAYED = 125;
+
+  private:
+    bool loadShot(const String &path, ShotLogHeader &header, std::vector<Sample> &samples, String &error) const;
+    bool loadProfile(const ShotLogHeader &header, Profile &profile, String &error) const;
+    void drive(const ShotLogHeader &header, const Profile &profile, const std::vector<Sample> &samples,
+               ShotReplayResult &result) const;
+    void compare(ShotReplayResult &result, uint32_t tolerance) const;
+    static void print(const ShotReplayResult &result);
+
+    String profilePath;
+    uint32_t toleranceMs = 0;
+};
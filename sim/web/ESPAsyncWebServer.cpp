@@ -169,18 +169,38 @@ void AsyncWebSocketClient::text(AsyncWebSocketSharedBuffer buffer) {
 void AsyncWebSocketClient::text(const String &message) {
     sendWsFrame(_fd, WS_TEXT, (const uint8_t *)message.c_str(), message.length());
 }
+void AsyncWebSocketClient::binary(AsyncWebSocketSharedBuffer buffer) {
+    if (buffer) {
+        sendWsFrame(_fd, WS_BINARY, buffer->data(), buffer->size());
+    }
+}
 
-void AsyncWebSocket::text(uint32_t id, const String &message) {
+AsyncWebSocketClient *AsyncWebSocket::client(uint32_t id) {
     for (auto *c : _clients)
         if (c->id() == id)
-            c->text(message);
+            return c;
+    return nullptr;
 }
-void AsyncWebSocket::text(uint32_t id, AsyncWebSocketSharedBuffer buffer) {
-    if (!buffer)
-        return;
-    for (auto *c : _clients)
-        if (c->id() == id)
-            sendWsFrame(c->fd(), WS_TEXT, buffer->data(), buffer->size());
+bool AsyncWebSocket::text(uint32_t id, const String &message) {
+    AsyncWebSocketClient *c = client(id);
+    if (!c)
+        return false;
+    c->text(message);
+    return true;
+}
+bool AsyncWebSocket::text(uint32_t id, AsyncWebSocketSharedBuffer buffer) {
+    AsyncWebSocketClient *c = client(id);
+    if (!c || !buffer)
+        return false;
+    sendWsFrame(c->fd(), WS_TEXT, buffer->data(), buffer->size());
+    return true;
+}
+bool AsyncWebSocket::binary(uint32_t id, AsyncWebSocketSharedBuffer buffer) {
+    AsyncWebSocketClient *c = client(id);
+    if (!c || !buffer)
+        return false;
+    sendWsFrame(c->fd(), WS_BINARY, buffer->data(), buffer->size());
+    return true;
 }
 void AsyncWebSocket::textAll(AsyncWebSocketSharedBuffer buffer) {
     if (!buffer)
@@ -204,10 +224,16 @@ static std::string httpReason(int code) {
         return "OK";
     case 204:
         return "No Content";
+    case 206:
+        return "Partial Content";
     case 302:
         return "Found";
+    case 304:
+        return "Not Modified";
     case 404:
         return "Not Found";
+    case 416:
+        return "Range Not Satisfiable";
     case 500:
         return "Internal Server Error";
     default:
@@ -229,6 +255,13 @@ static void writeResponse(int fd, AsyncWebServerResponse *resp) {
         sendAll(fd, body, bodyLen);
 }
 
+AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(int code, const String &contentType, const String &content) {
+    auto *r = new AsyncWebServerResponse();
+    r->_code = code;
+    r->_contentType = contentType;
+    r->_body.assign(content.c_str(), content.length());
+    return r;
+}
 AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(int code, const String &contentType, const uint8_t *content,
                                                              size_t len) {
     auto *r = new AsyncWebServerResponse();
@@ -242,8 +275,17 @@ AsyncWebServerResponse *AsyncWebServerRequest::beginResponse(const String &conte
     auto *r = new AsyncWebServerResponse();
     r->_contentType = contentType;
     if (filler && len) {
+        // Call the filler until it has produced len bytes or gives up, as the
+        // real library does across TCP sends.
         r->_body.resize(len);
-        filler((uint8_t *)r->_body.data(), len, 0);
+        size_t filled = 0;
+        while (filled < len) {
+            const size_t n = filler((uint8_t *)r->_body.data() + filled, len - filled, filled);
+            if (n == 0)
+                break;
+            filled += n;
+        }
+        r->_body.resize(filled);
     }
     return r;
 }
@@ -504,6 +546,8 @@ bool AsyncWebServer::handleHttp(Conn &c) {
     AsyncWebServerRequest req(c.fd, this);
     req._url = String(path.c_str());
     req._body = body;
+    for (auto &h : headers)
+        req._headers.emplace(h.first, AsyncWebHeader(String(h.first.c_str()), String(h.second.c_str())));
     req._method = method == "POST" ? HTTP_POST : method == "PUT" ? HTTP_PUT : method == "DELETE" ? HTTP_DELETE : HTTP_GET;
     auto parseArgs = [&](const std::string &s) {
         size_t i = 0;
@@ -532,11 +576,19 @@ bool AsyncWebServer::handleHttp(Conn &c) {
     return true; // Connection: close
 }
 
+bool AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest *request) const {
+    if (_method != HTTP_ANY && !(_method & request->method()))
+        return false;
+    const std::string path(request->url().c_str());
+    const bool matched = !_uri.empty() && _uri.back() == '*' ? path.rfind(_uri.substr(0, _uri.size() - 1), 0) == 0 : _uri == path;
+    return matched && (!_filter || _filter(request));
+}
+
 void AsyncWebServer::dispatch(Conn &c, AsyncWebServerRequest &req) {
     std::string path(req._url.c_str());
     for (auto &r : _routes) {
-        if ((r.method == HTTP_ANY || (r.method & req._method)) && r.uri == path) {
-            r.handler(&req);
+        if (r.canHandle(&req)) {
+            r.handleRequest(&req);
             return;
         }
     }
@@ -7,7 +7,9 @@
 #include "FS.h"
 #include "Print.h"
 #include "WString.h"
+#include <cctype>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <map>
 #include <memory>
@@ -68,6 +70,17 @@ using AwsResponseFiller = std::function<size_t(uint8_t *, size_t, size_t)>;
 
 class AsyncWebServer;
 
+class AsyncWebHeader {
+  public:
+    AsyncWebHeader(const String &name, const String &value) : _name(name), _value(value) {}
+    const String &name() const { return _name; }
+    const String &value() const { return _value; }
+
+  private:
+    String _name;
+    String _value;
+};
+
 class AsyncWebServerRequest {
   public:
     AsyncWebServerRequest(int fd, AsyncWebServer *server) : _fd(fd), _server(server) {}
@@ -81,7 +94,14 @@ class AsyncWebServerRequest {
         return it == _args.end() ? String() : String(it->second.c_str());
     }
     String arg(const String &name) const { return arg(name.c_str()); }
+    // Header names are matched case-insensitively, as in the real library.
+    bool hasHeader(const char *name) const { return findHeader(name) != _headers.end(); }
+    const AsyncWebHeader *getHeader(const char *name) const {
+        auto it = findHeader(name);
+        return it == _headers.end() ? nullptr : &it->second;
+    }
 
+    AsyncWebServerResponse *beginResponse(int code, const String &contentType = "text/plain", const String &content = String());
     AsyncWebServerResponse *beginResponse(int code, const String &contentType, const uint8_t *content, size_t len);
     AsyncWebServerResponse *beginResponse(const String &contentType, size_t len, AwsResponseFiller callback);
     AsyncResponseStream *beginResponseStream(const String &contentType);
@@ -95,12 +115,42 @@ class AsyncWebServerRequest {
     String _url;
     int _method = HTTP_GET;
     std::map<std::string, std::string> _args;
+    std::map<std::string, AsyncWebHeader> _headers; // lowercased name -> header
     std::string _body;
     int _fd;
     AsyncWebServer *_server;
+
+  private:
+    std::map<std::string, AsyncWebHeader>::const_iterator findHeader(const char *name) const {
+        std::string key(name);
+        for (auto &ch : key)
+            ch = tolower(ch);
+        return _headers.find(key);
+    }
 };
 
 using ArRequestHandlerFunction = std::function<void(AsyncWebServerRequest *)>;
+using ArRequestFilterFunction = std::function<bool(AsyncWebServerRequest *)>;
+
+// Returned by AsyncWebServer::on(). A uri ending in '*' matches by prefix, like
+// the real library; setFilter() adds a further condition.
+class AsyncCallbackWebHandler {
+  public:
+    AsyncCallbackWebHandler(int method, const std::string &uri, ArRequestHandlerFunction handler)
+        : _method(method), _uri(uri), _handler(std::move(handler)) {}
+    AsyncCallbackWebHandler &setFilter(ArRequestFilterFunction filter) {
+        _filter = std::move(filter);
+        return *this;
+    }
+    bool canHandle(AsyncWebServerRequest *request) const;
+    void handleRequest(AsyncWebServerRequest *request) { _handler(request); }
+
+  private:
+    int _method;
+    std::string _uri;
+    ArRequestHandlerFunction _handler;
+    ArRequestFilterFunction _filter;
+};
 
 // Matches the real library's queued-message payload type.
 using AsyncWebSocketSharedBuffer = std::shared_ptr<std::vector<uint8_t>>;
@@ -111,8 +161,12 @@ class AsyncWebSocketClient {
     uint32_t id() const { return _id; }
     int fd() const { return _fd; }
     void setCloseClientOnQueueFull(bool) {}
+    // Sends are written straight to the socket here, so nothing is ever queued.
+    size_t queueLen() const { return 0; }
+    bool queueIsFull() const { return false; }
     void text(AsyncWebSocketSharedBuffer buffer);
     void text(const String &message);
+    void binary(AsyncWebSocketSharedBuffer buffer);
 
   private:
     uint32_t _id;
@@ -127,8 +181,11 @@ class AsyncWebSocket {
     explicit AsyncWebSocket(const String &url) : _url(url) {}
     const String &url() const { return _url; }
     void onEvent(AwsEventHandler handler) { _handler = std::move(handler); }
-    void text(uint32_t id, const String &message);
-    void text(uint32_t id, AsyncWebSocketSharedBuffer buffer);
+    AsyncWebSocketClient *client(uint32_t id);
+    // false if there is no such client (the real library also when its queue is full)
+    bool text(uint32_t id, const String &message);
+    bool text(uint32_t id, AsyncWebSocketSharedBuffer buffer);
+    bool binary(uint32_t id, AsyncWebSocketSharedBuffer buffer);
     void textAll(AsyncWebSocketSharedBuffer buffer);
     void cleanupClients() {}
     void closeAll();
@@ -151,9 +208,13 @@ class AsyncWebServer {
     explicit AsyncWebServer(uint16_t port) : _port(port) {}
     ~AsyncWebServer();
 
-    void on(const char *uri, ArRequestHandlerFunction handler) { _routes.push_back({HTTP_ANY, uri, std::move(handler)}); }
-    void on(const char *uri, WebRequestMethod method, ArRequestHandlerFunction handler) {
-        _routes.push_back({(int)method, uri, std::move(handler)});
+    AsyncCallbackWebHandler &on(const char *uri, ArRequestHandlerFunction handler) {
+        _routes.emplace_back(HTTP_ANY, uri, std::move(handler));
+        return _routes.back();
+    }
+    AsyncCallbackWebHandler &on(const char *uri, WebRequestMethod method, ArRequestHandlerFunction handler) {
+        _routes.emplace_back((int)method, uri, std::move(handler));
+        return _routes.back();
     }
     void onNotFound(ArRequestHandlerFunction handler) { _notFound = std::move(handler); }
     void addHandler(AsyncWebSocket *ws) { _ws = ws; }
@@ -165,11 +226,6 @@ class AsyncWebServer {
     void pump(); // process pending sockets (called from gm_web_pump)
 
   private:
-    struct Route {
-        int method;
-        std::string uri;
-        ArRequestHandlerFunction handler;
-    };
     struct StaticRoute {
         std::string uri;
         FS *fs;
@@ -178,7 +234,7 @@ class AsyncWebServer {
 
     uint16_t _port;
     int _listenFd = -1;
-    std::vector<Route> _routes;
+    std::deque<AsyncCallbackWebHandler> _routes; // deque: on() hands out references
     std::vector<StaticRoute> _static;
     std::vector<AsyncStaticWebHandler> _staticHandlers;
     ArRequestHandlerFunction _notFound;
@@ -265,10 +265,10 @@ void Controller::setupBluetooth() {
         this->currentPumpPower = pumpPower;
         this->currentHeaterPower = heaterPower;
         this->currentPuckResistance = puckResistance;
-        pluginManager->trigger("boiler:pressure:change", "value", pressure);
-        pluginManager->trigger("pump:puck-flow:change", "value", puckFlow);
-        pluginManager->trigger("pump:flow:change", "value", pumpFlow);
-        pluginManager->trigger("pump:puck-resistance:change", "value", puckResistance);
+        pluginManager->trigger(events::BOILER_PRESSURE_CHANGE, PressureChanged{pressure});
+        pluginManager->trigger(events::PUMP_PUCK_FLOW_CHANGE, FlowChanged{puckFlow});
+        pluginManager->trigger(events::PUMP_FLOW_CHANGE, FlowChanged{pumpFlow});
+        pluginManager->trigger(events::PUMP_PUCK_RESISTANCE_CHANGE, PuckResistanceChanged{puckResistance});
     });
     comms.onButtonState([this](uint8_t index, bool pressed) {
         const int status = pressed ? 1 : 0;
@@ -330,7 +330,7 @@ void Controller::setupBluetooth() {
             this->error = error;
             deactivate();
             setMode(MODE_STANDBY);
-            pluginManager->trigger(F("controller:error"));
+            pluginManager->trigger("controller:error");
             ESP_LOGE(LOG_TAG, "Received error %d", error);
         }
     });
@@ -756,7 +756,7 @@ float Controller::getTargetTemp() const {
 }
 
 void Controller::setTargetTemp(float temperature) {
-    pluginManager->trigger("boiler:targetTemperature:change", "value", temperature);
+    pluginManager->trigger(events::BOILER_TARGET_TEMPERATURE_CHANGE, TempChanged{temperature});
     switch (mode) {
     case MODE_BREW:
     case MODE_GRIND:
@@ -1110,8 +1110,8 @@ bool Controller::isGrindActive() const {
 int Controller::getMode() const { return mode; }
 
 void Controller::setMode(int newMode) {
-    Event modeEvent = pluginManager->trigger("controller:mode:change", "value", newMode);
-    mode = modeEvent.getInt("value");
+    Event modeEvent = pluginManager->trigger(events::CONTROLLER_MODE_CHANGE, ModeChanged{newMode});
+    mode = modeEvent.as<ModeChanged>().value;
     steamReady = false;
 
     updateLastAction();
@@ -1121,8 +1121,8 @@ void Controller::setMode(int newMode) {
 
 void Controller::onTempRead(float temperature) {
     float temp = temperature - static_cast<float>(settings.getTemperatureOffset());
-    Event event = pluginManager->trigger("boiler:currentTemperature:change", "value", temp);
-    currentTemp = event.getFloat("value");
+    Event event = pluginManager->trigger(events::BOILER_CURRENT_TEMPERATURE_CHANGE, TempChanged{temp});
+    currentTemp = event.as<TempChanged>().value;
 }
 
 void Controller::updateLastAction() { lastAction = millis(); }
@@ -1147,10 +1147,9 @@ void Controller::onVolumetricMeasurement(double measurement, VolumetricMeasureme
     if (source == VolumetricMeasurementSource::FLOW_ESTIMATION) {
         currentCoffeeVolume = static_cast<float>(measurement);
     }
-    pluginManager->trigger(source == VolumetricMeasurementSource::FLOW_ESTIMATION
-                               ? F("controller:volumetric-measurement:estimation:change")
-                               : F("controller:volumetric-measurement:bluetooth:change"),
-                           "value", static_cast<float>(measurement));
+    pluginManager->trigger(source == VolumetricMeasurementSource::FLOW_ESTIMATION ? events::VOLUMETRIC_ESTIMATION_CHANGE
+                                                                                  : events::VOLUMETRIC_BLUETOOTH_CHANGE,
+                           WeightChanged{static_cast<float>(measurement)});
     if (source == VolumetricMeasurementSource::BLUETOOTH) {
         lastBluetoothMeasurement = millis();
     }
@@ -1292,7 +1291,8 @@ void Controller::handleProfileButton(int buttonStatus, String id) {
 }
 
 void Controller::handleProfileUpdate() {
-    pluginManager->trigger("boiler:targetTemperature:change", "value", profileManager->getSelectedProfile().temperature);
+    pluginManager->trigger(events::BOILER_TARGET_TEMPERATURE_CHANGE,
+                           TempChanged{profileManager->getSelectedProfile().temperature});
     pluginManager->trigger("controller:targetDuration:change", "value", profileManager->getSelectedProfile().getTotalDuration());
     pluginManager->trigger("controller:targetVolume:change", "value", profileManager->getSelectedProfile().getTotalVolume());
 }
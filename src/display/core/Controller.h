@@ -71,6 +71,7 @@ class Controller {
     std::recursive_mutex &getProcessLock() const { return processMutex; }
     Settings &getSettings() { return settings; }
     ProfileManager *getProfileManager() { return profileManager; }
+    PluginManager *getPluginManager() const { return pluginManager; }
 #ifndef GAGGIMATE_HEADLESS
     DefaultUI *getUI() const { return ui; }
 #endif
@@ -1,66 +1,189 @@
 #ifndef EVENT_H
 #define EVENT_H
 
+#include "EventId.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <type_traits>
+
+#ifdef ARDUINO
 #include <Arduino.h>
-#include <vector>
+#endif
+
+// The payload is stored inline, so creating, copying and dispatching an Event
+// never allocates. Keys must be string literals (they are kept by pointer).
+// Values past EVENT_MAX_ENTRIES are dropped, and text past EVENT_TEXT_SIZE
+// (all text values of one event together, after a typed payload if there is
+// one) is cut short.
+static constexpr size_t EVENT_MAX_ENTRIES = 4;
+static constexpr size_t EVENT_TEXT_SIZE = 48;
 
 enum class EventDataType { EVENT_TYPE_INT, EVENT_TYPE_FLOAT, EVENT_TYPE_STRING, EVENT_TYPE_NONE };
 
 struct EventDataEntry {
-    String key;
+    const char *key = nullptr;
     EventDataType type = EventDataType::EVENT_TYPE_NONE;
-    int intValue = 0;
-    float floatValue = 0.0f;
-    String stringValue = "";
-
-    EventDataEntry() = default;
+    union {
+        int intValue;
+        float floatValue;
+        uint8_t textOffset; // into Event::text
+    };
 
-    EventDataEntry(const String &k, int value) : key(k), type(EventDataType::EVENT_TYPE_INT), intValue(value) {}
-
-    EventDataEntry(const String &k, float value) : key(k), type(EventDataType::EVENT_TYPE_FLOAT), floatValue(value) {}
+    EventDataEntry() : intValue(0) {}
+};
 
-    EventDataEntry(const String &k, const String &value) : key(k), type(EventDataType::EVENT_TYPE_STRING), stringValue(value) {}
+// One field of a typed payload, so the key-based API can read it
+struct EventField {
+    const char *key;
+    EventDataType type;
+    uint8_t offset;
+    uint8_t size;
 };
 
-using EventData = std::vector<EventDataEntry>;
+// Specialised for every typed payload (see EventPayloads.h) with
+//   static constexpr EventField fields[] = {...};
+template <typename T> struct EventPayloadTraits;
 
 struct Event {
-    String id;
-    EventData data;
+    EventKey id;
     bool stopPropagation = false;
 
-    void setInt(const String &key, int value) { data.emplace_back(key, value); }
+    void setInt(const char *key, int value) {
+        if (EventDataEntry *entry = add(key, EventDataType::EVENT_TYPE_INT)) {
+            entry->intValue = value;
+        }
+    }
 
-    void setFloat(const String &key, float value) { data.emplace_back(key, value); }
+    void setFloat(const char *key, float value) {
+        if (EventDataEntry *entry = add(key, EventDataType::EVENT_TYPE_FLOAT)) {
+            entry->floatValue = value;
+        }
+    }
 
-    void setString(const String &key, const String &value) { data.emplace_back(key, value); }
+    void setString(const char *key, const char *value) {
+        if (textUsed >= EVENT_TEXT_SIZE) {
+            return;
+        }
+        if (EventDataEntry *entry = add(key, EventDataType::EVENT_TYPE_STRING)) {
+            entry->textOffset = textUsed;
+            const size_t len = strnlen(value, EVENT_TEXT_SIZE - 1 - textUsed);
+            memcpy(text + textUsed, value, len);
+            text[textUsed + len] = '\0';
+            textUsed += len + 1;
+        }
+    }
 
-    int getInt(const String &key) const {
-        for (const auto &entry : data) {
-            if (entry.key == key && entry.type == EventDataType::EVENT_TYPE_INT) {
-                return entry.intValue;
-            }
+    int getInt(const char *key) const {
+        int value = 0;
+        if (const void *found = find(key, EventDataType::EVENT_TYPE_INT)) {
+            memcpy(&value, found, sizeof(value));
+        }
+        return value;
+    }
+
+    float getFloat(const char *key) const {
+        float value = 0.0f;
+        if (const void *found = find(key, EventDataType::EVENT_TYPE_FLOAT)) {
+            memcpy(&value, found, sizeof(value));
         }
-        return 0;
+        return value;
+    }
+
+    // Valid as long as the event; "" if there is no such value
+    const char *getText(const char *key) const {
+        const void *found = find(key, EventDataType::EVENT_TYPE_STRING);
+        return found ? static_cast<const char *>(found) : "";
+    }
+
+    // Values set with the key-based setters; a typed payload is not counted
+    size_t size() const { return count; }
+
+    // Replaces all values with a typed payload. The key-based getters still
+    // see its fields, so listeners written against keys keep working.
+    template <typename T> void set(const T &payload) {
+        static_assert(std::is_trivially_copyable<T>::value, "event payloads are copied byte-wise");
+        static_assert(sizeof(T) <= EVENT_TEXT_SIZE, "event payload too large");
+        memcpy(text, &payload, sizeof(T));
+        count = 0;
+        textUsed = sizeof(T);
+        payloadFields = EventPayloadTraits<T>::fields;
+        payloadFieldCount = sizeof(EventPayloadTraits<T>::fields) / sizeof(EventField);
     }
 
-    float getFloat(const String &key) const {
-        for (const auto &entry : data) {
-            if (entry.key == key && entry.type == EventDataType::EVENT_TYPE_FLOAT) {
-                return entry.floatValue;
+    // The payload as a T. If the event was triggered with a T this is a plain
+    // copy; otherwise (key-based trigger, or another payload type) the fields
+    // of T are looked up by key and missing ones are zero.
+    template <typename T> T as() const {
+        T payload{};
+        if (payloadFields == EventPayloadTraits<T>::fields) {
+            memcpy(&payload, text, sizeof(T));
+            return payload;
+        }
+        auto *bytes = reinterpret_cast<char *>(&payload);
+        for (const EventField &field : EventPayloadTraits<T>::fields) {
+            const void *found = find(field.key, field.type);
+            if (found == nullptr) {
+                continue;
             }
+            if (field.type == EventDataType::EVENT_TYPE_STRING) {
+                const size_t len = strnlen(static_cast<const char *>(found), field.size - 1);
+                memcpy(bytes + field.offset, found, len);
+            } else {
+                memcpy(bytes + field.offset, found, field.size);
+            }
+        }
+        return payload;
+    }
+
+#ifdef ARDUINO
+    void setString(const char *key, const String &value) { setString(key, value.c_str()); }
+
+    String getString(const char *key) const { return String(getText(key)); }
+#endif
+
+  private:
+    EventDataEntry *add(const char *key, EventDataType type) {
+        if (count >= EVENT_MAX_ENTRIES) {
+            return nullptr;
         }
-        return 0.0f;
+        EventDataEntry &entry = entries[count++];
+        entry.key = key;
+        entry.type = type;
+        return &entry;
     }
 
-    String getString(const String &key) const {
-        for (const auto &entry : data) {
-            if (entry.key == key && entry.type == EventDataType::EVENT_TYPE_STRING) {
-                return entry.stringValue;
+    // Points at the value's bytes, in the typed payload or an entry
+    const void *find(const char *key, EventDataType type) const {
+        for (size_t i = 0; i < payloadFieldCount; i++) {
+            const EventField &field = payloadFields[i];
+            if (field.type == type && (field.key == key || strcmp(field.key, key) == 0)) {
+                return text + field.offset;
             }
         }
-        return "";
+        for (size_t i = 0; i < count; i++) {
+            const EventDataEntry &entry = entries[i];
+            if (entry.type != type || (entry.key != key && strcmp(entry.key, key) != 0)) {
+                continue;
+            }
+            switch (type) {
+            case EventDataType::EVENT_TYPE_INT:
+                return &entry.intValue;
+            case EventDataType::EVENT_TYPE_FLOAT:
+                return &entry.floatValue;
+            default:
+                return text + entry.textOffset;
+            }
+        }
+        return nullptr;
     }
+
+    EventDataEntry entries[EVENT_MAX_ENTRIES];
+    uint8_t count = 0;
+    uint8_t textUsed = 0;
+    uint8_t payloadFieldCount = 0;
+    const EventField *payloadFields = nullptr;
+    char text[EVENT_TEXT_SIZE] = {}; // text values, after the typed payload if any
 };
 
 #endif // EVENT_H
@@ -0,0 +1,49 @@
+#ifndef EVENTID_H
+#define EVENTID_H
+
+#include <stdint.h>
+
+// Events are named "area:subject:action" in code but dispatched by a 32-bit
+// FNV-1a hash of the name, so triggering one never builds or compares strings.
+// PluginManager::on() refuses a name whose hash collides with another's.
+//
+// Plain C++ so the host tests can use it.
+
+using EventId = uint32_t;
+
+constexpr EventId eventId(const char *name) {
+    uint32_t hash = 2166136261u;
+    while (*name != '\0') {
+        hash = (hash ^ static_cast<uint8_t>(*name++)) * 16777619u;
+    }
+    return hash;
+}
+
+// An event's id together with its name, which is only kept for logs. Converts
+// implicitly from a string literal, so trigger("controller:ready") still
+// works; the name is not copied and must have static storage. Declared
+// constexpr (see the constants below), the id is computed at compile time.
+struct EventKey {
+    EventId id = 0;
+    const char *name = "";
+
+    constexpr EventKey() = default;
+    constexpr EventKey(const char *name) : id(eventId(name)), name(name) {}
+};
+
+// Events fired from the control loop or on every sensor reading, and those
+// with a typed payload (EventPayloads.h)
+namespace events {
+constexpr EventKey BOILER_CURRENT_TEMPERATURE_CHANGE{"boiler:currentTemperature:change"};
+constexpr EventKey BOILER_TARGET_TEMPERATURE_CHANGE{"boiler:targetTemperature:change"};
+constexpr EventKey BOILER_PRESSURE_CHANGE{"boiler:pressure:change"};
+constexpr EventKey PUMP_FLOW_CHANGE{"pump:flow:change"};
+constexpr EventKey PUMP_PUCK_FLOW_CHANGE{"pump:puck-flow:change"};
+constexpr EventKey PUMP_PUCK_RESISTANCE_CHANGE{"pump:puck-resistance:change"};
+constexpr EventKey VOLUMETRIC_ESTIMATION_CHANGE{"controller:volumetric-measurement:estimation:change"};
+constexpr EventKey VOLUMETRIC_BLUETOOTH_CHANGE{"controller:volumetric-measurement:bluetooth:change"};
+constexpr EventKey VOLUMETRIC_SCALE_FLOW_CHANGE{"controller:volumetric-measurement:scale-flow:change"};
+constexpr EventKey CONTROLLER_MODE_CHANGE{"controller:mode:change"};
+} // namespace events
+
+#endif // EVENTID_H
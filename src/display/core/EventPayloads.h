@@ -0,0 +1,79 @@
+#ifndef EVENTPAYLOADS_H
+#define EVENTPAYLOADS_H
+
+#include "Event.h"
+
+// Typed payloads of the frequent events. Triggered with
+// pluginManager->trigger(events::X, Payload{...}) and read with
+// event.as<Payload>(), which copies the struct without looking at keys.
+// Each field is also listed in EventPayloadTraits under the key the event
+// used before, so listeners using getFloat("value") etc. still work, and so
+// does as<Payload>() on an event triggered with keys.
+//
+// Payloads must be trivially copyable and fit EVENT_TEXT_SIZE; char arrays
+// must be NUL-terminated.
+
+// boiler:currentTemperature:change, boiler:targetTemperature:change
+struct TempChanged {
+    float value; // °C
+};
+
+// boiler:pressure:change
+struct PressureChanged {
+    float value; // bar
+};
+
+// pump:flow:change, pump:puck-flow:change,
+// controller:volumetric-measurement:scale-flow:change
+struct FlowChanged {
+    float value; // ml/s, g/s from a scale
+};
+
+// pump:puck-resistance:change
+struct PuckResistanceChanged {
+    float value;
+};
+
+// controller:volumetric-measurement:estimation:change,
+// controller:volumetric-measurement:bluetooth:change
+struct WeightChanged {
+    float value; // g
+};
+
+// controller:mode:change. Listeners may change the mode being switched to by
+// setting another ModeChanged on the event.
+struct ModeChanged {
+    int value; // MODE_*
+};
+
+template <> struct EventPayloadTraits<TempChanged> {
+    static constexpr EventField fields[] = {
+        {"value", EventDataType::EVENT_TYPE_FLOAT, offsetof(TempChanged, value), sizeof(float)}};
+};
+
+template <> struct EventPayloadTraits<PressureChanged> {
+    static constexpr EventField fields[] = {
+        {"value", EventDataType::EVENT_TYPE_FLOAT, offsetof(PressureChanged, value), sizeof(float)}};
+};
+
+template <> struct EventPayloadTraits<FlowChanged> {
+    static constexpr EventField fields[] = {
+        {"value", EventDataType::EVENT_TYPE_FLOAT, offsetof(FlowChanged, value), sizeof(float)}};
+};
+
+template <> struct EventPayloadTraits<PuckResistanceChanged> {
+    static constexpr EventField fields[] = {
+        {"value", EventDataType::EVENT_TYPE_FLOAT, offsetof(PuckResistanceChanged, value), sizeof(float)}};
+};
+
+template <> struct EventPayloadTraits<WeightChanged> {
+    static constexpr EventField fields[] = {
+        {"value", EventDataType::EVENT_TYPE_FLOAT, offsetof(WeightChanged, value), sizeof(float)}};
+};
+
+template <> struct EventPayloadTraits<ModeChanged> {
+    static constexpr EventField fields[] = {
+        {"value", EventDataType::EVENT_TYPE_INT, offsetof(ModeChanged, value), sizeof(int)}};
+};
+
+#endif // EVENTPAYLOADS_H
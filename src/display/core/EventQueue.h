@@ -0,0 +1,93 @@
+#ifndef EVENTQUEUE_H
+#define EVENTQUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// A bounded queue that any number of tasks can push to and pop from without a
+// lock (D. Vyukov's bounded MPMC queue): every cell carries a sequence number
+// that says whether it is free for the push at that position or holds the
+// value for the pop at that position, so producers and consumers only race on
+// the two position counters. push() fails instead of blocking when the queue
+// is full. Capacity must be a power of two.
+//
+// Plain C++ so the host tests can use it.
+template <typename T, size_t Capacity> class EventQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+  public:
+    static constexpr size_t CAPACITY = Capacity;
+
+    EventQueue() {
+        for (size_t i = 0; i < Capacity; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    EventQueue(const EventQueue &) = delete;
+    EventQueue &operator=(const EventQueue &) = delete;
+
+    bool push(const T &value) {
+        size_t pos = pushPos.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true) {
+            cell = &cells[pos & (Capacity - 1)];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = pushPos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = value;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &value) {
+        size_t pos = popPos.load(std::memory_order_relaxed);
+        Cell *cell;
+        while (true) {
+            cell = &cells[pos & (Capacity - 1)];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // empty
+            } else {
+                pos = popPos.load(std::memory_order_relaxed);
+            }
+        }
+        value = cell->value;
+        cell->sequence.store(pos + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate while other tasks push or pop
+    size_t size() const {
+        const size_t pushed = pushPos.load(std::memory_order_relaxed);
+        const size_t popped = popPos.load(std::memory_order_relaxed);
+        return pushed > popped ? pushed - popped : 0;
+    }
+
+  private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    Cell cells[Capacity];
+    std::atomic<size_t> pushPos{0};
+    std::atomic<size_t> popPos{0};
+};
+
+#endif // EVENTQUEUE_H
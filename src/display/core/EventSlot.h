@@ -0,0 +1,94 @@
+#ifndef EVENTSLOT_H
+#define EVENTSLOT_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+// The latest payload of a high-frequency event, for a subscriber that only
+// needs the current value at its own cadence (see PluginManager::on(event,
+// slot)). Each trigger overwrites the slot instead of calling the subscriber,
+// and poll() hands over the value if one arrived since the last poll().
+//
+// A seqlock: the sequence is odd while a store is under way, and a reader
+// retries when it changed under the copy. Neither side ever waits on the
+// other, so a reader on a higher priority task cannot spin on a writer it
+// preempted on the same core: a store that finds another store under way is
+// dropped (the next sample replaces it anyway), and poll() gives up after a
+// few attempts and reports nothing new.
+//
+// Plain C++ so the host tests can use it.
+template <typename T> class EventSlot {
+    static_assert(std::is_trivially_copyable<T>::value, "slot payloads are copied as raw words");
+
+  public:
+    EventSlot() = default;
+    EventSlot(const EventSlot &) = delete;
+    EventSlot &operator=(const EventSlot &) = delete;
+
+    // Called for every trigger of the event, on the triggering task
+    void store(const T &value) {
+        uint32_t copy[WORDS] = {};
+        memcpy(copy, &value, sizeof(T));
+        uint32_t sequence = seq.load(std::memory_order_relaxed);
+        if ((sequence & 1) != 0 || !seq.compare_exchange_strong(sequence, sequence + 1, std::memory_order_relaxed)) {
+            return; // another store is under way
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++) {
+            words[i].store(copy[i], std::memory_order_relaxed);
+        }
+        seq.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Copies the latest value into out if one arrived since the last poll().
+    // One task polls a slot: it remembers what that task has seen.
+    bool poll(T &out) {
+        uint32_t sequence;
+        if (!load(out, sequence) || sequence == seen) {
+            return false;
+        }
+        seen = sequence;
+        return true;
+    }
+
+    // The latest value, seen or not; false if there is none yet
+    bool read(T &out) const {
+        uint32_t sequence;
+        return load(out, sequence) && sequence != 0;
+    }
+
+    // Stores so far
+    uint32_t updates() const { return seq.load(std::memory_order_relaxed) / 2; }
+
+  private:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+    static constexpr int READ_ATTEMPTS = 4;
+
+    bool load(T &out, uint32_t &sequence) const {
+        for (int attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+            sequence = seq.load(std::memory_order_acquire);
+            if ((sequence & 1) != 0) {
+                continue;
+            }
+            uint32_t copy[WORDS];
+            for (size_t i = 0; i < WORDS; i++) {
+                copy[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq.load(std::memory_order_relaxed) == sequence) {
+                memcpy(&out, copy, sizeof(T));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::atomic<uint32_t> seq{0};
+    std::atomic<uint32_t> words[WORDS] = {};
+    uint32_t seen = 0;
+};
+
+#endif // EVENTSLOT_H
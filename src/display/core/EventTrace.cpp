@@ -0,0 +1,284 @@
+#include "EventTrace.h"
+
+#ifdef GAGGIMATE_EVENT_TRACE
+
+#include <new>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#else
+#include <chrono>
+#include <stdlib.h>
+#endif
+
+namespace {
+constexpr size_t PRINT_MAX = 20;
+
+template <typename T> T *allocateTable(size_t count) {
+#ifdef ARDUINO
+    void *memory = heap_caps_malloc(count * sizeof(T), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#else
+    void *memory = malloc(count * sizeof(T));
+#endif
+    if (memory == nullptr) {
+        return nullptr;
+    }
+    T *table = static_cast<T *>(memory);
+    for (size_t i = 0; i < count; i++) {
+        new (&table[i]) T();
+    }
+    return table;
+}
+
+// Keeps out[] sorted by total time, slowest first
+template <typename T, typename Timing> void insertTop(T *out, size_t &count, size_t n, const T &item, Timing timing) {
+    const uint64_t total = timing(item).totalUs;
+    size_t pos = count;
+    while (pos > 0 && timing(out[pos - 1]).totalUs < total) {
+        pos--;
+    }
+    if (pos >= n) {
+        return;
+    }
+    const size_t last = count < n ? count : n - 1;
+    for (size_t i = last; i > pos; i--) {
+        out[i] = out[i - 1];
+    }
+    out[pos] = item;
+    if (count < n) {
+        count++;
+    }
+}
+} // namespace
+
+uint32_t EventTrace::nowUs() {
+#ifdef ARDUINO
+    return static_cast<uint32_t>(esp_timer_get_time());
+#else
+    using namespace std::chrono;
+    return static_cast<uint32_t>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+bool EventTrace::allocate() {
+    if (ring != nullptr) {
+        return true;
+    }
+    events = allocateTable<EventTraceEvent>(EVENT_TRACE_MAX_EVENTS);
+    listeners = allocateTable<EventTraceListener>(EVENT_TRACE_MAX_LISTENERS);
+    ring = allocateTable<EventTraceRecord>(EVENT_TRACE_RING_SIZE);
+    resetAtUs = nowUs();
+    return events != nullptr && listeners != nullptr && ring != nullptr;
+}
+
+uint16_t EventTrace::addListener(EventKey event, const char *label, bool async) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!allocate() || listenerCount >= EVENT_TRACE_MAX_LISTENERS) {
+        return EVENT_TRACE_NO_LISTENER;
+    }
+    EventTraceListener &listener = listeners[listenerCount];
+    listener.id = event.id;
+    listener.event = event.name;
+    listener.label = label;
+    listener.async = async;
+    return static_cast<uint16_t>(listenerCount++);
+}
+
+void EventTrace::recordListener(uint16_t slot, uint32_t us, uint8_t depth) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (slot >= listenerCount) {
+        return;
+    }
+    listeners[slot].timing.add(us);
+    addRecord(listeners[slot].id, slot, depth, us);
+}
+
+void EventTrace::recordEvent(EventKey event, uint32_t us, uint8_t depth) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!allocate()) {
+        return;
+    }
+    if (EventTraceEvent *entry = findEvent(event)) {
+        entry->sync.add(us);
+        if (depth > entry->maxDepth) {
+            entry->maxDepth = depth;
+        }
+    }
+    addRecord(event.id, EVENT_TRACE_NO_LISTENER, depth, us);
+}
+
+void EventTrace::recordAsyncEvent(EventKey event, uint32_t us) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!allocate()) {
+        return;
+    }
+    if (EventTraceEvent *entry = findEvent(event)) {
+        entry->async.add(us);
+    }
+}
+
+EventTraceEvent *EventTrace::findEvent(EventKey event) {
+    for (size_t i = 0; i < EVENT_TRACE_MAX_EVENTS; i++) {
+        EventTraceEvent &entry = events[(event.id + i) & (EVENT_TRACE_MAX_EVENTS - 1)];
+        if (entry.name == nullptr) {
+            entry.id = event.id;
+            entry.name = event.name;
+            return &entry;
+        }
+        if (entry.id == event.id) {
+            return &entry;
+        }
+    }
+    eventOverflow++;
+    return nullptr;
+}
+
+void EventTrace::addRecord(EventId id, uint16_t listener, uint8_t depth, uint32_t us) {
+    ring[ringNext] = EventTraceRecord{nowUs(), id, listener, depth, us};
+    ringNext = (ringNext + 1) % EVENT_TRACE_RING_SIZE;
+    if (ringCount < EVENT_TRACE_RING_SIZE) {
+        ringCount++;
+    }
+}
+
+void EventTrace::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!allocate()) {
+        return;
+    }
+    for (size_t i = 0; i < EVENT_TRACE_MAX_EVENTS; i++) {
+        events[i] = EventTraceEvent{};
+    }
+    for (size_t i = 0; i < listenerCount; i++) {
+        listeners[i].timing = EventTraceTiming{};
+    }
+    ringNext = ringCount = 0;
+    eventOverflow = 0;
+    resetAtUs = nowUs();
+}
+
+size_t EventTrace::topListeners(EventTraceListener *out, size_t n) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (size_t i = 0; i < listenerCount && n > 0; i++) {
+        if (listeners[i].timing.calls > 0) {
+            insertTop(out, count, n, listeners[i], [](const EventTraceListener &l) { return l.timing; });
+        }
+    }
+    return count;
+}
+
+size_t EventTrace::topEvents(EventTraceEvent *out, size_t n) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (size_t i = 0; events != nullptr && i < EVENT_TRACE_MAX_EVENTS && n > 0; i++) {
+        if (events[i].name == nullptr) {
+            continue;
+        }
+        // Ranked by the time the event held up its caller
+        insertTop(out, count, n, events[i], [](const EventTraceEvent &e) { return e.sync; });
+    }
+    return count;
+}
+
+size_t EventTrace::recent(EventTraceRecord *out, size_t n) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    const size_t count = n < ringCount ? n : ringCount;
+    for (size_t i = 0; i < count; i++) {
+        out[i] = ring[(ringNext + EVENT_TRACE_RING_SIZE - count + i) % EVENT_TRACE_RING_SIZE];
+    }
+    return count;
+}
+
+const char *EventTrace::eventName(EventId id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (size_t i = 0; events != nullptr && i < EVENT_TRACE_MAX_EVENTS; i++) {
+        const EventTraceEvent &entry = events[(id + i) & (EVENT_TRACE_MAX_EVENTS - 1)];
+        if (entry.name == nullptr) {
+            break;
+        }
+        if (entry.id == id) {
+            return entry.name;
+        }
+    }
+    return nullptr;
+}
+
+const char *EventTrace::listenerLabel(uint16_t slot) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slot < listenerCount ? listeners[slot].label : nullptr;
+}
+
+void EventTrace::label(const char *registration, char *out, size_t size) {
+    // GCC: "... [with F = MQTTPlugin::setup(Controller*, PluginManager*)::<lambda(const Event&)>]"
+    // Clang: "... [F = (lambda at src/display/plugins/MQTTPlugin.cpp:137:5)]"
+    // Slots: "void PluginManager::on(EventKey, EventSlot<T>&) [with T = TempChanged]"
+    const char *start = registration != nullptr ? strstr(registration, "F = ") : nullptr;
+    if (start == nullptr && registration != nullptr && size > 0) {
+        if (const char *payload = strstr(registration, "T = ")) {
+            payload += 4;
+            const size_t len = strlen(payload);
+            snprintf(out, size, "EventSlot<%.*s>", static_cast<int>(len > 0 && payload[len - 1] == ']' ? len - 1 : len),
+                     payload);
+            return;
+        }
+    }
+    if (start == nullptr || size == 0) {
+        snprintf(out, size, "%s", registration != nullptr ? registration : "?");
+        return;
+    }
+    start += 4;
+    size_t len = strlen(start);
+    if (len > 0 && start[len - 1] == ']') {
+        len--;
+    }
+    if (strncmp(start, "std::function", 13) == 0) {
+        len = 13;
+    } else if (const char *params = strchr(start, '(')) {
+        if (params != start && static_cast<size_t>(params - start) < len) {
+            len = params - start; // the enclosing function, without its parameters
+        }
+    }
+    snprintf(out, size, "%.*s", static_cast<int>(len), start);
+}
+
+void EventTrace::print(size_t n) const {
+    if (n > PRINT_MAX) {
+        n = PRINT_MAX;
+    }
+    EventTraceEvent topE[PRINT_MAX];
+    EventTraceListener topL[PRINT_MAX];
+    const size_t eventCount = topEvents(topE, n);
+    const size_t listenerCount = topListeners(topL, n);
+
+    printf("[event trace] %.1f s traced\n", sinceUs() / 1e6);
+    if (untracedEvents() > 0) {
+        printf("[event trace] %u triggers of events not traced: table full\n", static_cast<unsigned>(untracedEvents()));
+    }
+    printf("[event trace] slowest listeners by total time\n");
+    printf("[event trace] %8s %10s %8s %8s  %-5s %-44s %s\n", "calls", "total ms", "avg us", "max us", "mode", "event",
+           "listener");
+    for (size_t i = 0; i < listenerCount; i++) {
+        const EventTraceListener &l = topL[i];
+        char name[64];
+        label(l.label, name, sizeof(name));
+        printf("[event trace] %8u %10.2f %8u %8u  %-5s %-44s %s\n", static_cast<unsigned>(l.timing.calls),
+               l.timing.totalUs / 1000.0, static_cast<unsigned>(l.timing.totalUs / l.timing.calls),
+               static_cast<unsigned>(l.timing.maxUs), l.async ? "async" : "sync", l.event, name);
+    }
+    printf("[event trace] slowest events by time spent in trigger()\n");
+    printf("[event trace] %8s %10s %8s %8s %6s %8s %8s  %s\n", "calls", "total ms", "avg us", "max us", "depth", "async",
+           "max us", "event");
+    for (size_t i = 0; i < eventCount; i++) {
+        const EventTraceEvent &e = topE[i];
+        printf("[event trace] %8u %10.2f %8u %8u %6u %8u %8u  %s\n", static_cast<unsigned>(e.sync.calls),
+               e.sync.totalUs / 1000.0, static_cast<unsigned>(e.sync.calls ? e.sync.totalUs / e.sync.calls : 0),
+               static_cast<unsigned>(e.sync.maxUs), static_cast<unsigned>(e.maxDepth), static_cast<unsigned>(e.async.calls),
+               static_cast<unsigned>(e.async.maxUs), e.name);
+    }
+}
+
+#endif // GAGGIMATE_EVENT_TRACE
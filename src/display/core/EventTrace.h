@@ -0,0 +1,116 @@
+#ifndef EVENTTRACE_H
+#define EVENTTRACE_H
+
+// Event bus profiler, built only with -DGAGGIMATE_EVENT_TRACE (on in the
+// simulator). PluginManager times every trigger and every listener call and
+// reports them here: per event and per listener call counts, total and
+// longest run time, the deepest trigger nesting (a listener triggering
+// another event), and a ring of the most recent calls. All of it lives in
+// fixed tables allocated once in PSRAM; nothing is allocated while tracing.
+//
+// Plain C++ apart from the allocation, so the host tests can use it.
+
+#ifdef GAGGIMATE_EVENT_TRACE
+
+#include "EventId.h"
+
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+
+constexpr size_t EVENT_TRACE_MAX_EVENTS = 128; // power of two
+constexpr size_t EVENT_TRACE_MAX_LISTENERS = 192;
+constexpr size_t EVENT_TRACE_RING_SIZE = 512;
+constexpr uint16_t EVENT_TRACE_NO_LISTENER = 0xFFFF;
+
+struct EventTraceTiming {
+    uint32_t calls = 0;
+    uint32_t maxUs = 0;
+    uint64_t totalUs = 0;
+
+    void add(uint32_t us) {
+        calls++;
+        totalUs += us;
+        if (us > maxUs) {
+            maxUs = us;
+        }
+    }
+};
+
+struct EventTraceEvent {
+    EventId id = 0;
+    const char *name = nullptr;
+    EventTraceTiming sync;  // trigger() on the caller, sync listeners only
+    EventTraceTiming async; // from queueing to the last async listener
+    uint8_t maxDepth = 0;   // 1 = triggered outside any listener
+};
+
+struct EventTraceListener {
+    EventId id = 0;
+    const char *event = nullptr;
+    const char *label = nullptr; // where the listener was registered, see label()
+    bool async = false;
+    EventTraceTiming timing;
+};
+
+struct EventTraceRecord {
+    uint32_t atUs; // when the call ended
+    EventId id;
+    uint16_t listener; // EVENT_TRACE_NO_LISTENER for a whole trigger()
+    uint8_t depth;
+    uint32_t us;
+};
+
+class EventTrace {
+  public:
+    static uint32_t nowUs();
+
+    // Returns the slot to pass to recordListener(), or EVENT_TRACE_NO_LISTENER
+    // when the table is full (the listener then goes untraced).
+    uint16_t addListener(EventKey event, const char *label, bool async);
+    void recordListener(uint16_t slot, uint32_t us, uint8_t depth);
+    void recordEvent(EventKey event, uint32_t us, uint8_t depth);
+    void recordAsyncEvent(EventKey event, uint32_t us);
+
+    // Clears the counters and the ring; registered listeners are kept
+    void reset();
+    uint32_t sinceUs() const { return nowUs() - resetAtUs; }
+    uint32_t untracedEvents() const { return eventOverflow; }
+
+    // The n listeners / events with the most total time, slowest first.
+    // Copies, so the caller can format them without holding up tracing.
+    size_t topListeners(EventTraceListener *out, size_t n) const;
+    size_t topEvents(EventTraceEvent *out, size_t n) const;
+    // The n most recent records, oldest first
+    size_t recent(EventTraceRecord *out, size_t n) const;
+    // For the records: nullptr if unknown
+    const char *eventName(EventId id) const;
+    const char *listenerLabel(uint16_t slot) const;
+
+    // Writes the top-n report to the console (printf)
+    void print(size_t n) const;
+
+    // A readable name for a listener from its registration label:
+    // "MQTTPlugin::setup" for a lambda registered in MQTTPlugin::setup(),
+    // "EventSlot<TempChanged>" for a coalesced subscription
+    static void label(const char *registration, char *out, size_t size);
+
+  private:
+    bool allocate();
+    EventTraceEvent *findEvent(EventKey event);
+    void addRecord(EventId id, uint16_t listener, uint8_t depth, uint32_t us);
+
+    mutable std::mutex mutex;
+    EventTraceEvent *events = nullptr;
+    EventTraceListener *listeners = nullptr;
+    EventTraceRecord *ring = nullptr;
+    size_t listenerCount = 0;
+    size_t ringNext = 0;
+    size_t ringCount = 0;
+    uint32_t eventOverflow = 0;
+    uint32_t resetAtUs = 0;
+};
+
+#endif // GAGGIMATE_EVENT_TRACE
+
+#endif // EVENTTRACE_H
@@ -1,12 +1,21 @@
 #include "PluginManager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <string.h>
+
+#ifdef GAGGIMATE_EVENT_TRACE
+// How many trigger() calls are active on this task: listeners may trigger
+static thread_local uint8_t traceDepth = 0;
+#endif
+
 void PluginManager::registerPlugin(Plugin *plugin) { plugins.push_back(plugin); }
 
 void PluginManager::setup(Controller *controller) {
     ESP_LOGV("PluginManager", "Setting up PluginManager");
-    on("system:dummy", [](const Event &) {
-        // Register a dummy event so the event map is initialized properly
-    });
+#ifdef ARDUINO
+    xTaskCreatePinnedToCore(workerTask, "PluginManager::events", configMINIMAL_STACK_SIZE * 10, this, 1, &workerTaskHandle, 0);
+#endif
     for (const auto &plugin : plugins) {
         plugin->setup(controller, this);
     }
@@ -21,50 +30,178 @@ void PluginManager::loop() {
     }
 }
 
-void PluginManager::on(const String &eventId, const EventCallback &callback) {
-    ESP_LOGV("PluginManager", "Registering listener: %s", eventId.c_str());
-    listeners[std::string(eventId.c_str())].push_back(callback);
+void PluginManager::addListener(EventKey event, EventCallback callback, EventDelivery delivery, const char *traceLabel) {
+    ESP_LOGV("PluginManager", "Registering listener: %s", event.name);
+    std::lock_guard<std::mutex> lock(registerMutex);
+    auto table = std::make_shared<ListenerTable>(*std::atomic_load(&listeners));
+    auto end = std::upper_bound(table->begin(), table->end(), event.id,
+                                [](EventId id, const Listener &listener) { return id < listener.id; });
+    if (end != table->begin() && std::prev(end)->id == event.id && strcmp(std::prev(end)->name, event.name) != 0) {
+        ESP_LOGE("PluginManager", "Event id of %s collides with %s, listener not registered", event.name,
+                 std::prev(end)->name);
+        return;
+    }
+#ifdef GAGGIMATE_EVENT_TRACE
+    const uint16_t traceSlot = trace.addListener(event, traceLabel, delivery != EventDelivery::SYNC);
+    table->insert(end, Listener{event.id, event.name, delivery, std::move(callback), traceSlot});
+#else
+    (void)traceLabel;
+    table->insert(end, Listener{event.id, event.name, delivery, std::move(callback)});
+#endif
+    std::atomic_store(&listeners, std::shared_ptr<const ListenerTable>(std::move(table)));
 }
 
-Event PluginManager::trigger(const String &eventId) {
-    Event event;
-    event.id = eventId;
-    trigger(event);
-    return event;
+Event PluginManager::trigger(EventKey event) {
+    Event e;
+    e.id = event;
+    trigger(e);
+    return e;
 }
 
-Event PluginManager::trigger(const String &eventId, const String &key, const String &value) {
-    Event event;
-    event.id = eventId;
-    event.setString(key, value);
-    trigger(event);
-    return event;
+Event PluginManager::trigger(EventKey event, const char *key, const char *value) {
+    Event e;
+    e.id = event;
+    e.setString(key, value);
+    trigger(e);
+    return e;
 }
 
-Event PluginManager::trigger(const String &eventId, const String &key, const int value) {
-    Event event;
-    event.id = eventId;
-    event.setInt(key, value);
-    trigger(event);
-    return event;
+Event PluginManager::trigger(EventKey event, const char *key, const int value) {
+    Event e;
+    e.id = event;
+    e.setInt(key, value);
+    trigger(e);
+    return e;
 }
 
-Event PluginManager::trigger(const String &eventId, const String &key, const float value) {
-    Event event;
-    event.id = eventId;
-    event.setFloat(key, value);
-    trigger(event);
-    return event;
+Event PluginManager::trigger(EventKey event, const char *key, const float value) {
+    Event e;
+    e.id = event;
+    e.setFloat(key, value);
+    trigger(e);
+    return e;
 }
 
 void PluginManager::trigger(Event &event) {
-    ESP_LOGV("PluginManager", "Triggering event: %s", event.id.c_str());
-    if (listeners.count(std::string(event.id.c_str()))) {
-        for (auto const &callback : listeners[std::string(event.id.c_str())]) {
-            callback(event);
-            if (event.stopPropagation) {
-                break;
-            }
+    ESP_LOGV("PluginManager", "Triggering event: %s", event.id.name);
+#ifdef GAGGIMATE_EVENT_TRACE
+    const uint32_t start = EventTrace::nowUs();
+    const uint8_t depth = ++traceDepth;
+    dispatch(event);
+    traceDepth--;
+    trace.recordEvent(event.id, EventTrace::nowUs() - start, depth);
+#else
+    dispatch(event);
+#endif
+}
+
+void PluginManager::dispatch(Event &event) {
+    // Holding a reference keeps this table alive if a listener registers another
+    const std::shared_ptr<const ListenerTable> table = std::atomic_load(&listeners);
+    auto it = std::lower_bound(table->begin(), table->end(), event.id.id,
+                               [](const Listener &listener, EventId id) { return listener.id < id; });
+    bool async = false;
+    bool asyncLow = false;
+    for (; it != table->end() && it->id == event.id.id; ++it) {
+        if (it->delivery != EventDelivery::SYNC) {
+            (it->delivery == EventDelivery::ASYNC ? async : asyncLow) = true;
+            continue;
+        }
+        callListener(*it, event);
+        if (event.stopPropagation) {
+            return;
+        }
+    }
+    if (async) {
+        enqueue(lanes[0], event);
+    }
+    if (asyncLow) {
+        enqueue(lanes[1], event);
+    }
+}
+
+void PluginManager::callListener(const Listener &listener, Event &event) {
+#ifdef GAGGIMATE_EVENT_TRACE
+    const uint32_t start = EventTrace::nowUs();
+    listener.callback(event);
+    trace.recordListener(listener.traceSlot, EventTrace::nowUs() - start, traceDepth);
+#else
+    listener.callback(event);
+#endif
+}
+
+void PluginManager::enqueue(Lane &lane, const Event &event) {
+#ifdef GAGGIMATE_EVENT_TRACE
+    const QueuedEvent queued{event, EventTrace::nowUs()};
+#else
+    const QueuedEvent queued{event};
+#endif
+    if (!lane.queue.push(queued)) {
+        const uint32_t dropped = ++lane.dropped;
+        if (dropped == 1 || dropped % 100 == 0) {
+            ESP_LOGW("PluginManager", "Event queue full, dropped %s (%u dropped so far)", event.id.name,
+                     static_cast<unsigned>(dropped));
+        }
+        return;
+    }
+    lane.queued++;
+    const auto depth = static_cast<uint32_t>(lane.queue.size());
+    if (depth > lane.maxDepth.load(std::memory_order_relaxed)) {
+        lane.maxDepth.store(depth, std::memory_order_relaxed);
+    }
+#ifdef ARDUINO
+    if (workerTaskHandle != nullptr) {
+        xTaskNotifyGive(workerTaskHandle);
+    }
+#endif
+}
+
+bool PluginManager::dispatchQueued() {
+    QueuedEvent queued;
+    EventDelivery delivery = EventDelivery::ASYNC;
+    if (!lanes[0].queue.pop(queued)) {
+        if (!lanes[1].queue.pop(queued)) {
+            return false;
+        }
+        delivery = EventDelivery::ASYNC_LOW;
+    }
+    Event &event = queued.event;
+#ifdef GAGGIMATE_EVENT_TRACE
+    traceDepth++;
+#endif
+    const std::shared_ptr<const ListenerTable> table = std::atomic_load(&listeners);
+    auto it = std::lower_bound(table->begin(), table->end(), event.id.id,
+                               [](const Listener &listener, EventId id) { return listener.id < id; });
+    for (; it != table->end() && it->id == event.id.id; ++it) {
+        if (it->delivery != delivery) {
+            continue;
+        }
+        callListener(*it, event);
+        if (event.stopPropagation) {
+            break;
+        }
+    }
+#ifdef GAGGIMATE_EVENT_TRACE
+    traceDepth--;
+    trace.recordAsyncEvent(event.id, EventTrace::nowUs() - queued.queuedAtUs);
+#endif
+    return true;
+}
+
+EventLaneStats PluginManager::getLaneStats(EventDelivery lane) const {
+    const Lane &l = lanes[lane == EventDelivery::ASYNC_LOW ? 1 : 0];
+    return {l.queued.load(), l.dropped.load(), l.maxDepth.load()};
+}
+
+#ifdef ARDUINO
+void PluginManager::workerTask(void *arg) {
+    auto *manager = static_cast<PluginManager *>(arg);
+    // Events may have been queued before the task existed
+    xTaskNotifyGive(xTaskGetCurrentTaskHandle());
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (manager->dispatchQueued()) {
         }
     }
 }
+#endif
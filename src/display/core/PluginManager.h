@@ -1,15 +1,38 @@
 #ifndef PLUGINMANAGER_H
 #define PLUGINMANAGER_H
 #include "Event.h"
+#include "EventPayloads.h"
+#include "EventQueue.h"
+#include "EventSlot.h"
+#include "EventTrace.h"
 #include "Plugin.h"
 
+#include <atomic>
 #include <functional>
-#include <map>
-#include <string>
+#include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 
 using EventCallback = std::function<void(Event &)>;
 
+// How a listener is called. SYNC listeners run on the triggering task before
+// trigger() returns, and can change the event for the caller. ASYNC and
+// ASYNC_LOW listeners get a copy of the event on the event worker task, after
+// the SYNC ones, so a slow listener (network, SD card) does not hold up the
+// control loop or the BLE and web tasks. The worker empties the ASYNC lane
+// before taking from ASYNC_LOW, so control events do not wait behind
+// telemetry. A full lane drops the event for that lane's listeners.
+enum class EventDelivery : uint8_t { SYNC, ASYNC, ASYNC_LOW };
+
+struct EventLaneStats {
+    uint32_t queued;   // events accepted into the lane
+    uint32_t dropped;  // events lost because the lane was full
+    uint32_t maxDepth; // most events waiting in the lane at once
+};
+
+constexpr size_t EVENT_QUEUE_SIZE = 16; // per lane
+
 class Controller;
 class PluginManager {
   public:
@@ -18,18 +41,103 @@ class PluginManager {
     void setup(Controller *controller);
     void loop();
 
-    void on(const String &eventId, const EventCallback &callback);
+    template <typename F> void on(EventKey event, F &&callback, EventDelivery delivery = EventDelivery::SYNC) {
+#ifdef GAGGIMATE_EVENT_TRACE
+        // Names the lambda's type, and with it the function that registered it
+        addListener(event, EventCallback(std::forward<F>(callback)), delivery, __PRETTY_FUNCTION__);
+#else
+        addListener(event, EventCallback(std::forward<F>(callback)), delivery);
+#endif
+    }
 
-    Event trigger(const String &eventId);
-    Event trigger(const String &eventId, const String &key, const String &value);
-    Event trigger(const String &eventId, const String &key, int value);
-    Event trigger(const String &eventId, const String &key, float value);
+    // Coalesced subscription: every trigger of the event overwrites slot with
+    // its payload, and the subscriber poll()s the slot at its own cadence
+    // instead of taking a call per sensor sample.
+    template <typename T> void on(EventKey event, EventSlot<T> &slot) {
+        EventSlot<T> *target = &slot;
+        EventCallback store = [target](Event &e) { target->store(e.as<T>()); };
+#ifdef GAGGIMATE_EVENT_TRACE
+        addListener(event, std::move(store), EventDelivery::SYNC, __PRETTY_FUNCTION__);
+#else
+        addListener(event, std::move(store), EventDelivery::SYNC);
+#endif
+    }
+
+    Event trigger(EventKey event);
+    Event trigger(EventKey event, const char *key, const char *value);
+    Event trigger(EventKey event, const char *key, int value);
+    Event trigger(EventKey event, const char *key, float value);
+#ifdef ARDUINO
+    Event trigger(EventKey event, const char *key, const String &value) { return trigger(event, key, value.c_str()); }
+#endif
+    template <typename T> Event trigger(EventKey event, const T &payload) {
+        Event e;
+        e.id = event;
+        e.set(payload);
+        trigger(e);
+        return e;
+    }
     void trigger(Event &event);
 
+    // Runs the async listeners of one queued event, ASYNC lane first. Returns
+    // false if both lanes are empty. Called by the worker task; the simulator,
+    // which runs no tasks, calls it from its main loop.
+    bool dispatchQueued();
+
+    EventLaneStats getLaneStats(EventDelivery lane) const;
+
+#ifdef GAGGIMATE_EVENT_TRACE
+    EventTrace &getTrace() { return trace; }
+#endif
+
   private:
+    struct Listener {
+        EventId id;
+        const char *name;
+        EventDelivery delivery;
+        EventCallback callback;
+#ifdef GAGGIMATE_EVENT_TRACE
+        uint16_t traceSlot;
+#endif
+    };
+
+    using ListenerTable = std::vector<Listener>;
+
+    struct QueuedEvent {
+        Event event;
+#ifdef GAGGIMATE_EVENT_TRACE
+        uint32_t queuedAtUs;
+#endif
+    };
+
+    struct Lane {
+        EventQueue<QueuedEvent, EVENT_QUEUE_SIZE> queue;
+        std::atomic<uint32_t> queued{0};
+        std::atomic<uint32_t> dropped{0};
+        std::atomic<uint32_t> maxDepth{0};
+    };
+
+    void addListener(EventKey event, EventCallback callback, EventDelivery delivery, const char *traceLabel = nullptr);
+    void dispatch(Event &event);
+    void callListener(const Listener &listener, Event &event);
+    void enqueue(Lane &lane, const Event &event);
+
     bool initialized = false;
     std::vector<Plugin *> plugins;
-    std::map<std::string, std::vector<EventCallback>> listeners = {};
+    // Sorted by event id, in registration order within an id, so an event's
+    // listeners are one contiguous run found by binary search. Listeners are
+    // still registered after other tasks start triggering events, so on()
+    // publishes a new table instead of changing the one being dispatched from.
+    std::shared_ptr<const ListenerTable> listeners = std::make_shared<const ListenerTable>();
+    std::mutex registerMutex;
+    Lane lanes[2]; // ASYNC, ASYNC_LOW
+#ifdef ARDUINO
+    TaskHandle_t workerTaskHandle = nullptr;
+    static void workerTask(void *arg);
+#endif
+#ifdef GAGGIMATE_EVENT_TRACE
+    EventTrace trace;
+#endif
 };
 
 #endif // PLUGINMANAGER_H
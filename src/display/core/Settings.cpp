@@ -220,6 +220,16 @@ void Settings::setThemeMode(int theme_mode) { themeMode.set(theme_mode); }
 
 void Settings::setHistoryIndex(int history_index) { historyIndex.set(history_index); }
 
+void Settings::setHistoryInterval(int history_interval) { historyInterval.set(std::clamp(history_interval, 50, 250)); }
+
+void Settings::setHistoryQuotaMb(int history_quota_mb) { historyQuotaMb.set(std::clamp(history_quota_mb, 0, 32768)); }
+
+void Settings::setHistoryEviction(int history_eviction) { historyEviction.set(std::clamp(history_eviction, 0, 1)); }
+
+void Settings::setHistoryProtectAnnotated(bool history_protect_annotated) {
+    historyProtectAnnotated.set(history_protect_annotated);
+}
+
 void Settings::setSunriseR(int sunrise_r) { sunriseR = sunrise_r; }
 
 void Settings::setSunriseG(int sunrise_g) { sunriseG = sunrise_g; }
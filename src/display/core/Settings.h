@@ -120,6 +120,10 @@ class Settings {
     float getSteamPumpCutoff() const { return steamPumpCutoff.get(); }
     int getThemeMode() const { return themeMode.get(); }
     int getHistoryIndex() const { return historyIndex.get(); }
+    int getHistoryInterval() const { return historyInterval.get(); }
+    int getHistoryQuotaMb() const { return historyQuotaMb.get(); }
+    int getHistoryEviction() const { return historyEviction.get(); }
+    bool isHistoryProtectAnnotated() const { return historyProtectAnnotated.get(); }
 
     [[deprecated]]
     int getSunriseR() const {
@@ -209,6 +213,10 @@ class Settings {
     void setSteamPumpCutoff(float steam_pump_cutoff);
     void setThemeMode(int theme_mode);
     void setHistoryIndex(int history_index);
+    void setHistoryInterval(int history_interval);
+    void setHistoryQuotaMb(int history_quota_mb);
+    void setHistoryEviction(int history_eviction);
+    void setHistoryProtectAnnotated(bool history_protect_annotated);
     [[deprecated]]
     void setSunriseR(int sunrise_r);
     [[deprecated]]
@@ -284,6 +292,12 @@ class Settings {
     Property<float> steamPumpPercentage{registry, "spp", DEFAULT_STEAM_PUMP_PERCENTAGE};
     Property<float> steamPumpCutoff{registry, "spc", DEFAULT_STEAM_PUMP_CUTOFF};
     Property<int> historyIndex{registry, "hi", 0};
+    Property<int> historyInterval{registry, "h_int", 250}; // shot sampling interval (ms), below 250 = high-res recording
+
+    // Shot history storage quota (see shot_index_quota.h)
+    Property<int> historyQuotaMb{registry, "h_quota", 0};             // MB, 0 = only keep the free-space reserve
+    Property<int> historyEviction{registry, "h_evict", 0};            // ShotEvictionPolicy: 0 = oldest, 1 = unrated first
+    Property<bool> historyProtectAnnotated{registry, "h_prot", true}; // rated/annotated: evicted only for the free-space floor
 
     // Display settings
     Property<int> mainBrightness{registry, "main_b", 16};
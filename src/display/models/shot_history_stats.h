@@ -0,0 +1,299 @@
+#ifndef SHOT_HISTORY_STATS_H
+#define SHOT_HISTORY_STATS_H
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include "shot_log_format.h"
+
+// Running history statistics (/h/stats.bin), answered by req:history:stats
+// without touching a single .slog file.
+//
+// Every completed, non-deleted index entry counts towards the total, its
+// profile, its day and its week. ShotHistoryPlugin adds and removes entries as
+// index ops apply, so the aggregates always describe the index, in O(1) per
+// shot. Sums are kept instead of averages so that removing a shot is exact.
+//
+//   days      the SHOT_STATS_DAYS most recent UTC days with shots, in a ring
+//             keyed by day number (a slot is taken over by a newer day with
+//             the same residue, so older days fall out as new ones arrive)
+//   weeks     the same for weeks starting on Monday
+//   profiles  up to SHOT_STATS_PROFILES profiles by id; shots of profiles
+//             beyond that go to the "other" bucket, and no new profile gets a
+//             slot while it holds shots, so a shot is always removed from the
+//             bucket it was added to
+//
+// Shots without a set clock (timestamps before 2020) only count towards the
+// total and their profile. Averages skip shots without a yield or pressure.
+//
+// Layout (little-endian): ShotStatsHeader, total bucket, other bucket, then
+// ShotStatsPeriod[days], ShotStatsPeriod[weeks], ShotStatsProfile[profiles].
+// The header carries the index generation (ShotIndexHeader::generation) it
+// was written with; if that does not match index.bin, the plugin recomputes
+// the statistics from the index instead.
+//
+// Plain C++ so the host tests can use it; the plugin backs the tables with
+// PSRAM through the Alloc parameter.
+
+static constexpr uint32_t SHOT_STATS_MAGIC = 0x54415453; // 'S''T''A''T' little-endian
+static constexpr uint16_t SHOT_STATS_VERSION = 1;
+static constexpr uint16_t SHOT_STATS_HEADER_SIZE = 32;
+static constexpr uint16_t SHOT_STATS_DAYS = 64;
+static constexpr uint16_t SHOT_STATS_WEEKS = 52;
+static constexpr uint16_t SHOT_STATS_PROFILES = 48;
+static constexpr uint8_t SHOT_STATS_RATINGS = 6;                 // 0 (unrated) to 5 stars
+static constexpr uint32_t SHOT_STATS_MIN_TIMESTAMP = 1577836800; // 2020-01-01, earlier means the clock was not set
+static constexpr uint32_t SHOT_STATS_DAY_SECONDS = 86400;
+
+#pragma pack(push, 1)
+struct ShotStatsHeader {
+    uint32_t magic;      // SHOT_STATS_MAGIC
+    uint16_t version;    // SHOT_STATS_VERSION
+    uint16_t bucketSize; // sizeof(ShotStatsBucket)
+    uint32_t generation; // ShotIndexHeader::generation of the index these statistics describe
+    uint16_t days;       // SHOT_STATS_DAYS
+    uint16_t weeks;      // SHOT_STATS_WEEKS
+    uint16_t profiles;   // SHOT_STATS_PROFILES
+    uint8_t reserved[14];
+};
+
+struct ShotStatsBucket {
+    uint32_t count;         // shots
+    uint32_t yieldCount;    // shots with a yield
+    uint32_t pressureCount; // shots with an average pressure
+    uint64_t durationMs;    // sum of ShotIndexEntry::duration
+    uint32_t yieldSum;      // sum of ShotIndexEntry::volume, g * 10
+    uint32_t pressureSum;   // sum of ShotIndexEntry::avgPressure, bar * 10
+    uint32_t ratings[SHOT_STATS_RATINGS];
+};
+
+struct ShotStatsPeriod {
+    uint32_t key; // day (days since 1970-01-01) or week (see shot_history_stats::weekOf), 0 = unused
+    ShotStatsBucket bucket;
+};
+
+struct ShotStatsProfile {
+    char profileId[32];   // slots without shots are free
+    char profileName[48]; // as of the newest shot added
+    ShotStatsBucket bucket;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ShotStatsHeader) == SHOT_STATS_HEADER_SIZE, "ShotStatsHeader size mismatch");
+
+namespace shot_history_stats {
+
+// Only finished shots that are still in the history count.
+inline bool counts(const ShotIndexEntry &entry) {
+    return (entry.flags & SHOT_FLAG_COMPLETED) && !(entry.flags & SHOT_FLAG_DELETED);
+}
+
+inline uint32_t dayOf(uint32_t timestamp) { return timestamp / SHOT_STATS_DAY_SECONDS; }
+
+// 1970-01-01 was a Thursday; week 1 starts on Monday 1970-01-05.
+inline uint32_t weekOf(uint32_t day) { return (day + 3) / 7; }
+
+// Unix time of the start of a day or week.
+inline uint32_t dayStart(uint32_t day) { return day * SHOT_STATS_DAY_SECONDS; }
+inline uint32_t weekStart(uint32_t week) { return (week * 7 - 3) * SHOT_STATS_DAY_SECONDS; }
+
+template <typename T> T moved(T value, T amount, bool add) {
+    // Saturating on removal: a bucket never wraps around, whatever it was loaded with
+    return add ? value + amount : (value > amount ? value - amount : 0);
+}
+
+inline void apply(ShotStatsBucket &bucket, const ShotIndexEntry &entry, bool add) {
+    bucket.count = moved<uint32_t>(bucket.count, 1, add);
+    bucket.durationMs = moved<uint64_t>(bucket.durationMs, entry.duration, add);
+    if (entry.volume > 0) {
+        bucket.yieldCount = moved<uint32_t>(bucket.yieldCount, 1, add);
+        bucket.yieldSum = moved<uint32_t>(bucket.yieldSum, entry.volume, add);
+    }
+    if (entry.avgPressure > 0) {
+        bucket.pressureCount = moved<uint32_t>(bucket.pressureCount, 1, add);
+        bucket.pressureSum = moved<uint32_t>(bucket.pressureSum, entry.avgPressure, add);
+    }
+    const uint8_t rating = entry.rating < SHOT_STATS_RATINGS ? entry.rating : SHOT_STATS_RATINGS - 1;
+    bucket.ratings[rating] = moved<uint32_t>(bucket.ratings[rating], 1, add);
+}
+
+} // namespace shot_history_stats
+
+template <template <typename> class Alloc = std::allocator> class ShotHistoryStats {
+  public:
+    void clear() {
+        total = ShotStatsBucket{};
+        other = ShotStatsBucket{};
+        days.assign(SHOT_STATS_DAYS, ShotStatsPeriod{});
+        weeks.assign(SHOT_STATS_WEEKS, ShotStatsPeriod{});
+        profiles.assign(SHOT_STATS_PROFILES, ShotStatsProfile{});
+    }
+
+    // Entries that do not count (in progress, deleted) are ignored, so callers
+    // can remove the old state of an entry and add the new one unconditionally.
+    void add(const ShotIndexEntry &entry) { update(entry, true); }
+    void remove(const ShotIndexEntry &entry) { update(entry, false); }
+
+    const ShotStatsBucket &totals() const { return total; }
+    const ShotStatsBucket &otherProfiles() const { return other; } // shots of profiles that got no slot
+
+    // fn(profileId, profileName, bucket) for every profile with shots
+    template <typename Fn> void forEachProfile(Fn &&fn) const {
+        for (const ShotStatsProfile &profile : profiles) {
+            if (profile.bucket.count > 0) {
+                fn(profile.profileId, profile.profileName, profile.bucket);
+            }
+        }
+    }
+
+    // fn(day, bucket) / fn(week, bucket) for every period with shots, oldest first
+    template <typename Fn> void forEachDay(Fn &&fn) const { forEachPeriod(days, fn); }
+    template <typename Fn> void forEachWeek(Fn &&fn) const { forEachPeriod(weeks, fn); }
+
+    size_t imageSize() const {
+        return sizeof(ShotStatsHeader) + 2 * sizeof(ShotStatsBucket) + (days.size() + weeks.size()) * sizeof(ShotStatsPeriod) +
+               profiles.size() * sizeof(ShotStatsProfile);
+    }
+
+    // Serializes into out (imageSize() bytes).
+    void writeImage(uint8_t *out, uint32_t generation) const {
+        ShotStatsHeader header{};
+        header.magic = SHOT_STATS_MAGIC;
+        header.version = SHOT_STATS_VERSION;
+        header.bucketSize = sizeof(ShotStatsBucket);
+        header.generation = generation;
+        header.days = days.size();
+        header.weeks = weeks.size();
+        header.profiles = profiles.size();
+        out = put(out, &header, sizeof(header));
+        out = put(out, &total, sizeof(total));
+        out = put(out, &other, sizeof(other));
+        out = put(out, days.data(), days.size() * sizeof(ShotStatsPeriod));
+        out = put(out, weeks.data(), weeks.size() * sizeof(ShotStatsPeriod));
+        put(out, profiles.data(), profiles.size() * sizeof(ShotStatsProfile));
+    }
+
+    // Loads an image written for this generation of the index; false (and
+    // cleared statistics) if it is for another one or malformed.
+    bool readImage(const uint8_t *data, size_t length, uint32_t generation) {
+        clear();
+        ShotStatsHeader header{};
+        if (length != imageSize()) {
+            return false;
+        }
+        data = get(data, &header, sizeof(header));
+        if (header.magic != SHOT_STATS_MAGIC || header.version != SHOT_STATS_VERSION ||
+            header.bucketSize != sizeof(ShotStatsBucket) || header.generation != generation || header.days != days.size() ||
+            header.weeks != weeks.size() || header.profiles != profiles.size()) {
+            return false;
+        }
+        data = get(data, &total, sizeof(total));
+        data = get(data, &other, sizeof(other));
+        data = get(data, days.data(), days.size() * sizeof(ShotStatsPeriod));
+        data = get(data, weeks.data(), weeks.size() * sizeof(ShotStatsPeriod));
+        get(data, profiles.data(), profiles.size() * sizeof(ShotStatsProfile));
+        return true;
+    }
+
+  private:
+    using PeriodVector = std::vector<ShotStatsPeriod, Alloc<ShotStatsPeriod>>;
+
+    static uint8_t *put(uint8_t *out, const void *src, size_t n) {
+        memcpy(out, src, n);
+        return out + n;
+    }
+    static const uint8_t *get(const uint8_t *in, void *dst, size_t n) {
+        memcpy(dst, in, n);
+        return in + n;
+    }
+
+    void update(const ShotIndexEntry &entry, bool add) {
+        if (days.empty()) {
+            clear();
+        }
+        if (!shot_history_stats::counts(entry)) {
+            return;
+        }
+        shot_history_stats::apply(total, entry, add);
+        if (ShotStatsBucket *bucket = profileBucket(entry, add)) {
+            shot_history_stats::apply(*bucket, entry, add);
+        } else {
+            shot_history_stats::apply(other, entry, add);
+        }
+        if (entry.timestamp >= SHOT_STATS_MIN_TIMESTAMP) {
+            const uint32_t day = shot_history_stats::dayOf(entry.timestamp);
+            if (ShotStatsBucket *bucket = periodBucket(days, day, add)) {
+                shot_history_stats::apply(*bucket, entry, add);
+            }
+            if (ShotStatsBucket *bucket = periodBucket(weeks, shot_history_stats::weekOf(day), add)) {
+                shot_history_stats::apply(*bucket, entry, add);
+            }
+        }
+    }
+
+    ShotStatsBucket *profileBucket(const ShotIndexEntry &entry, bool add) {
+        ShotStatsProfile *unused = nullptr;
+        for (ShotStatsProfile &profile : profiles) {
+            if (profile.bucket.count > 0 && strncmp(profile.profileId, entry.profileId, sizeof(profile.profileId)) == 0) {
+                if (add) {
+                    memcpy(profile.profileName, entry.profileName, sizeof(profile.profileName));
+                }
+                return &profile.bucket;
+            }
+            if (unused == nullptr && profile.bucket.count == 0) {
+                unused = &profile;
+            }
+        }
+        if (!add || unused == nullptr || other.count > 0) {
+            return nullptr;
+        }
+        *unused = ShotStatsProfile{};
+        memcpy(unused->profileId, entry.profileId, sizeof(unused->profileId));
+        unused->profileId[sizeof(unused->profileId) - 1] = '\0';
+        memcpy(unused->profileName, entry.profileName, sizeof(unused->profileName));
+        unused->profileName[sizeof(unused->profileName) - 1] = '\0';
+        return &unused->bucket;
+    }
+
+    // A period newer than the one in its slot takes the slot over; an older
+    // one is outside the window and not counted.
+    static ShotStatsBucket *periodBucket(PeriodVector &periods, uint32_t key, bool add) {
+        ShotStatsPeriod &period = periods[key % periods.size()];
+        if (period.key == key) {
+            return &period.bucket;
+        }
+        if (!add || period.key > key) {
+            return nullptr;
+        }
+        period = ShotStatsPeriod{};
+        period.key = key;
+        return &period.bucket;
+    }
+
+    template <typename Fn> static void forEachPeriod(const PeriodVector &periods, Fn &fn) {
+        uint32_t newest = 0;
+        for (const ShotStatsPeriod &period : periods) {
+            if (period.key > newest) {
+                newest = period.key;
+            }
+        }
+        const uint32_t span = periods.size();
+        for (uint32_t key = newest >= span ? newest - span + 1 : 1; newest > 0 && key <= newest; key++) {
+            const ShotStatsPeriod &period = periods[key % span];
+            if (period.key == key && period.bucket.count > 0) {
+                fn(key, period.bucket);
+            }
+        }
+    }
+
+    ShotStatsBucket total{};
+    ShotStatsBucket other{};
+    PeriodVector days;
+    PeriodVector weeks;
+    std::vector<ShotStatsProfile, Alloc<ShotStatsProfile>> profiles;
+};
+
+#endif // SHOT_HISTORY_STATS_H
@@ -0,0 +1,194 @@
+#ifndef SHOT_INDEX_JOURNAL_H
+#define SHOT_INDEX_JOURNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "shot_log_format.h"
+
+// Append-only mutation journal for the shot index (/h/index.jnl).
+//
+// Every index change is appended here as one small record before it is applied
+// to the in-memory index; index.bin itself is only rewritten when the journal is
+// compacted. At boot the journal is replayed on top of index.bin, so a power cut
+// at any point loses at most the record being written, never the index.
+//
+// Record layout (little-endian):
+//   uint8_t  sync      SHOT_INDEX_JOURNAL_SYNC
+//   uint8_t  type      ShotIndexJournalOp::Type
+//   uint16_t length    payload bytes
+//   payload            Upsert: ShotIndexEntry (128 B)
+//                      Delete: uint32_t id
+//                      Rating: uint32_t id, uint8_t rating, uint16_t volume (0 = unchanged)
+//   uint32_t crc       CRC-32 of sync..payload
+//
+// Replaying is idempotent, so records that already reached index.bin before a
+// crash can safely be applied again. Plain C++ so the host tests can use it.
+
+constexpr uint8_t SHOT_INDEX_JOURNAL_SYNC = 0xA5;
+constexpr size_t SHOT_INDEX_JOURNAL_HEADER_SIZE = 4;
+constexpr size_t SHOT_INDEX_JOURNAL_CRC_SIZE = 4;
+constexpr size_t SHOT_INDEX_JOURNAL_MAX_RECORD =
+    SHOT_INDEX_JOURNAL_HEADER_SIZE + sizeof(ShotIndexEntry) + SHOT_INDEX_JOURNAL_CRC_SIZE;
+
+struct ShotIndexJournalOp {
+    enum Type : uint8_t { Upsert = 1, Delete = 2, Rating = 3 };
+
+    Type type = Upsert;
+    uint32_t id = 0;
+    uint8_t rating = 0;
+    uint16_t volume = 0;
+    ShotIndexEntry entry{}; // Upsert only
+
+    static ShotIndexJournalOp upsert(const ShotIndexEntry &entry) {
+        ShotIndexJournalOp op;
+        op.type = Upsert;
+        op.id = entry.id;
+        op.entry = entry;
+        return op;
+    }
+    static ShotIndexJournalOp remove(uint32_t id) {
+        ShotIndexJournalOp op;
+        op.type = Delete;
+        op.id = id;
+        return op;
+    }
+    static ShotIndexJournalOp setRating(uint32_t id, uint8_t rating, uint16_t volume) {
+        ShotIndexJournalOp op;
+        op.type = Rating;
+        op.id = id;
+        op.rating = rating;
+        op.volume = volume;
+        return op;
+    }
+};
+
+namespace shot_index_journal {
+
+inline uint32_t crc32(const uint8_t *data, size_t len, uint32_t crc = 0) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+inline size_t payloadSize(uint8_t type) {
+    switch (type) {
+    case ShotIndexJournalOp::Upsert:
+        return sizeof(ShotIndexEntry);
+    case ShotIndexJournalOp::Delete:
+        return 4;
+    case ShotIndexJournalOp::Rating:
+        return 7;
+    default:
+        return 0;
+    }
+}
+
+// Serializes op into out (at least SHOT_INDEX_JOURNAL_MAX_RECORD bytes). Returns the record size.
+inline size_t encode(const ShotIndexJournalOp &op, uint8_t *out) {
+    const size_t length = payloadSize(op.type);
+    out[0] = SHOT_INDEX_JOURNAL_SYNC;
+    out[1] = op.type;
+    out[2] = static_cast<uint8_t>(length & 0xFF);
+    out[3] = static_cast<uint8_t>(length >> 8);
+    uint8_t *payload = out + SHOT_INDEX_JOURNAL_HEADER_SIZE;
+    if (op.type == ShotIndexJournalOp::Upsert) {
+        memcpy(payload, &op.entry, sizeof(op.entry));
+    } else {
+        memcpy(payload, &op.id, sizeof(op.id));
+        if (op.type == ShotIndexJournalOp::Rating) {
+            payload[4] = op.rating;
+            memcpy(payload + 5, &op.volume, sizeof(op.volume));
+        }
+    }
+    const size_t body = SHOT_INDEX_JOURNAL_HEADER_SIZE + length;
+    const uint32_t crc = crc32(out, body);
+    memcpy(out + body, &crc, sizeof(crc));
+    return body + SHOT_INDEX_JOURNAL_CRC_SIZE;
+}
+
+// Streaming reader: feed the journal in arbitrary chunks and every intact record
+// is handed to onOp(const ShotIndexJournalOp &). Stops for good at the first
+// record that is torn or fails its CRC (a write cut short by power loss); valid()
+// then tells how many bytes of the journal were good.
+class Reader {
+  public:
+    template <typename Fn> void feed(const uint8_t *data, size_t len, Fn &&onOp) {
+        while (len > 0 && !stopped) {
+            const size_t want = pending();
+            const size_t take = len < want - filled ? len : want - filled;
+            memcpy(buffer + filled, data, take);
+            filled += take;
+            data += take;
+            len -= take;
+            if (filled < want) {
+                break;
+            }
+            if (filled == SHOT_INDEX_JOURNAL_HEADER_SIZE) {
+                const size_t length = buffer[2] | (buffer[3] << 8);
+                if (buffer[0] != SHOT_INDEX_JOURNAL_SYNC || payloadSize(buffer[1]) == 0 || length != payloadSize(buffer[1])) {
+                    stopped = true;
+                    break;
+                }
+                continue;
+            }
+            const size_t body = filled - SHOT_INDEX_JOURNAL_CRC_SIZE;
+            uint32_t crc;
+            memcpy(&crc, buffer + body, sizeof(crc));
+            if (crc != crc32(buffer, body)) {
+                stopped = true;
+                break;
+            }
+            onOp(decode());
+            good += filled;
+            records++;
+            filled = 0;
+        }
+    }
+
+    size_t valid() const { return good; }
+    uint32_t count() const { return records; }
+    // True if the journal ended in a damaged or partial record.
+    bool damaged() const { return stopped || filled > 0; }
+
+  private:
+    size_t pending() const {
+        if (filled < SHOT_INDEX_JOURNAL_HEADER_SIZE) {
+            return SHOT_INDEX_JOURNAL_HEADER_SIZE;
+        }
+        return SHOT_INDEX_JOURNAL_HEADER_SIZE + payloadSize(buffer[1]) + SHOT_INDEX_JOURNAL_CRC_SIZE;
+    }
+
+    ShotIndexJournalOp decode() const {
+        ShotIndexJournalOp op;
+        op.type = static_cast<ShotIndexJournalOp::Type>(buffer[1]);
+        const uint8_t *payload = buffer + SHOT_INDEX_JOURNAL_HEADER_SIZE;
+        if (op.type == ShotIndexJournalOp::Upsert) {
+            memcpy(&op.entry, payload, sizeof(op.entry));
+            op.id = op.entry.id;
+        } else {
+            memcpy(&op.id, payload, sizeof(op.id));
+            if (op.type == ShotIndexJournalOp::Rating) {
+                op.rating = payload[4];
+                memcpy(&op.volume, payload + 5, sizeof(op.volume));
+            }
+        }
+        return op;
+    }
+
+    uint8_t buffer[SHOT_INDEX_JOURNAL_MAX_RECORD];
+    size_t filled = 0;
+    size_t good = 0;
+    uint32_t records = 0;
+    bool stopped = false;
+};
+
+} // namespace shot_index_journal
+
+#endif // SHOT_INDEX_JOURNAL_H
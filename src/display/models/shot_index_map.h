@@ -0,0 +1,116 @@
+#ifndef SHOT_INDEX_MAP_H
+#define SHOT_INDEX_MAP_H
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+// id -> slot lookup for /h/index.bin (slot = entry number after the header).
+//
+// Shot ids are handed out sequentially, so the map is a dense array indexed by
+// id - baseId: one uint32_t per id in the covered range, O(1) lookups and ~40 KB
+// for 10k shots. An id can appear more than once in older indexes (an early
+// entry that was marked deleted, then the id was reused); the newest slot is the
+// primary one and older slots are kept on a short side list so deletes can still
+// reach every copy. Ids that would stretch the dense range past MAX_SPAN (e.g. a
+// stray file with a bogus number) also go to the side list.
+//
+// Plain C++ so the host tests can use it; the plugin backs the dense array with
+// PSRAM through the Alloc parameter.
+template <typename Alloc = std::allocator<uint32_t>> class ShotIndexMap {
+  public:
+    static constexpr uint32_t MAX_SPAN = 1u << 16;
+
+    void clear() {
+        slots.clear();
+        extra.clear();
+        baseId = 0;
+        count = 0;
+    }
+
+    void insert(uint32_t id, uint32_t slot) {
+        uint32_t *cell = cellFor(id, true);
+        if (cell == nullptr) {
+            extra.emplace_back(id, slot);
+            count++;
+            return;
+        }
+        if (*cell != EMPTY) {
+            extra.emplace_back(id, *cell - 1);
+        }
+        *cell = slot + 1;
+        count++;
+    }
+
+    // Newest slot recorded for id.
+    bool find(uint32_t id, uint32_t &slot) const {
+        if (const uint32_t *cell = cellFor(id); cell != nullptr && *cell != EMPTY) {
+            slot = *cell - 1;
+            return true;
+        }
+        for (auto it = extra.rbegin(); it != extra.rend(); ++it) {
+            if (it->first == id) {
+                slot = it->second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Calls fn(slot) for every slot holding id (newest first). Returns how many there were.
+    template <typename Fn> size_t forEachSlot(uint32_t id, Fn &&fn) const {
+        size_t found = 0;
+        if (const uint32_t *cell = cellFor(id); cell != nullptr && *cell != EMPTY) {
+            fn(*cell - 1);
+            found++;
+        }
+        for (auto it = extra.rbegin(); it != extra.rend(); ++it) {
+            if (it->first == id) {
+                fn(it->second);
+                found++;
+            }
+        }
+        return found;
+    }
+
+    size_t size() const { return count; }
+
+  private:
+    static constexpr uint32_t EMPTY = 0; // cells store slot + 1
+
+    const uint32_t *cellFor(uint32_t id) const {
+        if (slots.empty() || id < baseId || id - baseId >= slots.size()) {
+            return nullptr;
+        }
+        return &slots[id - baseId];
+    }
+
+    uint32_t *cellFor(uint32_t id, bool grow) {
+        if (slots.empty()) {
+            baseId = id;
+        }
+        if (id < baseId) {
+            const uint32_t shift = baseId - id;
+            if (!grow || slots.size() + shift > MAX_SPAN) {
+                return nullptr;
+            }
+            slots.insert(slots.begin(), shift, EMPTY);
+            baseId = id;
+        } else if (id - baseId >= slots.size()) {
+            if (!grow || id - baseId >= MAX_SPAN) {
+                return nullptr;
+            }
+            slots.resize(id - baseId + 1, EMPTY);
+        }
+        return &slots[id - baseId];
+    }
+
+    std::vector<uint32_t, Alloc> slots;
+    std::vector<std::pair<uint32_t, uint32_t>> extra; // (id, slot): duplicates and out-of-range ids
+    uint32_t baseId = 0;
+    size_t count = 0;
+};
+
+#endif // SHOT_INDEX_MAP_H
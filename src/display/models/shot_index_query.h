@@ -0,0 +1,119 @@
+#ifndef SHOT_INDEX_QUERY_H
+#define SHOT_INDEX_QUERY_H
+
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "shot_log_format.h"
+
+// Server-side filter/sort/page over the shot index, used by req:history:query
+// and /api/history/query so clients receive only the entries they display
+// instead of the whole index.bin. Bounds are inclusive and in the entry's own
+// fixed-point units (see ShotIndexEntry). Plain C++ so the host tests can run it.
+
+enum class ShotIndexSortKey : uint8_t { Id, Timestamp, Duration, Volume, Rating, AvgTemp, MaxPressure, AvgFlow };
+
+struct ShotIndexQuery {
+    static constexpr uint32_t DEFAULT_LIMIT = 50;
+    static constexpr uint32_t MAX_LIMIT = 500;
+
+    char profileId[32] = {}; // exact match, empty = any profile
+    uint32_t fromTimestamp = 0;
+    uint32_t toTimestamp = UINT32_MAX;
+    uint8_t minRating = 0;
+    uint8_t maxRating = UINT8_MAX;
+    uint16_t minAvgTemp = 0; // °C * 10
+    uint16_t maxAvgTemp = UINT16_MAX;
+    uint16_t minMaxPressure = 0; // bar * 10
+    uint16_t maxMaxPressure = UINT16_MAX;
+    uint16_t minAvgFlow = 0; // ml/s * 100
+    uint16_t maxAvgFlow = UINT16_MAX;
+    uint8_t requiredFlags = 0;                 // all of these must be set
+    uint8_t excludedFlags = SHOT_FLAG_DELETED; // none of these may be set
+
+    ShotIndexSortKey sortKey = ShotIndexSortKey::Id;
+    bool descending = true;
+    uint32_t offset = 0;
+    uint32_t limit = DEFAULT_LIMIT;
+
+    bool matches(const ShotIndexEntry &e) const {
+        if ((e.flags & requiredFlags) != requiredFlags || (e.flags & excludedFlags) != 0) {
+            return false;
+        }
+        if (e.timestamp < fromTimestamp || e.timestamp > toTimestamp) {
+            return false;
+        }
+        if (e.rating < minRating || e.rating > maxRating) {
+            return false;
+        }
+        if (e.avgTemp < minAvgTemp || e.avgTemp > maxAvgTemp || e.maxPressure < minMaxPressure ||
+            e.maxPressure > maxMaxPressure || e.avgFlow < minAvgFlow || e.avgFlow > maxAvgFlow) {
+            return false;
+        }
+        return profileId[0] == '\0' || strncmp(profileId, e.profileId, sizeof(profileId)) == 0;
+    }
+
+    uint32_t sortValue(const ShotIndexEntry &e) const {
+        switch (sortKey) {
+        case ShotIndexSortKey::Timestamp:
+            return e.timestamp;
+        case ShotIndexSortKey::Duration:
+            return e.duration;
+        case ShotIndexSortKey::Volume:
+            return e.volume;
+        case ShotIndexSortKey::Rating:
+            return e.rating;
+        case ShotIndexSortKey::AvgTemp:
+            return e.avgTemp;
+        case ShotIndexSortKey::MaxPressure:
+            return e.maxPressure;
+        case ShotIndexSortKey::AvgFlow:
+            return e.avgFlow;
+        case ShotIndexSortKey::Id:
+        default:
+            return e.id;
+        }
+    }
+};
+
+// Collects the slots of all entries matching query into slots (a vector-like
+// container of uint32_t), sorts them by query.sortKey (ties broken by id, same
+// direction) and trims slots to the requested page. Returns the number of
+// matches before paging so clients can show "n of total".
+template <typename SlotVector>
+size_t runShotIndexQuery(const ShotIndexEntry *entries, size_t count, const ShotIndexQuery &query, SlotVector &slots) {
+    slots.clear();
+    for (size_t i = 0; i < count; i++) {
+        if (query.matches(entries[i])) {
+            slots.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    const size_t total = slots.size();
+    const size_t begin = std::min<size_t>(query.offset, total);
+    const size_t end = std::min<size_t>(begin + std::min(query.limit, ShotIndexQuery::MAX_LIMIT), total);
+
+    // Entries are appended in id order, so the default sort needs no comparison.
+    if (query.sortKey == ShotIndexSortKey::Id) {
+        if (query.descending) {
+            std::reverse(slots.begin(), slots.end());
+        }
+    } else {
+        auto less = [&](uint32_t a, uint32_t b) {
+            const uint32_t va = query.sortValue(entries[a]);
+            const uint32_t vb = query.sortValue(entries[b]);
+            if (va != vb) {
+                return query.descending ? va > vb : va < vb;
+            }
+            return query.descending ? entries[a].id > entries[b].id : entries[a].id < entries[b].id;
+        };
+        std::partial_sort(slots.begin(), slots.begin() + end, slots.end(), less);
+    }
+
+    slots.erase(slots.begin() + end, slots.end());
+    slots.erase(slots.begin(), slots.begin() + begin);
+    return total;
+}
+
+#endif // SHOT_INDEX_QUERY_H
@@ -0,0 +1,130 @@
+#ifndef SHOT_INDEX_QUOTA_H
+#define SHOT_INDEX_QUOTA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "shot_log_format.h"
+
+// Storage quota for the shot history, planned from the index alone.
+//
+// The bytes the history occupies are the sum of the fileSize of the live index
+// entries (ShotHistoryPlugin keeps that sum up to date as index ops apply), so
+// deciding what to evict never lists /h or asks the filesystem for its usage
+// per file. Shots are evicted until the history fits its byte budget and the
+// filesystem keeps its free-space floor, in the order of the eviction policy:
+//   Oldest        lowest shot id first
+//   UnratedFirst  shots without rating or notes first (oldest first), then
+//                 rated or annotated ones by rating, lowest first, then age
+// With protectAnnotated, shots that have a rating or notes are kept out of the
+// budget: they only go, oldest first, when free space would otherwise stay
+// under the floor, so a fully rated history cannot fill the filesystem.
+//
+// Plain C++ so the host tests can use it.
+
+// Assumed size of entries written before the index tracked file sizes
+static constexpr uint32_t SHOT_QUOTA_UNKNOWN_FILE_BYTES = 8 * 1024;
+
+enum class ShotEvictionPolicy : uint8_t { Oldest = 0, UnratedFirst = 1 };
+
+struct ShotQuota {
+    uint64_t maxBytes = 0;     // history budget, 0 = only the free-space floor applies
+    uint64_t minFreeBytes = 0; // free space to leave on the filesystem
+    ShotEvictionPolicy policy = ShotEvictionPolicy::Oldest;
+    bool protectAnnotated = true;
+};
+
+namespace shot_index_quota {
+
+// Bytes an index entry stands for in the history total (0 once deleted).
+inline uint32_t entryBytes(const ShotIndexEntry &entry) {
+    if (entry.flags & SHOT_FLAG_DELETED) {
+        return 0;
+    }
+    return entry.fileSize ? entry.fileSize : SHOT_QUOTA_UNKNOWN_FILE_BYTES;
+}
+
+inline bool isAnnotated(const ShotIndexEntry &entry) { return entry.rating > 0 || (entry.flags & SHOT_FLAG_HAS_NOTES); }
+
+// How many bytes have to go: the larger of how far the history is over its
+// budget and how far free space is under the floor.
+inline uint64_t bytesToFree(uint64_t historyBytes, uint64_t freeBytes, const ShotQuota &quota) {
+    uint64_t need = 0;
+    if (quota.maxBytes > 0 && historyBytes > quota.maxBytes) {
+        need = historyBytes - quota.maxBytes;
+    }
+    if (freeBytes < quota.minFreeBytes && quota.minFreeBytes - freeBytes > need) {
+        need = quota.minFreeBytes - freeBytes;
+    }
+    return need;
+}
+
+// The part of bytesToFree() that keeps the free-space floor, which protected
+// shots give way to.
+inline uint64_t floorBytesToFree(uint64_t freeBytes, const ShotQuota &quota) {
+    return freeBytes < quota.minFreeBytes ? quota.minFreeBytes - freeBytes : 0;
+}
+
+// Picks the index slots to evict so at least need bytes are released, in
+// eviction order; keepId (the shot being recorded) is never picked. If that
+// leaves less than floorNeed (see floorBytesToFree()) released, protected
+// shots follow, oldest first, until it is. slots is scratch and receives the
+// picks; returns the bytes they stand for, which is less than need when
+// everything left is protected.
+template <typename SlotVector>
+uint64_t plan(const ShotIndexEntry *entries, size_t count, uint64_t need, const ShotQuota &quota, uint32_t keepId,
+              SlotVector &slots, uint64_t floorNeed = 0) {
+    slots.clear();
+    if (need == 0) {
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const ShotIndexEntry &entry = entries[i];
+        if ((entry.flags & SHOT_FLAG_DELETED) || entry.id == keepId || (quota.protectAnnotated && isAnnotated(entry))) {
+            continue;
+        }
+        slots.push_back(static_cast<uint32_t>(i));
+    }
+    const bool unratedFirst = quota.policy == ShotEvictionPolicy::UnratedFirst;
+    std::sort(slots.begin(), slots.end(), [&](uint32_t a, uint32_t b) {
+        const ShotIndexEntry &ea = entries[a];
+        const ShotIndexEntry &eb = entries[b];
+        if (unratedFirst) {
+            const bool annotatedA = isAnnotated(ea), annotatedB = isAnnotated(eb);
+            if (annotatedA != annotatedB) {
+                return !annotatedA;
+            }
+            if (ea.rating != eb.rating) {
+                return ea.rating < eb.rating;
+            }
+        }
+        return ea.id < eb.id;
+    });
+    uint64_t freed = 0;
+    size_t picked = 0;
+    while (picked < slots.size() && freed < need) {
+        freed += entryBytes(entries[slots[picked++]]);
+    }
+    slots.resize(picked);
+    if (!quota.protectAnnotated || freed >= floorNeed) {
+        return freed;
+    }
+    for (size_t i = 0; i < count; i++) {
+        const ShotIndexEntry &entry = entries[i];
+        if (!(entry.flags & SHOT_FLAG_DELETED) && entry.id != keepId && isAnnotated(entry)) {
+            slots.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    std::sort(slots.begin() + picked, slots.end(), [&](uint32_t a, uint32_t b) { return entries[a].id < entries[b].id; });
+    while (picked < slots.size() && freed < floorNeed) {
+        freed += entryBytes(entries[slots[picked++]]);
+    }
+    slots.resize(picked);
+    return freed;
+}
+
+} // namespace shot_index_quota
+
+#endif // SHOT_INDEX_QUOTA_H
@@ -0,0 +1,176 @@
+#ifndef SHOT_LOG_BATCH_H
+#define SHOT_LOG_BATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "shot_log_format.h"
+
+// Multi-shot download container served by /api/history/batch, so a page that
+// needs N shots makes one request instead of N.
+//
+// Layout (little-endian):
+//   ShotBatchHeader                 magic, version, count, fieldsMask
+//   ShotBatchEntry[count]           directory: id, offset and length of each section
+//   section[count]                  one per shot, in directory order
+//
+// With fieldsMask 0 (or SHOT_LOG_FIELDS_MASK_ALL) a section is the .slog file
+// exactly as stored. Otherwise it is a v5-style file holding only the selected
+// fields: the header with version = SHOT_LOG_VERSION_RAW, fieldsMask = the
+// mask and reserved0 = the projected sample size, then sampleCount fixed-size
+// records. Either way the existing .slog parsers read each section unchanged.
+//
+// Plain C++ so the host tests can use it.
+
+static constexpr uint32_t SHOT_BATCH_MAGIC = 0x54414253; // 'SBAT'
+static constexpr uint16_t SHOT_BATCH_VERSION = 1;
+static constexpr uint16_t SHOT_BATCH_MAX_SHOTS = 100;
+
+// ShotBatchEntry.flags
+static constexpr uint8_t SHOT_BATCH_MISSING = 0x01;    // no such shot; length is 0
+static constexpr uint8_t SHOT_BATCH_INCOMPLETE = 0x02; // still recording or cut short
+
+#pragma pack(push, 1)
+struct ShotBatchHeader {
+    uint32_t magic;      // SHOT_BATCH_MAGIC
+    uint16_t version;    // SHOT_BATCH_VERSION
+    uint16_t count;      // directory entries
+    uint32_t fieldsMask; // 0 = sections are the stored files
+    uint32_t reserved;
+};
+
+struct ShotBatchEntry {
+    uint32_t id;
+    uint32_t offset; // from the start of the container
+    uint32_t length; // section bytes
+    uint32_t sampleCount;
+    uint8_t flags;
+    uint8_t reserved[3];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ShotBatchHeader) == 16, "ShotBatchHeader size mismatch");
+static_assert(sizeof(ShotBatchEntry) == 20, "ShotBatchEntry size mismatch");
+
+namespace shot_log_batch {
+
+// Normalizes a requested mask: unknown bits are dropped and an empty or full
+// mask means "stored files" (0).
+inline uint32_t normalizeMask(uint32_t mask) {
+    mask &= SHOT_LOG_FIELDS_MASK_ALL;
+    return mask == SHOT_LOG_FIELDS_MASK_ALL ? 0 : mask;
+}
+
+inline uint8_t fieldCount(uint32_t mask) {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < SHOT_LOG_FIELD_COUNT; i++) {
+        n += (mask >> i) & 1u;
+    }
+    return n;
+}
+
+inline size_t sampleSize(uint32_t mask) { return mask ? fieldCount(mask) * 2u : SHOT_LOG_SAMPLE_SIZE; }
+
+// Writes the fields of sample selected by mask, in field order; returns bytes written.
+inline size_t projectSample(const ShotLogSample &sample, uint32_t mask, uint8_t *out) {
+    uint16_t fields[SHOT_LOG_FIELD_COUNT];
+    memcpy(fields, &sample, sizeof(fields));
+    size_t n = 0;
+    for (uint8_t i = 0; i < SHOT_LOG_FIELD_COUNT; i++) {
+        if (mask & (1u << i)) {
+            memcpy(out + n, &fields[i], sizeof(fields[i]));
+            n += sizeof(fields[i]);
+        }
+    }
+    return n;
+}
+
+// Turns a stored header into the header of a projected section.
+inline void projectHeader(ShotLogHeader &header, uint32_t mask) {
+    header.version = SHOT_LOG_VERSION_RAW;
+    header.fieldsMask = mask;
+    header.reserved0 = static_cast<uint8_t>(sampleSize(mask));
+}
+
+// Parses a comma-separated id list ("12,13,000014") into ids; returns the
+// count, at most maxIds. Empty and non-numeric items are skipped.
+inline size_t parseIds(const char *list, uint32_t *ids, size_t maxIds) {
+    size_t count = 0;
+    const char *p = list;
+    while (p && *p && count < maxIds) {
+        uint32_t id = 0;
+        bool digits = false;
+        while (*p >= '0' && *p <= '9') {
+            id = id * 10 + static_cast<uint32_t>(*p++ - '0');
+            digits = true;
+        }
+        if (digits && (*p == ',' || *p == '\0')) {
+            ids[count++] = id;
+        }
+        while (*p && *p != ',') {
+            p++;
+        }
+        if (*p == ',') {
+            p++;
+        }
+    }
+    return count;
+}
+
+// Fixed-capacity byte FIFO over caller-provided storage (a pooled PSRAM chunk
+// on the device). The batch stream fills it from the shot files and drains it
+// into the HTTP response, so memory stays the same whatever the batch size.
+class ByteRing {
+  public:
+    ByteRing(uint8_t *storage, size_t capacity) : data(storage), cap(capacity) {}
+
+    size_t size() const { return used; }
+    size_t space() const { return cap - used; }
+
+    size_t push(const uint8_t *in, size_t len) {
+        len = len < space() ? len : space();
+        for (size_t done = 0; done < len;) {
+            const size_t tail = (head + used) % cap;
+            const size_t run = (cap - tail) < (len - done) ? cap - tail : len - done;
+            memcpy(data + tail, in + done, run);
+            used += run;
+            done += run;
+        }
+        return len;
+    }
+
+    size_t pushZeros(size_t len) {
+        len = len < space() ? len : space();
+        for (size_t done = 0; done < len;) {
+            const size_t tail = (head + used) % cap;
+            const size_t run = (cap - tail) < (len - done) ? cap - tail : len - done;
+            memset(data + tail, 0, run);
+            used += run;
+            done += run;
+        }
+        return len;
+    }
+
+    size_t pop(uint8_t *out, size_t len) {
+        len = len < used ? len : used;
+        for (size_t done = 0; done < len;) {
+            const size_t run = (cap - head) < (len - done) ? cap - head : len - done;
+            memcpy(out + done, data + head, run);
+            head = (head + run) % cap;
+            used -= run;
+            done += run;
+        }
+        return len;
+    }
+
+  private:
+    uint8_t *data;
+    size_t cap;
+    size_t head = 0;
+    size_t used = 0;
+};
+
+} // namespace shot_log_batch
+
+#endif // SHOT_LOG_BATCH_H
@@ -0,0 +1,236 @@
+#ifndef SHOT_LOG_CODEC_H
+#define SHOT_LOG_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "shot_log_format.h"
+
+// Encoder / streaming decoder for the .slog sample stream (layout documented in shot_log_format.h).
+// Plain C++ with no Arduino/ESP dependencies so the same code runs in the firmware, the simulator and
+// host-side tools and tests.
+
+namespace shot_log {
+
+inline void toFields(const ShotLogSample &sample, uint16_t (&fields)[SHOT_LOG_FIELD_COUNT]) {
+    memcpy(fields, &sample, sizeof(sample));
+}
+
+inline void fromFields(const uint16_t (&fields)[SHOT_LOG_FIELD_COUNT], ShotLogSample &sample) {
+    memcpy(&sample, fields, sizeof(sample));
+}
+
+inline uint16_t zigzag(uint16_t delta) {
+    const auto v = static_cast<int16_t>(delta);
+    return static_cast<uint16_t>((static_cast<uint16_t>(v) << 1) ^ static_cast<uint16_t>(v >> 15));
+}
+
+inline uint16_t unzigzag(uint16_t v) { return static_cast<uint16_t>((v >> 1) ^ static_cast<uint16_t>(-(v & 1))); }
+
+inline size_t writeVarint(uint8_t *out, uint16_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+}
+
+// Returns bytes consumed, 0 if the varint runs past end or is longer than a uint16_t can hold.
+inline size_t readVarint(const uint8_t *in, size_t len, uint16_t &value) {
+    uint32_t result = 0;
+    for (size_t i = 0; i < len && i < 3; i++) {
+        result |= static_cast<uint32_t>(in[i] & 0x7F) << (7 * i);
+        if ((in[i] & 0x80) == 0) {
+            value = static_cast<uint16_t>(result);
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// Groups samples into v6 blocks. push() returns true once a block is full; the caller then copies
+// data()/size() to the file and calls reset(). finish() closes a partial block at the end of a shot.
+class Encoder {
+  public:
+    bool push(const ShotLogSample &sample) {
+        uint16_t fields[SHOT_LOG_FIELD_COUNT];
+        toFields(sample, fields);
+        uint8_t *payload = buffer + SHOT_LOG_BLOCK_HEADER_SIZE;
+        if (count == 0) {
+            memcpy(payload, fields, sizeof(fields));
+            payloadSize = sizeof(fields);
+            tickStep = 0;
+        } else {
+            uint8_t *out = payload + payloadSize;
+            size_t pos = 2;
+            uint16_t mask = 0;
+            for (uint8_t i = 0; i < SHOT_LOG_FIELD_COUNT; i++) {
+                uint16_t delta = static_cast<uint16_t>(fields[i] - prev[i]);
+                if (i == 0) {
+                    const uint16_t step = delta;
+                    delta = static_cast<uint16_t>(step - tickStep);
+                    tickStep = step;
+                }
+                if (delta != 0) {
+                    mask |= static_cast<uint16_t>(1u << i);
+                    pos += writeVarint(out + pos, zigzag(delta));
+                }
+            }
+            out[0] = static_cast<uint8_t>(mask & 0xFF);
+            out[1] = static_cast<uint8_t>(mask >> 8);
+            payloadSize += pos;
+        }
+        memcpy(prev, fields, sizeof(prev));
+        count++;
+        return count >= SHOT_LOG_BLOCK_SAMPLES;
+    }
+
+    // Seals the current block header. Returns false if there is nothing to write.
+    bool finish() {
+        if (count == 0) {
+            return false;
+        }
+        buffer[0] = count;
+        buffer[1] = static_cast<uint8_t>(payloadSize & 0xFF);
+        buffer[2] = static_cast<uint8_t>(payloadSize >> 8);
+        return true;
+    }
+
+    const uint8_t *data() {
+        finish();
+        return buffer;
+    }
+    size_t size() const { return count ? SHOT_LOG_BLOCK_HEADER_SIZE + payloadSize : 0; }
+    uint8_t pending() const { return count; }
+    void reset() {
+        count = 0;
+        payloadSize = 0;
+    }
+
+  private:
+    uint8_t buffer[SHOT_LOG_BLOCK_HEADER_SIZE + SHOT_LOG_BLOCK_MAX_PAYLOAD];
+    uint16_t prev[SHOT_LOG_FIELD_COUNT]{};
+    uint16_t tickStep = 0;
+    uint16_t payloadSize = 0;
+    uint8_t count = 0;
+};
+
+// Incremental decoder for the sample section of a .slog file (everything after headerSize). Bytes can
+// be fed in arbitrary chunks; each complete sample is handed to the callback as a ShotLogSample, so a
+// whole shot never has to be in memory. Handles both the raw v5 records and the v6 blocks.
+class Decoder {
+  public:
+    explicit Decoder(uint8_t version = SHOT_LOG_VERSION) : delta(version >= SHOT_LOG_VERSION_DELTA) {}
+
+    // Feeds len bytes and invokes onSample(const ShotLogSample &) for every decoded sample. Returning
+    // false from the callback stops decoding. Returns false once the stream is found to be corrupt.
+    template <typename Fn> bool feed(const uint8_t *data, size_t len, Fn &&onSample) {
+        while (len > 0 && !failed && !stopped) {
+            const size_t want = pendingBytes();
+            const size_t take = len < want - filled ? len : want - filled;
+            memcpy(buffer + filled, data, take);
+            filled += take;
+            data += take;
+            len -= take;
+            if (filled < want) {
+                break;
+            }
+            if (!delta) {
+                ShotLogSample sample;
+                memcpy(&sample, buffer, sizeof(sample));
+                filled = 0;
+                emit(sample, onSample);
+            } else if (!inBlock) {
+                blockCount = buffer[0];
+                blockPayload = static_cast<uint16_t>(buffer[1] | (buffer[2] << 8));
+                if (blockCount == 0 || blockCount > SHOT_LOG_BLOCK_SAMPLES || blockPayload < SHOT_LOG_SAMPLE_SIZE ||
+                    blockPayload > SHOT_LOG_BLOCK_MAX_PAYLOAD) {
+                    failed = true;
+                    break;
+                }
+                inBlock = true;
+                filled = 0;
+            } else {
+                decodeBlock(onSample);
+                inBlock = false;
+                filled = 0;
+            }
+        }
+        return !failed;
+    }
+
+    uint32_t decoded() const { return samples; }
+    bool corrupt() const { return failed; }
+    // Bytes held back waiting for the rest of a record/block; non-zero at end of input means truncation.
+    size_t buffered() const { return filled + (inBlock ? SHOT_LOG_BLOCK_HEADER_SIZE : 0); }
+
+  private:
+    size_t pendingBytes() const {
+        if (!delta) {
+            return SHOT_LOG_SAMPLE_SIZE;
+        }
+        return inBlock ? blockPayload : SHOT_LOG_BLOCK_HEADER_SIZE;
+    }
+
+    template <typename Fn> void emit(const ShotLogSample &sample, Fn &onSample) {
+        samples++;
+        if (!onSample(sample)) {
+            stopped = true;
+        }
+    }
+
+    template <typename Fn> void decodeBlock(Fn &onSample) {
+        uint16_t fields[SHOT_LOG_FIELD_COUNT];
+        memcpy(fields, buffer, sizeof(fields));
+        size_t pos = sizeof(fields);
+        uint16_t tickStep = 0;
+        ShotLogSample sample;
+        fromFields(fields, sample);
+        emit(sample, onSample);
+        for (uint8_t s = 1; s < blockCount && !stopped; s++) {
+            if (pos + 2 > blockPayload) {
+                failed = true;
+                return;
+            }
+            const uint16_t mask = static_cast<uint16_t>(buffer[pos] | (buffer[pos + 1] << 8));
+            pos += 2;
+            for (uint8_t i = 0; i < SHOT_LOG_FIELD_COUNT; i++) {
+                uint16_t delta = 0;
+                if (mask & (1u << i)) {
+                    uint16_t encoded = 0;
+                    const size_t n = readVarint(buffer + pos, blockPayload - pos, encoded);
+                    if (n == 0) {
+                        failed = true;
+                        return;
+                    }
+                    pos += n;
+                    delta = unzigzag(encoded);
+                }
+                if (i == 0) {
+                    tickStep = static_cast<uint16_t>(tickStep + delta);
+                    delta = tickStep;
+                }
+                fields[i] = static_cast<uint16_t>(fields[i] + delta);
+            }
+            fromFields(fields, sample);
+            emit(sample, onSample);
+        }
+    }
+
+    uint8_t buffer[SHOT_LOG_BLOCK_MAX_PAYLOAD];
+    size_t filled = 0;
+    uint32_t samples = 0;
+    uint16_t blockPayload = 0;
+    uint8_t blockCount = 0;
+    bool delta;
+    bool inBlock = false;
+    bool failed = false;
+    bool stopped = false;
+};
+
+} // namespace shot_log
+
+#endif // SHOT_LOG_CODEC_H
@@ -0,0 +1,117 @@
+#ifndef SHOT_LOG_COLUMNS_H
+#define SHOT_LOG_COLUMNS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "shot_log_batch.h"
+#include "shot_log_format.h"
+
+// Column-major field projection of a shot, served by
+// GET /api/history/<id>.slog?fieldsMask=... for charts that only need a few
+// of the 13 sample fields (e.g. t, cp, fl and v: 8 instead of 26 bytes per
+// sample).
+//
+// Layout (little-endian):
+//   ShotLogHeader     as stored, except version = SHOT_LOG_VERSION_COLUMNAR,
+//                     fieldsMask = the projection and reserved0 = its sample size
+//   column[fields]    one per selected field in field order, n uint16 values each
+//
+// n = (length - headerSize) / reserved0. sampleCount and durationMs keep their
+// stored meaning, so a shot still recording has sampleCount 0.
+//
+// The firmware collects the projected rows while decoding the file and
+// transposes them as the response is sent (copyColumns); Reader is the
+// matching decoder for host tools and tests. Plain C++ so both can use it.
+
+namespace shot_log_columns {
+
+// Turns a stored header into the header of a columnar response.
+inline void makeHeader(ShotLogHeader &header, uint32_t mask) {
+    header.version = SHOT_LOG_VERSION_COLUMNAR;
+    header.fieldsMask = mask;
+    header.reserved0 = static_cast<uint8_t>(shot_log_batch::sampleSize(mask));
+}
+
+// Appends the fields of sample selected by mask to a row-major buffer.
+template <typename Rows> inline void appendRow(Rows &rows, const ShotLogSample &sample, uint32_t mask) {
+    uint16_t fields[SHOT_LOG_FIELD_COUNT];
+    const size_t n = shot_log_batch::projectSample(sample, mask, reinterpret_cast<uint8_t *>(fields)) / sizeof(uint16_t);
+    rows.insert(rows.end(), fields, fields + n);
+}
+
+// Copies bytes [offset, offset + len) of the column-major form of count rows
+// of fields values each into out; returns the bytes copied.
+inline size_t copyColumns(const uint16_t *rows, uint8_t fields, uint32_t count, size_t offset, uint8_t *out,
+                          size_t len) {
+    const size_t total = static_cast<size_t>(fields) * count * sizeof(uint16_t);
+    if (offset >= total) {
+        return 0;
+    }
+    len = len < total - offset ? len : total - offset;
+    for (size_t done = 0; done < len;) {
+        const size_t value = (offset + done) / sizeof(uint16_t);
+        const size_t byte = (offset + done) % sizeof(uint16_t);
+        const uint16_t v = rows[(value % count) * fields + value / count];
+        const uint8_t bytes[2] = {static_cast<uint8_t>(v & 0xFF), static_cast<uint8_t>(v >> 8)};
+        const size_t run = (sizeof(uint16_t) - byte) < (len - done) ? sizeof(uint16_t) - byte : len - done;
+        memcpy(out + done, bytes + byte, run);
+        done += run;
+    }
+    return len;
+}
+
+// Read-only view over a columnar response held in memory.
+class Reader {
+  public:
+    bool parse(const uint8_t *data, size_t len) {
+        valid = false;
+        if (data == nullptr || len < sizeof(ShotLogHeader)) {
+            return false;
+        }
+        memcpy(&head, data, sizeof(head));
+        if (head.magic != SHOT_LOG_MAGIC || head.version != SHOT_LOG_VERSION_COLUMNAR ||
+            head.headerSize != SHOT_LOG_HEADER_SIZE || head.fieldsMask == 0 ||
+            head.reserved0 != shot_log_batch::sampleSize(head.fieldsMask)) {
+            return false;
+        }
+        columns = data + head.headerSize;
+        rowCount = static_cast<uint32_t>((len - head.headerSize) / head.reserved0);
+        valid = true;
+        return true;
+    }
+
+    const ShotLogHeader &header() const { return head; }
+    uint32_t count() const { return valid ? rowCount : 0; }
+    bool has(uint32_t field) const { return valid && (head.fieldsMask & field) != 0; }
+
+    // Value of sample index for a SHOT_LOG_FIELD_* bit; 0 if it was not selected.
+    uint16_t value(uint32_t field, uint32_t index) const {
+        if (!has(field) || index >= rowCount) {
+            return 0;
+        }
+        const uint8_t column = shot_log_batch::fieldCount(head.fieldsMask & (field - 1));
+        const uint8_t *p = columns + (static_cast<size_t>(column) * rowCount + index) * sizeof(uint16_t);
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    // Rebuilds a full sample; fields outside the projection are 0.
+    void sample(uint32_t index, ShotLogSample &out) const {
+        uint16_t fields[SHOT_LOG_FIELD_COUNT];
+        for (uint8_t i = 0; i < SHOT_LOG_FIELD_COUNT; i++) {
+            fields[i] = value(1u << i, index);
+        }
+        memcpy(&out, fields, sizeof(out));
+    }
+
+  private:
+    ShotLogHeader head{};
+    const uint8_t *columns = nullptr;
+    uint32_t rowCount = 0;
+    bool valid = false;
+};
+
+} // namespace shot_log_columns
+
+#endif // SHOT_LOG_COLUMNS_H
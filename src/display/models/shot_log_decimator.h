@@ -0,0 +1,143 @@
+#ifndef SHOT_LOG_DECIMATOR_H
+#define SHOT_LOG_DECIMATOR_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "shot_log_format.h"
+
+// Adaptive decimation for high-rate shot recording.
+//
+// With a history interval below SHOT_LOG_SAMPLE_INTERVAL_MS the recorder
+// samples at that rate during the shot but only stores what the higher rate
+// actually adds:
+//   - every sample within windowMs either side of a phase transition,
+//   - samples where pressure, flow, a target or the system state moved by more
+//     than the thresholds below since the last stored sample,
+//   - otherwise one sample per maxGapMs (the standard 250 ms cadence).
+// A steady stretch therefore costs the same as at the standard rate, and the
+// extra samples go to ramps and transitions.
+//
+// Stored samples keep their timestamp (sample.t, ms since the shot started,
+// see shot_log_timing.h), so readers get the right time for each sample
+// without knowing which ones were dropped. Phase transitions refer to the
+// index among stored samples.
+//
+// Samples are held back for the window so the ones just before a transition
+// can still be kept; flush() releases them at the end of the shot. Plain C++
+// so the host tests can use it.
+
+static constexpr uint8_t SHOT_LOG_DECIMATOR_MAX_WINDOW = 16;    // samples held back at most
+static constexpr uint16_t SHOT_LOG_DECIMATOR_WINDOW_MS = 500;   // full rate either side of a transition
+static constexpr uint16_t SHOT_LOG_DECIMATOR_PRESSURE_STEP = 2; // bar * 10
+static constexpr uint16_t SHOT_LOG_DECIMATOR_FLOW_STEP = 20;    // ml/s * 100
+
+class ShotLogDecimator {
+  public:
+    // intervalMs is the rate samples are taken at. At maxGapMs or slower every
+    // sample is stored as it comes in.
+    void reset(uint16_t intervalMs, uint16_t windowMs = SHOT_LOG_DECIMATOR_WINDOW_MS,
+               uint16_t maxGapMs = SHOT_LOG_SAMPLE_INTERVAL_MS) {
+        *this = ShotLogDecimator();
+        interval = intervalMs ? intervalMs : SHOT_LOG_SAMPLE_INTERVAL_MS;
+        maxGap = maxGapMs;
+        fullRateMs = windowMs;
+        if (interval < maxGap) {
+            const uint32_t samples = windowMs / interval;
+            window = static_cast<uint8_t>(samples < SHOT_LOG_DECIMATOR_MAX_WINDOW ? samples : SHOT_LOG_DECIMATOR_MAX_WINDOW);
+        }
+    }
+
+    // A phase transition happens at the next sample pushed: the samples held
+    // back and the window after it are all stored. Returns the index that next
+    // sample gets among the stored ones.
+    uint32_t markTransition() {
+        for (uint8_t i = 0; i < held; i++) {
+            slots[(head + i) % CAPACITY].keep = true;
+        }
+        transitionPending = true;
+        return stored + held;
+    }
+
+    // emit(const ShotLogSample &) is called for every sample that is stored, in order.
+    template <typename Emit> void push(const ShotLogSample &sample, Emit &&emit) {
+        if (interval >= maxGap) {
+            store(sample, emit);
+            return;
+        }
+        if (transitionPending) {
+            transitionPending = false;
+            transitionT = sample.t;
+            keepActive = true;
+        }
+        Slot &slot = slots[(head + held) % CAPACITY];
+        slot.sample = sample;
+        slot.keep = keepActive && static_cast<uint16_t>(sample.t - transitionT) <= fullRateMs;
+        keepActive = keepActive && slot.keep;
+        held++;
+        if (held > window) {
+            release(emit, false);
+        }
+    }
+
+    // Releases the held samples; the last one is always stored so the shot's end is kept.
+    template <typename Emit> void flush(Emit &&emit) {
+        while (held > 0) {
+            release(emit, held == 1);
+        }
+    }
+
+    uint32_t storedCount() const { return stored; }
+
+  private:
+    static constexpr uint8_t CAPACITY = SHOT_LOG_DECIMATOR_MAX_WINDOW + 1;
+
+    struct Slot {
+        ShotLogSample sample;
+        bool keep;
+    };
+
+    template <typename Emit> void release(Emit &emit, bool force) {
+        const Slot &slot = slots[head];
+        head = (head + 1) % CAPACITY;
+        held--;
+        if (force || slot.keep || !hasLast || significant(slot.sample)) {
+            store(slot.sample, emit);
+        }
+    }
+
+    template <typename Emit> void store(const ShotLogSample &sample, Emit &emit) {
+        emit(sample);
+        last = sample;
+        hasLast = true;
+        stored++;
+    }
+
+    bool significant(const ShotLogSample &s) const {
+        // Half an interval early, so sampling jitter doesn't push the steady cadence out to the next sample
+        if (static_cast<uint16_t>(s.t - last.t) + interval / 2 >= maxGap) {
+            return true;
+        }
+        if (s.tt != last.tt || s.tp != last.tp || s.tf != last.tf || s.si != last.si) {
+            return true;
+        }
+        return abs(static_cast<int>(s.cp) - static_cast<int>(last.cp)) >= SHOT_LOG_DECIMATOR_PRESSURE_STEP ||
+               abs(s.fl - last.fl) >= SHOT_LOG_DECIMATOR_FLOW_STEP || abs(s.pf - last.pf) >= SHOT_LOG_DECIMATOR_FLOW_STEP;
+    }
+
+    Slot slots[CAPACITY] = {};
+    uint8_t head = 0;
+    uint8_t held = 0;
+    uint8_t window = 0; // samples held back
+    uint16_t interval = SHOT_LOG_SAMPLE_INTERVAL_MS;
+    uint16_t maxGap = SHOT_LOG_SAMPLE_INTERVAL_MS;
+    uint32_t stored = 0;
+    uint16_t fullRateMs = SHOT_LOG_DECIMATOR_WINDOW_MS; // after a transition
+    uint16_t transitionT = 0;
+    bool keepActive = false;
+    bool transitionPending = false;
+    bool hasLast = false;
+    ShotLogSample last{};
+};
+
+#endif // SHOT_LOG_DECIMATOR_H
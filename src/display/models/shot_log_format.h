@@ -15,13 +15,38 @@
 // Values are stored as scaled integers (see comments per field below).
 // Sample size = 13 fields * 2 bytes = 26 bytes (v5+ format). Phase data moved to header transitions.
 // Older files may have fewer fields - use fieldsMask to determine layout.
+//
+// v6 keeps the v5 header byte-for-byte but stores the samples delta-compressed (see shot_log_codec.h):
+//   Samples are grouped into blocks of up to SHOT_LOG_BLOCK_SAMPLES. Each block is
+//     uint8_t count, uint16_t payloadSize, payload[payloadSize]
+//   and the payload starts with a keyframe (the first sample as 13 raw uint16 values, 26 bytes). Every
+//   following sample is a uint16_t changed-field mask (bit i = field i in the order above) plus one
+//   zigzag LEB128 varint per set bit holding the 16-bit wrapping delta to the previous sample. For the
+//   tick field the delta is taken against the previous tick step, so a steady cadence costs nothing (with
+//   millisecond timestamps only the jitter is stored, usually one byte).
+//   Blocks are self-contained, so a file truncated by power loss decodes up to its last complete block.
+//   reserved0 still reports the decoded sample size (26) and sampleCount the number of decoded samples.
+//
+// v7 is never written to flash: it is the column-major field projection served by
+// GET /api/history/<id>.slog?fieldsMask=... (see shot_log_columns.h).
 
 static constexpr uint32_t SHOT_LOG_MAGIC = 0x544F4853; // 'S''H''O''T' little-endian 0x54 0x4F 0x48 0x53
-static constexpr uint8_t SHOT_LOG_VERSION = 5;
+static constexpr uint8_t SHOT_LOG_VERSION_RAW = 5;                 // fixed-size sample records
+static constexpr uint8_t SHOT_LOG_VERSION_DELTA = 6;               // delta/varint-compressed sample blocks
+static constexpr uint8_t SHOT_LOG_VERSION_COLUMNAR = 7;            // projected columns, downloads only
+static constexpr uint8_t SHOT_LOG_VERSION = SHOT_LOG_VERSION_DELTA; // version written by the firmware
 static constexpr uint16_t SHOT_LOG_HEADER_SIZE = 512;
-static constexpr uint16_t SHOT_LOG_SAMPLE_INTERVAL_MS = 250; // nominal recording interval
+static constexpr uint16_t SHOT_LOG_SAMPLE_INTERVAL_MS = 250; // standard recording interval (Settings::getHistoryInterval())
 static constexpr uint32_t SHOT_LOG_FIELDS_MASK_ALL = 0x1FFF; // 13 fields present (removed phase number)
 static constexpr uint32_t SHOT_LOG_SAMPLE_SIZE = 26;
+static constexpr uint8_t SHOT_LOG_FIELD_COUNT = 13;
+
+// v6 block layout (see shot_log_codec.h)
+static constexpr uint8_t SHOT_LOG_BLOCK_SAMPLES = 32;     // samples per block, the first one is the keyframe
+static constexpr uint16_t SHOT_LOG_BLOCK_HEADER_SIZE = 3; // uint8_t count + uint16_t payloadSize
+// Keyframe + worst case for every other sample (mask + 3-byte varint per field)
+static constexpr uint16_t SHOT_LOG_BLOCK_MAX_PAYLOAD =
+    SHOT_LOG_SAMPLE_SIZE + (SHOT_LOG_BLOCK_SAMPLES - 1) * (2 + SHOT_LOG_FIELD_COUNT * 3);
 
 // Field bit positions (for future expansion)
 static constexpr uint32_t SHOT_LOG_FIELD_T = 0x0001;  // tick (bit 0)
@@ -39,6 +64,10 @@ static constexpr uint32_t SHOT_LOG_FIELD_PR = 0x0800; // puck resistance (bit 11
 static constexpr uint32_t SHOT_LOG_FIELD_SI = 0x1000; // system info (bit 12)
 // Bits 13-31 available for future fields
 
+// ShotLogHeader.flags
+// sample.t is milliseconds since the shot started (mod 65536, see shot_log_timing.h) instead of a tick index
+static constexpr uint16_t SHOT_LOG_FLAG_MS_TIMESTAMPS = 0x0001;
+
 // Phase transition structure for version 5+ headers
 // transitionReason was a reserved/padding byte through v5; repurposing it keeps the struct byte-identical,
 // so old readers (firmware + web parser) ignore it and old files read back as PHASE_EXIT_REASON_NONE (0).
@@ -68,8 +97,8 @@ struct ShotLogHeader {
     uint8_t version;         // = SHOT_LOG_VERSION
     uint8_t reserved0;       // stores sample size (SHOT_LOG_SAMPLE_SIZE) for diagnostics
     uint16_t headerSize;     // = SHOT_LOG_HEADER_SIZE
-    uint16_t sampleInterval; // ms (nominal)
-    uint16_t reserved1;      // future
+    uint16_t sampleInterval; // ms the shot was sampled at (see shot_log_decimator.h)
+    uint16_t flags;          // SHOT_LOG_FLAG_*, 0 in older files (was reserved)
     uint32_t fieldsMask;     // bitmask (currently always SHOT_LOG_FIELDS_MASK_ALL)
     uint32_t sampleCount;    // patched at end
     uint32_t durationMs;     // patched at end (last t)
@@ -89,13 +118,24 @@ struct ShotLogHeader {
     // Carved from the v5 reserved padding; old files have 0 here and old readers ignore it.
     uint16_t brewDelayMs; // 2 bytes
 
+    // Sampling health, counted by the recorder (0 in older files): samples taken more than half an
+    // interval late, and whole intervals missed (no sample recorded for them).
+    uint16_t lateSamples;    // 2 bytes
+    uint16_t droppedSamples; // 2 bytes
+
+    // Gaps between samples taken (stored or not), measured by the recorder; 0 in older files.
+    uint16_t maxGapMs; // 2 bytes
+    uint16_t p99GapMs; // 2 bytes
+
     // Future expansion - pad to 512 bytes total
-    uint8_t reserved_v5[50]; // Manual padding to reach 512 bytes
+    uint8_t reserved_v5[42]; // Manual padding to reach 512 bytes
 };
 #pragma pack(pop)
 
 // Scaled values:
-//   tick: sample index (0.25 s steps) -> milliseconds = tick * SHOT_LOG_SAMPLE_INTERVAL_MS
+//   t: with SHOT_LOG_FLAG_MS_TIMESTAMPS, ms since the shot started mod 65536 (ShotLogTimeline unwraps it);
+//      in older files a tick index -> milliseconds = tick * header.sampleInterval
+//      (stored samples need not be evenly spaced either way, see shot_log_decimator.h)
 //   tt / ct: temperature in °C * 10 (0.1 °C resolution)
 //   tp / cp: pressure in bar * 10 (0.1 bar resolution)
 //   fl / tf / pf / vf: flow in ml/s * 100 (0.01 ml/s resolution)
@@ -103,7 +143,7 @@ struct ShotLogHeader {
 //   pr: puck resistance * 100 (0.01 step, saturates at uint16_t max)
 //   si: system info bit-packed (see SYSTEM_INFO_* constants)
 struct ShotLogSample {
-    uint16_t t;  // sample index (0.25 s ticks)
+    uint16_t t;  // ms since shot start (mod 65536), or tick index in older files
     uint16_t tt; // target temp * 10
     uint16_t ct; // current temp * 10
     uint16_t tp; // target pressure * 10
@@ -150,7 +190,8 @@ struct ShotIndexHeader {
     uint16_t entrySize;   // SHOT_INDEX_ENTRY_SIZE
     uint32_t entryCount;  // Number of entries in file
     uint32_t nextId;      // Next shot ID to use
-    uint8_t reserved[16]; // Future expansion
+    uint32_t generation;  // Bumped on every write; /h/stats.bin records the one it was computed for (0 in older files)
+    uint8_t reserved[12]; // Future expansion
 };
 
 struct ShotIndexEntry {
@@ -170,7 +211,29 @@ struct ShotIndexEntry {
     uint16_t maxPressure; // bar * 10
     uint16_t avgFlow;     // ml/s * 100
 
-    uint8_t reserved[26]; // Future expansion
+    // .slog size and last-write time the entry was built from, so an
+    // incremental rebuild can skip files that have not changed (0 = unknown).
+    uint32_t fileSize;  // bytes
+    uint32_t fileMtime; // Unix timestamp
+
+    uint16_t avgPressure; // bar * 10, time-weighted over the brew (0 = not recorded)
+
+    uint8_t reserved[16]; // Future expansion
+};
+#pragma pack(pop)
+
+// Rebuild checkpoint (/h/rebuild.ckpt), rewritten every few files while the
+// index is rebuilt and removed when the rebuild completes. If it is still there
+// at boot, the rebuild resumes with the shots after lastId.
+static constexpr uint32_t SHOT_REBUILD_MAGIC = 0x4B434252; // 'RBCK'
+
+#pragma pack(push, 1)
+struct ShotRebuildCheckpoint {
+    uint32_t magic;      // SHOT_REBUILD_MAGIC
+    uint8_t incremental; // 1 = incremental rebuild, 0 = full
+    uint8_t reserved[3];
+    uint32_t lastId;    // highest shot id already in the index
+    uint32_t processed; // files handled so far (diagnostics)
 };
 #pragma pack(pop)
 
@@ -0,0 +1,129 @@
+#ifndef SHOT_LOG_HTTP_H
+#define SHOT_LOG_HTTP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// HTTP helpers for serving .slog files from /api/history/: single byte-range
+// parsing (RFC 7233) and the shot ETag. A completed shot never changes, so
+// its id, sampleCount and file size identify the content; browsers revalidate
+// with If-None-Match and get a 304 instead of the file. Plain C++ so the host
+// tests can use it.
+
+struct ShotLogByteRange {
+    uint32_t start = 0;
+    uint32_t length = 0;
+};
+
+enum class ShotLogRangeStatus : uint8_t {
+    Full,         // no (usable) Range header: send the whole file
+    Partial,      // send range with 206
+    Unsatisfiable // send 416
+};
+
+namespace shot_log_http {
+
+inline bool parseNumber(const char *&p, uint32_t &out) {
+    if (*p < '0' || *p > '9') {
+        return false;
+    }
+    uint64_t value = 0;
+    while (*p >= '0' && *p <= '9') {
+        value = value * 10 + (*p++ - '0');
+        if (value > UINT32_MAX) {
+            value = UINT32_MAX; // clamp, the range check below rejects it
+        }
+    }
+    out = static_cast<uint32_t>(value);
+    return true;
+}
+
+// Parses a Range header value against a file of size bytes. Only a single
+// "bytes=" range is honoured; multi-range and malformed headers fall back to
+// Full, as RFC 7233 allows.
+inline ShotLogRangeStatus parseRange(const char *header, uint32_t size, ShotLogByteRange &range) {
+    range.start = 0;
+    range.length = size;
+    if (header == nullptr || strncmp(header, "bytes=", 6) != 0 || strchr(header, ',') != nullptr) {
+        return ShotLogRangeStatus::Full;
+    }
+    const char *p = header + 6;
+    uint32_t first = 0, last = 0;
+    if (*p == '-') { // suffix range: the last n bytes
+        p++;
+        if (!parseNumber(p, last) || *p != '\0') {
+            return ShotLogRangeStatus::Full;
+        }
+        if (last == 0 || size == 0) {
+            return ShotLogRangeStatus::Unsatisfiable;
+        }
+        range.length = last < size ? last : size;
+        range.start = size - range.length;
+        return ShotLogRangeStatus::Partial;
+    }
+    if (!parseNumber(p, first) || *p++ != '-') {
+        return ShotLogRangeStatus::Full;
+    }
+    last = size > 0 ? size - 1 : 0;
+    if (*p != '\0') {
+        uint32_t requested = 0;
+        if (!parseNumber(p, requested) || *p != '\0' || requested < first) {
+            return ShotLogRangeStatus::Full;
+        }
+        if (requested < last) {
+            last = requested;
+        }
+    }
+    if (first >= size) {
+        return ShotLogRangeStatus::Unsatisfiable;
+    }
+    range.start = first;
+    range.length = last - first + 1;
+    return ShotLogRangeStatus::Partial;
+}
+
+// Writes the quoted ETag for a completed shot into out; returns its length.
+inline size_t formatEtag(char *out, size_t len, uint32_t id, uint32_t sampleCount, uint32_t size) {
+    const int n = snprintf(out, len, "\"%lu-%lu-%lx\"", static_cast<unsigned long>(id), static_cast<unsigned long>(sampleCount),
+                           static_cast<unsigned long>(size));
+    return n > 0 ? static_cast<size_t>(n) : 0;
+}
+
+// If-None-Match check: "*" or any listed tag (weak or strong) equal to etag.
+inline bool etagMatches(const char *ifNoneMatch, const char *etag) {
+    if (ifNoneMatch == nullptr) {
+        return false;
+    }
+    const size_t etagLen = strlen(etag);
+    const char *p = ifNoneMatch;
+    while (*p) {
+        while (*p == ' ' || *p == ',') {
+            p++;
+        }
+        if (*p == '*') {
+            return true;
+        }
+        if (strncmp(p, "W/", 2) == 0) {
+            p += 2;
+        }
+        const char *end = strchr(p, ',');
+        size_t n = end ? static_cast<size_t>(end - p) : strlen(p);
+        while (n > 0 && p[n - 1] == ' ') {
+            n--;
+        }
+        if (n == etagLen && strncmp(p, etag, n) == 0) {
+            return true;
+        }
+        if (!end) {
+            break;
+        }
+        p = end;
+    }
+    return false;
+}
+
+} // namespace shot_log_http
+
+#endif // SHOT_LOG_HTTP_H
@@ -0,0 +1,148 @@
+#ifndef SHOT_LOG_LIVE_H
+#define SHOT_LOG_LIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "shot_log_format.h"
+
+// Live shot stream: binary websocket messages sent to clients subscribed with
+// req:history:live while a shot records. Each message is one frame:
+//   ShotLiveFrameHeader             magic, type, flags, count, shotId, index
+//   payload                         depends on the type
+//
+//   START    the ShotLogHeader as written at the start of the .slog (512 bytes).
+//            index is the stored index of the next sample, 0 unless the frame
+//            is a RESYNC for a client that joined mid-shot (the header then
+//            already holds the phase transitions so far).
+//   SAMPLES  count ShotLogSample records (26 bytes each), exactly the samples
+//            stored in the .slog; index is the stored index of the first one.
+//            At sampling rates faster than SHOT_LOG_SAMPLE_INTERVAL_MS they can
+//            lag by up to the decimator's holdback (see shot_log_decimator.h).
+//   PHASE    count PhaseTransition records (29 bytes each); index is the slot
+//            of the first one in header.phaseTransitions. sampleIndex may point
+//            at a sample that has not been sent yet.
+//   END      the final ShotLogHeader (sampleCount, durationMs etc. patched),
+//            with SHOT_LIVE_FLAG_DISCARDED if the shot was too short to keep.
+//
+// START followed by the SAMPLES payloads is the shot as a v5 file (set
+// version to SHOT_LOG_VERSION_RAW), so the .slog parsers read it unchanged.
+//
+// Plain C++ so the host tests can use it.
+
+static constexpr uint32_t SHOT_LIVE_MAGIC = 0x564C4853; // 'SHLV'
+static constexpr uint16_t SHOT_LIVE_MAX_SAMPLES = 32;   // per SAMPLES frame
+
+// ShotLiveFrameHeader.type
+static constexpr uint8_t SHOT_LIVE_START = 1;
+static constexpr uint8_t SHOT_LIVE_SAMPLES = 2;
+static constexpr uint8_t SHOT_LIVE_PHASE = 3;
+static constexpr uint8_t SHOT_LIVE_END = 4;
+
+// ShotLiveFrameHeader.flags
+static constexpr uint8_t SHOT_LIVE_FLAG_RESYNC = 0x01;    // START re-sent mid-shot for a new subscriber
+static constexpr uint8_t SHOT_LIVE_FLAG_DISCARDED = 0x02; // END of a shot that was not saved
+
+#pragma pack(push, 1)
+struct ShotLiveFrameHeader {
+    uint32_t magic; // SHOT_LIVE_MAGIC
+    uint8_t type;   // SHOT_LIVE_START..SHOT_LIVE_END
+    uint8_t flags;  // SHOT_LIVE_FLAG_*
+    uint16_t count; // records in the payload (1 for START and END)
+    uint32_t shotId;
+    uint32_t index; // see the frame types above
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ShotLiveFrameHeader) == 16, "ShotLiveFrameHeader size mismatch");
+
+namespace shot_log_live {
+
+// Payload bytes of a frame of the given type and record count.
+inline size_t payloadSize(uint8_t type, uint16_t count) {
+    switch (type) {
+    case SHOT_LIVE_START:
+    case SHOT_LIVE_END:
+        return count == 1 ? sizeof(ShotLogHeader) : 0;
+    case SHOT_LIVE_SAMPLES:
+        return static_cast<size_t>(count) * sizeof(ShotLogSample);
+    case SHOT_LIVE_PHASE:
+        return static_cast<size_t>(count) * sizeof(PhaseTransition);
+    default:
+        return 0;
+    }
+}
+
+inline size_t frameSize(uint8_t type, uint16_t count) { return sizeof(ShotLiveFrameHeader) + payloadSize(type, count); }
+
+// Writes a frame into out (frameSize(type, count) bytes); returns its size.
+inline size_t writeFrame(uint8_t *out, uint8_t type, uint8_t flags, uint16_t count, uint32_t shotId, uint32_t index,
+                         const void *payload) {
+    ShotLiveFrameHeader frame{};
+    frame.magic = SHOT_LIVE_MAGIC;
+    frame.type = type;
+    frame.flags = flags;
+    frame.count = count;
+    frame.shotId = shotId;
+    frame.index = index;
+    memcpy(out, &frame, sizeof(frame));
+    const size_t len = payloadSize(type, count);
+    if (len > 0) {
+        memcpy(out + sizeof(frame), payload, len);
+    }
+    return sizeof(frame) + len;
+}
+
+// Checks a received frame and points payload at its records; false if it is
+// not a live frame or its length does not match the type and count.
+inline bool readFrame(const uint8_t *data, size_t len, ShotLiveFrameHeader &frame, const uint8_t *&payload) {
+    if (len < sizeof(frame)) {
+        return false;
+    }
+    memcpy(&frame, data, sizeof(frame));
+    if (frame.magic != SHOT_LIVE_MAGIC || frame.count == 0 || len != frameSize(frame.type, frame.count) ||
+        payloadSize(frame.type, frame.count) == 0) {
+        return false;
+    }
+    payload = data + sizeof(frame);
+    return true;
+}
+
+// The stored samples not yet sent, numbered from the start of the shot. The
+// recorder pushes every stored sample and sends (or just clears) the batch
+// once per record() call, or early when it fills up.
+class SampleBatch {
+  public:
+    void reset() {
+        next = 0;
+        used = 0;
+    }
+
+    // Adds the next stored sample; true when the batch is full and must be sent.
+    bool push(const ShotLogSample &sample) {
+        if (used == 0) {
+            first = next;
+        }
+        samples[used++] = sample;
+        next++;
+        return used == SHOT_LIVE_MAX_SAMPLES;
+    }
+
+    void clear() { used = 0; }
+
+    uint16_t count() const { return used; }
+    uint32_t firstIndex() const { return first; }
+    uint32_t nextIndex() const { return next; } // samples stored so far
+    const ShotLogSample *data() const { return samples; }
+
+  private:
+    ShotLogSample samples[SHOT_LIVE_MAX_SAMPLES];
+    uint32_t first = 0;
+    uint32_t next = 0;
+    uint16_t used = 0;
+};
+
+} // namespace shot_log_live
+
+#endif // SHOT_LOG_LIVE_H
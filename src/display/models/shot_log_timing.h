@@ -0,0 +1,95 @@
+#ifndef SHOT_LOG_TIMING_H
+#define SHOT_LOG_TIMING_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "shot_log_format.h"
+
+// Sample time helpers for .slog files.
+//
+// With SHOT_LOG_FLAG_MS_TIMESTAMPS set in the header, sample.t is the time the
+// sample was taken in milliseconds since the shot started, modulo 65536.
+// Consecutive samples are never 65 s apart, so readers unwrap it by adding up
+// the 16-bit differences. Older files store a tick index instead, and the time
+// is t × sampleInterval. Plain C++ so the host tests can use it.
+
+// Turns the sample.t of consecutive samples into milliseconds since the shot started.
+class ShotLogTimeline {
+  public:
+    void reset(const ShotLogHeader &header) {
+        msTimestamps = (header.flags & SHOT_LOG_FLAG_MS_TIMESTAMPS) != 0;
+        interval = header.sampleInterval ? header.sampleInterval : SHOT_LOG_SAMPLE_INTERVAL_MS;
+        started = false;
+        ms = 0;
+    }
+
+    // Call once per sample, in file order.
+    uint32_t next(uint16_t t) {
+        if (!msTimestamps) {
+            return static_cast<uint32_t>(t) * interval;
+        }
+        ms = started ? ms + static_cast<uint16_t>(t - lastT) : t;
+        lastT = t;
+        started = true;
+        return ms;
+    }
+
+  private:
+    uint32_t ms = 0;
+    uint16_t lastT = 0;
+    uint16_t interval = SHOT_LOG_SAMPLE_INTERVAL_MS;
+    bool msTimestamps = false;
+    bool started = false;
+};
+
+// Distribution of the gaps between samples taken during a shot, for the
+// header's maxGapMs and p99GapMs. 1 ms buckets up to SHOT_LOG_JITTER_BUCKETS,
+// longer gaps count in the last one (the maximum is still exact).
+static constexpr uint16_t SHOT_LOG_JITTER_BUCKETS = 512;
+
+class ShotLogJitter {
+  public:
+    void reset() {
+        memset(counts, 0, sizeof(counts));
+        total = 0;
+        max = 0;
+    }
+
+    void add(uint32_t gapMs) {
+        const uint16_t gap = static_cast<uint16_t>(gapMs < UINT16_MAX ? gapMs : UINT16_MAX);
+        if (gap > max) {
+            max = gap;
+        }
+        uint16_t &bucket = counts[gap < SHOT_LOG_JITTER_BUCKETS ? gap : SHOT_LOG_JITTER_BUCKETS - 1];
+        if (bucket < UINT16_MAX) {
+            bucket++;
+            total++;
+        }
+    }
+
+    uint16_t maxGap() const { return max; }
+
+    // Smallest gap that at least permille/1000 of the gaps do not exceed.
+    uint16_t percentile(uint16_t permille) const {
+        if (total == 0) {
+            return 0;
+        }
+        const uint32_t rank = (static_cast<uint64_t>(total) * permille + 999) / 1000;
+        uint32_t seen = 0;
+        for (uint16_t gap = 0; gap < SHOT_LOG_JITTER_BUCKETS; gap++) {
+            seen += counts[gap];
+            if (seen >= rank) {
+                return gap == SHOT_LOG_JITTER_BUCKETS - 1 ? max : gap;
+            }
+        }
+        return max;
+    }
+
+  private:
+    uint16_t counts[SHOT_LOG_JITTER_BUCKETS] = {};
+    uint32_t total = 0;
+    uint16_t max = 0;
+};
+
+#endif // SHOT_LOG_TIMING_H
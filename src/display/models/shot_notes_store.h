@@ -0,0 +1,237 @@
+#ifndef SHOT_NOTES_STORE_H
+#define SHOT_NOTES_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "shot_index_journal.h"
+
+// Log-structured store for shot notes (/h/notes.log), replacing one .json file
+// per shot.
+//
+// Saving notes appends a record with the shot's JSON; erasing appends a
+// tombstone. The newest record for an id wins. At boot the log is scanned once
+// into a ShotNotesDirectory (id -> payload offset), so reading notes is one
+// seek and one read. Once the log holds more than twice the bytes of its live
+// records it is compacted into a new file that replaces it.
+//
+// File layout (little-endian):
+//   header   uint32_t magic SHOT_NOTES_MAGIC, uint16_t version, uint16_t reserved
+//   records  uint8_t  sync      SHOT_NOTES_SYNC
+//            uint8_t  type      ShotNotesRecord::Type
+//            uint16_t length    payload bytes (0 for Erase)
+//            uint32_t id        shot id
+//            payload            notes JSON (Put only)
+//            uint32_t crc       CRC-32 of sync..payload
+//
+// A record cut short by a power loss fails its CRC; the scan stops there and
+// the store is compacted, which drops the torn tail. Plain C++ so the host
+// tests can use it.
+
+constexpr uint32_t SHOT_NOTES_MAGIC = 0x53544E53; // 'SNTS'
+constexpr uint16_t SHOT_NOTES_VERSION = 1;
+constexpr size_t SHOT_NOTES_FILE_HEADER_SIZE = 8;
+constexpr uint8_t SHOT_NOTES_SYNC = 0x5A;
+constexpr size_t SHOT_NOTES_RECORD_HEADER_SIZE = 8;
+constexpr size_t SHOT_NOTES_CRC_SIZE = 4;
+constexpr size_t SHOT_NOTES_MAX_PAYLOAD = 4096;       // larger notes are rejected
+constexpr size_t SHOT_NOTES_COMPACT_MIN_BYTES = 16384; // don't compact logs smaller than this
+
+struct ShotNotesRecord {
+    enum Type : uint8_t { Put = 1, Erase = 2 };
+};
+
+namespace shot_notes_store {
+
+inline size_t recordSize(size_t payloadLength) {
+    return SHOT_NOTES_RECORD_HEADER_SIZE + payloadLength + SHOT_NOTES_CRC_SIZE;
+}
+
+inline void encodeFileHeader(uint8_t *out) {
+    const uint16_t version = SHOT_NOTES_VERSION;
+    memcpy(out, &SHOT_NOTES_MAGIC, 4);
+    memcpy(out + 4, &version, 2);
+    memset(out + 6, 0, 2);
+}
+
+inline bool checkFileHeader(const uint8_t *data, size_t len) {
+    uint32_t magic;
+    uint16_t version;
+    if (len < SHOT_NOTES_FILE_HEADER_SIZE) {
+        return false;
+    }
+    memcpy(&magic, data, 4);
+    memcpy(&version, data + 4, 2);
+    return magic == SHOT_NOTES_MAGIC && version == SHOT_NOTES_VERSION;
+}
+
+// Serializes a record into out (at least recordSize(length) bytes). Returns
+// the record size.
+inline size_t encode(ShotNotesRecord::Type type, uint32_t id, const uint8_t *payload, size_t length, uint8_t *out) {
+    if (type == ShotNotesRecord::Erase) {
+        length = 0;
+    }
+    out[0] = SHOT_NOTES_SYNC;
+    out[1] = type;
+    out[2] = static_cast<uint8_t>(length & 0xFF);
+    out[3] = static_cast<uint8_t>(length >> 8);
+    memcpy(out + 4, &id, sizeof(id));
+    if (length > 0) {
+        memcpy(out + SHOT_NOTES_RECORD_HEADER_SIZE, payload, length);
+    }
+    const size_t body = SHOT_NOTES_RECORD_HEADER_SIZE + length;
+    const uint32_t crc = shot_index_journal::crc32(out, body);
+    memcpy(out + body, &crc, sizeof(crc));
+    return body + SHOT_NOTES_CRC_SIZE;
+}
+
+// Streaming scanner for the records after the file header. Feed the log in
+// arbitrary chunks; every intact record is reported as
+// onRecord(type, id, payloadOffset, length), with payloadOffset counted from
+// the start of the file. Payloads are checked against their CRC as they pass
+// but not kept, so scanning needs no buffer for them. Stops for good at the
+// first damaged record.
+class Scanner {
+  public:
+    template <typename Fn> void feed(const uint8_t *data, size_t len, Fn &&onRecord) {
+        while (len > 0 && !stopped) {
+            if (filled < SHOT_NOTES_RECORD_HEADER_SIZE) {
+                const size_t take = std::min(len, SHOT_NOTES_RECORD_HEADER_SIZE - filled);
+                memcpy(header + filled, data, take);
+                filled += take;
+                data += take;
+                len -= take;
+                if (filled < SHOT_NOTES_RECORD_HEADER_SIZE) {
+                    break;
+                }
+                length = header[2] | (header[3] << 8);
+                const bool put = header[1] == ShotNotesRecord::Put;
+                if (header[0] != SHOT_NOTES_SYNC || (!put && header[1] != ShotNotesRecord::Erase) ||
+                    (put && (length == 0 || length > SHOT_NOTES_MAX_PAYLOAD)) || (!put && length != 0)) {
+                    stopped = true;
+                    break;
+                }
+                crc = shot_index_journal::crc32(header, SHOT_NOTES_RECORD_HEADER_SIZE);
+                continue;
+            }
+            const size_t payloadSeen = filled - SHOT_NOTES_RECORD_HEADER_SIZE;
+            if (payloadSeen < length) {
+                const size_t take = std::min(len, length - payloadSeen);
+                crc = shot_index_journal::crc32(data, take, crc);
+                filled += take;
+                data += take;
+                len -= take;
+                continue;
+            }
+            const size_t crcSeen = payloadSeen - length;
+            const size_t take = std::min(len, SHOT_NOTES_CRC_SIZE - crcSeen);
+            memcpy(stored + crcSeen, data, take);
+            filled += take;
+            data += take;
+            len -= take;
+            if (crcSeen + take < SHOT_NOTES_CRC_SIZE) {
+                break;
+            }
+            uint32_t expected;
+            memcpy(&expected, stored, sizeof(expected));
+            if (expected != crc) {
+                stopped = true;
+                break;
+            }
+            uint32_t id;
+            memcpy(&id, header + 4, sizeof(id));
+            onRecord(static_cast<ShotNotesRecord::Type>(header[1]), id, good + SHOT_NOTES_RECORD_HEADER_SIZE, length);
+            good += filled;
+            records++;
+            filled = 0;
+        }
+    }
+
+    // Bytes of intact records, from the file header on.
+    size_t valid() const { return good; }
+    uint32_t count() const { return records; }
+    // True if the log ended in a damaged or partial record.
+    bool damaged() const { return stopped || filled > 0; }
+
+  private:
+    uint8_t header[SHOT_NOTES_RECORD_HEADER_SIZE];
+    uint8_t stored[SHOT_NOTES_CRC_SIZE];
+    size_t filled = 0;
+    size_t length = 0;
+    uint32_t crc = 0;
+    size_t good = SHOT_NOTES_FILE_HEADER_SIZE;
+    uint32_t records = 0;
+    bool stopped = false;
+};
+
+} // namespace shot_notes_store
+
+// Where the current notes of each shot sit in the log, sorted by id. Tracks
+// the bytes of the live records so the owner knows when compaction pays off.
+template <typename Alloc = std::allocator<uint32_t>> class ShotNotesDirectory {
+  public:
+    struct Entry {
+        uint32_t id;
+        uint32_t offset; // of the payload in the log
+        uint32_t length;
+    };
+
+    void clear() {
+        entries.clear();
+        live = 0;
+    }
+
+    // Applies a scanned or appended record.
+    void apply(ShotNotesRecord::Type type, uint32_t id, uint32_t offset, uint32_t length) {
+        auto it = lowerBound(id);
+        const bool found = it != entries.end() && it->id == id;
+        if (found) {
+            live -= shot_notes_store::recordSize(it->length);
+        }
+        if (type == ShotNotesRecord::Erase) {
+            if (found) {
+                entries.erase(it);
+            }
+            return;
+        }
+        live += shot_notes_store::recordSize(length);
+        if (found) {
+            it->offset = offset;
+            it->length = length;
+        } else {
+            entries.insert(it, Entry{id, offset, length});
+        }
+    }
+
+    const Entry *find(uint32_t id) const {
+        auto it = std::lower_bound(entries.begin(), entries.end(), id, [](const Entry &e, uint32_t v) { return e.id < v; });
+        return it != entries.end() && it->id == id ? &*it : nullptr;
+    }
+
+    size_t size() const { return entries.size(); }
+    const Entry &operator[](size_t i) const { return entries[i]; }
+
+    // Bytes a compacted log would have, file header included.
+    size_t liveBytes() const { return SHOT_NOTES_FILE_HEADER_SIZE + live; }
+
+    bool needsCompaction(size_t fileSize) const {
+        return fileSize >= SHOT_NOTES_COMPACT_MIN_BYTES && fileSize > 2 * liveBytes();
+    }
+
+  private:
+    using EntryAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Entry>;
+
+    typename std::vector<Entry, EntryAlloc>::iterator lowerBound(uint32_t id) {
+        return std::lower_bound(entries.begin(), entries.end(), id, [](const Entry &e, uint32_t v) { return e.id < v; });
+    }
+
+    std::vector<Entry, EntryAlloc> entries;
+    size_t live = 0;
+};
+
+#endif // SHOT_NOTES_STORE_H
@@ -0,0 +1,257 @@
+#ifndef SHOT_SUMMARY_H
+#define SHOT_SUMMARY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "shot_log_format.h"
+#include "shot_log_timing.h"
+
+// Per-shot summary sidecar (/h/summary.bin): the features "compare shots" and
+// analytics views need, so they never have to open the .slog files.
+//
+// Layout (little-endian):
+//   ShotSummaryHeader
+//   ShotSummary[slots]   record n belongs to index.bin slot n
+//
+// Records follow the index slots, so finding a shot's summary is one seek once
+// its index entry is known. Each record carries its shot id and readers only
+// trust a record whose id matches the index entry at the same slot; a slot
+// with no summary (older shots, or a crash between the index and the sidecar
+// write) is all zeros. A full index rebuild recreates the file.
+//
+// ShotSummaryBuilder computes a record from the samples as they are recorded
+// (ShotHistoryPlugin::record()) or decoded again from a .slog (index rebuild).
+// Plain C++ so the host tests can use it.
+
+static constexpr uint32_t SHOT_SUMMARY_MAGIC = 0x4D555353; // 'S''S''U''M' little-endian
+static constexpr uint16_t SHOT_SUMMARY_VERSION = 1;
+static constexpr uint16_t SHOT_SUMMARY_HEADER_SIZE = 16;
+static constexpr uint16_t SHOT_SUMMARY_RECORD_SIZE = 256;
+static constexpr uint8_t SHOT_SUMMARY_CURVE_POINTS = 32;
+static constexpr uint8_t SHOT_SUMMARY_MAX_PHASES = 12;   // = ShotLogHeader::phaseTransitions
+static constexpr uint16_t SHOT_SUMMARY_DRIP_WEIGHT = 10; // g * 10 in the cup that counts as the first drip
+
+// ShotSummary.flags
+static constexpr uint8_t SHOT_SUMMARY_HAS_DRIP = 0x01;   // firstDripMs is valid
+static constexpr uint8_t SHOT_SUMMARY_HAS_WEIGHT = 0x02; // finalWeight, predictedWeight and weightError are valid
+static constexpr uint8_t SHOT_SUMMARY_VOLUMETRIC = 0x04; // shot started in volumetric (brew by weight) mode
+
+#pragma pack(push, 1)
+struct ShotSummaryHeader {
+    uint32_t magic;      // SHOT_SUMMARY_MAGIC
+    uint16_t version;    // SHOT_SUMMARY_VERSION
+    uint16_t recordSize; // SHOT_SUMMARY_RECORD_SIZE
+    uint8_t reserved[8];
+};
+
+struct ShotSummary {
+    uint32_t id;               // shot id, 0 = no summary for this slot
+    uint32_t brewMs;           // until the pump stopped (excludes extended recording)
+    uint32_t firstDripMs;      // first SHOT_SUMMARY_DRIP_WEIGHT in the cup
+    uint32_t pressureIntegral; // pressure over the brew, bar·s * 10
+    uint16_t peakPressure;     // bar * 10
+    int16_t peakFlow;          // pump flow, ml/s * 100
+    uint16_t finalWeight;      // g * 10, settled weight at the end of the recording
+    uint16_t predictedWeight;  // g * 10, weight + flow × brewDelayMs when the pump stopped
+    int16_t weightError;       // g * 10, finalWeight - predictedWeight
+    uint16_t brewDelayMs;      // predictive lead time the shot ran with
+    uint8_t flags;             // SHOT_SUMMARY_*
+    uint8_t phaseCount;
+    uint8_t curvePoints; // valid curve points, fewer than 32 only for very short shots
+    uint8_t reserved0;
+    uint32_t phaseDurationMs[SHOT_SUMMARY_MAX_PHASES];
+    uint16_t pressureCurve[SHOT_SUMMARY_CURVE_POINTS]; // bar * 10, evenly spaced over the brew
+    int16_t flowCurve[SHOT_SUMMARY_CURVE_POINTS];      // ml/s * 100, evenly spaced over the brew
+    uint8_t reserved[48];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ShotSummaryHeader) == SHOT_SUMMARY_HEADER_SIZE, "ShotSummaryHeader size mismatch");
+static_assert(sizeof(ShotSummary) == SHOT_SUMMARY_RECORD_SIZE, "ShotSummary size mismatch");
+
+// Mean pressure over the brew in bar * 10 (ShotIndexEntry::avgPressure), 0 for an empty summary.
+inline uint16_t shotSummaryAveragePressure(const ShotSummary &summary) {
+    if (summary.brewMs == 0) {
+        return 0;
+    }
+    const uint64_t average = static_cast<uint64_t>(summary.pressureIntegral) * 1000 / summary.brewMs;
+    return static_cast<uint16_t>(average > UINT16_MAX ? UINT16_MAX : average);
+}
+
+// Accumulates a ShotSummary one sample at a time in constant memory. Samples
+// recorded after the pump stopped (SYSTEM_INFO_EXTENDED_RECORDING) only count
+// towards the final weight, which comes from the header.
+//
+// Times come from the sample timestamps (shot_log_timing.h), so a shot
+// recorded with adaptive decimation (shot_log_decimator.h) or with jittery
+// sampling, where the stored samples are not evenly spaced, summarizes the
+// same as an evenly sampled one.
+//
+// The curves are kept in 2 × SHOT_SUMMARY_CURVE_POINTS buckets of a width in
+// ms that doubles (pairs merge) whenever they fill up, and finish() folds
+// those into the 32 points, so the shot length does not need to be known in
+// advance.
+class ShotSummaryBuilder {
+  public:
+    void reset() { *this = ShotSummaryBuilder(); }
+
+    // header is the shot's header (sample interval, time format) with the
+    // phase transitions recorded so far; each transition is recorded before
+    // the sample it points at is pushed.
+    void push(const ShotLogSample &sample, const ShotLogHeader &header) {
+        if (brewEnded || (sample.si & SYSTEM_INFO_EXTENDED_RECORDING)) {
+            brewEnded = true;
+            return;
+        }
+        if (brewSamples == 0) {
+            timeline.reset(header);
+            interval = header.sampleInterval ? header.sampleInterval : SHOT_LOG_SAMPLE_INTERVAL_MS;
+            bucketWidth = interval;
+        }
+        const uint32_t ms = timeline.next(sample.t);
+        while (phasesSeen < header.phaseTransitionCount && phasesSeen < SHOT_SUMMARY_MAX_PHASES &&
+               header.phaseTransitions[phasesSeen].sampleIndex <= brewSamples) {
+            phaseStartMs[phasesSeen++] = ms;
+        }
+        const uint16_t weight = (sample.si & SYSTEM_INFO_BLUETOOTH_SCALE_CONNECTED) ? sample.v : sample.ev;
+        if (!dripSeen && weight >= SHOT_SUMMARY_DRIP_WEIGHT) {
+            dripSeen = true;
+            dripMs = ms;
+        }
+        if (sample.cp > peakPressure) {
+            peakPressure = sample.cp;
+        }
+        if (brewSamples == 0 || sample.fl > peakFlow) {
+            peakFlow = sample.fl;
+        }
+        // Each sample's pressure holds until the next one
+        const uint32_t stepMs = brewSamples == 0 ? interval : ms - lastMs;
+        pressureMsSum += static_cast<uint64_t>(sample.cp) * stepMs;
+
+        uint32_t bucket = ms / bucketWidth;
+        while (bucket >= BUCKETS) {
+            for (uint8_t i = 0; i < BUCKETS / 2; i++) {
+                pressureSum[i] = pressureSum[2 * i] + pressureSum[2 * i + 1];
+                flowSum[i] = flowSum[2 * i] + flowSum[2 * i + 1];
+                bucketSamples[i] = bucketSamples[2 * i] + bucketSamples[2 * i + 1];
+            }
+            memset(pressureSum + BUCKETS / 2, 0, sizeof(pressureSum) / 2);
+            memset(flowSum + BUCKETS / 2, 0, sizeof(flowSum) / 2);
+            memset(bucketSamples + BUCKETS / 2, 0, sizeof(bucketSamples) / 2);
+            bucketWidth *= 2;
+            bucket = ms / bucketWidth;
+        }
+        pressureSum[bucket] += sample.cp;
+        flowSum[bucket] += sample.fl;
+        bucketSamples[bucket]++;
+
+        last = sample;
+        lastMs = ms;
+        brewSamples++;
+    }
+
+    // header is the finished .slog header (phase transitions, final weight, brew delay).
+    void finish(const ShotLogHeader &header, uint32_t id, ShotSummary &out) const {
+        memset(&out, 0, sizeof(out));
+        out.id = id;
+        const uint32_t endMs = brewSamples ? lastMs + interval : 0;
+        out.brewMs = endMs;
+        out.firstDripMs = dripMs;
+        out.pressureIntegral = static_cast<uint32_t>(pressureMsSum / 1000);
+        out.peakPressure = peakPressure;
+        out.peakFlow = peakFlow;
+        out.brewDelayMs = header.brewDelayMs;
+        if (dripSeen) {
+            out.flags |= SHOT_SUMMARY_HAS_DRIP;
+        }
+        if (brewSamples > 0 && (last.si & SYSTEM_INFO_SHOT_STARTED_VOLUMETRIC)) {
+            out.flags |= SHOT_SUMMARY_VOLUMETRIC;
+        }
+
+        // Weight error against the brew delay: the pump stops once weight plus
+        // flow × brewDelayMs reaches the target, so final - predicted shows
+        // whether the delay is too short (> 0) or too long (< 0).
+        if (header.finalWeight > 0 && brewSamples > 0 && (last.si & SYSTEM_INFO_BLUETOOTH_SCALE_CONNECTED)) {
+            const int32_t lead = static_cast<int32_t>(last.vf) * header.brewDelayMs / 10000; // (g/s * 100) × ms -> g * 10
+            const int32_t predicted = static_cast<int32_t>(last.v) + (lead > 0 ? lead : 0);
+            out.finalWeight = header.finalWeight;
+            out.predictedWeight = static_cast<uint16_t>(predicted > 0xFFFF ? 0xFFFF : predicted);
+            out.weightError = clamp16(static_cast<int32_t>(header.finalWeight) - predicted);
+            out.flags |= SHOT_SUMMARY_HAS_WEIGHT;
+        }
+
+        // Phase durations from the times of the samples the transitions point
+        // at; the last phase runs until the pump stopped, and a phase that
+        // only started after that has no duration.
+        const uint8_t phases = header.phaseTransitionCount < SHOT_SUMMARY_MAX_PHASES ? header.phaseTransitionCount
+                                                                                       : SHOT_SUMMARY_MAX_PHASES;
+        out.phaseCount = phases;
+        for (uint8_t i = 0; i < phases && i < phasesSeen; i++) {
+            const uint32_t start = phaseStartMs[i];
+            const uint32_t end = i + 1 < phasesSeen ? phaseStartMs[i + 1] : endMs;
+            out.phaseDurationMs[i] = end > start ? end - start : 0;
+        }
+
+        // Buckets without a sample (a decimated steady stretch) repeat the point before.
+        const uint32_t used = brewSamples ? endMs / bucketWidth + (endMs % bucketWidth ? 1 : 0) : 0;
+        uint16_t pressure = 0;
+        int16_t flow = 0;
+        if (used <= SHOT_SUMMARY_CURVE_POINTS) {
+            out.curvePoints = static_cast<uint8_t>(used);
+            for (uint32_t i = 0; i < used; i++) {
+                if (bucketSamples[i]) {
+                    pressure = static_cast<uint16_t>(pressureSum[i] / bucketSamples[i]);
+                    flow = static_cast<int16_t>(flowSum[i] / static_cast<int32_t>(bucketSamples[i]));
+                }
+                out.pressureCurve[i] = pressure;
+                out.flowCurve[i] = flow;
+            }
+            return;
+        }
+        out.curvePoints = SHOT_SUMMARY_CURVE_POINTS;
+        for (uint32_t p = 0; p < SHOT_SUMMARY_CURVE_POINTS; p++) {
+            uint32_t pressureTotal = 0, count = 0;
+            int32_t flowTotal = 0;
+            for (uint32_t b = p * used / SHOT_SUMMARY_CURVE_POINTS; b < (p + 1) * used / SHOT_SUMMARY_CURVE_POINTS; b++) {
+                pressureTotal += pressureSum[b];
+                flowTotal += flowSum[b];
+                count += bucketSamples[b];
+            }
+            if (count) {
+                pressure = static_cast<uint16_t>(pressureTotal / count);
+                flow = static_cast<int16_t>(flowTotal / static_cast<int32_t>(count));
+            }
+            out.pressureCurve[p] = pressure;
+            out.flowCurve[p] = flow;
+        }
+    }
+
+  private:
+    static constexpr uint8_t BUCKETS = 2 * SHOT_SUMMARY_CURVE_POINTS;
+
+    static int16_t clamp16(int32_t v) {
+        return static_cast<int16_t>(v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v));
+    }
+
+    uint32_t pressureSum[BUCKETS] = {};
+    int32_t flowSum[BUCKETS] = {};
+    uint32_t bucketSamples[BUCKETS] = {};
+    uint32_t bucketWidth = SHOT_LOG_SAMPLE_INTERVAL_MS; // ms
+    uint32_t brewSamples = 0;
+    uint64_t pressureMsSum = 0;
+    uint32_t dripMs = 0;
+    uint32_t lastMs = 0;
+    uint32_t phaseStartMs[SHOT_SUMMARY_MAX_PHASES] = {};
+    uint8_t phasesSeen = 0;
+    uint16_t interval = SHOT_LOG_SAMPLE_INTERVAL_MS;
+    uint16_t peakPressure = 0;
+    int16_t peakFlow = 0;
+    ShotLogSample last{};
+    ShotLogTimeline timeline;
+    bool dripSeen = false;
+    bool brewEnded = false;
+};
+
+#endif // SHOT_SUMMARY_H
@@ -0,0 +1,288 @@
+#ifndef STATUS_FRAME_H
+#define STATUS_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Binary machine status for websocket clients that subscribe with
+// req:status:subscribe (format "binary"), in place of the JSON evt:status
+// document. Each frame carries only the fields that changed since the last
+// frame sent to that client; the first one after subscribing is a keyframe
+// with every field.
+//
+// Layout (little-endian):
+//   StatusFrameHeader                   magic, version, flags, seq, mask
+//   value[popcount(mask)]               one per set bit, in bit order
+//
+// A value is the field's raw little-endian bytes (see STATUS_FIELDS for the
+// type of each field), or for text fields a uint8_t length followed by that
+// many UTF-8 bytes. A frame with an empty mask means nothing changed; it is
+// still sent so the client sees the status cadence. seq counts the frames sent
+// to the client, so a client that sees a gap subscribes again to get a
+// keyframe. New fields are only ever appended; a reader that meets a bit it
+// does not know must stop there.
+//
+// Plain C++ so the host tests can use it.
+
+static constexpr uint32_t STATUS_FRAME_MAGIC = 0x54534D47; // 'GMST'
+static constexpr uint8_t STATUS_FRAME_VERSION = 1;
+
+// StatusFrameHeader.flags
+static constexpr uint8_t STATUS_FRAME_KEYFRAME = 0x01;
+
+// StatusSnapshot.processActive when there is no current or last process
+static constexpr uint8_t STATUS_NO_PROCESS = 0xFF;
+// StatusSnapshot.scaleBattery when the scale reports none
+static constexpr uint8_t STATUS_NO_BATTERY = 0xFF;
+
+// StatusSnapshot.processState
+static constexpr uint8_t STATUS_PROCESS_INFUSION = 0;
+static constexpr uint8_t STATUS_PROCESS_BREW = 1;
+static constexpr uint8_t STATUS_PROCESS_GRIND = 2;
+static constexpr uint8_t STATUS_PROCESS_OTHER = 3; // steam/water: only process.a is reported
+
+#pragma pack(push, 1)
+struct StatusFrameHeader {
+    uint32_t magic;  // STATUS_FRAME_MAGIC
+    uint8_t version; // STATUS_FRAME_VERSION
+    uint8_t flags;   // STATUS_FRAME_*
+    uint16_t seq;    // frames sent to this client, wrapping
+    uint64_t mask;   // bit i set = field i follows
+};
+#pragma pack(pop)
+
+static_assert(sizeof(StatusFrameHeader) == 16, "StatusFrameHeader size mismatch");
+
+// Everything evt:status reports, collected once per status tick. The JSON key
+// of each field is noted; text fields are NUL-terminated and cut at a UTF-8
+// character boundary.
+struct StatusSnapshot {
+    float currentTemp;         // ct
+    float targetTemp;          // tt
+    float pressure;            // pr
+    float pumpFlow;            // fl
+    float targetPressure;      // pt
+    uint8_t mode;              // m
+    char profileName[96];      // p
+    char profileId[48];        // puid
+    uint8_t capPressure;       // cp
+    uint8_t capDimming;        // cd
+    uint8_t capGrind;          // gp
+    float targetWeight;        // tw
+    uint8_t volumetric;        // bta
+    uint8_t brewTarget;        // bt
+    float brewDuration;        // btd
+    uint8_t capLed;            // led
+    int32_t grindDuration;     // gtd
+    float grindVolume;         // gtv
+    uint8_t grindTarget;       // gt
+    uint8_t grindActive;       // gact
+    int32_t waterLevel;        // wl
+    int32_t tofDistance;       // tof
+    int16_t rssi;              // rssi
+    int32_t latency;           // lat, -1 = not yet measured
+    float pumpPower;           // pw
+    float heaterPower;         // hp
+    float scaleWeight;         // bw and cw
+    uint8_t scaleConnected;    // bc
+    uint8_t scaleBattery;      // sbat, STATUS_NO_BATTERY = omitted
+    float puckResistance;      // pkr (only with a process)
+    float puckFlow;            // pf (only with a process)
+    float targetFlow;          // tf (only with a process)
+    uint8_t processActive;     // process.a, STATUS_NO_PROCESS = no process object
+    uint8_t processState;      // process.s, STATUS_PROCESS_*
+    char processLabel[64];     // process.l
+    uint32_t processElapsed;   // process.e (ms)
+    uint8_t processVolumetric; // process.tt: 1 = "volumetric", 0 = "time"
+    float processTarget;       // process.pt
+    float processProgress;     // process.pp
+};
+
+namespace status_frame {
+
+enum class FieldType : uint8_t { U8, I16, I32, U32, F32, TEXT };
+
+struct Field {
+    const char *key; // JSON key, for documentation and the web decoder
+    FieldType type;
+    size_t offset;
+    size_t size; // bytes in StatusSnapshot
+};
+
+#define STATUS_FIELD(key, type, member) {key, FieldType::type, offsetof(StatusSnapshot, member), sizeof(StatusSnapshot::member)}
+
+// Bit i of StatusFrameHeader.mask is STATUS_FIELDS[i]. Append only.
+static const Field STATUS_FIELDS[] = {
+    STATUS_FIELD("ct", F32, currentTemp),
+    STATUS_FIELD("tt", F32, targetTemp),
+    STATUS_FIELD("pr", F32, pressure),
+    STATUS_FIELD("fl", F32, pumpFlow),
+    STATUS_FIELD("pt", F32, targetPressure),
+    STATUS_FIELD("m", U8, mode),
+    STATUS_FIELD("p", TEXT, profileName),
+    STATUS_FIELD("puid", TEXT, profileId),
+    STATUS_FIELD("cp", U8, capPressure),
+    STATUS_FIELD("cd", U8, capDimming),
+    STATUS_FIELD("gp", U8, capGrind),
+    STATUS_FIELD("tw", F32, targetWeight),
+    STATUS_FIELD("bta", U8, volumetric),
+    STATUS_FIELD("bt", U8, brewTarget),
+    STATUS_FIELD("btd", F32, brewDuration),
+    STATUS_FIELD("led", U8, capLed),
+    STATUS_FIELD("gtd", I32, grindDuration),
+    STATUS_FIELD("gtv", F32, grindVolume),
+    STATUS_FIELD("gt", U8, grindTarget),
+    STATUS_FIELD("gact", U8, grindActive),
+    STATUS_FIELD("wl", I32, waterLevel),
+    STATUS_FIELD("tof", I32, tofDistance),
+    STATUS_FIELD("rssi", I16, rssi),
+    STATUS_FIELD("lat", I32, latency),
+    STATUS_FIELD("pw", F32, pumpPower),
+    STATUS_FIELD("hp", F32, heaterPower),
+    STATUS_FIELD("bw", F32, scaleWeight),
+    STATUS_FIELD("bc", U8, scaleConnected),
+    STATUS_FIELD("sbat", U8, scaleBattery),
+    STATUS_FIELD("pkr", F32, puckResistance),
+    STATUS_FIELD("pf", F32, puckFlow),
+    STATUS_FIELD("tf", F32, targetFlow),
+    STATUS_FIELD("process.a", U8, processActive),
+    STATUS_FIELD("process.s", U8, processState),
+    STATUS_FIELD("process.l", TEXT, processLabel),
+    STATUS_FIELD("process.e", U32, processElapsed),
+    STATUS_FIELD("process.tt", U8, processVolumetric),
+    STATUS_FIELD("process.pt", F32, processTarget),
+    STATUS_FIELD("process.pp", F32, processProgress),
+};
+
+#undef STATUS_FIELD
+
+static constexpr size_t FIELD_COUNT = sizeof(STATUS_FIELDS) / sizeof(STATUS_FIELDS[0]);
+static_assert(FIELD_COUNT <= 64, "StatusFrameHeader.mask holds 64 fields");
+
+// Largest possible frame: a keyframe with every text field full
+inline size_t maxFrameSize() {
+    size_t size = sizeof(StatusFrameHeader);
+    for (const Field &field : STATUS_FIELDS) {
+        size += field.size; // a text field's length byte takes the place of its NUL
+    }
+    return size;
+}
+
+// Copies text into a snapshot field, cut at a UTF-8 character boundary if it
+// does not fit.
+template <size_t N> inline void copyText(char (&out)[N], const char *text) {
+    size_t len = text ? strlen(text) : 0;
+    if (len > N - 1) {
+        len = N - 1;
+        while (len > 0 && (static_cast<uint8_t>(text[len]) & 0xC0) == 0x80) {
+            len--; // text[len] continues the character that would be cut
+        }
+    }
+    if (len > 0) {
+        memcpy(out, text, len);
+    }
+    memset(out + len, 0, N - len);
+}
+
+inline bool fieldChanged(const Field &field, const StatusSnapshot &a, const StatusSnapshot &b) {
+    const uint8_t *pa = reinterpret_cast<const uint8_t *>(&a) + field.offset;
+    const uint8_t *pb = reinterpret_cast<const uint8_t *>(&b) + field.offset;
+    if (field.type == FieldType::TEXT) {
+        return strncmp(reinterpret_cast<const char *>(pa), reinterpret_cast<const char *>(pb), field.size) != 0;
+    }
+    return memcmp(pa, pb, field.size) != 0;
+}
+
+// Builds the frames for one client: remembers what it last sent and encodes
+// the fields that changed since.
+class Encoder {
+  public:
+    // The next frame is a keyframe (new subscriber, or one that lost a frame).
+    void reset() { primed = false; }
+
+    // Writes the frame for now into out (maxFrameSize() bytes) and returns its
+    // size: just the header if nothing changed since the last frame.
+    size_t encode(const StatusSnapshot &now, uint8_t *out) {
+        const bool keyframe = !primed;
+        uint64_t mask = 0;
+        size_t pos = sizeof(StatusFrameHeader);
+        for (size_t i = 0; i < FIELD_COUNT; i++) {
+            const Field &field = STATUS_FIELDS[i];
+            if (!keyframe && !fieldChanged(field, now, last)) {
+                continue;
+            }
+            mask |= 1ull << i;
+            const uint8_t *value = reinterpret_cast<const uint8_t *>(&now) + field.offset;
+            if (field.type == FieldType::TEXT) {
+                const size_t len = strnlen(reinterpret_cast<const char *>(value), field.size - 1);
+                out[pos++] = static_cast<uint8_t>(len);
+                memcpy(out + pos, value, len);
+                pos += len;
+            } else {
+                memcpy(out + pos, value, field.size);
+                pos += field.size;
+            }
+        }
+        StatusFrameHeader header{};
+        header.magic = STATUS_FRAME_MAGIC;
+        header.version = STATUS_FRAME_VERSION;
+        header.flags = keyframe ? STATUS_FRAME_KEYFRAME : 0;
+        header.seq = seq++;
+        header.mask = mask;
+        memcpy(out, &header, sizeof(header));
+        last = now;
+        primed = true;
+        return pos;
+    }
+
+  private:
+    StatusSnapshot last{};
+    bool primed = false;
+    uint16_t seq = 0;
+};
+
+// Applies a frame to state (the reader's copy of the snapshot); false if the
+// frame is malformed or from a newer version. seq receives the frame's seq.
+inline bool decode(const uint8_t *data, size_t len, StatusSnapshot &state, uint16_t &seq) {
+    StatusFrameHeader header;
+    if (len < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != STATUS_FRAME_MAGIC || header.version != STATUS_FRAME_VERSION) {
+        return false;
+    }
+    size_t pos = sizeof(header);
+    for (size_t i = 0; i < 64; i++) {
+        if (!(header.mask & (1ull << i))) {
+            continue;
+        }
+        if (i >= FIELD_COUNT) {
+            return false;
+        }
+        const Field &field = STATUS_FIELDS[i];
+        uint8_t *value = reinterpret_cast<uint8_t *>(&state) + field.offset;
+        if (field.type == FieldType::TEXT) {
+            if (pos >= len || data[pos] > field.size - 1 || pos + 1 + data[pos] > len) {
+                return false;
+            }
+            const size_t textLen = data[pos++];
+            memcpy(value, data + pos, textLen);
+            memset(value + textLen, 0, field.size - textLen);
+            pos += textLen;
+        } else {
+            if (pos + field.size > len) {
+                return false;
+            }
+            memcpy(value, data + pos, field.size);
+            pos += field.size;
+        }
+    }
+    seq = header.seq;
+    return pos == len;
+}
+
+} // namespace status_frame
+
+#endif // STATUS_FRAME_H
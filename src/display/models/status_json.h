@@ -0,0 +1,68 @@
+#ifndef STATUS_JSON_H
+#define STATUS_JSON_H
+
+#include <ArduinoJson.h>
+#include <display/models/status_frame.h>
+
+namespace status_frame {
+
+// The JSON evt:status document for clients that have not asked for binary
+// frames. Kept next to the frame layout so the host benchmark serializes the
+// same document the firmware sends.
+inline void writeJson(JsonDocument &doc, const StatusSnapshot &s) {
+    doc.clear();
+    doc["tp"] = "evt:status";
+    doc["ct"] = s.currentTemp;
+    doc["tt"] = s.targetTemp;
+    doc["pr"] = s.pressure;
+    doc["fl"] = s.pumpFlow;
+    doc["pt"] = s.targetPressure;
+    doc["m"] = s.mode;
+    doc["p"] = s.profileName;
+    doc["puid"] = s.profileId;
+    doc["cp"] = s.capPressure != 0;
+    doc["cd"] = s.capDimming != 0;
+    doc["gp"] = s.capGrind != 0;
+    doc["tw"] = s.targetWeight;
+    doc["bta"] = s.volumetric;
+    doc["bt"] = s.brewTarget;
+    doc["btd"] = s.brewDuration;
+    doc["led"] = s.capLed != 0;
+    doc["gtd"] = s.grindDuration;
+    doc["gtv"] = s.grindVolume;
+    doc["gt"] = s.grindTarget;
+    doc["gact"] = s.grindActive;
+    doc["wl"] = s.waterLevel;
+    doc["tof"] = s.tofDistance;
+    doc["rssi"] = s.rssi;
+    doc["lat"] = s.latency;
+    doc["pw"] = s.pumpPower;
+    doc["hp"] = s.heaterPower;
+    doc["bw"] = s.scaleWeight;
+    doc["cw"] = s.scaleWeight; // Use 'currentWeight' for forward compatbility
+    doc["bc"] = s.scaleConnected != 0;
+    if (s.scaleBattery != STATUS_NO_BATTERY) {
+        doc["sbat"] = s.scaleBattery;
+    }
+    if (s.processActive == STATUS_NO_PROCESS) {
+        return;
+    }
+    auto pObj = doc["process"].to<JsonObject>();
+    pObj["a"] = s.processActive;
+    doc["pkr"] = s.puckResistance;
+    doc["pf"] = s.puckFlow;
+    doc["tf"] = s.targetFlow;
+    if (s.processState == STATUS_PROCESS_OTHER) {
+        return;
+    }
+    pObj["s"] = s.processState == STATUS_PROCESS_GRIND ? "grind" : s.processState == STATUS_PROCESS_BREW ? "brew" : "infusion";
+    pObj["l"] = s.processLabel;
+    pObj["e"] = s.processElapsed;
+    pObj["tt"] = s.processVolumetric ? "volumetric" : "time";
+    pObj["pt"] = s.processTarget;
+    pObj["pp"] = s.processProgress;
+}
+
+} // namespace status_frame
+
+#endif // STATUS_JSON_H
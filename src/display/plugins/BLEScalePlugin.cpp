@@ -100,8 +100,8 @@ void BLEScalePlugin::setup(Controller *controller, PluginManager *manager) {
         }
     });
     manager->on("controller:grind:start", [this](Event const &) { onProcessStart(); });
-    manager->on("controller:mode:change", [this](Event const &event) {
-        if (event.getInt("value") != MODE_STANDBY) {
+    manager->on(events::CONTROLLER_MODE_CHANGE, [this](Event const &event) {
+        if (event.as<ModeChanged>().value != MODE_STANDBY) {
             ESP_LOGI("BLEScalePlugin", "Resuming scanning");
             scan();
             active = true;
@@ -366,7 +366,7 @@ void BLEScalePlugin::onMeasurement(float value) const {
     // updates lastBluetoothMeasurement timestamps as a side effect; we reuse
     // a lighter path here since flow is not gating shot state.
     if (scale != nullptr && scale->hasFlowRate() && pluginManager != nullptr) {
-        pluginManager->trigger("controller:volumetric-measurement:scale-flow:change", "value", scale->getFlowRate());
+        pluginManager->trigger(events::VOLUMETRIC_SCALE_FLOW_CHANGE, FlowChanged{scale->getFlowRate()});
     }
 }
 
@@ -9,8 +9,8 @@ void BoilerFillPlugin::setup(Controller *controller, PluginManager *pluginManage
     pluginManager->on("controller:ready", [this](Event const &) {
         this->controller->startProcess(new PumpProcess(this->controller->getSettings().getStartupFillTime()));
     });
-    pluginManager->on("controller:mode:change", [this](Event const &event) {
-        int newMode = event.getInt("value");
+    pluginManager->on(events::CONTROLLER_MODE_CHANGE, [this](Event const &event) {
+        int newMode = event.as<ModeChanged>().value;
         if (newMode == MODE_BREW && this->controller->getMode() == MODE_STEAM) {
             this->controller->startProcess(new PumpProcess(this->controller->getSettings().getSteamFillTime()));
         }
@@ -72,22 +72,22 @@ void HomekitPlugin::setup(Controller *controller, PluginManager *pluginManager)
         homeSpan.autoPoll();
     });
 
-    pluginManager->on("boiler:targetTemperature:change", [this](Event const &event) {
+    pluginManager->on(events::BOILER_TARGET_TEMPERATURE_CHANGE, [this](Event const &event) {
         if (accessory == nullptr)
             return;
-        accessory->setTargetTemperature(event.getFloat("value"));
+        accessory->setTargetTemperature(event.as<TempChanged>().value);
     });
 
-    pluginManager->on("boiler:currentTemperature:change", [this](Event const &event) {
+    pluginManager->on(events::BOILER_CURRENT_TEMPERATURE_CHANGE, [this](Event const &event) {
         if (accessory == nullptr)
             return;
-        accessory->setCurrentTemperature(event.getFloat("value"));
+        accessory->setCurrentTemperature(event.as<TempChanged>().value);
     });
 
-    pluginManager->on("controller:mode:change", [this](Event const &event) {
+    pluginManager->on(events::CONTROLLER_MODE_CHANGE, [this](Event const &event) {
         if (accessory == nullptr)
             return;
-        accessory->setState(event.getInt("value") != MODE_STANDBY);
+        accessory->setState(event.as<ModeChanged>().value != MODE_STANDBY);
     });
 }
 
@@ -7,30 +7,64 @@
 
 const String LOG_TAG = F("MQTTPlugin");
 
-bool MQTTPlugin::connect(Controller *controller) {
+static constexpr EventKey MQTT_SERVICE{"mqtt:service"};
+
+void MQTTPlugin::loop() {
+    if (!started)
+        return;
+    const unsigned long now = millis();
+    if (now - lastServiceRequest < (servicePending ? MQTT_SERVICE_TIMEOUT : MQTT_SERVICE_INTERVAL))
+        return;
+    lastServiceRequest = now;
+    servicePending = true;
+    pluginManager->trigger(MQTT_SERVICE);
+}
+
+void MQTTPlugin::begin() {
     const Settings settings = controller->getSettings();
     const String ip = settings.getHomeAssistantIP();
     const int haPort = settings.getHomeAssistantPort();
-    const String clientId = "GaggiMate";
-    const String haUser = settings.getHomeAssistantUser();
-    const String haPassword = settings.getHomeAssistantPassword();
 
     client.begin(ip.c_str(), haPort, net);
     client.setKeepAlive(10);
     ESP_LOGI(LOG_TAG.c_str(), "Connecting to %s:%d", ip.c_str(), haPort);
-    for (int i = 0; i < MQTT_CONNECTION_RETRIES; i++) {
-        ESP_LOGD(LOG_TAG.c_str(), "Attempt (%d/%d)", i + 1, MQTT_CONNECTION_RETRIES);
-        if (client.connect(clientId.c_str(), haUser.c_str(), haPassword.c_str())) {
-            ESP_LOGI(LOG_TAG.c_str(), "Successfully connected");
-            return true;
-        }
-        delay(MQTT_CONNECTION_DELAY);
+    connectAttemptsLeft = MQTT_CONNECTION_RETRIES;
+    lastConnectAttempt = millis() - MQTT_CONNECTION_DELAY;
+    started = true;
+}
+
+// One attempt; service() spaces out the retries instead of waiting here
+bool MQTTPlugin::connect() {
+    const Settings settings = controller->getSettings();
+    const String clientId = "GaggiMate";
+    const String haUser = settings.getHomeAssistantUser();
+    const String haPassword = settings.getHomeAssistantPassword();
+
+    ESP_LOGD(LOG_TAG.c_str(), "Attempt (%d/%d)", MQTT_CONNECTION_RETRIES - connectAttemptsLeft + 1, MQTT_CONNECTION_RETRIES);
+    if (!client.connect(clientId.c_str(), haUser.c_str(), haPassword.c_str())) {
+        return false;
+    }
+    ESP_LOGI(LOG_TAG.c_str(), "Successfully connected");
+    return true;
+}
+
+void MQTTPlugin::service() {
+    servicePending = false;
+    client.loop();
+    if (client.connected() || connectAttemptsLeft == 0 || millis() - lastConnectAttempt < MQTT_CONNECTION_DELAY)
+        return;
+    if (connect()) {
+        connectAttemptsLeft = 0;
+        publishDiscovery();
+        return;
+    }
+    lastConnectAttempt = millis();
+    if (--connectAttemptsLeft == 0) {
+        ESP_LOGW(LOG_TAG.c_str(), "Connection failed");
     }
-    ESP_LOGW(LOG_TAG.c_str(), "Connection failed");
-    return false;
 }
 
-void MQTTPlugin::publishDiscovery(Controller *controller) {
+void MQTTPlugin::publishDiscovery() {
     if (!client.connected())
         return;
     const Settings settings = controller->getSettings();
@@ -127,60 +161,75 @@ void MQTTPlugin::publishBrewState(const char *state) {
     publish("controller/brew/state", json);
 }
 
+// Publishing blocks on the network, so all listeners run on the event worker
 void MQTTPlugin::setup(Controller *controller, PluginManager *pluginManager) {
-    pluginManager->on("controller:wifi:connect", [this, controller](const Event &) {
-        if (!connect(controller))
-            return;
-        publishDiscovery(controller);
-    });
-
-    pluginManager->on("boiler:currentTemperature:change", [this](Event const &event) {
-        if (!client.connected())
-            return;
-        char json[50];
-        const float temp = event.getFloat("value");
-        if (temp != lastTemperature) {
+    this->controller = controller;
+    this->pluginManager = pluginManager;
+    pluginManager->on(
+        "controller:wifi:connect",
+        [this](const Event &) {
+            begin();
+            service();
+        },
+        EventDelivery::ASYNC);
+    pluginManager->on(MQTT_SERVICE, [this](const Event &) { service(); }, EventDelivery::ASYNC_LOW);
+
+    pluginManager->on(
+        events::BOILER_CURRENT_TEMPERATURE_CHANGE,
+        [this](Event const &event) {
+            if (!client.connected())
+                return;
+            char json[50];
+            const float temp = event.as<TempChanged>().value;
+            if (temp != lastTemperature) {
+                snprintf(json, sizeof(json), R"***({"temperature":%02f})***", temp);
+                publish("boilers/0/temperature", json);
+            }
+            lastTemperature = temp;
+        },
+        EventDelivery::ASYNC_LOW);
+    pluginManager->on(
+        events::BOILER_TARGET_TEMPERATURE_CHANGE,
+        [this](Event const &event) {
+            if (!client.connected())
+                return;
+            char json[50];
+            const float temp = event.as<TempChanged>().value;
             snprintf(json, sizeof(json), R"***({"temperature":%02f})***", temp);
-            publish("boilers/0/temperature", json);
-        }
-        lastTemperature = temp;
-    });
-    pluginManager->on("boiler:targetTemperature:change", [this](Event const &event) {
-        if (!client.connected())
-            return;
-        char json[50];
-        const float temp = event.getFloat("value");
-        snprintf(json, sizeof(json), R"***({"temperature":%02f})***", temp);
-        publish("boilers/0/targetTemperature", json);
-    });
-    pluginManager->on("controller:mode:change", [this](Event const &event) {
-        int newMode = event.getInt("value");
-        const char *modeStr;
-        switch (newMode) {
-        case 0:
-            modeStr = "Standby";
-            break;
-        case 1:
-            modeStr = "Brew";
-            break;
-        case 2:
-            modeStr = "Steam";
-            break;
-        case 3:
-            modeStr = "Water";
-            break;
-        case 4:
-            modeStr = "Grind";
-            break;
-        default:
-            modeStr = "Unknown";
-            break; // Fallback in case of unexpected value
-        }
-        char json[100];
-        snprintf(json, sizeof(json), R"({"mode":%d,"mode_str":"%s"})", newMode, modeStr);
-        publish("controller/mode", json);
-    });
-    pluginManager->on("controller:brew:start", [this](Event const &) { publishBrewState("brewing"); });
-
-    pluginManager->on("controller:brew:end", [this](Event const &) { publishBrewState("not brewing"); });
+            publish("boilers/0/targetTemperature", json);
+        },
+        EventDelivery::ASYNC);
+    pluginManager->on(
+        events::CONTROLLER_MODE_CHANGE,
+        [this](Event const &event) {
+            int newMode = event.as<ModeChanged>().value;
+            const char *modeStr;
+            switch (newMode) {
+            case 0:
+                modeStr = "Standby";
+                break;
+            case 1:
+                modeStr = "Brew";
+                break;
+            case 2:
+                modeStr = "Steam";
+                break;
+            case 3:
+                modeStr = "Water";
+                break;
+            case 4:
+                modeStr = "Grind";
+                break;
+            default:
+                modeStr = "Unknown";
+                break; // Fallback in case of unexpected value
+            }
+            char json[100];
+            snprintf(json, sizeof(json), R"({"mode":%d,"mode_str":"%s"})", newMode, modeStr);
+            publish("controller/mode", json);
+        },
+        EventDelivery::ASYNC);
+    pluginManager->on("controller:brew:start", [this](Event const &) { publishBrewState("brewing"); }, EventDelivery::ASYNC);
+
+    pluginManager->on("controller:brew:end", [this](Event const &) { publishBrewState("not brewing"); }, EventDelivery::ASYNC);
 }
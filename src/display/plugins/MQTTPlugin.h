@@ -3,25 +3,41 @@
 #include "../core/Plugin.h"
 #include <MQTT.h>
 #include <WiFi.h>
+#include <atomic>
 
 constexpr int MQTT_CONNECTION_RETRIES = 5;
 constexpr int MQTT_CONNECTION_DELAY = 1000;
+constexpr unsigned long MQTT_SERVICE_INTERVAL = 100; // ms between client.loop() runs
+constexpr unsigned long MQTT_SERVICE_TIMEOUT = 5000; // ms before a service request lost to a full lane is repeated
 
+// The MQTT client is only used on the event worker task: the listeners publish
+// there, and loop() asks the worker to service the connection, so client calls
+// never race each other and a slow broker never holds up the control loop.
 class MQTTPlugin : public Plugin {
   public:
     void setup(Controller *controller, PluginManager *pluginManager) override;
-    bool connect(Controller *controller);
-    void loop() override {
-        client.loop();
-    };
+    void loop() override;
 
   private:
+    void begin();
+    bool connect();
+    void service();
     void publish(const std::string &topic, const std::string &message);
     void publishBrewState(const char *state);
-    void publishDiscovery(Controller *controller);
+    void publishDiscovery();
     MQTTClient client;
     WiFiClient net;
+    Controller *controller = nullptr;
+    PluginManager *pluginManager = nullptr;
 
+    // Written on the worker, read by loop()
+    std::atomic<bool> started{false};
+    std::atomic<bool> servicePending{false};
+    unsigned long lastServiceRequest = 0; // loop() only
+
+    // Worker only
+    int connectAttemptsLeft = 0;
+    unsigned long lastConnectAttempt = 0;
     float lastTemperature = 0;
 };
 
@@ -2,11 +2,13 @@
 
 #include <LittleFS.h>
 #include <SD_MMC.h>
+#include <algorithm>
 #include <cmath>
 #include <display/core/Controller.h>
 #include <display/core/ProfileManager.h>
 #include <display/core/process/BrewProcess.h>
 #include <display/core/utils.h>
+#include <display/models/shot_log_codec.h>
 #include <display/models/shot_log_format.h>
 #include <display/util/PsramAllocator.h>
 
@@ -73,6 +75,68 @@ String padId(String id, int length = 6) {
     }
     return id;
 }
+
+// Query parameters arrive as JSON numbers over the websocket and as strings from
+// HTTP query args; accept both.
+bool readQueryNumber(JsonVariantConst value, double &out) {
+    if (value.is<const char *>()) {
+        String str = value.as<String>();
+        if (str.isEmpty()) {
+            return false;
+        }
+        out = str.toDouble();
+        return true;
+    }
+    if (value.is<double>()) {
+        out = value.as<double>();
+        return true;
+    }
+    return false;
+}
+
+template <typename T> void readQueryInt(JsonVariantConst value, T &out, T maxValue) {
+    double number;
+    if (readQueryNumber(value, number)) {
+        out = number <= 0.0 ? 0 : (number >= static_cast<double>(maxValue) ? maxValue : static_cast<T>(number));
+    }
+}
+
+void readQueryScaled(JsonVariantConst value, uint16_t &out, float scale) {
+    double number;
+    if (readQueryNumber(value, number)) {
+        out = encodeUnsigned(static_cast<float>(number), scale, UINT16_MAX);
+    }
+}
+
+void writeStatsBucket(JsonObject out, const ShotStatsBucket &bucket) {
+    out["count"] = bucket.count;
+    out["avgDuration"] = bucket.count ? bucket.durationMs / static_cast<float>(bucket.count) / 1000.0f : 0.0f;
+    out["avgYield"] = bucket.yieldCount ? bucket.yieldSum / static_cast<float>(bucket.yieldCount) / WEIGHT_SCALE : 0.0f;
+    out["avgPressure"] =
+        bucket.pressureCount ? bucket.pressureSum / static_cast<float>(bucket.pressureCount) / PRESSURE_SCALE : 0.0f;
+    JsonArray ratings = out["ratings"].to<JsonArray>();
+    for (uint8_t rating = 0; rating < SHOT_STATS_RATINGS; rating++) {
+        ratings.add(bucket.ratings[rating]);
+    }
+}
+
+ShotIndexSortKey parseSortKey(const String &name) {
+    if (name == "timestamp")
+        return ShotIndexSortKey::Timestamp;
+    if (name == "duration")
+        return ShotIndexSortKey::Duration;
+    if (name == "volume")
+        return ShotIndexSortKey::Volume;
+    if (name == "rating")
+        return ShotIndexSortKey::Rating;
+    if (name == "avgTemp")
+        return ShotIndexSortKey::AvgTemp;
+    if (name == "maxPressure")
+        return ShotIndexSortKey::MaxPressure;
+    if (name == "avgFlow")
+        return ShotIndexSortKey::AvgFlow;
+    return ShotIndexSortKey::Id;
+}
 } // namespace
 
 ShotHistoryPlugin ShotHistory;
@@ -87,22 +151,47 @@ void ShotHistoryPlugin::setup(Controller *c, PluginManager *pm) {
     pm->on("controller:brew:start", [this](Event const &) { startRecording(); });
     pm->on("controller:brew:end", [this](Event const &) { endRecording(); });
     pm->on("controller:brew:clear", [this](Event const &) { endExtendedRecording(); });
-    pm->on("controller:volumetric-measurement:estimation:change",
-           [this](Event const &event) { currentEstimatedWeight = event.getFloat("value"); });
-    pm->on("controller:volumetric-measurement:bluetooth:change",
-           [this](Event const &event) { currentBluetoothWeight = event.getFloat("value"); });
-    pm->on("boiler:currentTemperature:change", [this](Event const &event) { currentTemperature = event.getFloat("value"); });
-    pm->on("pump:puck-resistance:change", [this](Event const &event) { currentPuckResistance = event.getFloat("value"); });
+    pm->on(events::VOLUMETRIC_ESTIMATION_CHANGE, estimatedWeightSlot);
+    pm->on(events::VOLUMETRIC_BLUETOOTH_CHANGE, bluetoothWeightSlot);
+    pm->on(events::BOILER_CURRENT_TEMPERATURE_CHANGE, temperatureSlot);
+    pm->on(events::PUMP_PUCK_RESISTANCE_CHANGE, puckResistanceSlot);
     // Initialize rebuild state
     rebuildInProgress = false;
     // Leftover from the abandoned separate recent-shots index; aggregates now live in index.bin.
     if (fs->exists("/h/recent.bin")) {
         fs->remove("/h/recent.bin");
     }
+    for (ShotHistoryBuffer &buffer : ioBuffers) {
+        buffer.resize(SHOT_LOG_IO_BUFFER_SIZE);
+    }
     xTaskCreatePinnedToCore(loopTask, "ShotHistoryPlugin::loop", configMINIMAL_STACK_SIZE * 6, this, 1, &taskHandle, 0);
+    // Below the sampling task, so file I/O only ever uses time it leaves over
+    if (xTaskCreatePinnedToCore(writerTask, "ShotHistoryPlugin::writer", configMINIMAL_STACK_SIZE * 6, this, 0, &writerTaskHandle,
+                                0) != pdPASS) {
+        writerTaskHandle = nullptr; // record() writes its buffers itself
+    }
+}
+
+void ShotHistoryPlugin::pollSensors() {
+    WeightChanged weight;
+    if (estimatedWeightSlot.poll(weight)) {
+        currentEstimatedWeight = weight.value;
+    }
+    if (bluetoothWeightSlot.poll(weight)) {
+        currentBluetoothWeight = weight.value;
+    }
+    TempChanged temperature;
+    if (temperatureSlot.poll(temperature)) {
+        currentTemperature = temperature.value;
+    }
+    PuckResistanceChanged resistance;
+    if (puckResistanceSlot.poll(resistance)) {
+        currentPuckResistance = resistance.value;
+    }
 }
 
 void ShotHistoryPlugin::record() {
+    pollSensors();
     bool shouldRecord = recording || extendedRecording;
 
     if (shouldRecord && (controller->getMode() == MODE_BREW || extendedRecording)) {
@@ -119,7 +208,8 @@ void ShotHistoryPlugin::record() {
                 header.version = SHOT_LOG_VERSION;
                 header.reserved0 = (uint8_t)SHOT_LOG_SAMPLE_SIZE; // record sample size actually used
                 header.headerSize = SHOT_LOG_HEADER_SIZE;
-                header.sampleInterval = SHOT_LOG_SAMPLE_INTERVAL_MS;
+                header.sampleInterval = sampleInterval;
+                header.flags = SHOT_LOG_FLAG_MS_TIMESTAMPS;
                 header.fieldsMask = SHOT_LOG_FIELDS_MASK_ALL;
                 header.startEpoch = getTime();
                 Profile profile = controller->getProfileManager()->getSelectedProfile();
@@ -133,7 +223,12 @@ void ShotHistoryPlugin::record() {
                 header.brewDelayMs = delayMs > 65535.0 ? 65535 : static_cast<uint16_t>(delayMs);
                 // Write header placeholder
                 currentFile.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+                liveResync = false; // every subscriber gets this START
+                sendLiveFrame(SHOT_LIVE_START, 0, 1, 0, &header);
             }
+        } else if (liveResync.exchange(false)) {
+            // A client subscribed mid-shot: the header so far, then samples from the next one on
+            sendLiveFrame(SHOT_LIVE_START, SHOT_LIVE_FLAG_RESYNC, 1, liveSamples.nextIndex(), &header);
         }
         // Bluetooth weight flow (vf): derive from the same non-negative weight we
         // store in sample.v so the two can never disagree, and skip the EMA update
@@ -142,14 +237,17 @@ void ShotHistoryPlugin::record() {
         const float btWeight = currentBluetoothWeight > 0.0f ? currentBluetoothWeight : 0.0f;
         const float btDiff = btWeight - lastBluetoothWeight;
         if (fabsf(btDiff) <= MAX_PLAUSIBLE_WEIGHT_DELTA) {
-            const float btFlow = btDiff / (SHOT_LOG_SAMPLE_INTERVAL_MS / 1000.0f);
-            currentBluetoothFlow = currentBluetoothFlow * 0.75f + btFlow * 0.25f;
+            // Smoothing weight scaled to the interval, so the EMA settles in the same time at any rate
+            const float btFlow = btDiff / (sampleInterval / 1000.0f);
+            const float alpha = 0.25f * sampleInterval / SHOT_LOG_SAMPLE_INTERVAL_MS;
+            currentBluetoothFlow = currentBluetoothFlow * (1.0f - alpha) + btFlow * alpha;
         }
         lastBluetoothWeight = btWeight;
 
+        // Taken now: ms since the shot started, wrapping at 16 bits (readers unwrap it, see shot_log_timing.h)
+        const unsigned long now = millis();
         ShotLogSample sample{};
-        uint32_t tick = sampleCount <= 0xFFFF ? sampleCount : 0xFFFF;
-        sample.t = static_cast<uint16_t>(tick);
+        sample.t = static_cast<uint16_t>(now - shotStart);
         sample.tt = encodeUnsigned(controller->getTargetTemp(), TEMP_SCALE, TEMP_MAX_VALUE);
         sample.ct = encodeUnsigned(currentTemperature, TEMP_SCALE, TEMP_MAX_VALUE);
         sample.tp = encodeUnsigned(controller->getTargetPressure(), PRESSURE_SCALE, PRESSURE_MAX_VALUE);
@@ -174,30 +272,19 @@ void ShotHistoryPlugin::record() {
 
                 // Check for phase transition
                 if (currentPhase != lastRecordedPhase) {
-                    recordPhaseTransition(currentPhase, sampleCount, static_cast<uint8_t>(brewProcess->lastExitReason));
+                    // The decimator keeps this sample and its neighbours, and knows its stored index
+                    const uint32_t index = decimator.markTransition();
+                    recordPhaseTransition(currentPhase, index <= 0xFFFF ? index : 0xFFFF,
+                                          static_cast<uint8_t>(brewProcess->lastExitReason));
                     lastRecordedPhase = currentPhase;
                 }
             }
         }
 
         if (isFileOpen) {
-            if (ioBufferPos + sizeof(sample) > sizeof(ioBuffer)) {
-                flushBuffer();
-            }
-            memcpy(ioBuffer + ioBufferPos, &sample, sizeof(sample));
-            ioBufferPos += sizeof(sample);
-            sampleCount++;
-
-            // Track running aggregates for the rolling recent-shots buffer.
-            tempSumScaled += sample.ct;
-            tempSampleCount++;
-            if (sample.cp > maxPressureScaled) {
-                maxPressureScaled = sample.cp;
-            }
-            if (sample.fl > 0) {
-                flowSumScaled += sample.fl;
-                positiveFlowCount++;
-            }
+            trackSampleTiming(now);
+            decimator.push(sample, [this](const ShotLogSample &stored) { storeSample(stored); });
+            sendLiveSamples();
         }
 
         // Check for early index insertion (once per shot after 7.5s)
@@ -243,18 +330,33 @@ void ShotHistoryPlugin::record() {
         }
     }
     if (!recording && !extendedRecording && isFileOpen) {
-        flushBuffer();
+        decimator.flush([this](const ShotLogSample &stored) { storeSample(stored); });
+        sendLiveSamples();
+        writeEncodedBlock(); // partial last block
+        drainWriter();
         // Patch header with sampleCount and duration
-        header.sampleCount = sampleCount;
+        header.sampleCount = decimator.storedCount();
         header.durationMs = millis() - shotStart;
         header.finalExitReason = finalExitReason; // why the shot ended (last phase exit or manual abort)
         float finalWeight = currentBluetoothWeight;
         header.finalWeight = finalWeight > 0.0f ? encodeUnsigned(finalWeight, WEIGHT_SCALE, WEIGHT_MAX_VALUE) : 0;
-        currentFile.seek(0, SeekSet);
-        currentFile.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
-        currentFile.close();
+        header.lateSamples = lateSamples;
+        header.droppedSamples = droppedSamples;
+        header.maxGapMs = sampleJitter.maxGap();
+        header.p99GapMs = sampleJitter.percentile(990);
+        if (lateSamples > 0 || droppedSamples > 0) {
+            ESP_LOGW("ShotHistoryPlugin", "Shot %s: %u late and %u missed samples (%u writer stalls since boot)",
+                     currentId.c_str(), lateSamples, droppedSamples, writerStalls);
+        }
+        {
+            std::lock_guard<std::mutex> lock(writerFileMutex);
+            currentFile.seek(0, SeekSet);
+            currentFile.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+            currentFile.close();
+        }
         isFileOpen = false;
         unsigned long duration = header.durationMs;
+        sendLiveFrame(SHOT_LIVE_END, duration <= 7500 ? SHOT_LIVE_FLAG_DISCARDED : 0, 1, liveSamples.nextIndex(), &header);
         if (duration <= 7500) { // Exclude failed shots and flushes
             fs->remove("/h/" + currentId + ".slog");
 
@@ -264,7 +366,6 @@ void ShotHistoryPlugin::record() {
             }
         } else {
             controller->getSettings().setHistoryIndex(controller->getSettings().getHistoryIndex() + 1);
-            cleanupHistory();
 
             // Always create a complete index entry via upsert.
             // If an early entry exists, it gets overwritten with final data.
@@ -283,10 +384,23 @@ void ShotHistoryPlugin::record() {
             indexEntry.avgTemp = tempSampleCount ? static_cast<uint16_t>(tempSumScaled / tempSampleCount) : 0;
             indexEntry.maxPressure = maxPressureScaled;
             indexEntry.avgFlow = positiveFlowCount ? static_cast<uint16_t>(flowSumScaled / positiveFlowCount) : 0;
+            ShotSummary summary;
+            summaryBuilder.finish(header, indexEntry.id, summary);
+            indexEntry.avgPressure = shotSummaryAveragePressure(summary);
+            File written = fs->open("/h/" + currentId + ".slog", "r");
+            if (written) {
+                indexEntry.fileSize = written.size();
+                indexEntry.fileMtime = written.getLastWrite();
+                written.close();
+            }
 
             if (!appendToIndex(indexEntry)) {
                 ESP_LOGE("ShotHistoryPlugin", "CRITICAL: Failed to add completed shot %u to index", indexEntry.id);
+            } else {
+                writeSummary(summary);
             }
+            // After the upsert, so the new shot counts with its real size
+            cleanupHistory(indexEntry.id);
 
             // Notify clients the shot is actually persisted. The brew process's
             // isActive/isFinished state (used elsewhere for UI) can go inactive
@@ -332,13 +446,22 @@ void ShotHistoryPlugin::startRecording() {
     recording = true;
     extendedRecording = false;
     indexEntryCreated = false; // Reset flag for new shot
-    sampleCount = 0;
+    sampleInterval = static_cast<uint16_t>(
+        std::clamp(controller->getSettings().getHistoryInterval(), 50, static_cast<int>(SHOT_LOG_SAMPLE_INTERVAL_MS)));
+    decimator.reset(sampleInterval);
     ioBufferPos = 0;
+    lastSampleMs = 0;
+    lateSamples = 0;
+    droppedSamples = 0;
+    sampleJitter.reset();
+    encoder.reset();
+    liveSamples.reset();
     tempSumScaled = 0;
     tempSampleCount = 0;
     maxPressureScaled = 0;
     flowSumScaled = 0;
     positiveFlowCount = 0;
+    summaryBuilder.reset();
 
     // Reset phase tracking for new shot
     lastRecordedPhase = 0xFF;                                      // Invalid value to detect first phase
@@ -422,11 +545,45 @@ void ShotHistoryPlugin::recordPhaseTransition(uint8_t phaseNumber, uint16_t samp
     }
 
     header.phaseTransitionCount++;
+    sendLiveFrame(SHOT_LIVE_PHASE, 0, 1, header.phaseTransitionCount - 1, &transition);
 
     ESP_LOGD("ShotHistoryPlugin", "Recorded phase transition to phase %d (%s) at sample %d", phaseNumber, transition.phaseName,
              sampleIndex);
 }
 
+void ShotHistoryPlugin::setLiveListener(ShotLiveListener listener) {
+    std::lock_guard<std::mutex> lock(liveMutex);
+    liveListener = std::move(listener);
+}
+
+void ShotHistoryPlugin::setLiveStreaming(bool enabled) {
+    liveStreaming = enabled;
+    if (enabled) {
+        liveResync = true; // picked up by the next record() call of a running shot
+    }
+}
+
+void ShotHistoryPlugin::sendLiveFrame(uint8_t type, uint8_t flags, uint16_t count, uint32_t index, const void *payload) {
+    if (!liveStreaming) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(liveMutex);
+    if (!liveListener) {
+        return;
+    }
+    liveFrame.resize(shot_log_live::frameSize(type, count));
+    shot_log_live::writeFrame(liveFrame.data(), type, flags, count, currentId.toInt(), index, payload);
+    liveListener(liveFrame.data(), liveFrame.size());
+}
+
+void ShotHistoryPlugin::sendLiveSamples() {
+    if (liveSamples.count() == 0) {
+        return;
+    }
+    sendLiveFrame(SHOT_LIVE_SAMPLES, 0, liveSamples.count(), liveSamples.firstIndex(), liveSamples.data());
+    liveSamples.clear();
+}
+
 uint16_t ShotHistoryPlugin::getSystemInfo() {
     uint16_t systemInfo = 0;
 
@@ -468,50 +625,69 @@ uint16_t ShotHistoryPlugin::getSystemInfo() {
     return systemInfo;
 }
 
-void ShotHistoryPlugin::cleanupHistory() {
-    size_t freeSpace = getFreeSpace();
-    if (freeSpace > MIN_FREE_SPACE_BYTES) {
-        return; // Enough space, nothing to do
+// Plans evictions from the in-memory index (see shot_index_quota.h): the
+// history total is kept by applyIndexOp() and free space comes from the cache,
+// so this neither lists /h nor rescans the filesystem after every removal.
+void ShotHistoryPlugin::cleanupHistory(uint32_t keepId) {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    if (!ensureIndexExists()) {
+        return;
     }
+    const Settings &settings = controller->getSettings();
+    ShotQuota quota;
+    quota.maxBytes = static_cast<uint64_t>(settings.getHistoryQuotaMb()) * 1024 * 1024;
+    quota.minFreeBytes = MIN_FREE_SPACE_BYTES;
+    quota.policy = static_cast<ShotEvictionPolicy>(settings.getHistoryEviction());
+    quota.protectAnnotated = settings.isHistoryProtectAnnotated();
 
-    // Collect and sort .slog files to find the oldest
-    File directory = fs->open("/h");
-    std::vector<String> slogFiles;
-    String filename = directory.getNextFileName();
-    while (filename != "") {
-        if (filename.endsWith(".slog")) {
-            slogFiles.push_back(filename);
-        }
-        filename = directory.getNextFileName();
+    const uint64_t freeBytes = getCachedFreeSpace();
+    const uint64_t need = shot_index_quota::bytesToFree(historyBytes, freeBytes, quota);
+    if (need == 0) {
+        return; // Within budget and enough space, nothing to do
     }
-    directory.close();
 
-    if (slogFiles.empty()) {
-        return;
-    }
+    std::vector<uint32_t, PsramStlAllocator<uint32_t>> slots;
+    // Protected shots only give way to the free-space floor, never to the budget
+    const uint64_t planned = shot_index_quota::plan(indexEntries.data(), indexEntries.size(), need, quota, keepId, slots,
+                                                    shot_index_quota::floorBytesToFree(freeBytes, quota));
 
-    sort(slogFiles.begin(), slogFiles.end(), [](const String &a, const String &b) { return a < b; });
+    // Removing entries only flags them, so the planned slots stay valid
+    for (uint32_t slot : slots) {
+        char paddedId[16];
+        snprintf(paddedId, sizeof(paddedId), "%06u", (unsigned)indexEntries[slot].id);
+        fs->remove(String("/h/") + paddedId + ".slog");
+        eraseNotes(indexEntries[slot].id);
+        markIndexDeleted(indexEntries[slot].id);
+    }
 
-    // Remove oldest files one at a time until we have enough free space
-    size_t removed = 0;
-    for (size_t i = 0; i < slogFiles.size() && getFreeSpace() <= MIN_FREE_SPACE_BYTES; i++) {
-        String fname = slogFiles[i];
-        int start = fname.lastIndexOf('/') + 1;
-        int end = fname.lastIndexOf('.');
-        if (end > start) {
-            uint32_t shotId = fname.substring(start, end).toInt();
-            markIndexDeleted(shotId);
-        }
+    if (!slots.empty()) {
+        ESP_LOGI("ShotHistoryPlugin", "Cleaned up %u shots, %llu bytes (history: %llu bytes, free: %llu bytes)",
+                 (unsigned)slots.size(), (unsigned long long)planned, (unsigned long long)historyBytes,
+                 (unsigned long long)cachedFreeBytes);
+    }
+    if (planned < need) {
+        ESP_LOGW("ShotHistoryPlugin", "Quota short by %llu bytes, the remaining shots are protected",
+                 (unsigned long long)(need - planned));
+    }
+}
 
-        // Remove .slog and associated .json notes file
-        fs->remove(fname);
-        String notesPath = fname.substring(0, fname.lastIndexOf('.')) + ".json";
-        fs->remove(notesPath);
-        removed++;
+uint64_t ShotHistoryPlugin::getCachedFreeSpace() {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    const unsigned long now = millis();
+    if (!freeSpaceKnown || now - freeSpaceCheckedAt >= FREE_SPACE_RECHECK_MS) {
+        cachedFreeBytes = getFreeSpace();
+        freeSpaceCheckedAt = now;
+        freeSpaceKnown = true;
     }
+    return cachedFreeBytes;
+}
 
-    if (removed > 0) {
-        ESP_LOGI("ShotHistoryPlugin", "Cleaned up %u old shots (free space: %u bytes)", removed, getFreeSpace());
+// Index entries going live or away move the history total and, until the next
+// filesystem read, the cached free space by the same amount.
+void ShotHistoryPlugin::accountHistoryBytes(uint32_t removed, uint32_t added) {
+    historyBytes = historyBytes + added >= removed ? historyBytes + added - removed : 0;
+    if (freeSpaceKnown) {
+        cachedFreeBytes = cachedFreeBytes + removed >= added ? cachedFreeBytes + removed - added : 0;
     }
 }
 
@@ -528,7 +704,7 @@ size_t ShotHistoryPlugin::getFreeSpace() {
     return total > used ? (total - used) : 0;
 }
 
-void ShotHistoryPlugin::handleRequest(JsonDocument &request, JsonDocument &response) {
+void ShotHistoryPlugin::handleRequest(JsonDocument &request, JsonDocument &response, ShotHistoryBuffer *binary) {
     String type = request["tp"].as<String>();
     response["tp"] = String("res:") + type.substring(4);
     response["rid"] = request["rid"].as<String>();
@@ -540,7 +716,7 @@ void ShotHistoryPlugin::handleRequest(JsonDocument &request, JsonDocument &respo
             paddedId = "0" + paddedId;
         }
         fs->remove("/h/" + paddedId + ".slog");
-        fs->remove("/h/" + paddedId + ".json");
+        eraseNotes(id.toInt());
 
         // Mark as deleted in index
         markIndexDeleted(id.toInt());
@@ -549,13 +725,16 @@ void ShotHistoryPlugin::handleRequest(JsonDocument &request, JsonDocument &respo
     } else if (type == "req:history:notes:get") {
         auto id = request["id"].as<String>();
         JsonDocument notes(&psramAllocator);
-        loadNotes(id, notes);
+        loadNotes(id.toInt(), notes);
         response["notes"] = notes;
     } else if (type == "req:history:notes:save") {
         auto id = request["id"].as<String>();
         JsonDocument notes; // explicit document: variant->const JsonDocument& is ambiguous on clang
         notes.set(request["notes"]);
-        saveNotes(id, notes);
+        if (!saveNotes(id.toInt(), notes)) {
+            response["error"] = "Save failed";
+            return;
+        }
 
         // Update rating and volume in index
         uint8_t rating = notes["rating"].as<uint8_t>();
@@ -573,6 +752,20 @@ void ShotHistoryPlugin::handleRequest(JsonDocument &request, JsonDocument &respo
         updateIndexMetadata(id.toInt(), rating, volume);
 
         response["msg"] = "Ok";
+    } else if (type == "req:history:query") {
+        // Metadata goes in the JSON response; the matching entries follow as a
+        // binary SIDX frame (see docs/websocket-api.yaml).
+        ShotIndexQuery query;
+        parseQuery(request.as<JsonVariantConst>(), query);
+        ShotHistoryBuffer result;
+        response["total"] = queryIndex(query, result);
+        response["offset"] = query.offset;
+        response["count"] = (result.size() - sizeof(ShotIndexHeader)) / sizeof(ShotIndexEntry);
+        if (binary != nullptr) {
+            *binary = std::move(result);
+        }
+    } else if (type == "req:history:stats") {
+        writeStats(response);
     } else if (type == "req:history:rebuild") {
         // Rebuild is now handled asynchronously by WebUIPlugin
         // This path shouldn't be reached, but handle it just in case
@@ -580,241 +773,866 @@ void ShotHistoryPlugin::handleRequest(JsonDocument &request, JsonDocument &respo
     }
 }
 
-void ShotHistoryPlugin::saveNotes(const String &id, const JsonDocument &notes) {
-    File file = fs->open("/h/" + id + ".json", FILE_WRITE);
+// Notes live in one log-structured file (see shot_notes_store.h) instead of a
+// .json file per shot. The log is scanned into notesDirectory on first use;
+// after that a read is one seek and a save or erase is one append.
+bool ShotHistoryPlugin::ensureNotesStore() {
+    std::lock_guard<std::recursive_mutex> lock(notesMutex);
+    if (notesLoaded) {
+        return true;
+    }
+    // Same recovery as index.tmp: only a complete tmp file replaces the log
+    if (fs->exists(NOTES_TMP_PATH)) {
+        if (!fs->exists(NOTES_PATH)) {
+            fs->rename(NOTES_TMP_PATH, NOTES_PATH);
+        } else {
+            fs->remove(NOTES_TMP_PATH);
+        }
+    }
+    const bool fresh = !fs->exists(NOTES_PATH);
+    if (!loadNotesStore() && !createNotesStore()) {
+        return false;
+    }
+    notesLoaded = true;
+    if (fresh || fs->exists(NOTES_MIGRATION_PATH)) {
+        migrateNotes();
+    }
+    return true;
+}
+
+bool ShotHistoryPlugin::loadNotesStore() {
+    notesDirectory.clear();
+    notesReadOnly = false;
+    File file = fs->open(NOTES_PATH, "r");
+    if (!file) {
+        return false;
+    }
+    uint8_t chunk[256];
+    if (file.read(chunk, SHOT_NOTES_FILE_HEADER_SIZE) != SHOT_NOTES_FILE_HEADER_SIZE ||
+        !shot_notes_store::checkFileHeader(chunk, SHOT_NOTES_FILE_HEADER_SIZE)) {
+        file.close();
+        // Moved aside rather than overwritten, so the notes can still be recovered by hand
+        fs->remove(NOTES_BAD_PATH);
+        if (fs->rename(NOTES_PATH, NOTES_BAD_PATH)) {
+            ESP_LOGE("ShotHistoryPlugin", "Corrupt notes store (bad magic), moved to %s, starting a new one", NOTES_BAD_PATH);
+        } else {
+            ESP_LOGE("ShotHistoryPlugin", "Corrupt notes store (bad magic), could not move it aside");
+        }
+        return false;
+    }
+    shot_notes_store::Scanner scanner;
+    size_t n;
+    while ((n = file.read(chunk, sizeof(chunk))) > 0) {
+        scanner.feed(chunk, n, [this](ShotNotesRecord::Type type, uint32_t id, size_t offset, size_t length) {
+            notesDirectory.apply(type, id, offset, length);
+        });
+    }
+    file.close();
+    notesFileSize = scanner.valid();
+    ESP_LOGI("ShotHistoryPlugin", "Loaded notes store: %u shots with notes, %u records", (unsigned)notesDirectory.size(),
+             scanner.count());
+    if (scanner.damaged()) {
+        // Appends must not land behind a torn record, so rewrite the good part now.
+        // If that fails (low space), the notes read so far stay readable and
+        // appends wait until a compaction succeeds.
+        ESP_LOGW("ShotHistoryPlugin", "Notes store damaged after %u bytes, dropping the tail", (unsigned)notesFileSize);
+        notesReadOnly = !compactNotes();
+    }
+    return true;
+}
+
+bool ShotHistoryPlugin::createNotesStore() {
+    if (fs->exists(NOTES_PATH)) {
+        // Could not be read, but may still hold notes: never truncate it
+        ESP_LOGE("ShotHistoryPlugin", "Notes store unreadable, leaving it untouched");
+        return false;
+    }
+    notesDirectory.clear();
+    uint8_t header[SHOT_NOTES_FILE_HEADER_SIZE];
+    shot_notes_store::encodeFileHeader(header);
+    File file = fs->open(NOTES_PATH, FILE_WRITE);
+    const bool ok = file && file.write(header, sizeof(header)) == sizeof(header);
     if (file) {
-        String notesStr;
-        serializeJson(notes, notesStr);
-        file.print(notesStr);
         file.close();
     }
+    if (!ok) {
+        ESP_LOGE("ShotHistoryPlugin", "Failed to create notes store");
+        return false;
+    }
+    notesFileSize = sizeof(header);
+    return true;
+}
+
+// Imports /h/<id>.json files left by older firmware, removing each once its
+// record is in the log. NOTES_MIGRATION_PATH marks an import in progress, so
+// one cut short by a reboot continues on the next start. Notes already in the
+// store are newer than a leftover file and win.
+void ShotHistoryPlugin::migrateNotes() {
+    File marker = fs->open(NOTES_MIGRATION_PATH, FILE_WRITE);
+    if (marker) {
+        marker.close();
+    }
+    File directory = fs->open("/h");
+    std::vector<String> jsonFiles;
+    String filename = directory.getNextFileName();
+    while (filename != "") {
+        if (filename.endsWith(".json")) {
+            jsonFiles.push_back(filename);
+        }
+        filename = directory.getNextFileName();
+    }
+    directory.close();
+
+    uint32_t migrated = 0;
+    ShotHistoryBuffer payload;
+    for (const String &path : jsonFiles) {
+        const int start = path.lastIndexOf('/') + 1;
+        const uint32_t shotId = path.substring(start, path.lastIndexOf('.')).toInt();
+        if (shotId == 0) {
+            continue;
+        }
+        bool imported = notesDirectory.find(shotId) != nullptr;
+        if (!imported) {
+            File file = fs->open(path, "r");
+            if (!file) {
+                continue;
+            }
+            payload.resize(file.size());
+            const size_t length = file.read(payload.data(), payload.size());
+            file.close();
+            if (length == 0 || length > SHOT_NOTES_MAX_PAYLOAD) {
+                ESP_LOGW("ShotHistoryPlugin", "Skipping notes file %s (%u bytes)", path.c_str(), (unsigned)length);
+                continue;
+            }
+            imported = appendNotesRecord(ShotNotesRecord::Put, shotId, payload.data(), length);
+            migrated += imported;
+        }
+        if (imported) {
+            fs->remove(path);
+        }
+    }
+    fs->remove(NOTES_MIGRATION_PATH);
+    if (migrated > 0) {
+        ESP_LOGI("ShotHistoryPlugin", "Migrated notes of %u shots into %s", migrated, NOTES_PATH);
+    }
 }
 
-void ShotHistoryPlugin::loadNotes(const String &id, JsonDocument &notes) {
-    File file = fs->open("/h/" + id + ".json", "r");
+bool ShotHistoryPlugin::appendNotesRecord(ShotNotesRecord::Type type, uint32_t shotId, const uint8_t *payload, size_t length) {
+    if (notesReadOnly) {
+        if (!compactNotes()) {
+            ESP_LOGE("ShotHistoryPlugin", "Notes store is read-only until its damaged tail is dropped");
+            return false;
+        }
+        notesReadOnly = false;
+    }
+    ShotHistoryBuffer record(shot_notes_store::recordSize(length));
+    const size_t size = shot_notes_store::encode(type, shotId, payload, length, record.data());
+    File file = fs->open(NOTES_PATH, FILE_APPEND);
+    const bool ok = file && file.write(record.data(), size) == size;
     if (file) {
-        String notesStr = file.readString();
         file.close();
-        deserializeJson(notes, notesStr);
+    }
+    if (!ok) {
+        // A partial record may be on disk: rescan (and compact) on next use
+        ESP_LOGE("ShotHistoryPlugin", "Failed to append to notes store");
+        notesLoaded = false;
+        return false;
+    }
+    notesDirectory.apply(type, shotId, notesFileSize + SHOT_NOTES_RECORD_HEADER_SIZE, type == ShotNotesRecord::Put ? length : 0);
+    notesFileSize += size;
+    if (notesDirectory.needsCompaction(notesFileSize)) {
+        compactNotes();
+    }
+    return true;
+}
+
+// Copies the live records into notes.tmp and renames it over the log, like
+// flushIndex() does for index.bin.
+bool ShotHistoryPlugin::compactNotes() {
+    File source = fs->open(NOTES_PATH, "r");
+    File target = fs->open(NOTES_TMP_PATH, FILE_WRITE);
+    bool ok = source && target;
+    ShotNotesDirectory<PsramStlAllocator<uint32_t>> compacted;
+    size_t size = SHOT_NOTES_FILE_HEADER_SIZE;
+    if (ok) {
+        uint8_t header[SHOT_NOTES_FILE_HEADER_SIZE];
+        shot_notes_store::encodeFileHeader(header);
+        ok = target.write(header, sizeof(header)) == sizeof(header);
+    }
+    ShotHistoryBuffer payload;
+    ShotHistoryBuffer record;
+    for (size_t i = 0; ok && i < notesDirectory.size(); i++) {
+        const auto &entry = notesDirectory[i];
+        payload.resize(entry.length);
+        record.resize(shot_notes_store::recordSize(entry.length));
+        ok = source.seek(entry.offset, SeekSet) && source.read(payload.data(), entry.length) == entry.length;
+        if (ok) {
+            const size_t n =
+                shot_notes_store::encode(ShotNotesRecord::Put, entry.id, payload.data(), entry.length, record.data());
+            ok = target.write(record.data(), n) == n;
+            compacted.apply(ShotNotesRecord::Put, entry.id, size + SHOT_NOTES_RECORD_HEADER_SIZE, entry.length);
+            size += n;
+        }
+    }
+    if (source) {
+        source.close();
+    }
+    if (target) {
+        target.close();
+    }
+    if (ok && !fs->rename(NOTES_TMP_PATH, NOTES_PATH)) {
+        // LittleFS renames over an existing file atomically; FAT (SD card) refuses
+        fs->remove(NOTES_PATH);
+        ok = fs->rename(NOTES_TMP_PATH, NOTES_PATH);
+    }
+    if (!ok) {
+        ESP_LOGE("ShotHistoryPlugin", "Failed to compact notes store");
+        fs->remove(NOTES_TMP_PATH);
+        return false;
+    }
+    ESP_LOGI("ShotHistoryPlugin", "Compacted notes store: %u -> %u bytes", (unsigned)notesFileSize, (unsigned)size);
+    notesDirectory = std::move(compacted);
+    notesFileSize = size;
+    return true;
+}
+
+bool ShotHistoryPlugin::saveNotes(uint32_t shotId, const JsonDocument &notes) {
+    std::lock_guard<std::recursive_mutex> lock(notesMutex);
+    if (!ensureNotesStore()) {
+        return false;
+    }
+    String notesStr;
+    serializeJson(notes, notesStr);
+    if (notesStr.length() > SHOT_NOTES_MAX_PAYLOAD) {
+        ESP_LOGW("ShotHistoryPlugin", "Notes for shot %u too large (%u bytes)", shotId, notesStr.length());
+        return false;
+    }
+    return appendNotesRecord(ShotNotesRecord::Put, shotId, reinterpret_cast<const uint8_t *>(notesStr.c_str()),
+                             notesStr.length());
+}
+
+bool ShotHistoryPlugin::loadNotes(uint32_t shotId, JsonDocument &notes) {
+    std::lock_guard<std::recursive_mutex> lock(notesMutex);
+    if (!ensureNotesStore()) {
+        return false;
+    }
+    const auto *entry = notesDirectory.find(shotId);
+    if (entry == nullptr) {
+        return false;
+    }
+    ShotHistoryBuffer payload(entry->length);
+    File file = fs->open(NOTES_PATH, "r");
+    if (!file) {
+        return false;
+    }
+    const bool ok = file.seek(entry->offset, SeekSet) && file.read(payload.data(), payload.size()) == payload.size();
+    file.close();
+    return ok && deserializeJson(notes, payload.data(), payload.size()) == DeserializationError::Ok;
+}
+
+void ShotHistoryPlugin::eraseNotes(uint32_t shotId) {
+    std::lock_guard<std::recursive_mutex> lock(notesMutex);
+    if (ensureNotesStore() && notesDirectory.find(shotId) != nullptr) {
+        appendNotesRecord(ShotNotesRecord::Erase, shotId, nullptr, 0);
     }
 }
 
 void ShotHistoryPlugin::loopTask(void *arg) {
     auto *plugin = static_cast<ShotHistoryPlugin *>(arg);
+    // Load the index into PSRAM here so the first web request doesn't pay for it.
+    plugin->ensureIndexExists();
+    plugin->ensureNotesStore(); // also imports per-shot .json files from older firmware
+    // A rebuild interrupted by a reboot left its checkpoint behind; pick it up.
+    if (plugin->fs->exists(REBUILD_CHECKPOINT_PATH)) {
+        ESP_LOGI("ShotHistoryPlugin", "Found rebuild checkpoint, resuming index rebuild");
+        plugin->startAsyncRebuild();
+    }
+    // Sample against an absolute cadence: time spent in record() and flushIndex()
+    // shortens the wait instead of pushing every later sample back.
+    TickType_t lastWake = xTaskGetTickCount();
     while (true) {
         plugin->record();
-        // Use canonical interval from shot log format to avoid divergence.
-        vTaskDelay(SHOT_LOG_SAMPLE_INTERVAL_MS / portTICK_PERIOD_MS);
+        plugin->flushIndex();
+        if (xTaskDelayUntil(&lastWake, pdMS_TO_TICKS(plugin->getSampleInterval())) == pdFALSE) {
+            lastWake = xTaskGetTickCount(); // a whole interval behind: start over from now rather than catch up in a burst
+        }
     }
 }
 
-void ShotHistoryPlugin::flushBuffer() {
-    if (isFileOpen && ioBufferPos > 0) {
-        currentFile.write(ioBuffer, ioBufferPos);
-        ioBufferPos = 0;
+void ShotHistoryPlugin::writerTask(void *arg) {
+    auto *plugin = static_cast<ShotHistoryPlugin *>(arg);
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (plugin->writePendingBuffer()) {
+        }
     }
 }
 
-// Index management methods
-bool ShotHistoryPlugin::ensureIndexExists() {
-    if (fs->exists("/h/index.bin")) {
-        // Validate existing index header
-        File indexFile = fs->open("/h/index.bin", "r");
-        if (indexFile) {
-            ShotIndexHeader hdr{};
-            bool valid =
-                (indexFile.read(reinterpret_cast<uint8_t *>(&hdr), sizeof(hdr)) == sizeof(hdr) && hdr.magic == SHOT_INDEX_MAGIC);
-            indexFile.close();
-            if (valid) {
-                return true;
-            }
-            ESP_LOGW("ShotHistoryPlugin", "Corrupt index file detected (bad magic), recreating");
-            fs->remove("/h/index.bin");
+bool ShotHistoryPlugin::writePendingBuffer() {
+    std::lock_guard<std::mutex> fileLock(writerFileMutex);
+    uint8_t buffer;
+    size_t length;
+    {
+        std::lock_guard<std::mutex> lock(writerStateMutex);
+        if (pendingCount == 0) {
+            return false;
         }
+        buffer = pendingBuffers[0];
+        length = pendingLength[0];
+    }
+    if (currentFile.write(ioBuffers[buffer].data(), length) != length) {
+        ESP_LOGE("ShotHistoryPlugin", "Short write to shot file");
     }
+    std::lock_guard<std::mutex> lock(writerStateMutex);
+    pendingBuffers[0] = pendingBuffers[1];
+    pendingLength[0] = pendingLength[1];
+    pendingCount--;
+    return true;
+}
 
-    // Create new empty index
-    File indexFile = fs->open("/h/index.bin", FILE_WRITE);
-    if (!indexFile) {
-        ESP_LOGE("ShotHistoryPlugin", "Failed to create index file");
-        return false;
+bool ShotHistoryPlugin::isBufferPending(uint8_t buffer) {
+    std::lock_guard<std::mutex> lock(writerStateMutex);
+    for (uint8_t i = 0; i < pendingCount; i++) {
+        if (pendingBuffers[i] == buffer) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ShotHistoryPlugin::submitBuffer() {
+    if (!isFileOpen || ioBufferPos == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(writerStateMutex);
+        pendingBuffers[pendingCount] = activeBuffer;
+        pendingLength[pendingCount] = ioBufferPos;
+        pendingCount++;
+    }
+    if (writerTaskHandle != nullptr) {
+        xTaskNotifyGive(writerTaskHandle);
+    } else {
+        writePendingBuffer();
+    }
+    activeBuffer ^= 1;
+    ioBufferPos = 0;
+    // The other buffer was handed off a whole buffer's worth of samples ago, so
+    // it is normally written out by now. If storage is that slow, write it here
+    // rather than overwrite it; the delay shows up in the sample timing.
+    if (isBufferPending(activeBuffer)) {
+        writerStalls++;
+        while (isBufferPending(activeBuffer) && writePendingBuffer()) {
+        }
     }
+}
 
-    ShotIndexHeader header{};
-    header.magic = SHOT_INDEX_MAGIC;
-    header.version = SHOT_INDEX_VERSION;
-    header.entrySize = SHOT_INDEX_ENTRY_SIZE;
-    header.entryCount = 0;
-    header.nextId = controller->getSettings().getHistoryIndex();
+void ShotHistoryPlugin::drainWriter() {
+    submitBuffer();
+    while (writePendingBuffer()) {
+    }
+}
 
-    indexFile.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
-    indexFile.close();
+void ShotHistoryPlugin::writeEncodedBlock() {
+    if (!encoder.finish()) {
+        return;
+    }
+    const size_t blockSize = encoder.size();
+    if (ioBufferPos + blockSize > SHOT_LOG_IO_BUFFER_SIZE) {
+        submitBuffer();
+    }
+    memcpy(ioBuffers[activeBuffer].data() + ioBufferPos, encoder.data(), blockSize);
+    ioBufferPos += blockSize;
+    encoder.reset();
+}
 
-    ESP_LOGI("ShotHistoryPlugin", "Created new index file");
+void ShotHistoryPlugin::storeSample(const ShotLogSample &sample) {
+    if (encoder.push(sample)) {
+        writeEncodedBlock();
+    }
+    if (liveSamples.push(sample)) {
+        sendLiveSamples(); // full before the end of this record() call
+    }
+
+    // Track running aggregates for the rolling recent-shots buffer.
+    tempSumScaled += sample.ct;
+    tempSampleCount++;
+    if (sample.cp > maxPressureScaled) {
+        maxPressureScaled = sample.cp;
+    }
+    if (sample.fl > 0) {
+        flowSumScaled += sample.fl;
+        positiveFlowCount++;
+    }
+    summaryBuilder.push(sample, header);
+}
+
+void ShotHistoryPlugin::trackSampleTiming(unsigned long now) {
+    if (lastSampleMs != 0) {
+        const unsigned long gap = now - lastSampleMs;
+        sampleJitter.add(gap);
+        if (gap >= 2u * sampleInterval) {
+            const unsigned long missed = gap / sampleInterval - 1;
+            droppedSamples = missed > UINT16_MAX - droppedSamples ? UINT16_MAX : droppedSamples + missed;
+        } else if (gap > sampleInterval + sampleInterval / 2u && lateSamples < UINT16_MAX) {
+            lateSamples++;
+        }
+    }
+    lastSampleMs = now;
+}
+
+// Index management methods
+//
+// index.bin is held in PSRAM (indexEntries + indexHeader) and every index read
+// and write goes through that copy. Each change is first appended to the
+// mutation journal (/h/index.jnl, see shot_index_journal.h) and then applied in
+// memory; flushIndex() compacts from loopTask by writing the dirty entries back
+// into index.bin and dropping the journal. A power cut therefore never leaves
+// more than one half-written journal record, which replay skips.
+bool ShotHistoryPlugin::ensureIndexExists() {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    if (indexLoaded) {
+        return true;
+    }
+    if (!loadIndex()) {
+        clearIndex();
+    }
+    // Replay on top of a recovered empty index as well: its upserts bring back
+    // every shot recorded since the last compaction.
+    const bool damaged = replayJournal();
+    if (indexRewrite || damaged) {
+        // New or recovered index, or a torn journal tail that later appends
+        // would sit behind: compact right away.
+        return flushIndex(true);
+    }
     return true;
 }
 
-bool ShotHistoryPlugin::appendToIndex(const ShotIndexEntry &entry) {
-    if (!ensureIndexExists()) {
+bool ShotHistoryPlugin::loadIndex() {
+    // A crash between writing index.tmp and renaming it leaves one of the two
+    // behind; only a complete tmp file ever replaces index.bin.
+    if (fs->exists(INDEX_TMP_PATH)) {
+        if (!fs->exists(INDEX_PATH)) {
+            fs->rename(INDEX_TMP_PATH, INDEX_PATH);
+        } else {
+            fs->remove(INDEX_TMP_PATH);
+        }
+    }
+    if (!fs->exists(INDEX_PATH)) {
         return false;
     }
-
-    File indexFile = fs->open("/h/index.bin", "r+");
+    File indexFile = fs->open(INDEX_PATH, "r");
     if (!indexFile) {
-        ESP_LOGE("ShotHistoryPlugin", "Failed to open index file for append");
         return false;
     }
-
-    ShotIndexHeader header{};
-    if (!readIndexHeader(indexFile, header)) {
+    ShotIndexHeader hdr{};
+    if (!readIndexHeader(indexFile, hdr)) {
         indexFile.close();
+        ESP_LOGW("ShotHistoryPlugin", "Corrupt index file detected (bad magic), recreating");
         return false;
     }
 
-    // Check for existing entry with same ID - update in place (upsert)
-    int existingPos = findEntryPosition(indexFile, header, entry.id);
-    if (existingPos >= 0) {
-        if (writeEntryAtPosition(indexFile, existingPos, entry)) {
-            ESP_LOGD("ShotHistoryPlugin", "Updated existing index entry for shot %u", entry.id);
-            indexFile.close();
-            return true;
+    indexEntries.clear();
+    indexEntries.reserve(hdr.entryCount + INDEX_CACHE_HEADROOM);
+    indexEntries.resize(hdr.entryCount);
+    const size_t got = indexFile.read(reinterpret_cast<uint8_t *>(indexEntries.data()), hdr.entryCount * sizeof(ShotIndexEntry)) /
+                       sizeof(ShotIndexEntry);
+    indexFile.close();
+    if (got < hdr.entryCount) {
+        ESP_LOGW("ShotHistoryPlugin", "Index truncated at entry %u of %u", (unsigned)got, hdr.entryCount);
+        indexEntries.resize(got);
+        hdr.entryCount = got;
+        indexRewrite = true;
+        markIndexDirty();
+    }
+    indexHeader = hdr;
+
+    // stats.bin saved with this index saves the pass over the entries; a
+    // missing or stale one (crash between the two writes) is recomputed.
+    historyStats.clear();
+    const bool statsLoaded = !indexRewrite && loadStats(hdr.generation);
+    indexMap.clear();
+    historyBytes = 0;
+    for (uint32_t slot = 0; slot < indexEntries.size(); slot++) {
+        indexMap.insert(indexEntries[slot].id, slot);
+        historyBytes += shot_index_quota::entryBytes(indexEntries[slot]);
+        if (!statsLoaded) {
+            historyStats.add(indexEntries[slot]);
         }
-        ESP_LOGE("ShotHistoryPlugin", "Failed to update existing index entry for shot %u", entry.id);
-        indexFile.close();
+    }
+    if (!statsLoaded) {
+        markIndexDirty(); // the next flush writes the recomputed stats.bin
+    }
+    indexLoaded = true;
+    ESP_LOGI("ShotHistoryPlugin", "Loaded index: %u entries", (unsigned)indexEntries.size());
+    return true;
+}
+
+void ShotHistoryPlugin::clearIndex() {
+    indexEntries.clear();
+    indexMap.clear();
+    dirtySlots.clear();
+    historyBytes = 0;
+    historyStats.clear();
+    indexHeader = ShotIndexHeader{};
+    indexHeader.magic = SHOT_INDEX_MAGIC;
+    indexHeader.version = SHOT_INDEX_VERSION;
+    indexHeader.entrySize = SHOT_INDEX_ENTRY_SIZE;
+    indexHeader.entryCount = 0;
+    indexHeader.nextId = controller->getSettings().getHistoryIndex();
+    indexLoaded = true;
+    indexRewrite = true;
+    markIndexDirty();
+}
+
+bool ShotHistoryPlugin::resetIndex() {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    clearIndex();
+    if (!flushIndex(true)) {
+        ESP_LOGE("ShotHistoryPlugin", "Failed to create index file");
         return false;
     }
+    ESP_LOGI("ShotHistoryPlugin", "Created new index file");
+    return true;
+}
 
-    // Append entry
-    indexFile.seek(0, SeekEnd);
-    size_t written = indexFile.write(reinterpret_cast<const uint8_t *>(&entry), sizeof(entry));
-    if (written != sizeof(entry)) {
-        ESP_LOGE("ShotHistoryPlugin", "Failed to write index entry for shot %u", entry.id);
-        indexFile.close();
+bool ShotHistoryPlugin::replayJournal() {
+    journalBytes = 0;
+    File journal = fs->open(INDEX_JOURNAL_PATH, "r");
+    if (!journal) {
         return false;
     }
+    shot_index_journal::Reader reader;
+    uint8_t chunk[256];
+    size_t n;
+    while ((n = journal.read(chunk, sizeof(chunk))) > 0) {
+        reader.feed(chunk, n, [this](const ShotIndexJournalOp &op) { applyIndexOp(op); });
+    }
+    journalBytes = journal.size();
+    journal.close();
 
-    // Update header
-    header.entryCount++;
-    header.nextId = entry.id + 1;
-    indexFile.seek(0, SeekSet);
-    indexFile.write(reinterpret_cast<const uint8_t *>(&header), sizeof(header));
+    if (reader.count() > 0) {
+        ESP_LOGI("ShotHistoryPlugin", "Replayed %u index journal records", reader.count());
+    }
+    if (reader.damaged()) {
+        ESP_LOGW("ShotHistoryPlugin", "Index journal damaged after %u bytes, dropping the tail", (unsigned)reader.valid());
+    }
+    return reader.damaged();
+}
 
-    indexFile.close();
-    ESP_LOGD("ShotHistoryPlugin", "Appended shot %u to index", entry.id);
+bool ShotHistoryPlugin::journalIndexOp(const ShotIndexJournalOp &op) {
+    uint8_t record[SHOT_INDEX_JOURNAL_MAX_RECORD];
+    const size_t size = shot_index_journal::encode(op, record);
+    File journal = fs->open(INDEX_JOURNAL_PATH, FILE_APPEND);
+    const bool ok = journal && journal.write(record, size) == size;
+    if (journal) {
+        journal.close();
+    }
+    if (!ok) {
+        // Without a journal record the change only lives in memory; persist it
+        // the old way rather than risk losing it.
+        ESP_LOGE("ShotHistoryPlugin", "Failed to append to index journal, compacting now");
+        return false;
+    }
+    journalBytes += size;
     return true;
 }
 
-void ShotHistoryPlugin::updateIndexMetadata(uint32_t shotId, uint8_t rating, uint16_t volume) {
-    File indexFile = fs->open("/h/index.bin", "r+");
-    if (!indexFile) {
-        ESP_LOGE("ShotHistoryPlugin", "Failed to open index file for metadata update");
-        return;
+void ShotHistoryPlugin::markIndexDirty(int slot) {
+    if (!indexHeaderDirty && dirtySlots.empty()) {
+        indexDirtySince = millis();
+    }
+    if (slot < 0) {
+        indexHeaderDirty = true;
+    } else {
+        dirtySlots.push_back(slot);
     }
+}
 
-    ShotIndexHeader header{};
-    if (!readIndexHeader(indexFile, header)) {
-        indexFile.close();
-        return;
+bool ShotHistoryPlugin::flushIndex(bool force) {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    if (!indexHeaderDirty && dirtySlots.empty()) {
+        return true;
+    }
+    // Every change is already durable in the journal, so compaction can wait
+    // for changes to pile up, and keeps flash free while a shot is recording.
+    const bool due = journalBytes >= INDEX_JOURNAL_COMPACT_BYTES || millis() - indexDirtySince >= INDEX_COMPACT_DELAY_MS;
+    if (!force && (recording || !due)) {
+        return true;
     }
 
-    int entryPos = findEntryPosition(indexFile, header, shotId);
-    if (entryPos >= 0) {
-        ShotIndexEntry entry{};
-        if (readEntryAtPosition(indexFile, entryPos, entry)) {
-            entry.rating = rating;
-            if (volume > 0) {
-                entry.volume = volume;
-            }
-            if (rating > 0) {
-                entry.flags |= SHOT_FLAG_HAS_NOTES;
-            }
+    // Full rewrites go to a temporary file that replaces index.bin only once
+    // complete; dirty-entry updates are written in place (a torn in-place write
+    // is repaired by replaying the journal, which is removed only afterwards).
+    const bool rewrite = indexRewrite || !fs->exists(INDEX_PATH);
+    File indexFile = fs->open(rewrite ? INDEX_TMP_PATH : INDEX_PATH, rewrite ? FILE_WRITE : "r+");
+    if (!indexFile) {
+        ESP_LOGE("ShotHistoryPlugin", "Failed to open index file for flush");
+        return false;
+    }
 
-            if (writeEntryAtPosition(indexFile, entryPos, entry)) {
-                ESP_LOGD("ShotHistoryPlugin", "Updated metadata for shot %u: rating=%u, volume=%u", shotId, rating, volume);
+    indexHeader.entryCount = indexEntries.size();
+    indexHeader.generation++;
+    bool ok = indexFile.write(reinterpret_cast<const uint8_t *>(&indexHeader), sizeof(indexHeader)) == sizeof(indexHeader);
+    size_t written = 0;
+    if (rewrite) {
+        const size_t bytes = indexEntries.size() * sizeof(ShotIndexEntry);
+        ok = ok && indexFile.write(reinterpret_cast<const uint8_t *>(indexEntries.data()), bytes) == bytes;
+        written = indexEntries.size();
+    } else {
+        // Coalesce dirty slots into contiguous runs: one seek + write per run.
+        std::sort(dirtySlots.begin(), dirtySlots.end());
+        dirtySlots.erase(std::unique(dirtySlots.begin(), dirtySlots.end()), dirtySlots.end());
+        for (size_t i = 0; i < dirtySlots.size() && ok;) {
+            size_t runEnd = i + 1;
+            while (runEnd < dirtySlots.size() && dirtySlots[runEnd] == dirtySlots[runEnd - 1] + 1) {
+                runEnd++;
             }
+            const uint32_t first = dirtySlots[i];
+            const size_t count = runEnd - i;
+            const size_t bytes = count * sizeof(ShotIndexEntry);
+            ok = indexFile.seek(sizeof(ShotIndexHeader) + first * sizeof(ShotIndexEntry), SeekSet) &&
+                 indexFile.write(reinterpret_cast<const uint8_t *>(&indexEntries[first]), bytes) == bytes;
+            written += count;
+            i = runEnd;
         }
-    } else {
-        ESP_LOGW("ShotHistoryPlugin", "Shot %u not found in index for metadata update", shotId);
     }
-
     indexFile.close();
-}
 
-void ShotHistoryPlugin::markIndexDeleted(uint32_t shotId) {
-    File indexFile = fs->open("/h/index.bin", "r+");
-    if (!indexFile) {
-        ESP_LOGE("ShotHistoryPlugin", "Failed to open index file for deletion marking");
-        return;
+    if (ok && rewrite) {
+        // LittleFS renames over an existing file atomically; FAT (SD card) refuses,
+        // and loadIndex() picks up index.tmp if we crash in between.
+        if (!fs->rename(INDEX_TMP_PATH, INDEX_PATH)) {
+            fs->remove(INDEX_PATH);
+            ok = fs->rename(INDEX_TMP_PATH, INDEX_PATH);
+        }
     }
-
-    ShotIndexHeader header{};
-    if (!readIndexHeader(indexFile, header)) {
-        indexFile.close();
-        return;
+    if (!ok) {
+        // Keep everything dirty and rewrite the whole file on the next attempt.
+        ESP_LOGE("ShotHistoryPlugin", "Failed to flush index");
+        indexRewrite = true;
+        return false;
     }
+    // Before the journal goes: replaying it over index.bin leaves the statistics unchanged
+    saveStats();
+    fs->remove(INDEX_JOURNAL_PATH);
+    ESP_LOGD("ShotHistoryPlugin", "Compacted index: %u entries%s, %u journal bytes", (unsigned)written,
+             rewrite ? " (rewrite)" : "", (unsigned)journalBytes);
+    journalBytes = 0;
+    dirtySlots.clear();
+    indexHeaderDirty = false;
+    indexRewrite = false;
+    return true;
+}
 
-    // Find ALL entries with this shot ID and mark them as deleted
-    uint32_t duplicatesFound = 0;
-
-    for (uint32_t i = 0; i < header.entryCount; i++) {
-        size_t entryPos = sizeof(ShotIndexHeader) + i * sizeof(ShotIndexEntry);
-        ShotIndexEntry entry{};
-        if (readEntryAtPosition(indexFile, entryPos, entry)) {
-            if (entry.id == shotId) {
-                duplicatesFound++;
+bool ShotHistoryPlugin::commitIndexOp(const ShotIndexJournalOp &op) {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    if (!ensureIndexExists()) {
+        return false;
+    }
+    const bool journaled = journalIndexOp(op);
+    const bool applied = applyIndexOp(op);
+    if (!journaled) {
+        flushIndex(true);
+    }
+    return applied;
+}
 
-                // Mark this entry as deleted
-                entry.flags |= SHOT_FLAG_DELETED;
+bool ShotHistoryPlugin::applyIndexOp(const ShotIndexJournalOp &op) {
+    switch (op.type) {
+    case ShotIndexJournalOp::Upsert: {
+        const ShotIndexEntry &entry = op.entry;
+        // Check for existing entry with same ID - update in place (upsert)
+        int existingSlot = findSlot(entry.id);
+        if (existingSlot >= 0) {
+            accountHistoryBytes(shot_index_quota::entryBytes(indexEntries[existingSlot]), shot_index_quota::entryBytes(entry));
+            historyStats.remove(indexEntries[existingSlot]);
+            historyStats.add(entry);
+            indexEntries[existingSlot] = entry;
+            markIndexDirty(existingSlot);
+            ESP_LOGD("ShotHistoryPlugin", "Updated existing index entry for shot %u", entry.id);
+            return true;
+        }
 
-                if (writeEntryAtPosition(indexFile, entryPos, entry)) {
-                    ESP_LOGD("ShotHistoryPlugin", "Marked shot %u as deleted in index (duplicate #%u)", shotId, duplicatesFound);
-                }
+        // Append entry
+        const uint32_t slot = indexEntries.size();
+        accountHistoryBytes(0, shot_index_quota::entryBytes(entry));
+        historyStats.add(entry);
+        indexEntries.push_back(entry);
+        indexMap.insert(entry.id, slot);
+        markIndexDirty(slot);
+
+        // Update header
+        indexHeader.entryCount = indexEntries.size();
+        indexHeader.nextId = entry.id + 1;
+        markIndexDirty();
+
+        ESP_LOGD("ShotHistoryPlugin", "Appended shot %u to index", entry.id);
+        return true;
+    }
+    case ShotIndexJournalOp::Rating: {
+        int slot = findSlot(op.id);
+        if (slot < 0) {
+            ESP_LOGW("ShotHistoryPlugin", "Shot %u not found in index for metadata update", op.id);
+            return false;
+        }
+        ShotIndexEntry &entry = indexEntries[slot];
+        historyStats.remove(entry);
+        entry.rating = op.rating;
+        if (op.volume > 0) {
+            entry.volume = op.volume;
+        }
+        // Only saving notes sends this op, and the rebuild flags every shot that has them
+        entry.flags |= SHOT_FLAG_HAS_NOTES;
+        historyStats.add(entry);
+        markIndexDirty(slot);
+        ESP_LOGD("ShotHistoryPlugin", "Updated metadata for shot %u: rating=%u, volume=%u", op.id, op.rating, op.volume);
+        return true;
+    }
+    case ShotIndexJournalOp::Delete: {
+        // Mark ALL entries with this shot ID as deleted (older firmware could leave duplicates)
+        uint32_t duplicatesFound = 0;
+        indexMap.forEachSlot(op.id, [&](uint32_t slot) {
+            if (slot >= indexEntries.size() || indexEntries[slot].id != op.id) {
+                return;
             }
+            duplicatesFound++;
+            accountHistoryBytes(shot_index_quota::entryBytes(indexEntries[slot]), 0);
+            historyStats.remove(indexEntries[slot]);
+            indexEntries[slot].flags |= SHOT_FLAG_DELETED;
+            markIndexDirty(slot);
+            ESP_LOGD("ShotHistoryPlugin", "Marked shot %u as deleted in index (duplicate #%u)", op.id, duplicatesFound);
+        });
+
+        if (duplicatesFound == 0) {
+            ESP_LOGW("ShotHistoryPlugin", "Shot %u not found in index for deletion marking", op.id);
+        } else if (duplicatesFound > 1) {
+            ESP_LOGW("ShotHistoryPlugin", "Found and marked %u duplicate entries for shot %u as deleted", duplicatesFound, op.id);
         }
+        return duplicatesFound > 0;
     }
-
-    if (duplicatesFound == 0) {
-        ESP_LOGW("ShotHistoryPlugin", "Shot %u not found in index for deletion marking", shotId);
-    } else if (duplicatesFound > 1) {
-        ESP_LOGW("ShotHistoryPlugin", "Found and marked %u duplicate entries for shot %u as deleted", duplicatesFound, shotId);
     }
+    return false;
+}
 
-    indexFile.close();
+bool ShotHistoryPlugin::appendToIndex(const ShotIndexEntry &entry) { return commitIndexOp(ShotIndexJournalOp::upsert(entry)); }
+
+void ShotHistoryPlugin::updateIndexMetadata(uint32_t shotId, uint8_t rating, uint16_t volume) {
+    commitIndexOp(ShotIndexJournalOp::setRating(shotId, rating, volume));
 }
 
-size_t ShotHistoryPlugin::readRecentEntries(ShotIndexEntry *outEntries, size_t maxCount) {
-    File indexFile = fs->open("/h/index.bin", "r");
-    if (!indexFile) {
-        return 0;
-    }
+void ShotHistoryPlugin::markIndexDeleted(uint32_t shotId) { commitIndexOp(ShotIndexJournalOp::remove(shotId)); }
 
-    ShotIndexHeader header{};
-    if (!readIndexHeader(indexFile, header)) {
-        indexFile.close();
+size_t ShotHistoryPlugin::readRecentEntries(ShotIndexEntry *outEntries, size_t maxCount) {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    if (!ensureIndexExists()) {
         return 0;
     }
 
     // Entries are appended in id order, so walking backwards yields newest first.
     size_t found = 0;
-    for (uint32_t i = header.entryCount; i > 0 && found < maxCount; i--) {
-        size_t entryPos = sizeof(ShotIndexHeader) + (i - 1) * sizeof(ShotIndexEntry);
-        ShotIndexEntry entry{};
-        if (!readEntryAtPosition(indexFile, entryPos, entry)) {
-            break;
-        }
+    for (size_t i = indexEntries.size(); i > 0 && found < maxCount; i--) {
+        const ShotIndexEntry &entry = indexEntries[i - 1];
         if (entry.flags & SHOT_FLAG_DELETED) {
             continue;
         }
         outEntries[found++] = entry;
     }
-
-    indexFile.close();
     return found;
 }
 
-void ShotHistoryPlugin::startAsyncRebuild() {
+void ShotHistoryPlugin::parseQuery(JsonVariantConst params, ShotIndexQuery &query) {
+    if (params["profileId"].is<const char *>()) {
+        strncpy(query.profileId, params["profileId"].as<const char *>(), sizeof(query.profileId) - 1);
+        query.profileId[sizeof(query.profileId) - 1] = '\0';
+    }
+    readQueryInt<uint32_t>(params["from"], query.fromTimestamp, UINT32_MAX);
+    readQueryInt<uint32_t>(params["to"], query.toTimestamp, UINT32_MAX);
+    readQueryInt<uint8_t>(params["minRating"], query.minRating, UINT8_MAX);
+    readQueryInt<uint8_t>(params["maxRating"], query.maxRating, UINT8_MAX);
+    readQueryScaled(params["minTemp"], query.minAvgTemp, TEMP_SCALE);
+    readQueryScaled(params["maxTemp"], query.maxAvgTemp, TEMP_SCALE);
+    readQueryScaled(params["minPressure"], query.minMaxPressure, PRESSURE_SCALE);
+    readQueryScaled(params["maxPressure"], query.maxMaxPressure, PRESSURE_SCALE);
+    readQueryScaled(params["minFlow"], query.minAvgFlow, FLOW_SCALE);
+    readQueryScaled(params["maxFlow"], query.maxAvgFlow, FLOW_SCALE);
+    readQueryInt<uint8_t>(params["flags"], query.requiredFlags, UINT8_MAX);
+    readQueryInt<uint8_t>(params["excludeFlags"], query.excludedFlags, UINT8_MAX);
+    if (!params["sort"].isNull()) {
+        query.sortKey = parseSortKey(params["sort"].as<String>());
+    }
+    if (!params["order"].isNull()) {
+        query.descending = params["order"].as<String>() != "asc";
+    }
+    readQueryInt<uint32_t>(params["offset"], query.offset, UINT32_MAX);
+    readQueryInt<uint32_t>(params["limit"], query.limit, ShotIndexQuery::MAX_LIMIT);
+}
+
+size_t ShotHistoryPlugin::queryIndex(const ShotIndexQuery &query, ShotHistoryBuffer &out) {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    ShotIndexHeader hdr{};
+    hdr.magic = SHOT_INDEX_MAGIC;
+    hdr.version = SHOT_INDEX_VERSION;
+    hdr.entrySize = SHOT_INDEX_ENTRY_SIZE;
+    hdr.nextId = 0; // meaningless for a partial view
+    if (!ensureIndexExists()) {
+        out.assign(reinterpret_cast<const uint8_t *>(&hdr), reinterpret_cast<const uint8_t *>(&hdr) + sizeof(hdr));
+        return 0;
+    }
+
+    std::vector<uint32_t, PsramStlAllocator<uint32_t>> slots;
+    const size_t total = runShotIndexQuery(indexEntries.data(), indexEntries.size(), query, slots);
+    hdr.entryCount = slots.size();
+
+    out.resize(sizeof(hdr) + slots.size() * sizeof(ShotIndexEntry));
+    memcpy(out.data(), &hdr, sizeof(hdr));
+    uint8_t *dst = out.data() + sizeof(hdr);
+    for (uint32_t slot : slots) {
+        memcpy(dst, &indexEntries[slot], sizeof(ShotIndexEntry));
+        dst += sizeof(ShotIndexEntry);
+    }
+    ESP_LOGD("ShotHistoryPlugin", "Index query: %u of %u matches returned", (unsigned)slots.size(), (unsigned)total);
+    return total;
+}
+
+uint32_t ShotHistoryPlugin::indexEntryCount() {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    if (!ensureIndexExists()) {
+        return 0;
+    }
+    return indexEntries.size();
+}
+
+size_t ShotHistoryPlugin::readIndexImage(uint8_t *out, size_t maxLen, size_t offset, uint32_t entryCount) {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    ShotIndexHeader hdr = indexHeader;
+    hdr.entryCount = entryCount;
+    const size_t total = sizeof(hdr) + entryCount * sizeof(ShotIndexEntry);
+    if (offset >= total) {
+        return 0;
+    }
+    const size_t len = std::min(maxLen, total - offset);
+    size_t done = 0;
+    if (offset < sizeof(hdr)) {
+        done = std::min(len, sizeof(hdr) - offset);
+        memcpy(out, reinterpret_cast<const uint8_t *>(&hdr) + offset, done);
+    }
+    if (done < len) {
+        // A rebuild may have shrunk the index since entryCount was taken; pad with
+        // zeroed entries so the response still matches its Content-Length.
+        const size_t pos = offset + done - sizeof(hdr);
+        const size_t cached = indexEntries.size() * sizeof(ShotIndexEntry);
+        const size_t avail = pos < cached ? std::min(len - done, cached - pos) : 0;
+        memcpy(out + done, reinterpret_cast<const uint8_t *>(indexEntries.data()) + pos, avail);
+        memset(out + done + avail, 0, len - done - avail);
+    }
+    return len;
+}
+
+void ShotHistoryPlugin::startAsyncRebuild(bool incremental) {
     if (!rebuildInProgress) {
         rebuildInProgress = true; // Set immediately to prevent multiple rebuilds
+        rebuildIncremental = incremental;
         ESP_LOGI("ShotHistoryPlugin", "Starting immediate async rebuild task");
 
         // Create a dedicated task for rebuild instead of using the existing loop
@@ -822,7 +1640,7 @@ void ShotHistoryPlugin::startAsyncRebuild() {
             [](void *param) {
                 auto *plugin = static_cast<ShotHistoryPlugin *>(param);
                 ESP_LOGI("ShotHistoryPlugin", "Rebuild task started");
-                plugin->rebuildIndex();
+                plugin->rebuildIndex(plugin->rebuildIncremental);
                 plugin->rebuildInProgress = false;
                 ESP_LOGI("ShotHistoryPlugin", "Rebuild task completed");
                 vTaskDelete(NULL); // Delete this task when done
@@ -837,8 +1655,23 @@ void ShotHistoryPlugin::startAsyncRebuild() {
     }
 }
 
-void ShotHistoryPlugin::rebuildIndex() {
-    ESP_LOGI("ShotHistoryPlugin", "Starting index rebuild...");
+// Rebuilds the index from the .slog files. A full rebuild starts from an empty
+// index and reparses every file; an incremental one keeps the index and only
+// reparses files whose size or mtime differ from their entry. Entries go through
+// the journal and /h/rebuild.ckpt records the last finished shot, so a rebuild
+// cut short by a reboot resumes from there (see loopTask) instead of starting over.
+void ShotHistoryPlugin::rebuildIndex(bool incremental) {
+    ShotRebuildCheckpoint checkpoint{};
+    const bool resuming = readRebuildCheckpoint(checkpoint);
+    if (resuming) {
+        incremental = checkpoint.incremental != 0; // finish the rebuild that was interrupted
+        ESP_LOGI("ShotHistoryPlugin", "Resuming %s index rebuild after shot %u", incremental ? "incremental" : "full",
+                 checkpoint.lastId);
+    } else {
+        checkpoint.magic = SHOT_REBUILD_MAGIC;
+        checkpoint.incremental = incremental ? 1 : 0;
+        ESP_LOGI("ShotHistoryPlugin", "Starting %s index rebuild...", incremental ? "incremental" : "full");
+    }
 
     // Send scanning event
     if (pluginManager) {
@@ -850,11 +1683,9 @@ void ShotHistoryPlugin::rebuildIndex() {
         pluginManager->trigger(startEvent);
     }
 
-    // Delete existing index
-    fs->remove("/h/index.bin");
-
-    // Create new empty index
-    if (!ensureIndexExists()) {
+    // A full rebuild starts from an empty index (rewrites /h/index.bin). A resumed
+    // one keeps what the interrupted run already journaled.
+    if (!incremental && !resuming && !resetIndex()) {
         ESP_LOGE("ShotHistoryPlugin", "Failed to create index during rebuild");
         // Emit error event
         if (pluginManager) {
@@ -867,12 +1698,19 @@ void ShotHistoryPlugin::rebuildIndex() {
         }
         return;
     }
+    if (!incremental && !resuming) {
+        fs->remove(SUMMARY_PATH); // recreated slot by slot below
+    }
+    if (!resuming) {
+        writeRebuildCheckpoint(checkpoint);
+    }
 
     File directory = fs->open("/h");
     if (!directory || !directory.isDirectory()) {
         ESP_LOGW("ShotHistoryPlugin", "No history directory found");
         if (directory)
             directory.close();
+        fs->remove(REBUILD_CHECKPOINT_PATH);
         // Emit completion event even if no directory exists
         if (pluginManager) {
             Event completedEvent;
@@ -885,21 +1723,30 @@ void ShotHistoryPlugin::rebuildIndex() {
         return;
     }
 
-    // Collect all .slog files
-    std::vector<String> slogFiles;
+    // Collect all .slog files with the size and mtime used for change detection
+    struct SlogFile {
+        String name;
+        uint32_t id;
+        uint32_t size;
+        uint32_t mtime;
+    };
+    std::vector<SlogFile> slogFiles;
     File file = directory.openNextFile();
     while (file) {
         String fname = String(file.name());
         if (fname.endsWith(".slog")) {
-            slogFiles.push_back(fname);
+            int start = fname.lastIndexOf('/') + 1;
+            int end = fname.lastIndexOf('.');
+            uint32_t shotId = fname.substring(start, end).toInt();
+            slogFiles.push_back({fname, shotId, static_cast<uint32_t>(file.size()), static_cast<uint32_t>(file.getLastWrite())});
         }
         file.close();
         file = directory.openNextFile();
     }
     directory.close();
 
-    // Sort files to maintain order
-    std::sort(slogFiles.begin(), slogFiles.end());
+    // Process in id order so the checkpoint can simply record the last finished id
+    std::sort(slogFiles.begin(), slogFiles.end(), [](const SlogFile &a, const SlogFile &b) { return a.id < b.id; });
 
     ESP_LOGI("ShotHistoryPlugin", "Rebuilding index from %d shot files", slogFiles.size());
 
@@ -914,104 +1761,34 @@ void ShotHistoryPlugin::rebuildIndex() {
     }
 
     int currentIndex = 0;
+    int skipped = 0;
     uint32_t maxId = controller->getSettings().getHistoryIndex();
-    for (const String &fileName : slogFiles) {
+    for (const SlogFile &slog : slogFiles) {
         currentIndex++;
-        File shotFile = fs->open("/h/" + fileName, "r");
-        if (!shotFile) {
-            continue;
-        }
-
-        // Read shot header
-        ShotLogHeader shotHeader{};
-        if (shotFile.read(reinterpret_cast<uint8_t *>(&shotHeader), sizeof(shotHeader)) != sizeof(shotHeader) ||
-            shotHeader.magic != SHOT_LOG_MAGIC) {
-            shotFile.close();
-            continue;
+        if (slog.id > maxId) {
+            maxId = slog.id;
         }
 
-        // Extract shot ID from filename
-        int start = fileName.lastIndexOf('/') + 1;
-        int end = fileName.lastIndexOf('.');
-        uint32_t shotId = fileName.substring(start, end).toInt();
-        if (shotId > maxId) {
-            maxId = shotId;
-        }
-
-        // Create index entry
-        ShotIndexEntry entry{};
-        entry.id = shotId;
-        entry.timestamp = shotHeader.startEpoch;
-        entry.duration = shotHeader.durationMs;
-        entry.volume = shotHeader.finalWeight;
-        entry.rating = 0; // Will be updated if notes exist
-        entry.flags = SHOT_FLAG_COMPLETED;
-        strncpy(entry.profileId, shotHeader.profileId, sizeof(entry.profileId) - 1);
-        entry.profileId[sizeof(entry.profileId) - 1] = '\0';
-        strncpy(entry.profileName, shotHeader.profileName, sizeof(entry.profileName) - 1);
-        entry.profileName[sizeof(entry.profileName) - 1] = '\0';
-
-        // Check for incomplete shots
-        if (shotHeader.sampleCount == 0) {
-            entry.flags &= ~SHOT_FLAG_COMPLETED;
-        }
-
-        // Recompute the per-shot aggregates from the sample records (same math
-        // as the running sums in record()).
-        {
-            uint32_t tempSum = 0, tempCount = 0, flowSum = 0, flowCount = 0;
-            uint16_t maxPressure = 0;
-            ShotLogSample sample{};
-            shotFile.seek(shotHeader.headerSize, SeekSet);
-            for (uint32_t s = 0; s < shotHeader.sampleCount; s++) {
-                if (shotFile.read(reinterpret_cast<uint8_t *>(&sample), sizeof(sample)) != sizeof(sample)) {
-                    break;
-                }
-                tempSum += sample.ct;
-                tempCount++;
-                if (sample.cp > maxPressure) {
-                    maxPressure = sample.cp;
-                }
-                if (sample.fl > 0) {
-                    flowSum += sample.fl;
-                    flowCount++;
-                }
+        if (resuming && slog.id <= checkpoint.lastId) {
+            skipped++; // done before the reboot
+        } else if (incremental && isIndexEntryCurrent(slog.id, slog.size, slog.mtime)) {
+            skipped++;
+        } else {
+            ShotIndexEntry entry{};
+            ShotSummary summary;
+            if (buildIndexEntry("/h/" + slog.name, slog.id, entry, summary)) {
+                // Journaled like any other change, so the work survives a reboot
+                commitIndexOp(ShotIndexJournalOp::upsert(entry));
+                writeSummary(summary);
             }
-            entry.avgTemp = tempCount ? static_cast<uint16_t>(tempSum / tempCount) : 0;
-            entry.maxPressure = maxPressure;
-            entry.avgFlow = flowCount ? static_cast<uint16_t>(flowSum / flowCount) : 0;
         }
 
-        // Check for notes and extract rating and volume override
-        String notesPath = "/h/" + String(shotId, 10) + ".json";
-        if (fs->exists(notesPath)) {
-            entry.flags |= SHOT_FLAG_HAS_NOTES;
-
-            File notesFile = fs->open(notesPath, "r");
-            if (notesFile) {
-                String notesStr = notesFile.readString();
-                notesFile.close();
-
-                JsonDocument notesDoc(&psramAllocator);
-                if (deserializeJson(notesDoc, notesStr) == DeserializationError::Ok) {
-                    entry.rating = notesDoc["rating"].as<uint8_t>();
-
-                    // Check if user provided a doseOut value to override volume
-                    if (notesDoc["doseOut"].is<String>() && !notesDoc["doseOut"].as<String>().isEmpty()) {
-                        float doseOut = notesDoc["doseOut"].as<String>().toFloat();
-                        if (doseOut > 0.0f) {
-                            entry.volume = encodeUnsigned(doseOut, WEIGHT_SCALE, WEIGHT_MAX_VALUE);
-                        }
-                    }
-                }
-            }
+        if (currentIndex % REBUILD_CHECKPOINT_INTERVAL == 0 && slog.id > checkpoint.lastId) {
+            checkpoint.lastId = slog.id;
+            checkpoint.processed = currentIndex;
+            writeRebuildCheckpoint(checkpoint);
         }
 
-        shotFile.close();
-
-        // Append to index
-        appendToIndex(entry);
-
         // Emit progress update with adaptive frequency
         // Update every file for small rebuilds, every few files for larger ones
         int updateFrequency = slogFiles.size() <= 20 ? 1 : (slogFiles.size() <= 100 ? 3 : 5);
@@ -1020,6 +1797,7 @@ void ShotHistoryPlugin::rebuildIndex() {
             progressEvent.id = "evt:history-rebuild-progress";
             progressEvent.setInt("total", (int)slogFiles.size());
             progressEvent.setInt("current", currentIndex);
+            progressEvent.setInt("skipped", skipped);
             progressEvent.setString("status", "processing");
             pluginManager->trigger(progressEvent);
             ESP_LOGI("ShotHistoryPlugin", "Rebuild progress: %d/%d", currentIndex, (int)slogFiles.size());
@@ -1029,72 +1807,314 @@ void ShotHistoryPlugin::rebuildIndex() {
         }
     }
 
+    // Entries whose .slog is gone (removed outside the history API) are marked
+    // deleted. A shot started during the rebuild may be caught here too; its
+    // completion upsert restores the entry.
+    std::vector<uint32_t> staleIds;
+    {
+        std::lock_guard<std::recursive_mutex> lock(indexMutex);
+        for (const ShotIndexEntry &entry : indexEntries) {
+            if (entry.flags & SHOT_FLAG_DELETED) {
+                continue;
+            }
+            auto it = std::lower_bound(slogFiles.begin(), slogFiles.end(), entry.id,
+                                       [](const SlogFile &f, uint32_t id) { return f.id < id; });
+            if (it == slogFiles.end() || it->id != entry.id) {
+                staleIds.push_back(entry.id);
+            }
+        }
+    }
+    for (uint32_t id : staleIds) {
+        commitIndexOp(ShotIndexJournalOp::remove(id));
+    }
+
     if (maxId > controller->getSettings().getHistoryIndex()) {
         controller->getSettings().setHistoryIndex(maxId);
     }
 
+    // Persist the rebuilt index now rather than waiting for loopTask
+    flushIndex(true);
+    fs->remove(REBUILD_CHECKPOINT_PATH);
+
     // Emit completion event
     if (pluginManager) {
         Event completionEvent;
         completionEvent.id = "evt:history-rebuild-progress";
         completionEvent.setInt("total", (int)slogFiles.size());
         completionEvent.setInt("current", (int)slogFiles.size());
+        completionEvent.setInt("skipped", skipped);
         completionEvent.setString("status", "completed");
         pluginManager->trigger(completionEvent);
     }
 
-    ESP_LOGI("ShotHistoryPlugin", "Index rebuild completed");
+    ESP_LOGI("ShotHistoryPlugin", "Index rebuild completed: %d files, %d unchanged, %d stale entries removed",
+             (int)slogFiles.size(), skipped, (int)staleIds.size());
 }
 
-// Index helper functions
-bool ShotHistoryPlugin::readIndexHeader(File &indexFile, ShotIndexHeader &header) {
-    if (indexFile.read(reinterpret_cast<uint8_t *>(&header), sizeof(header)) != sizeof(header)) {
-        ESP_LOGE("ShotHistoryPlugin", "Failed to read index header");
+bool ShotHistoryPlugin::isIndexEntryCurrent(uint32_t shotId, uint32_t fileSize, uint32_t fileMtime) {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    if (!ensureIndexExists()) {
         return false;
     }
-    if (header.magic != SHOT_INDEX_MAGIC) {
-        ESP_LOGE("ShotHistoryPlugin", "Invalid index magic: 0x%08X", header.magic);
+    int slot = findSlot(shotId);
+    if (slot < 0) {
         return false;
     }
-    return true;
+    const ShotIndexEntry &entry = indexEntries[slot];
+    // fileSize 0 means the entry predates change tracking, so it is always rescanned
+    return (entry.flags & SHOT_FLAG_DELETED) == 0 && entry.fileSize != 0 && entry.fileSize == fileSize &&
+           entry.fileMtime == fileMtime;
 }
 
-int ShotHistoryPlugin::findEntryPosition(File &indexFile, const ShotIndexHeader &header, uint32_t shotId) {
-    for (uint32_t i = 0; i < header.entryCount; i++) {
-        size_t entryPos = sizeof(ShotIndexHeader) + i * sizeof(ShotIndexEntry);
-        indexFile.seek(entryPos, SeekSet);
+bool ShotHistoryPlugin::buildIndexEntry(const String &path, uint32_t shotId, ShotIndexEntry &entry, ShotSummary &summary) {
+    File shotFile = fs->open(path, "r");
+    if (!shotFile) {
+        return false;
+    }
 
-        ShotIndexEntry entry{};
-        if (!readEntryAtPosition(indexFile, entryPos, entry)) {
-            ESP_LOGW("ShotHistoryPlugin", "Failed to read entry at position %u", i);
-            break;
+    // Read shot header
+    ShotLogHeader shotHeader{};
+    if (shotFile.read(reinterpret_cast<uint8_t *>(&shotHeader), sizeof(shotHeader)) != sizeof(shotHeader) ||
+        shotHeader.magic != SHOT_LOG_MAGIC) {
+        shotFile.close();
+        return false;
+    }
+
+    // Create index entry
+    entry = ShotIndexEntry{};
+    entry.id = shotId;
+    entry.timestamp = shotHeader.startEpoch;
+    entry.duration = shotHeader.durationMs;
+    entry.volume = shotHeader.finalWeight;
+    entry.rating = 0; // Will be updated if notes exist
+    entry.flags = SHOT_FLAG_COMPLETED;
+    strncpy(entry.profileId, shotHeader.profileId, sizeof(entry.profileId) - 1);
+    entry.profileId[sizeof(entry.profileId) - 1] = '\0';
+    strncpy(entry.profileName, shotHeader.profileName, sizeof(entry.profileName) - 1);
+    entry.profileName[sizeof(entry.profileName) - 1] = '\0';
+    entry.fileSize = shotFile.size();
+    entry.fileMtime = shotFile.getLastWrite();
+
+    // Check for incomplete shots
+    if (shotHeader.sampleCount == 0) {
+        entry.flags &= ~SHOT_FLAG_COMPLETED;
+    }
+
+    // Recompute the per-shot aggregates and the summary from the sample
+    // records (same math as the running sums in record()). The decoder handles
+    // both raw v5 records and v6 delta blocks.
+    {
+        uint32_t tempSum = 0, tempCount = 0, flowSum = 0, flowCount = 0;
+        uint16_t maxPressure = 0;
+        ShotSummaryBuilder builder;
+        builder.reset();
+        const uint32_t expected = shotHeader.sampleCount;
+        shot_log::Decoder decoder(shotHeader.version);
+        uint8_t chunk[256];
+        shotFile.seek(shotHeader.headerSize, SeekSet);
+        bool more = expected > 0;
+        while (more) {
+            const size_t n = shotFile.read(chunk, sizeof(chunk));
+            if (n == 0) {
+                break;
+            }
+            more = decoder.feed(chunk, n, [&](const ShotLogSample &sample) {
+                tempSum += sample.ct;
+                tempCount++;
+                if (sample.cp > maxPressure) {
+                    maxPressure = sample.cp;
+                }
+                if (sample.fl > 0) {
+                    flowSum += sample.fl;
+                    flowCount++;
+                }
+                builder.push(sample, shotHeader);
+                return tempCount < expected;
+            });
+            more = more && tempCount < expected;
         }
+        entry.avgTemp = tempCount ? static_cast<uint16_t>(tempSum / tempCount) : 0;
+        entry.maxPressure = maxPressure;
+        entry.avgFlow = flowCount ? static_cast<uint16_t>(flowSum / flowCount) : 0;
+        builder.finish(shotHeader, shotId, summary);
+        entry.avgPressure = shotSummaryAveragePressure(summary);
+    }
+    shotFile.close();
 
-        if (entry.id == shotId) {
-            return entryPos;
+    // Check for notes and extract rating and volume override
+    JsonDocument notesDoc(&psramAllocator);
+    if (loadNotes(shotId, notesDoc)) {
+        entry.flags |= SHOT_FLAG_HAS_NOTES;
+        entry.rating = notesDoc["rating"].as<uint8_t>();
+
+        // Check if user provided a doseOut value to override volume
+        if (notesDoc["doseOut"].is<String>() && !notesDoc["doseOut"].as<String>().isEmpty()) {
+            float doseOut = notesDoc["doseOut"].as<String>().toFloat();
+            if (doseOut > 0.0f) {
+                entry.volume = encodeUnsigned(doseOut, WEIGHT_SCALE, WEIGHT_MAX_VALUE);
+            }
         }
     }
-    return -1;
+    return true;
 }
 
-bool ShotHistoryPlugin::readEntryAtPosition(File &indexFile, size_t position, ShotIndexEntry &entry) {
-    indexFile.seek(position, SeekSet);
-    if (indexFile.read(reinterpret_cast<uint8_t *>(&entry), sizeof(entry)) != sizeof(entry)) {
-        ESP_LOGE("ShotHistoryPlugin", "Failed to read entry at position %zu", position);
+bool ShotHistoryPlugin::writeSummary(const ShotSummary &summary) {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    const int slot = findSlot(summary.id);
+    if (slot < 0) {
         return false;
     }
-    return true;
+    const bool exists = fs->exists(SUMMARY_PATH);
+    File file = fs->open(SUMMARY_PATH, exists ? "r+" : FILE_WRITE);
+    if (!file) {
+        ESP_LOGE("ShotHistoryPlugin", "Failed to open %s", SUMMARY_PATH);
+        return false;
+    }
+    bool ok = true;
+    size_t size = exists ? file.size() : 0;
+    if (size < sizeof(ShotSummaryHeader)) {
+        ShotSummaryHeader summaryHeader{};
+        summaryHeader.magic = SHOT_SUMMARY_MAGIC;
+        summaryHeader.version = SHOT_SUMMARY_VERSION;
+        summaryHeader.recordSize = SHOT_SUMMARY_RECORD_SIZE;
+        ok = file.seek(0, SeekSet) &&
+             file.write(reinterpret_cast<const uint8_t *>(&summaryHeader), sizeof(summaryHeader)) == sizeof(summaryHeader);
+        size = sizeof(summaryHeader);
+    }
+    // Slots without a summary (shots from before summary.bin, or a torn last
+    // record) are zero-filled up to this one.
+    size -= (size - sizeof(ShotSummaryHeader)) % sizeof(ShotSummary);
+    const size_t offset = sizeof(ShotSummaryHeader) + slot * sizeof(ShotSummary);
+    const ShotSummary empty{};
+    ok = ok && file.seek(size, SeekSet);
+    for (; ok && size < offset; size += sizeof(empty)) {
+        ok = file.write(reinterpret_cast<const uint8_t *>(&empty), sizeof(empty)) == sizeof(empty);
+    }
+    ok = ok && file.seek(offset, SeekSet) &&
+         file.write(reinterpret_cast<const uint8_t *>(&summary), sizeof(summary)) == sizeof(summary);
+    file.close();
+    if (!ok) {
+        ESP_LOGE("ShotHistoryPlugin", "Failed to write summary for shot %u", summary.id);
+    }
+    return ok;
+}
+
+bool ShotHistoryPlugin::readRebuildCheckpoint(ShotRebuildCheckpoint &checkpoint) {
+    File file = fs->open(REBUILD_CHECKPOINT_PATH, "r");
+    if (!file) {
+        return false;
+    }
+    const bool ok = file.read(reinterpret_cast<uint8_t *>(&checkpoint), sizeof(checkpoint)) == sizeof(checkpoint) &&
+                    checkpoint.magic == SHOT_REBUILD_MAGIC;
+    file.close();
+    if (!ok) {
+        ESP_LOGW("ShotHistoryPlugin", "Ignoring invalid rebuild checkpoint");
+        checkpoint = ShotRebuildCheckpoint{};
+    }
+    return ok;
 }
 
-bool ShotHistoryPlugin::writeEntryAtPosition(File &indexFile, size_t position, const ShotIndexEntry &entry) {
-    indexFile.seek(position, SeekSet);
-    if (indexFile.write(reinterpret_cast<const uint8_t *>(&entry), sizeof(entry)) != sizeof(entry)) {
-        ESP_LOGE("ShotHistoryPlugin", "Failed to write entry at position %zu", position);
+void ShotHistoryPlugin::writeRebuildCheckpoint(const ShotRebuildCheckpoint &checkpoint) {
+    File file = fs->open(REBUILD_CHECKPOINT_PATH, FILE_WRITE);
+    if (!file) {
+        ESP_LOGW("ShotHistoryPlugin", "Failed to write rebuild checkpoint");
+        return;
+    }
+    file.write(reinterpret_cast<const uint8_t *>(&checkpoint), sizeof(checkpoint));
+    file.close();
+}
+
+bool ShotHistoryPlugin::loadStats(uint32_t generation) {
+    if (!fs->exists(STATS_PATH)) {
+        return false;
+    }
+    File file = fs->open(STATS_PATH, "r");
+    if (!file) {
+        return false;
+    }
+    ShotHistoryBuffer image(file.size());
+    const bool ok = file.read(image.data(), image.size()) == image.size() &&
+                    historyStats.readImage(image.data(), image.size(), generation);
+    file.close();
+    if (!ok) {
+        ESP_LOGI("ShotHistoryPlugin", "History statistics out of date, recomputing from the index");
+    }
+    return ok;
+}
+
+// Written whole through stats.tmp like index.bin. A failed write only costs a
+// recomputation at the next start, since the generation will not match.
+bool ShotHistoryPlugin::saveStats() {
+    ShotHistoryBuffer image(historyStats.imageSize());
+    historyStats.writeImage(image.data(), indexHeader.generation);
+    File file = fs->open(STATS_TMP_PATH, FILE_WRITE);
+    bool ok = file && file.write(image.data(), image.size()) == image.size();
+    if (file) {
+        file.close();
+    }
+    if (ok && !fs->rename(STATS_TMP_PATH, STATS_PATH)) {
+        fs->remove(STATS_PATH);
+        ok = fs->rename(STATS_TMP_PATH, STATS_PATH);
+    }
+    if (!ok) {
+        ESP_LOGW("ShotHistoryPlugin", "Failed to write %s", STATS_PATH);
+    }
+    return ok;
+}
+
+// Answers from the running totals, so the cost does not depend on the number of shots.
+void ShotHistoryPlugin::writeStats(JsonDocument &response) {
+    std::lock_guard<std::recursive_mutex> lock(indexMutex);
+    if (!ensureIndexExists()) {
+        response["error"] = "Index unavailable";
+        return;
+    }
+    writeStatsBucket(response["total"].to<JsonObject>(), historyStats.totals());
+    JsonArray profiles = response["profiles"].to<JsonArray>();
+    historyStats.forEachProfile([&](const char *profileId, const char *profileName, const ShotStatsBucket &bucket) {
+        JsonObject profile = profiles.add<JsonObject>();
+        profile["profileId"] = profileId;
+        profile["profileName"] = profileName;
+        writeStatsBucket(profile, bucket);
+    });
+    if (historyStats.otherProfiles().count > 0) {
+        writeStatsBucket(response["otherProfiles"].to<JsonObject>(), historyStats.otherProfiles());
+    }
+    JsonArray days = response["days"].to<JsonArray>();
+    historyStats.forEachDay([&](uint32_t day, const ShotStatsBucket &bucket) {
+        JsonObject period = days.add<JsonObject>();
+        period["start"] = shot_history_stats::dayStart(day);
+        writeStatsBucket(period, bucket);
+    });
+    JsonArray weeks = response["weeks"].to<JsonArray>();
+    historyStats.forEachWeek([&](uint32_t week, const ShotStatsBucket &bucket) {
+        JsonObject period = weeks.add<JsonObject>();
+        period["start"] = shot_history_stats::weekStart(week);
+        writeStatsBucket(period, bucket);
+    });
+}
+
+// Index helper functions
+bool ShotHistoryPlugin::readIndexHeader(File &indexFile, ShotIndexHeader &header) {
+    if (indexFile.read(reinterpret_cast<uint8_t *>(&header), sizeof(header)) != sizeof(header)) {
+        ESP_LOGE("ShotHistoryPlugin", "Failed to read index header");
+        return false;
+    }
+    if (header.magic != SHOT_INDEX_MAGIC) {
+        ESP_LOGE("ShotHistoryPlugin", "Invalid index magic: 0x%08X", header.magic);
         return false;
     }
     return true;
 }
 
+int ShotHistoryPlugin::findSlot(uint32_t shotId) {
+    uint32_t slot = 0;
+    if (!indexMap.find(shotId, slot) || slot >= indexEntries.size()) {
+        return -1;
+    }
+    return slot;
+}
+
 bool ShotHistoryPlugin::createEarlyIndexEntry() {
     Profile profile = controller->getProfileManager()->getSelectedProfile();
 
@@ -3,15 +3,58 @@
 
 #include <ArduinoJson.h>
 #include <LittleFS.h>
+#include <display/core/EventPayloads.h>
+#include <display/core/EventSlot.h>
 #include <display/core/Plugin.h>
 #include <display/core/utils.h>
+#include <display/models/shot_history_stats.h>
+#include <display/models/shot_index_journal.h>
+#include <display/models/shot_index_map.h>
+#include <display/models/shot_index_quota.h>
+#include <display/models/shot_index_query.h>
+#include <display/models/shot_log_codec.h>
+#include <display/models/shot_log_decimator.h>
 #include <display/models/shot_log_format.h>
+#include <display/models/shot_log_live.h>
+#include <display/models/shot_log_timing.h>
+#include <display/models/shot_notes_store.h>
+#include <display/models/shot_summary.h>
+#include <display/util/PsramStlAllocator.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
 
 constexpr size_t SHOT_HISTORY_INTERVAL = 100;
+constexpr size_t SHOT_LOG_IO_BUFFER_SIZE = 4096; // each of the two write buffers
 constexpr size_t MIN_FREE_SPACE_BYTES = 500 * 1024;         // 500 KB reserved free space
 constexpr unsigned long EXTENDED_RECORDING_DURATION = 3000; // 3 seconds
 constexpr unsigned long WEIGHT_STABILIZATION_TIME = 1000;   // 1 second
 constexpr float WEIGHT_STABILIZATION_THRESHOLD = 0.1f;      // 0.1g threshold
+constexpr unsigned long INDEX_COMPACT_DELAY_MS = 30000;     // compact the index journal after 30 seconds
+constexpr size_t INDEX_JOURNAL_COMPACT_BYTES = 16 * 1024;   // ... or once the journal reaches 16 KB
+constexpr size_t INDEX_CACHE_HEADROOM = 64;                 // spare slots reserved when loading the index
+constexpr unsigned long FREE_SPACE_RECHECK_MS = 600000;     // re-read filesystem usage after 10 minutes
+constexpr const char *INDEX_PATH = "/h/index.bin";
+constexpr const char *INDEX_TMP_PATH = "/h/index.tmp";
+constexpr const char *INDEX_JOURNAL_PATH = "/h/index.jnl";
+constexpr const char *REBUILD_CHECKPOINT_PATH = "/h/rebuild.ckpt";
+constexpr const char *SUMMARY_PATH = "/h/summary.bin";
+constexpr const char *STATS_PATH = "/h/stats.bin";
+constexpr const char *STATS_TMP_PATH = "/h/stats.tmp";
+constexpr const char *NOTES_PATH = "/h/notes.log";
+constexpr const char *NOTES_TMP_PATH = "/h/notes.tmp";
+constexpr const char *NOTES_BAD_PATH = "/h/notes.bad"; // a log with a bad header, kept for recovery
+constexpr const char *NOTES_MIGRATION_PATH = "/h/notes.mig"; // present while per-shot .json files are imported
+constexpr int REBUILD_CHECKPOINT_INTERVAL = 10; // files between rebuild checkpoints
+
+// Parameters understood by req:history:query; /api/history/query takes the same names as URL args.
+constexpr const char *SHOT_HISTORY_QUERY_PARAMS[] = {"profileId", "from", "to", "minRating", "maxRating", "minTemp", "maxTemp",
+                                                     "minPressure", "maxPressure", "minFlow", "maxFlow", "flags", "excludeFlags",
+                                                     "sort", "order", "offset", "limit"};
+
+using ShotHistoryBuffer = std::vector<uint8_t, PsramStlAllocator<uint8_t>>;
+// Receives each live shot frame (see shot_log_live.h); called from the history task.
+using ShotLiveListener = std::function<void(const uint8_t *frame, size_t len)>;
 
 class ShotHistoryPlugin : public Plugin {
   public:
@@ -22,31 +65,95 @@ class ShotHistoryPlugin : public Plugin {
 
     void record();
 
-    void handleRequest(JsonDocument &request, JsonDocument &response);
+    // Requests with a binary payload (req:history:query) also fill binary, which
+    // the caller sends as a binary frame right after the JSON response.
+    void handleRequest(JsonDocument &request, JsonDocument &response, ShotHistoryBuffer *binary = nullptr);
+
+    // Filters, sorts and pages the in-memory index. out receives the page as a
+    // SIDX image (header + entries, same layout as index.bin); returns the number
+    // of matches before paging.
+    static void parseQuery(JsonVariantConst params, ShotIndexQuery &query);
+    size_t queryIndex(const ShotIndexQuery &query, ShotHistoryBuffer &out);
 
     // Index management methods
     bool appendToIndex(const ShotIndexEntry &entry);
     void updateIndexMetadata(uint32_t shotId, uint8_t rating, uint16_t volume);
     void markIndexDeleted(uint32_t shotId);
-    void rebuildIndex();
-    void startAsyncRebuild();
+    // incremental only rescans .slog files whose size or mtime changed; see rebuildIndex().
+    void rebuildIndex(bool incremental = false);
+    void startAsyncRebuild(bool incremental = false);
     bool ensureIndexExists();
 
     // Read up to maxCount most recent non-deleted index entries, newest first.
     // Returns the number of entries written to outEntries.
     size_t readRecentEntries(ShotIndexEntry *outEntries, size_t maxCount);
 
+    // index.bin as served over HTTP, built from the in-memory index: SIDX header
+    // (with entryCount) followed by the first entryCount entries. Copies up to
+    // maxLen bytes starting at offset and returns how many were written.
+    uint32_t indexEntryCount();
+    size_t readIndexImage(uint8_t *out, size_t maxLen, size_t offset, uint32_t entryCount);
+
+    // Compacts the index journal: writes dirty entries back to /h/index.bin and
+    // removes /h/index.jnl. Without force, waits until changes are
+    // INDEX_COMPACT_DELAY_MS old or the journal reaches INDEX_JOURNAL_COMPACT_BYTES,
+    // and no shot is recording. Called from loopTask (the simulator drives it from
+    // its main loop).
+    bool flushIndex(bool force = false);
+
+    // Writes the oldest buffer handed off by record(), if any; returns false
+    // when there was nothing to write. Runs on the writer task (the simulator
+    // calls it from its main loop); record() also calls it when it has to wait
+    // for a buffer.
+    bool writePendingBuffer();
+
+    // How often record() wants to be called: the shot's sampling interval
+    // (Settings::getHistoryInterval()) while recording, the standard interval otherwise.
+    uint16_t getSampleInterval() const {
+        return recording || extendedRecording ? sampleInterval : SHOT_LOG_SAMPLE_INTERVAL_MS;
+    }
+
+    // Live shot stream (req:history:live). The listener gets the frames while
+    // streaming is enabled; enabling it mid-shot re-sends START (RESYNC) so a
+    // new subscriber can pick the shot up from there.
+    void setLiveListener(ShotLiveListener listener);
+    void setLiveStreaming(bool enabled);
+
   private:
     // Index helper functions
     bool readIndexHeader(File &indexFile, ShotIndexHeader &header);
-    int findEntryPosition(File &indexFile, const ShotIndexHeader &header, uint32_t shotId);
-    bool readEntryAtPosition(File &indexFile, size_t position, ShotIndexEntry &entry);
-    bool writeEntryAtPosition(File &indexFile, size_t position, const ShotIndexEntry &entry);
+    int findSlot(uint32_t shotId);
+    bool loadIndex();
+    void clearIndex();
+    bool resetIndex();
+    bool replayJournal(); // returns true if the journal had a damaged tail
+    bool journalIndexOp(const ShotIndexJournalOp &op);
+    bool applyIndexOp(const ShotIndexJournalOp &op);
+    bool commitIndexOp(const ShotIndexJournalOp &op); // journal + apply
+    void markIndexDirty(int slot = -1); // -1 marks the header
     bool createEarlyIndexEntry();
+    bool buildIndexEntry(const String &path, uint32_t shotId, ShotIndexEntry &entry,
+                         ShotSummary &summary); // parses a .slog + notes
+    bool writeSummary(const ShotSummary &summary); // into the summary.bin record of the shot's index slot
+    bool isIndexEntryCurrent(uint32_t shotId, uint32_t fileSize, uint32_t fileMtime);
+    bool readRebuildCheckpoint(ShotRebuildCheckpoint &checkpoint);
+    void writeRebuildCheckpoint(const ShotRebuildCheckpoint &checkpoint);
+    bool loadStats(uint32_t generation); // false if stats.bin is missing or was written for another index
+    bool saveStats();
+    void writeStats(JsonDocument &response); // req:history:stats
 
-    void saveNotes(const String &id, const JsonDocument &notes);
-    void loadNotes(const String &id, JsonDocument &notes);
+    // Notes store (/h/notes.log, see shot_notes_store.h)
+    bool ensureNotesStore();
+    bool loadNotesStore();
+    bool createNotesStore();
+    void migrateNotes(); // one-time import of the per-shot .json files
+    bool appendNotesRecord(ShotNotesRecord::Type type, uint32_t shotId, const uint8_t *payload, size_t length);
+    bool compactNotes();
+    bool saveNotes(uint32_t shotId, const JsonDocument &notes);
+    bool loadNotes(uint32_t shotId, JsonDocument &notes); // false if the shot has no notes
+    void eraseNotes(uint32_t shotId);
     void startRecording();
+    void pollSensors(); // takes the latest sensor values, once per sample
 
     uint16_t getSystemInfo(); // Helper to pack system state bits
 
@@ -54,11 +161,15 @@ class ShotHistoryPlugin : public Plugin {
 
     void endRecording();
     void endExtendedRecording();
-    void cleanupHistory();
-    size_t getFreeSpace();
+    void cleanupHistory(uint32_t keepId); // evicts shots per the storage quota, never keepId
+    size_t getFreeSpace();                // asks the filesystem (slow on SD cards)
+    uint64_t getCachedFreeSpace();        // getFreeSpace() at most every FREE_SPACE_RECHECK_MS
+    void accountHistoryBytes(uint32_t removed, uint32_t added);
 
     void recordPhaseTransition(uint8_t phaseNumber, uint16_t sampleIndex,
                                uint8_t reason); // Helper for phase transitions
+    void sendLiveFrame(uint8_t type, uint8_t flags, uint16_t count, uint32_t index, const void *payload);
+    void sendLiveSamples(); // the stored samples batched since the last call
 
     Controller *controller = nullptr;
     PluginManager *pluginManager = nullptr;
@@ -67,9 +178,9 @@ class ShotHistoryPlugin : public Plugin {
     bool isFileOpen = false;
     File currentFile;
     ShotLogHeader header{};
-    uint32_t sampleCount = 0;
-    uint8_t ioBuffer[4096];
-    size_t ioBufferPos = 0; // bytes used
+    uint16_t sampleInterval = SHOT_LOG_SAMPLE_INTERVAL_MS; // of the current shot, see getSampleInterval()
+    ShotLogDecimator decimator;                            // picks the samples that are stored
+    shot_log::Encoder encoder;                             // v6 block being assembled for the current shot
 
     bool recording = false;
     bool extendedRecording = false;
@@ -86,6 +197,11 @@ class ShotHistoryPlugin : public Plugin {
     float currentBluetoothFlow = 0.0f;
     float currentEstimatedWeight = 0.0f;
     float currentPuckResistance = 0.0f;
+    // Sensor events fire on every reading; only the latest matters per sample
+    EventSlot<WeightChanged> estimatedWeightSlot;
+    EventSlot<WeightChanged> bluetoothWeightSlot;
+    EventSlot<TempChanged> temperatureSlot;
+    EventSlot<PuckResistanceChanged> puckResistanceSlot;
     String currentProfileName;
 
     // Phase transition tracking (v5+)
@@ -99,13 +215,88 @@ class ShotHistoryPlugin : public Plugin {
     uint16_t maxPressureScaled = 0; // max of sample.cp (bar * 10)
     uint32_t flowSumScaled = 0;     // sum of positive sample.fl (ml/s * 100)
     uint32_t positiveFlowCount = 0;
+    ShotSummaryBuilder summaryBuilder; // features for summary.bin
 
     // Async rebuild state
     bool rebuildInProgress = false;
+    bool rebuildIncremental = false;
+
+    // PSRAM copy of index.bin, loaded on first use, plus an id -> slot map into
+    // it. Writes are journaled, applied in memory and mark slots dirty;
+    // flushIndex() persists them. Index access comes from the history task, the
+    // rebuild task and web requests, so all of it is serialized by indexMutex.
+    std::vector<ShotIndexEntry, PsramStlAllocator<ShotIndexEntry>> indexEntries;
+    ShotIndexHeader indexHeader{};
+    ShotIndexMap<PsramStlAllocator<uint32_t>> indexMap;
+    std::vector<uint32_t> dirtySlots;
+    unsigned long indexDirtySince = 0;
+    size_t journalBytes = 0;
+    bool indexLoaded = false;
+    bool indexHeaderDirty = false;
+    bool indexRewrite = false; // write the whole file (new, rebuilt or after a failed flush)
+    std::recursive_mutex indexMutex;
+
+    // Running totals per profile, day and week over the live index entries
+    // (indexMutex), updated as index ops apply and saved to /h/stats.bin with
+    // every index flush (see shot_history_stats.h).
+    ShotHistoryStats<PsramStlAllocator> historyStats;
+
+    // Storage quota bookkeeping (indexMutex): the bytes of all live shots, kept
+    // up to date as index ops apply, and the filesystem's free space as last
+    // read, moved by the same amounts in between reads.
+    uint64_t historyBytes = 0;
+    uint64_t cachedFreeBytes = 0;
+    unsigned long freeSpaceCheckedAt = 0;
+    bool freeSpaceKnown = false;
+
+    // Where each shot's notes sit in /h/notes.log, scanned once on first use.
+    // Web requests, the rebuild task and cleanup all reach the store, so it is
+    // serialized by notesMutex.
+    ShotNotesDirectory<PsramStlAllocator<uint32_t>> notesDirectory;
+    size_t notesFileSize = 0;
+    bool notesLoaded = false;
+    bool notesReadOnly = false; // damaged tail not compacted away yet: no appends behind it
+    std::recursive_mutex notesMutex;
+
+    // Double-buffered shot file writes: record() fills ioBuffers[activeBuffer]
+    // and hands it to the writer task when full, so a slow flash or SD write
+    // never holds up the next sample. pendingBuffers is the FIFO of handed-off
+    // buffers (writerStateMutex); writerFileMutex serializes writes to currentFile.
+    ShotHistoryBuffer ioBuffers[2];
+    uint8_t activeBuffer = 0;
+    size_t ioBufferPos = 0; // bytes used in the active buffer
+    uint8_t pendingBuffers[2] = {};
+    size_t pendingLength[2] = {};
+    uint8_t pendingCount = 0;
+    std::mutex writerStateMutex;
+    std::mutex writerFileMutex;
+    uint32_t writerStalls = 0; // hand-offs that had to wait for the other buffer, since boot
+
+    // Sample timing for the current shot (see ShotLogHeader::lateSamples and maxGapMs)
+    unsigned long lastSampleMs = 0;
+    uint16_t lateSamples = 0;
+    uint16_t droppedSamples = 0;
+    ShotLogJitter sampleJitter;
+
+    // Live stream state: stored samples not yet sent (history task only), and
+    // the listener plus its frame buffer (liveMutex).
+    shot_log_live::SampleBatch liveSamples;
+    ShotLiveListener liveListener;
+    ShotHistoryBuffer liveFrame;
+    std::mutex liveMutex;
+    std::atomic<bool> liveStreaming{false};
+    std::atomic<bool> liveResync{false};
 
     xTaskHandle taskHandle;
-    void flushBuffer();
+    xTaskHandle writerTaskHandle = nullptr;
+    void submitBuffer(); // hands the active buffer to the writer
+    void drainWriter();  // submits and waits until everything is written
+    bool isBufferPending(uint8_t buffer);
+    void writeEncodedBlock(); // moves the encoder's current block into the active buffer
+    void storeSample(const ShotLogSample &sample); // encodes a sample the decimator kept, updates the aggregates
+    void trackSampleTiming(unsigned long now);
     static void loopTask(void *arg);
+    static void writerTask(void *arg);
 };
 
 extern ShotHistoryPlugin ShotHistory;
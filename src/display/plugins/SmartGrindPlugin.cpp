@@ -7,6 +7,8 @@
 
 void SmartGrindPlugin::setup(Controller *controller, PluginManager *pluginManager) {
     this->controller = controller;
+    // Synchronous on purpose: the relay must be off when the grind ends, not
+    // after whatever the event worker is busy with (e.g. an MQTT publish)
     pluginManager->on("controller:grind:start", [this](Event const &event) { start(); });
     pluginManager->on("controller:grind:end", [this](Event const &event) { stop(); });
 }
@@ -8,8 +8,14 @@
 #include <display/core/process/BrewProcess.h>
 #include <display/core/process/GrindProcess.h>
 #include <display/models/profile.h>
+#include <display/models/shot_log_batch.h>
+#include <display/models/shot_log_codec.h>
+#include <display/models/shot_log_columns.h>
+#include <display/models/shot_log_http.h>
+#include <display/models/status_json.h>
 #include <display/plugins/BLEScalePlugin.h>
 #include <display/plugins/ShotHistoryPlugin.h>
+#include <display/util/PsramChunkPool.h>
 #include <display/util/PsramStlAllocator.h>
 #include <display/util/PsramWsBuffer.h>
 #include <display/util/mathutils.h>
@@ -42,6 +48,201 @@ static AsyncWebSocketSharedBuffer toWsBuffer(JsonDocument &doc) {
     return buffer;
 }
 
+// Read-ahead buffers for .slog downloads (see handleShotLogDownload). Four
+// concurrent downloads get a pooled chunk; any beyond that read directly into
+// the response buffer.
+static PsramChunkPool<8192, 4> shotLogChunks;
+
+// One .slog response, owned by its filler callback. The file stays open for the
+// transfer and is read in whole chunks into a pooled PSRAM buffer, so flash sees
+// a few large sequential reads whatever sizes the TCP layer asks for.
+struct ShotLogStream {
+    File file;
+    uint32_t start = 0;  // first byte of the requested range
+    uint32_t length = 0; // bytes in the range
+    uint32_t sent = 0;
+    uint8_t *chunk = nullptr;
+    size_t chunkLen = 0;
+    size_t chunkPos = 0;
+
+    ~ShotLogStream() {
+        file.close();
+        shotLogChunks.release(chunk);
+    }
+
+    size_t fill(uint8_t *out, size_t maxLen, size_t index) {
+        if (index != sent) { // the response never rewinds, but don't rely on it
+            file.seek(start + index, SeekSet);
+            sent = index;
+            chunkLen = chunkPos = 0;
+        }
+        const size_t want = std::min<size_t>(maxLen, length - sent);
+        if (want == 0) {
+            return 0;
+        }
+        size_t n;
+        if (chunk == nullptr) {
+            n = file.read(out, want);
+        } else {
+            if (chunkPos == chunkLen) {
+                chunkLen = file.read(chunk, std::min<size_t>(shotLogChunks.CHUNK_SIZE, length - sent));
+                chunkPos = 0;
+            }
+            n = std::min(want, chunkLen - chunkPos);
+            memcpy(out, chunk + chunkPos, n);
+            chunkPos += n;
+        }
+        sent += n;
+        return n;
+    }
+};
+
+// Producer side of /api/history/batch (see handleShotBatch): writes the
+// directory, then walks the shot files one section at a time and refills a
+// ring over a pooled PSRAM chunk whenever the response drains it. Only the
+// current file is open, so memory stays flat whatever the batch size.
+struct ShotBatchStream {
+    // Samples are decoded from INPUT_CHUNK-byte reads, which can finish at most
+    // two v6 blocks; REFILL_MIN keeps room for both at full width.
+    static constexpr size_t INPUT_CHUNK = 64;
+    static constexpr size_t REFILL_MIN = 2 * SHOT_LOG_BLOCK_SAMPLES * SHOT_LOG_SAMPLE_SIZE;
+
+    struct Section {
+        uint32_t id;
+        uint32_t length; // 0 for missing shots
+        uint32_t sampleCount;
+    };
+
+    FS *fs = nullptr;
+    uint32_t mask = 0; // 0 = stored files
+    std::vector<uint8_t, PsramStlAllocator<uint8_t>> directory;
+    std::vector<Section, PsramStlAllocator<Section>> sections;
+    uint8_t *chunk = nullptr;
+    shot_log_batch::ByteRing ring{nullptr, 0};
+
+    size_t directorySent = 0;
+    size_t current = 0;       // section being produced
+    uint32_t sectionSent = 0; // bytes of it already in the ring
+    uint32_t samplesSent = 0;
+    bool opened = false;
+    File file;
+    ShotLogHeader header{};
+    shot_log::Decoder decoder;
+
+    ~ShotBatchStream() {
+        file.close();
+        shotLogChunks.release(chunk);
+    }
+
+    static String path(uint32_t id) {
+        char name[24];
+        snprintf(name, sizeof(name), "/h/%06lu.slog", static_cast<unsigned long>(id));
+        return String(name);
+    }
+
+    size_t fill(uint8_t *out, size_t maxLen) {
+        if (ring.size() < maxLen) {
+            refill();
+        }
+        return ring.pop(out, maxLen);
+    }
+
+    void refill() {
+        while (ring.space() >= REFILL_MIN) {
+            if (directorySent < directory.size()) {
+                directorySent += ring.push(directory.data() + directorySent, directory.size() - directorySent);
+                continue;
+            }
+            if (current >= sections.size()) {
+                return;
+            }
+            const Section &section = sections[current];
+            if (sectionSent >= section.length) {
+                file.close();
+                opened = false;
+                current++;
+                sectionSent = 0;
+                samplesSent = 0;
+                continue;
+            }
+            if (!opened) {
+                open(section);
+            }
+            const uint32_t remaining = section.length - sectionSent;
+            size_t n = 0;
+            if (mask == 0) {
+                uint8_t buffer[512];
+                n = file ? file.read(buffer, std::min<size_t>(sizeof(buffer), remaining)) : 0;
+                n = ring.push(buffer, n);
+            } else if (sectionSent < sizeof(header)) {
+                n = ring.push(reinterpret_cast<const uint8_t *>(&header) + sectionSent, sizeof(header) - sectionSent);
+            } else {
+                n = produceSamples(section);
+            }
+            if (n == 0) {
+                // File shorter than planned (cut short, or changed since): pad so
+                // the section keeps the length the directory promised.
+                n = ring.pushZeros(remaining);
+            }
+            sectionSent += n;
+        }
+    }
+
+    void open(const Section &section) {
+        opened = true;
+        file = fs->open(path(section.id), "r");
+        if (!file || mask == 0) {
+            return;
+        }
+        if (file.read(reinterpret_cast<uint8_t *>(&header), sizeof(header)) != sizeof(header)) {
+            file.close();
+            return;
+        }
+        decoder = shot_log::Decoder(header.version);
+        shot_log_batch::projectHeader(header, mask);
+        header.sampleCount = section.sampleCount;
+    }
+
+    size_t produceSamples(const Section &section) {
+        size_t produced = 0;
+        uint8_t input[INPUT_CHUNK];
+        // A v6 block spans several reads, so read on until one yields samples
+        while (produced == 0 && file && samplesSent < section.sampleCount && !decoder.corrupt()) {
+            const size_t read = file.read(input, sizeof(input));
+            if (read == 0) {
+                break;
+            }
+            decoder.feed(input, read, [&](const ShotLogSample &sample) {
+                uint8_t record[SHOT_LOG_SAMPLE_SIZE];
+                produced += ring.push(record, shot_log_batch::projectSample(sample, mask, record));
+                return ++samplesSent < section.sampleCount;
+            });
+        }
+        return produced;
+    }
+};
+
+// A column-major projection of one shot (GET /api/history/<id>.slog?fieldsMask=).
+// The projected rows are small (8 bytes per sample for a chart) and kept in
+// PSRAM; the filler transposes them into columns as the response drains.
+struct ShotColumnStream {
+    ShotLogHeader header{};
+    std::vector<uint16_t, PsramStlAllocator<uint16_t>> rows;
+    uint8_t fields = 0;
+    uint32_t count = 0;
+
+    size_t length() const { return sizeof(header) + rows.size() * sizeof(uint16_t); }
+
+    size_t fill(uint8_t *out, size_t maxLen, size_t index) {
+        size_t n = 0;
+        if (index < sizeof(header)) {
+            n = std::min(maxLen, sizeof(header) - index);
+            memcpy(out, reinterpret_cast<const uint8_t *>(&header) + index, n);
+        }
+        return n + shot_log_columns::copyColumns(rows.data(), fields, count, index + n - sizeof(header), out + n, maxLen - n);
+    }
+};
+
 // Route mbedTLS allocations to PSRAM.
 static void *mbedtlsPsramCalloc(size_t n, size_t size) { // NOSONAR
     void *p = heap_caps_calloc(n, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
@@ -97,6 +298,7 @@ void WebUIPlugin::setup(Controller *_controller, PluginManager *_pluginManager)
         doc["tp"] = "evt:history-rebuild-progress";
         doc["total"] = event.getInt("total");
         doc["current"] = event.getInt("current");
+        doc["skipped"] = event.getInt("skipped");
         doc["status"] = event.getString("status");
         broadcastJson(doc);
     });
@@ -122,8 +324,11 @@ void WebUIPlugin::setup(Controller *_controller, PluginManager *_pluginManager)
     });
 
     // Subscribe to Bluetooth scale weight updates
-    pluginManager->on("controller:volumetric-measurement:bluetooth:change",
-                      [this](Event const &event) { this->currentBluetoothWeight = event.getFloat("value"); });
+    pluginManager->on(events::VOLUMETRIC_BLUETOOTH_CHANGE,
+                      [this](Event const &event) { this->currentBluetoothWeight = event.as<WeightChanged>().value; });
+
+    // Binary frames of the shot being recorded, for req:history:live subscribers
+    ShotHistory.setLiveListener([this](const uint8_t *frame, size_t len) { sendLiveFrame(frame, len); });
 
     setupServer();
 }
@@ -152,112 +357,7 @@ void WebUIPlugin::loop() {
         lastUpdateCheck = now;
         updateOTAStatus(ota->getCurrentVersion());
     }
-    if (now > lastStatus + STATUS_PERIOD && !ws.getClients().empty()) {
-        lastStatus = now;
-        statusDoc.clear();
-        statusDoc["tp"] = "evt:status";
-        statusDoc["ct"] = round_to(controller->getCurrentTemp(), 3);
-        statusDoc["tt"] = controller->getTargetTemp();
-        statusDoc["pr"] = round_to(controller->getCurrentPressure(), 3);
-        statusDoc["fl"] = round_to(controller->getCurrentPumpFlow(), 3);
-        statusDoc["pt"] = controller->getTargetPressure();
-        statusDoc["m"] = controller->getMode();
-        statusDoc["p"] = controller->getProfileManager()->getSelectedProfile().label;
-        statusDoc["puid"] = controller->getProfileManager()->getSelectedProfile().id;
-        statusDoc["cp"] = controller->getSystemInfo().capabilities.pressure;
-        statusDoc["cd"] = controller->getSystemInfo().capabilities.dimming;
-        statusDoc["gp"] = controller->getSystemInfo().capabilities.hasAddon(7);
-        statusDoc["tw"] = profileManager->getSelectedProfile().getTotalVolume(); // total target weight for the process
-        statusDoc["bta"] = controller->isVolumetricAvailable() ? 1 : 0;
-        statusDoc["bt"] =
-            controller->isVolumetricAvailable() && controller->getProfileManager()->getSelectedProfile().isVolumetric() ? 1 : 0;
-        statusDoc["btd"] = profileManager->getSelectedProfile().getTotalDuration();
-        statusDoc["led"] = controller->getSystemInfo().capabilities.ledControl;
-        statusDoc["gtd"] = controller->getTargetGrindDuration();
-        statusDoc["gtv"] = controller->getSettings().getTargetGrindVolume();
-        statusDoc["gt"] = controller->isVolumetricAvailable() && controller->getSettings().isVolumetricTarget() ? 1 : 0;
-        statusDoc["gact"] = controller->isGrindActive() ? 1 : 0;
-        statusDoc["wl"] = controller->getWaterLevel();
-        statusDoc["tof"] = controller->getTofDistance();
-        statusDoc["rssi"] = 0;
-        statusDoc["lat"] = -1; // BLE round-trip latency (ms); -1 = not yet measured
-        statusDoc["pw"] = controller->getCurrentPumpPower();
-        statusDoc["hp"] = round_to(controller->getCurrentHeaterPower(), 3);
-
-        if (controller->getClientController()->getClient()->isConnected()) {
-            statusDoc["rssi"] = controller->getClientController()->getClient()->getRssi();
-        }
-        if (controller->getClientController()->hasLatency()) {
-            statusDoc["lat"] = controller->getClientController()->getLatencyMs();
-        }
-
-        bool bleConnected = BLEScales.isConnected();
-        // Add Bluetooth scale weight information
-        statusDoc["bw"] = bleConnected ? this->currentBluetoothWeight : 0; // current bluetooth weight
-        statusDoc["cw"] = bleConnected ? this->currentBluetoothWeight : 0; // Use 'currentWeight' for forward compatbility
-        statusDoc["bc"] = bleConnected;                                    // bluetooth scale connected status
-        // Scale battery — only surfaced when the driver reports one and the
-        // value isn't the UNKNOWN sentinel (255). UI omits the battery pill
-        // entirely when `sbat` is absent, so disconnected/unknown scales don't
-        // render a stale stub.
-        if (bleConnected && BLEScales.hasBatteryLevel()) {
-            const uint8_t pct = BLEScales.getBatteryLevel();
-            if (pct != REMOTE_SCALES_BATTERY_UNKNOWN) {
-                statusDoc["sbat"] = pct;
-            }
-        }
-
-        // Deref under the process lock — other tasks delete the process at any time (GM-147).
-        // Released before broadcastJson so the ws send never runs under the lock.
-        std::unique_lock<std::recursive_mutex> processGuard(controller->getProcessLock());
-        Process *process = controller->getProcess();
-        if (process == nullptr) {
-            process = controller->getLastProcess();
-        }
-        if (process != nullptr) {
-            auto pObj = statusDoc["process"].to<JsonObject>();
-            pObj["a"] = controller->isActive() ? 1 : 0;
-            statusDoc["pkr"] = round_to(controller->getCurrentPuckResistance(), 3);
-            statusDoc["pf"] = round_to(controller->getCurrentPuckFlow(), 3);
-            statusDoc["tf"] = controller->getTargetFlow();
-            if (process->getType() == MODE_BREW) {
-                auto *brew = static_cast<BrewProcess *>(process);
-                unsigned long ts = brew->isActive() && controller->isActive() ? millis() : brew->finished;
-                pObj["s"] = brew->currentPhase.phase == PhaseType::PHASE_TYPE_BREW ? "brew" : "infusion";
-                pObj["l"] = brew->isActive() ? brew->currentPhase.name.c_str() : "Finished";
-                pObj["e"] = ts - brew->processStarted;
-                const bool isVolumetric = brew->target == ProcessTarget::VOLUMETRIC && brew->currentPhase.hasVolumetricTarget() &&
-                                          controller->isVolumetricAvailable();
-                pObj["tt"] = isVolumetric ? "volumetric" : "time";
-                if (isVolumetric) {
-                    Target t = brew->currentPhase.getVolumetricTarget();
-                    pObj["pt"] = t.value;
-                    pObj["pp"] = brew->currentVolume;
-                } else {
-                    pObj["pt"] = brew->getPhaseDuration();
-                    pObj["pp"] = ts - brew->currentPhaseStarted;
-                }
-            } else if (process->getType() == MODE_GRIND) {
-                auto *grind = static_cast<GrindProcess *>(process);
-                unsigned long ts = grind->isActive() && controller->isActive() ? millis() : grind->finished;
-                pObj["s"] = "grind";
-                pObj["l"] = grind->isActive() ? "Grinding" : "Finished";
-                pObj["e"] = ts - grind->started;
-                const bool isVolumetric = grind->target == ProcessTarget::VOLUMETRIC && controller->isVolumetricAvailable();
-                pObj["tt"] = isVolumetric ? "volumetric" : "time";
-                if (isVolumetric) {
-                    pObj["pt"] = grind->grindVolume;
-                    pObj["pp"] = grind->currentVolume;
-                } else {
-                    pObj["pt"] = grind->time;
-                    pObj["pp"] = ts - grind->started;
-                }
-            }
-        }
-        processGuard.unlock();
-
-        broadcastJson(statusDoc);
-    }
+    sendStatus(now);
     if (now > lastCleanup + CLEANUP_PERIOD) {
         lastCleanup = now;
         ws.cleanupClients();
@@ -314,6 +414,186 @@ void WebUIPlugin::serveWebAsset(AsyncWebServerRequest *request) {
     request->send(response);
 }
 
+void WebUIPlugin::handleShotLogDownload(AsyncWebServerRequest *request, FS *fs) {
+    // Shot ids only, so the name can't reach outside /h/
+    const String name = request->url().substring(strlen("/api/history/"));
+    const String id = name.substring(0, name.length() - strlen(".slog"));
+    bool valid = id.length() > 0;
+    for (unsigned int i = 0; i < id.length() && valid; i++) {
+        valid = isdigit(static_cast<unsigned char>(id[i]));
+    }
+    auto stream = std::make_shared<ShotLogStream>();
+    if (valid) {
+        stream->file = fs->open("/h/" + name, "r");
+    }
+    if (!stream->file) {
+        request->send(404, "text/plain", "Not found");
+        return;
+    }
+    const uint32_t size = stream->file.size();
+
+    // sampleCount is patched into the header when the shot ends, so 0 means it
+    // is still recording (or was cut short) and the file may yet change.
+    ShotLogHeader header{};
+    char etag[40] = "";
+    if (stream->file.read(reinterpret_cast<uint8_t *>(&header), sizeof(header)) == sizeof(header) &&
+        header.magic == SHOT_LOG_MAGIC && header.sampleCount > 0) {
+        shot_log_http::formatEtag(etag, sizeof(etag), id.toInt(), header.sampleCount, size);
+    }
+    if (etag[0] && request->hasHeader("If-None-Match") &&
+        shot_log_http::etagMatches(request->getHeader("If-None-Match")->value().c_str(), etag)) {
+        AsyncWebServerResponse *response = request->beginResponse(304);
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", "no-cache");
+        request->send(response);
+        return;
+    }
+
+    uint32_t mask = 0;
+    if (request->hasArg("fieldsMask")) {
+        mask = shot_log_batch::normalizeMask(strtoul(request->arg("fieldsMask").c_str(), nullptr, 0));
+    }
+    if (mask != 0 && header.magic == SHOT_LOG_MAGIC && header.headerSize == SHOT_LOG_HEADER_SIZE) {
+        sendShotColumns(request, stream->file, header, mask, etag);
+        return;
+    }
+
+    ShotLogByteRange range;
+    range.length = size;
+    ShotLogRangeStatus status = ShotLogRangeStatus::Full;
+    // If-Range: only send a part if the client's copy is still the current file
+    if (request->hasHeader("Range") &&
+        (!request->hasHeader("If-Range") || (etag[0] && request->getHeader("If-Range")->value() == etag))) {
+        status = shot_log_http::parseRange(request->getHeader("Range")->value().c_str(), size, range);
+    }
+    if (status == ShotLogRangeStatus::Unsatisfiable) {
+        AsyncWebServerResponse *response = request->beginResponse(416);
+        response->addHeader("Content-Range", "bytes */" + String(size));
+        request->send(response);
+        return;
+    }
+
+    stream->start = range.start;
+    stream->length = range.length;
+    stream->file.seek(range.start, SeekSet);
+    stream->chunk = shotLogChunks.acquire();
+    AsyncWebServerResponse *response =
+        request->beginResponse("application/octet-stream", range.length, [stream](uint8_t *buffer, size_t maxLen, size_t index) {
+            return stream->fill(buffer, maxLen, index);
+        });
+    if (status == ShotLogRangeStatus::Partial) {
+        response->setCode(206);
+        response->addHeader("Content-Range",
+                            "bytes " + String(range.start) + "-" + String(range.start + range.length - 1) + "/" + String(size));
+    }
+    response->addHeader("Accept-Ranges", "bytes");
+    if (etag[0]) {
+        // Completed shots never change: let the browser keep them and revalidate
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", "no-cache");
+    } else {
+        response->addHeader("Cache-Control", "no-store");
+    }
+    request->send(response);
+}
+
+void WebUIPlugin::sendShotColumns(AsyncWebServerRequest *request, File &file, const ShotLogHeader &header, uint32_t mask,
+                                  const char *etag) {
+    auto stream = std::allocate_shared<ShotColumnStream>(PsramStlAllocator<ShotColumnStream>());
+    stream->header = header;
+    shot_log_columns::makeHeader(stream->header, mask);
+    stream->fields = shot_log_batch::fieldCount(mask);
+    stream->rows.reserve(static_cast<size_t>(header.sampleCount) * stream->fields);
+
+    // file is positioned just past the header. The whole shot is decoded here
+    // since every column needs every sample before the first one can be sent.
+    shot_log::Decoder decoder(header.version);
+    const uint32_t limit = header.sampleCount ? header.sampleCount : UINT32_MAX;
+    uint8_t input[256];
+    size_t read;
+    while (stream->count < limit && !decoder.corrupt() && (read = file.read(input, sizeof(input))) > 0) {
+        decoder.feed(input, read, [&](const ShotLogSample &sample) {
+            shot_log_columns::appendRow(stream->rows, sample, mask);
+            return ++stream->count < limit;
+        });
+    }
+    file.close();
+
+    AsyncWebServerResponse *response = request->beginResponse(
+        "application/octet-stream", stream->length(),
+        [stream](uint8_t *buffer, size_t maxLen, size_t index) { return stream->fill(buffer, maxLen, index); });
+    if (etag[0]) {
+        response->addHeader("ETag", etag);
+        response->addHeader("Cache-Control", "no-cache");
+    } else {
+        response->addHeader("Cache-Control", "no-store");
+    }
+    request->send(response);
+}
+
+void WebUIPlugin::handleShotBatch(AsyncWebServerRequest *request, FS *fs) {
+    uint32_t ids[SHOT_BATCH_MAX_SHOTS];
+    const size_t count =
+        request->hasArg("ids") ? shot_log_batch::parseIds(request->arg("ids").c_str(), ids, SHOT_BATCH_MAX_SHOTS) : 0;
+    if (count == 0) {
+        request->send(400, "text/plain", "ids required");
+        return;
+    }
+    auto stream = std::allocate_shared<ShotBatchStream>(PsramStlAllocator<ShotBatchStream>());
+    stream->fs = fs;
+    if (request->hasArg("fieldsMask")) {
+        stream->mask = shot_log_batch::normalizeMask(strtoul(request->arg("fieldsMask").c_str(), nullptr, 0));
+    }
+    stream->chunk = shotLogChunks.acquire();
+    if (stream->chunk == nullptr) {
+        AsyncWebServerResponse *response = request->beginResponse(503, "text/plain", "Busy");
+        response->addHeader("Retry-After", "1");
+        request->send(response);
+        return;
+    }
+    stream->ring = shot_log_batch::ByteRing(stream->chunk, shotLogChunks.CHUNK_SIZE);
+
+    // Plan every section from its header up front: the directory comes first
+    // and the response needs its total length.
+    ShotBatchHeader batchHeader{};
+    batchHeader.magic = SHOT_BATCH_MAGIC;
+    batchHeader.version = SHOT_BATCH_VERSION;
+    batchHeader.count = count;
+    batchHeader.fieldsMask = stream->mask;
+    uint32_t offset = sizeof(batchHeader) + count * sizeof(ShotBatchEntry);
+    stream->directory.resize(offset);
+    memcpy(stream->directory.data(), &batchHeader, sizeof(batchHeader));
+    stream->sections.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        ShotBatchEntry entry{};
+        entry.id = ids[i];
+        entry.offset = offset;
+        File file = fs->open(ShotBatchStream::path(ids[i]), "r");
+        ShotLogHeader header{};
+        if (file && file.read(reinterpret_cast<uint8_t *>(&header), sizeof(header)) == sizeof(header) &&
+            header.magic == SHOT_LOG_MAGIC && (stream->mask == 0 || header.headerSize == SHOT_LOG_HEADER_SIZE)) {
+            entry.sampleCount = header.sampleCount;
+            entry.length = stream->mask ? sizeof(header) + header.sampleCount * shot_log_batch::sampleSize(stream->mask)
+                                        : file.size();
+            if (header.sampleCount == 0) {
+                entry.flags |= SHOT_BATCH_INCOMPLETE;
+            }
+        } else {
+            entry.flags |= SHOT_BATCH_MISSING;
+        }
+        file.close();
+        memcpy(stream->directory.data() + sizeof(batchHeader) + i * sizeof(entry), &entry, sizeof(entry));
+        stream->sections.push_back({entry.id, entry.length, entry.sampleCount});
+        offset += entry.length;
+    }
+
+    AsyncWebServerResponse *response = request->beginResponse(
+        "application/octet-stream", offset,
+        [stream](uint8_t *buffer, size_t maxLen, size_t) -> size_t { return stream->fill(buffer, maxLen); });
+    response->addHeader("Cache-Control", "no-store");
+    request->send(response);
+}
+
 void WebUIPlugin::setupServer() {
     server.on("/connecttest.txt", [](AsyncWebServerRequest *request) {
         request->redirect("http://logout.net");
@@ -348,14 +628,22 @@ void WebUIPlugin::setupServer() {
     if (controller->isSDCard()) {
         fs = &SD_MMC;
     }
-    server.serveStatic("/api/history/", *fs, "/h/").setCacheControl("no-store");
-    server.on("/api/history/index.bin", HTTP_GET, [this, fs](AsyncWebServerRequest *request) {
-        // Serve the binary index file directly
-        if (fs->exists("/h/index.bin")) {
-            request->send(*fs, "/h/index.bin", "application/octet-stream");
-        } else {
+    server.on("/api/history/index.bin", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        // Served from ShotHistory's in-memory index rather than /h/index.bin,
+        // which trails it by up to one write-behind flush. The entry count is
+        // fixed up front so the length stays valid if a shot is appended mid-send.
+        if (!ShotHistory.ensureIndexExists()) {
             request->send(404, "text/plain", "Index not found");
+            return;
         }
+        const uint32_t count = ShotHistory.indexEntryCount();
+        const size_t size = sizeof(ShotIndexHeader) + count * sizeof(ShotIndexEntry);
+        AsyncWebServerResponse *response =
+            request->beginResponse("application/octet-stream", size, [count](uint8_t *buffer, size_t maxLen, size_t index) {
+                return ShotHistory.readIndexImage(buffer, maxLen, index, count);
+            });
+        response->addHeader("Cache-Control", "no-store");
+        request->send(response);
     });
     server.on("/api/history/recent.bin", HTTP_GET, [this](AsyncWebServerRequest *request) {
         // The most recent non-deleted shots, newest first, as a regular shot
@@ -388,6 +676,42 @@ void WebUIPlugin::setupServer() {
         free(entries);
         request->send(response);
     });
+    server.on("/api/history/query", HTTP_GET, [this](AsyncWebServerRequest *request) {
+        // Filtered/sorted/paged view of the index in the index.bin layout; same
+        // parameters as req:history:query. X-Total-Count is the match count
+        // before paging.
+        JsonDocument params(&psramAllocator);
+        for (const char *name : SHOT_HISTORY_QUERY_PARAMS) {
+            if (request->hasArg(name)) {
+                params[name] = request->arg(name);
+            }
+        }
+        ShotIndexQuery query;
+        ShotHistoryPlugin::parseQuery(params.as<JsonVariantConst>(), query);
+        auto result = std::make_shared<ShotHistoryBuffer>();
+        const size_t total = ShotHistory.queryIndex(query, *result);
+
+        AsyncWebServerResponse *response = request->beginResponse(
+            "application/octet-stream", result->size(), [result](uint8_t *buffer, size_t maxLen, size_t index) -> size_t {
+                if (index >= result->size()) {
+                    return 0;
+                }
+                const size_t len = std::min(maxLen, result->size() - index);
+                memcpy(buffer, result->data() + index, len);
+                return len;
+            });
+        response->addHeader("Cache-Control", "no-store");
+        response->addHeader("X-Total-Count", String(total));
+        request->send(response);
+    });
+    server.on("/api/history/batch", HTTP_GET, [this, fs](AsyncWebServerRequest *request) { handleShotBatch(request, fs); });
+    // Shot files get their own handler (Range, ETag, pooled read-ahead); notes
+    // and the other files in /h/ stay with serveStatic below.
+    server.on("/api/history/*", HTTP_GET, [this, fs](AsyncWebServerRequest *request) { handleShotLogDownload(request, fs); })
+        .setFilter([](AsyncWebServerRequest *request) { return request->url().endsWith(".slog"); });
+    // Registered after the index.bin/recent.bin handlers so those win over the
+    // static files in /h/.
+    server.serveStatic("/api/history/", *fs, "/h/").setCacheControl("no-store");
     server.on("/api/core-dump", HTTP_GET, [this](AsyncWebServerRequest *request) { handleCoreDumpDownload(request); });
     // The web UI is embedded in firmware flash and served from the memory-mapped blob (see serveWebAsset). It is no
     // longer in LittleFS, so OTA never touches the partition holding profiles/shots. The catch-all onNotFound handles
@@ -403,12 +727,20 @@ void WebUIPlugin::setupServer() {
                 // queued frames / AsyncTCP buffers reclaimed, so they accumulate
                 // in internal DRAM until the whole IP stack starves (web + ICMP
                 // die, no recovery). Reclaiming via close is the safer failure
-                // mode. (Was the v1.8.1 behaviour.)
+                // mode. (Was the v1.8.1 behaviour.) The periodic status stops
+                // being queued to a client well before that (see sendStatus), so
+                // a merely slow client gets less frequent status instead.
                 client->setCloseClientOnQueueFull(true);
+                {
+                    std::lock_guard<std::mutex> lock(statusClientsMutex);
+                    statusClients.push_back(StatusClient{client->id(), client});
+                }
                 ESP_LOGI("WebUIPlugin", "WebSocket client connected (%d open connections)", server->getClients().size());
             } else if (type == WS_EVT_DISCONNECT) {
                 ESP_LOGI("WebUIPlugin", "WebSocket client disconnected (%d open connections)", server->getClients().size());
                 rxBuffers.erase(client->id());
+                removeLiveSubscriber(client->id());
+                removeStatusClient(client->id());
             } else if (type == WS_EVT_DATA) {
                 handleWebSocketData(server, client, type, arg, data, len);
             }
@@ -533,13 +865,28 @@ void WebUIPlugin::handleWebSocketData(AsyncWebSocket *server, AsyncWebSocketClie
                     }
                     resp["msg"] = "Rebuild started";
                     client->text(toWsBuffer(resp));
-                    ShotHistory.startAsyncRebuild();
+                    // "mode": "incremental" only rescans changed shots; the default rebuilds from scratch
+                    ShotHistory.startAsyncRebuild(doc["mode"] == "incremental");
+                } else if (msgType == "req:history:live") {
+                    handleLiveSubscription(client->id(), doc);
                 } else if (msgType.startsWith("req:history")) {
                     JsonDocument resp(&psramAllocator);
-                    ShotHistory.handleRequest(doc, resp);
+                    ShotHistoryBuffer binary;
+                    ShotHistory.handleRequest(doc, resp, &binary);
                     client->text(toWsBuffer(resp));
+                    if (!binary.empty()) {
+                        auto frame = makePsramWsBuffer(binary.size());
+                        memcpy(frame->data(), binary.data(), binary.size());
+                        client->binary(frame);
+                    }
                 } else if (msgType == "req:flush:start") {
                     handleFlushStart(client->id(), doc);
+                } else if (msgType == "req:status:subscribe") {
+                    handleStatusSubscription(client->id(), doc);
+                } else if (msgType == "req:status:stats") {
+                    handleStatusStats(client->id(), doc);
+                } else if (msgType == "req:events:trace") {
+                    handleEventTrace(client->id(), doc);
                 }
             }
         }
@@ -548,6 +895,433 @@ void WebUIPlugin::handleWebSocketData(AsyncWebSocket *server, AsyncWebSocketClie
     }
 }
 
+void WebUIPlugin::handleLiveSubscription(uint32_t clientId, JsonDocument &request) {
+    const bool enable = request["enable"] | true;
+    if (enable) {
+        std::lock_guard<std::mutex> lock(liveSubscribersMutex);
+        if (std::find(liveSubscribers.begin(), liveSubscribers.end(), clientId) == liveSubscribers.end()) {
+            liveSubscribers.push_back(clientId);
+        }
+        ShotHistory.setLiveStreaming(true); // also re-sends START if a shot is running
+    } else {
+        removeLiveSubscriber(clientId);
+    }
+
+    JsonDocument response(&psramAllocator);
+    response["tp"] = "res:history:live";
+    if (request["rid"].is<const char *>()) {
+        response["rid"] = request["rid"];
+    }
+    response["enabled"] = enable;
+    ws.text(clientId, toWsBuffer(response));
+}
+
+void WebUIPlugin::removeLiveSubscriber(uint32_t clientId) {
+    std::lock_guard<std::mutex> lock(liveSubscribersMutex);
+    liveSubscribers.erase(std::remove(liveSubscribers.begin(), liveSubscribers.end(), clientId), liveSubscribers.end());
+    if (liveSubscribers.empty()) {
+        ShotHistory.setLiveStreaming(false);
+    }
+}
+
+// One PSRAM copy of the frame, shared by the send queues of all subscribers.
+// The AsyncWebSocket lock must never be taken under liveSubscribersMutex: the
+// library raises WS_EVT_DISCONNECT holding it, and that handler takes ours
+// (removeLiveSubscriber). So the subscribers are copied and sent to unlocked.
+void WebUIPlugin::sendLiveFrame(const uint8_t *frame, size_t len) {
+    std::vector<uint32_t> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(liveSubscribersMutex);
+        subscribers = liveSubscribers;
+    }
+    if (subscribers.empty()) {
+        return;
+    }
+    auto buffer = makePsramWsBuffer(len);
+    memcpy(buffer->data(), frame, len);
+    std::vector<uint32_t> dropped;
+    for (uint32_t clientId : subscribers) {
+        if (!ws.binary(clientId, buffer)) {
+            dropped.push_back(clientId);
+        }
+    }
+    countDrops(dropped);
+}
+
+void WebUIPlugin::handleStatusSubscription(uint32_t clientId, JsonDocument &request) {
+    const bool binary = request["format"] == "binary";
+    const unsigned long activePeriod =
+        std::clamp<unsigned long>(request["brewInterval"] | STATUS_PERIOD, STATUS_MIN_PERIOD, STATUS_PERIOD);
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(statusClientsMutex);
+        for (StatusClient &client : statusClients) {
+            if (client.id == clientId) {
+                client.binary = binary;
+                client.activePeriod = activePeriod;
+                client.lastSent = 0; // send now, as a keyframe
+                client.encoder.reset();
+                found = true;
+            }
+        }
+    }
+
+    JsonDocument response(&psramAllocator);
+    response["tp"] = "res:status:subscribe";
+    if (request["rid"].is<const char *>()) {
+        response["rid"] = request["rid"];
+    }
+    response["success"] = found;
+    response["format"] = binary ? "binary" : "json";
+    response["brewInterval"] = activePeriod;
+    ws.text(clientId, toWsBuffer(response));
+}
+
+void WebUIPlugin::handleStatusStats(uint32_t clientId, JsonDocument &request) {
+    JsonDocument response(&psramAllocator);
+    response["tp"] = "res:status:stats";
+    if (request["rid"].is<const char *>()) {
+        response["rid"] = request["rid"];
+    }
+    {
+        std::lock_guard<std::mutex> lock(statusClientsMutex);
+        response["ms"] = millis() - statsSince;
+        const std::pair<const char *, StatusPathStats *> paths[] = {
+            {"json", &jsonStats}, {"binary", &binaryStats}, {"collect", &collectStats}};
+        for (const auto &path : paths) {
+            auto obj = response[path.first].to<JsonObject>();
+            obj["frames"] = path.second->frames;
+            obj["bytes"] = path.second->bytes;
+            obj["us"] = path.second->us;
+        }
+        auto clients = response["clients"].to<JsonArray>();
+        for (StatusClient &client : statusClients) {
+            auto obj = clients.add<JsonObject>();
+            obj["id"] = client.id;
+            obj["format"] = client.binary ? "binary" : "json";
+            obj["backoff"] = client.backoff;
+            obj["depth"] = client.queueDepth;
+            obj["maxDepth"] = client.maxQueueDepth;
+            obj["sent"] = client.sent;
+            obj["coalesced"] = client.coalesced;
+            obj["drops"] = client.drops;
+        }
+        if (request["reset"] | false) {
+            jsonStats = binaryStats = collectStats = StatusPathStats{};
+            statsSince = millis();
+            for (StatusClient &client : statusClients) {
+                client.maxQueueDepth = 0;
+                client.sent = client.coalesced = client.drops = 0;
+            }
+        }
+    }
+    ws.text(clientId, toWsBuffer(response));
+}
+
+void WebUIPlugin::handleEventTrace(uint32_t clientId, JsonDocument &request) {
+    JsonDocument response(&psramAllocator);
+    response["tp"] = "res:events:trace";
+    if (request["rid"].is<const char *>()) {
+        response["rid"] = request["rid"];
+    }
+    const std::pair<const char *, EventDelivery> lanes[] = {{"async", EventDelivery::ASYNC},
+                                                            {"asyncLow", EventDelivery::ASYNC_LOW}};
+    auto lanesObj = response["lanes"].to<JsonObject>();
+    for (const auto &lane : lanes) {
+        const EventLaneStats stats = pluginManager->getLaneStats(lane.second);
+        auto obj = lanesObj[lane.first].to<JsonObject>();
+        obj["queued"] = stats.queued;
+        obj["dropped"] = stats.dropped;
+        obj["maxDepth"] = stats.maxDepth;
+    }
+#ifdef GAGGIMATE_EVENT_TRACE
+    response["enabled"] = true;
+    EventTrace &trace = pluginManager->getTrace();
+    const size_t top = std::min<size_t>(request["top"] | 10, 20);
+    const size_t recentCount = std::min<size_t>(request["recent"] | 0, 64);
+    response["us"] = trace.sinceUs();
+    response["untraced"] = trace.untracedEvents();
+
+    // Copied out of the tracer first, into PSRAM like the response
+    std::vector<EventTraceEvent, PsramStlAllocator<EventTraceEvent>> topEvents(top);
+    topEvents.resize(trace.topEvents(topEvents.data(), top));
+    auto events = response["events"].to<JsonArray>();
+    for (const EventTraceEvent &e : topEvents) {
+        auto obj = events.add<JsonObject>();
+        obj["event"] = e.name;
+        obj["calls"] = e.sync.calls;
+        obj["us"] = e.sync.totalUs;
+        obj["maxUs"] = e.sync.maxUs;
+        obj["maxDepth"] = e.maxDepth;
+        obj["asyncCalls"] = e.async.calls;
+        obj["asyncUs"] = e.async.totalUs;
+        obj["asyncMaxUs"] = e.async.maxUs;
+    }
+
+    std::vector<EventTraceListener, PsramStlAllocator<EventTraceListener>> topListeners(top);
+    topListeners.resize(trace.topListeners(topListeners.data(), top));
+    auto listeners = response["listeners"].to<JsonArray>();
+    char label[64];
+    for (const EventTraceListener &l : topListeners) {
+        auto obj = listeners.add<JsonObject>();
+        EventTrace::label(l.label, label, sizeof(label));
+        obj["event"] = l.event;
+        obj["listener"] = label;
+        obj["mode"] = l.async ? "async" : "sync";
+        obj["calls"] = l.timing.calls;
+        obj["us"] = l.timing.totalUs;
+        obj["maxUs"] = l.timing.maxUs;
+    }
+
+    if (recentCount > 0) {
+        std::vector<EventTraceRecord, PsramStlAllocator<EventTraceRecord>> records(recentCount);
+        records.resize(trace.recent(records.data(), recentCount));
+        auto recent = response["recent"].to<JsonArray>();
+        for (const EventTraceRecord &r : records) {
+            auto obj = recent.add<JsonObject>();
+            obj["at"] = r.atUs;
+            obj["event"] = trace.eventName(r.id);
+            if (r.listener != EVENT_TRACE_NO_LISTENER) {
+                EventTrace::label(trace.listenerLabel(r.listener), label, sizeof(label));
+                obj["listener"] = label;
+            }
+            obj["depth"] = r.depth;
+            obj["us"] = r.us;
+        }
+    }
+
+    if (request["print"] | false) {
+        trace.print(top);
+    }
+    if (request["reset"] | false) {
+        trace.reset();
+    }
+#else
+    response["enabled"] = false;
+#endif
+    ws.text(clientId, toWsBuffer(response));
+}
+
+void WebUIPlugin::removeStatusClient(uint32_t clientId) {
+    std::lock_guard<std::mutex> lock(statusClientsMutex);
+    statusClients.erase(std::remove_if(statusClients.begin(), statusClients.end(),
+                                       [clientId](const StatusClient &client) { return client.id == clientId; }),
+                        statusClients.end());
+}
+
+void WebUIPlugin::countDrops(const std::vector<uint32_t> &clientIds) {
+    if (clientIds.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(statusClientsMutex);
+    for (StatusClient &client : statusClients) {
+        client.drops += std::count(clientIds.begin(), clientIds.end(), client.id);
+    }
+}
+
+// One snapshot per tick, shared by every client that is due: JSON clients get
+// one serialized document, binary clients each get their own delta. A client
+// with a backed-up send queue is skipped (coalesced) and polled less often.
+void WebUIPlugin::sendStatus(unsigned long now) {
+    const bool active = controller->isActive();
+    // Due a quarter period early, so clients on the same period line up on one snapshot
+    auto isDue = [&](const StatusClient &client) {
+        const unsigned long period = (active ? client.activePeriod : STATUS_PERIOD) * client.backoff;
+        return now - client.lastSent + period / 4 >= period;
+    };
+    // Queue depths are read under statusClientsMutex, which keeps the library
+    // from freeing a client in the meantime (see StatusClient::socket). Only the
+    // client's own queue lock is taken under it, never the AsyncWebSocket one
+    // (the same holds for liveSubscribersMutex, see sendLiveFrame).
+    std::vector<std::pair<uint32_t, size_t>> due; // client id, send-queue depth
+    {
+        std::lock_guard<std::mutex> lock(statusClientsMutex);
+        for (const StatusClient &client : statusClients) {
+            if (isDue(client)) {
+                due.emplace_back(client.id, client.socket->queueLen());
+            }
+        }
+    }
+    if (due.empty()) {
+        return;
+    }
+
+    // The snapshot is collected without holding statusClientsMutex (it takes the process lock)
+    unsigned long started = micros();
+    collectStatus(status);
+    const unsigned long collectUs = micros() - started;
+
+    std::vector<uint32_t> jsonClients;
+    std::vector<std::pair<uint32_t, AsyncWebSocketSharedBuffer>> binaryFrames;
+    {
+        std::lock_guard<std::mutex> lock(statusClientsMutex);
+        collectStats.frames++;
+        collectStats.us += collectUs;
+        if (statusFrame.empty()) {
+            statusFrame.resize(status_frame::maxFrameSize());
+        }
+        for (StatusClient &client : statusClients) {
+            auto entry = std::find_if(due.begin(), due.end(), [&](const auto &e) { return e.first == client.id; });
+            if (entry == due.end()) {
+                continue;
+            }
+            const size_t depth = entry->second;
+            client.lastSent = now;
+            client.queueDepth = depth;
+            client.maxQueueDepth = std::max(client.maxQueueDepth, depth);
+            if (depth >= STATUS_QUEUE_HIGH) {
+                // Nothing is lost: the next frame carries the latest values
+                // (for binary clients, every change since the last one sent).
+                client.coalesced++;
+                client.backoff = std::min<uint8_t>(client.backoff * 2, STATUS_MAX_BACKOFF);
+                continue;
+            }
+            if (depth <= STATUS_QUEUE_LOW && client.backoff > 1) {
+                client.backoff /= 2;
+            }
+            client.sent++;
+            if (!client.binary) {
+                jsonClients.push_back(client.id);
+                continue;
+            }
+            started = micros();
+            const size_t len = client.encoder.encode(status, statusFrame.data());
+            auto buffer = makePsramWsBuffer(len);
+            memcpy(buffer->data(), statusFrame.data(), len);
+            binaryStats.us += micros() - started;
+            binaryStats.frames++;
+            binaryStats.bytes += len;
+            binaryFrames.emplace_back(client.id, buffer);
+        }
+    }
+
+    std::vector<uint32_t> dropped;
+    if (!jsonClients.empty()) {
+        started = micros();
+        status_frame::writeJson(statusDoc, status);
+        auto buffer = toWsBuffer(statusDoc);
+        const unsigned long jsonUs = micros() - started;
+        for (uint32_t clientId : jsonClients) {
+            if (!ws.text(clientId, buffer)) {
+                dropped.push_back(clientId);
+            }
+        }
+        std::lock_guard<std::mutex> lock(statusClientsMutex);
+        jsonStats.us += jsonUs;
+        jsonStats.frames += jsonClients.size();
+        jsonStats.bytes += buffer->size() * jsonClients.size();
+    }
+    for (auto &frame : binaryFrames) {
+        if (!ws.binary(frame.first, frame.second)) {
+            dropped.push_back(frame.first);
+        }
+    }
+    countDrops(dropped);
+}
+
+void WebUIPlugin::collectStatus(StatusSnapshot &s) {
+    s = StatusSnapshot{};
+    const SystemInfo systemInfo = controller->getSystemInfo();
+    const Profile &profile = profileManager->getSelectedProfile();
+    s.currentTemp = round_to(controller->getCurrentTemp(), 3);
+    s.targetTemp = controller->getTargetTemp();
+    s.pressure = round_to(controller->getCurrentPressure(), 3);
+    s.pumpFlow = round_to(controller->getCurrentPumpFlow(), 3);
+    s.targetPressure = controller->getTargetPressure();
+    s.mode = controller->getMode();
+    status_frame::copyText(s.profileName, profile.label.c_str());
+    status_frame::copyText(s.profileId, profile.id.c_str());
+    s.capPressure = systemInfo.capabilities.pressure;
+    s.capDimming = systemInfo.capabilities.dimming;
+    s.capGrind = systemInfo.capabilities.hasAddon(7);
+    s.targetWeight = profile.getTotalVolume(); // total target weight for the process
+    s.volumetric = controller->isVolumetricAvailable() ? 1 : 0;
+    s.brewTarget = controller->isVolumetricAvailable() && profile.isVolumetric() ? 1 : 0;
+    s.brewDuration = profile.getTotalDuration();
+    s.capLed = systemInfo.capabilities.ledControl;
+    s.grindDuration = controller->getTargetGrindDuration();
+    s.grindVolume = controller->getSettings().getTargetGrindVolume();
+    s.grindTarget = controller->isVolumetricAvailable() && controller->getSettings().isVolumetricTarget() ? 1 : 0;
+    s.grindActive = controller->isGrindActive() ? 1 : 0;
+    s.waterLevel = controller->getWaterLevel();
+    s.tofDistance = controller->getTofDistance();
+    s.latency = -1; // BLE round-trip latency (ms); -1 = not yet measured
+    s.pumpPower = controller->getCurrentPumpPower();
+    s.heaterPower = round_to(controller->getCurrentHeaterPower(), 3);
+
+    if (controller->getClientController()->getClient()->isConnected()) {
+        s.rssi = controller->getClientController()->getClient()->getRssi();
+    }
+    if (controller->getClientController()->hasLatency()) {
+        s.latency = controller->getClientController()->getLatencyMs();
+    }
+
+    const bool bleConnected = BLEScales.isConnected();
+    s.scaleWeight = bleConnected ? this->currentBluetoothWeight : 0; // current bluetooth weight
+    s.scaleConnected = bleConnected;                                 // bluetooth scale connected status
+    // Scale battery — only surfaced when the driver reports one and the
+    // value isn't the UNKNOWN sentinel (255). UI omits the battery pill
+    // entirely when `sbat` is absent, so disconnected/unknown scales don't
+    // render a stale stub.
+    s.scaleBattery = STATUS_NO_BATTERY;
+    if (bleConnected && BLEScales.hasBatteryLevel()) {
+        const uint8_t pct = BLEScales.getBatteryLevel();
+        if (pct != REMOTE_SCALES_BATTERY_UNKNOWN) {
+            s.scaleBattery = pct;
+        }
+    }
+
+    // Deref under the process lock — other tasks delete the process at any time (GM-147).
+    // Released before sending so the ws send never runs under the lock.
+    std::lock_guard<std::recursive_mutex> processGuard(controller->getProcessLock());
+    Process *process = controller->getProcess();
+    if (process == nullptr) {
+        process = controller->getLastProcess();
+    }
+    s.processActive = STATUS_NO_PROCESS;
+    if (process == nullptr) {
+        return;
+    }
+    s.processActive = controller->isActive() ? 1 : 0;
+    s.puckResistance = round_to(controller->getCurrentPuckResistance(), 3);
+    s.puckFlow = round_to(controller->getCurrentPuckFlow(), 3);
+    s.targetFlow = controller->getTargetFlow();
+    s.processState = STATUS_PROCESS_OTHER;
+    if (process->getType() == MODE_BREW) {
+        auto *brew = static_cast<BrewProcess *>(process);
+        unsigned long ts = brew->isActive() && controller->isActive() ? millis() : brew->finished;
+        s.processState = brew->currentPhase.phase == PhaseType::PHASE_TYPE_BREW ? STATUS_PROCESS_BREW : STATUS_PROCESS_INFUSION;
+        status_frame::copyText(s.processLabel, brew->isActive() ? brew->currentPhase.name.c_str() : "Finished");
+        s.processElapsed = ts - brew->processStarted;
+        const bool isVolumetric = brew->target == ProcessTarget::VOLUMETRIC && brew->currentPhase.hasVolumetricTarget() &&
+                                  controller->isVolumetricAvailable();
+        s.processVolumetric = isVolumetric;
+        if (isVolumetric) {
+            Target t = brew->currentPhase.getVolumetricTarget();
+            s.processTarget = t.value;
+            s.processProgress = brew->currentVolume;
+        } else {
+            s.processTarget = brew->getPhaseDuration();
+            s.processProgress = ts - brew->currentPhaseStarted;
+        }
+    } else if (process->getType() == MODE_GRIND) {
+        auto *grind = static_cast<GrindProcess *>(process);
+        unsigned long ts = grind->isActive() && controller->isActive() ? millis() : grind->finished;
+        s.processState = STATUS_PROCESS_GRIND;
+        status_frame::copyText(s.processLabel, grind->isActive() ? "Grinding" : "Finished");
+        s.processElapsed = ts - grind->started;
+        const bool isVolumetric = grind->target == ProcessTarget::VOLUMETRIC && controller->isVolumetricAvailable();
+        s.processVolumetric = isVolumetric;
+        if (isVolumetric) {
+            s.processTarget = grind->grindVolume;
+            s.processProgress = grind->currentVolume;
+        } else {
+            s.processTarget = grind->time;
+            s.processProgress = ts - grind->started;
+        }
+    }
+}
+
 void WebUIPlugin::handleOTASettings(uint32_t clientId, JsonDocument &request) {
     if (request["update"].as<bool>()) {
         if (!request["channel"].isNull()) {
@@ -716,6 +1490,13 @@ void WebUIPlugin::handleSettings(AsyncWebServerRequest *request) const {
                 settings->setBrewDelay(request->arg("brewDelay").toDouble());
             if (request->hasArg("grindDelay"))
                 settings->setGrindDelay(request->arg("grindDelay").toDouble());
+            if (request->hasArg("historyInterval"))
+                settings->setHistoryInterval(request->arg("historyInterval").toInt());
+            if (request->hasArg("historyQuotaMb"))
+                settings->setHistoryQuotaMb(request->arg("historyQuotaMb").toInt());
+            if (request->hasArg("historyEviction"))
+                settings->setHistoryEviction(request->arg("historyEviction").toInt());
+            settings->setHistoryProtectAnnotated(request->hasArg("historyProtectAnnotated"));
             if (request->hasArg("timezone"))
                 settings->setTimezone(request->arg("timezone"));
             settings->setClockFormat(request->hasArg("clock24hFormat"));
@@ -844,6 +1625,10 @@ void WebUIPlugin::handleSettings(AsyncWebServerRequest *request) const {
     doc["brewDelay"] = settings.getBrewDelay();
     doc["grindDelay"] = settings.getGrindDelay();
     doc["delayAdjust"] = settings.isDelayAdjust();
+    doc["historyInterval"] = settings.getHistoryInterval();
+    doc["historyQuotaMb"] = settings.getHistoryQuotaMb();
+    doc["historyEviction"] = settings.getHistoryEviction();
+    doc["historyProtectAnnotated"] = settings.isHistoryProtectAnnotated();
     doc["timezone"] = settings.getTimezone();
     doc["clock24hFormat"] = settings.isClock24hFormat();
     doc["standbyTimeout"] = settings.getStandbyTimeout() / 1000;
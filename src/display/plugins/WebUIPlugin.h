@@ -9,11 +9,22 @@
 #include <ArduinoJson.h>
 #include <ESPAsyncWebServer.h>
 #include <display/core/Plugin.h>
+#include <display/models/shot_log_format.h>
+#include <display/models/status_frame.h>
 #include <display/util/PsramAllocator.h>
+#include <mutex>
+#include <vector>
 
 constexpr size_t UPDATE_CHECK_INTERVAL = 30 * 60 * 1000;
 constexpr size_t CLEANUP_PERIOD = 1000;
 constexpr size_t STATUS_PERIOD = 500;
+constexpr size_t STATUS_MIN_PERIOD = 100; // fastest brewInterval a client may ask for
+// Send-queue depth (messages) at which a client's status is coalesced rather
+// than queued, and at or below which its status rate recovers. The library
+// closes a client at WS_MAX_QUEUED_MESSAGES (32).
+constexpr size_t STATUS_QUEUE_HIGH = 8;
+constexpr size_t STATUS_QUEUE_LOW = 2;
+constexpr uint8_t STATUS_MAX_BACKOFF = 8; // slowest status: every 8 periods
 constexpr size_t DNS_PERIOD = 50;
 
 const String LOCAL_URL = "http://4.4.4.1/";
@@ -21,6 +32,37 @@ const String RELEASE_URL = "https://github.com/jniebuhr/gaggimate/releases/";
 
 class ProfileManager;
 
+// Status delivery for one websocket client. Everyone gets JSON evt:status every
+// STATUS_PERIOD until it subscribes with req:status:subscribe, which can switch
+// it to binary frames (see status_frame.h) and a faster rate while a process runs.
+// A client whose send queue backs up is not sent more: its status is coalesced
+// (the next frame carries the latest values) and its period backs off until the
+// queue drains.
+struct StatusClient {
+    uint32_t id;
+    // Valid while the entry exists: the library raises WS_EVT_DISCONNECT, which
+    // removes the entry under statusClientsMutex, before it frees the client.
+    AsyncWebSocketClient *socket;
+    bool binary = false;
+    unsigned long activePeriod = STATUS_PERIOD; // while a process is active
+    unsigned long lastSent = 0;
+    uint8_t backoff = 1; // period multiplier, up to STATUS_MAX_BACKOFF
+    status_frame::Encoder encoder;
+    // Send-queue accounting, for req:status:stats
+    size_t queueDepth = 0; // at the last status tick
+    size_t maxQueueDepth = 0;
+    uint32_t sent = 0;      // status frames queued
+    uint32_t coalesced = 0; // status frames skipped for a backed-up queue
+    uint32_t drops = 0;     // messages of any kind the library refused
+};
+
+// What each status path costs, for req:status:stats
+struct StatusPathStats {
+    uint32_t frames = 0;
+    uint64_t bytes = 0;
+    uint64_t us = 0; // CPU time building the frames
+};
+
 class WebUIPlugin : public Plugin {
   public:
     WebUIPlugin();
@@ -40,11 +82,30 @@ class WebUIPlugin : public Plugin {
     void handleAutotuneStart(uint32_t clientId, JsonDocument &request);
     void handleProfileRequest(uint32_t clientId, JsonDocument &request);
     void handleFlushStart(uint32_t clientId, JsonDocument &request);
+    void handleLiveSubscription(uint32_t clientId, JsonDocument &request); // req:history:live
+    void removeLiveSubscriber(uint32_t clientId);
+    void sendLiveFrame(const uint8_t *frame, size_t len); // ShotHistory's live listener
+    void handleStatusSubscription(uint32_t clientId, JsonDocument &request); // req:status:subscribe
+    void handleStatusStats(uint32_t clientId, JsonDocument &request);        // req:status:stats
+    void handleEventTrace(uint32_t clientId, JsonDocument &request);         // req:events:trace
+    void removeStatusClient(uint32_t clientId);
+    void countDrops(const std::vector<uint32_t> &clientIds);
+
+    // Status broadcast
+    void sendStatus(unsigned long now);
+    void collectStatus(StatusSnapshot &snapshot);
 
     // HTTP handlers
     // Serves the web UI from the firmware-embedded, memory-mapped flash blob
     // (catch-all for any path not claimed by an explicit route). [GM-106]
     void serveWebAsset(AsyncWebServerRequest *request);
+    // /api/history/<id>.slog with Range, ETag/If-None-Match and pooled PSRAM read-ahead
+    void handleShotLogDownload(AsyncWebServerRequest *request, FS *fs);
+    // ?fieldsMask=..: the selected fields of one shot, column-major (see shot_log_columns.h)
+    void sendShotColumns(AsyncWebServerRequest *request, File &file, const ShotLogHeader &header, uint32_t mask,
+                         const char *etag);
+    // /api/history/batch?ids=..&fieldsMask=..: many shots in one container (see shot_log_batch.h)
+    void handleShotBatch(AsyncWebServerRequest *request, FS *fs);
     void handleSettings(AsyncWebServerRequest *request) const;
     void handleBLEScaleList(AsyncWebServerRequest *request);
     void handleBLEScaleScan(AsyncWebServerRequest *request);
@@ -69,7 +130,6 @@ class WebUIPlugin : public Plugin {
     ProfileManager *profileManager = nullptr;
 
     long lastUpdateCheck = 0;
-    long lastStatus = 0;
     long lastCleanup = 0;
     long lastDns = 0;
     bool updating = false;
@@ -83,6 +143,20 @@ class WebUIPlugin : public Plugin {
     // stall mid-asset-serve). Keeping one doc lets its underlying pool grow
     // once and stay put.
     JsonDocument statusDoc{&psramAllocator};
+    // Clients subscribed to the live shot stream. Changed from the websocket
+    // handlers, read from the history task, so guarded by liveSubscribersMutex.
+    std::vector<uint32_t> liveSubscribers;
+    std::mutex liveSubscribersMutex;
+    // Every connected client and how it wants its status. Changed from the
+    // websocket handlers, read from loop(), so guarded by statusClientsMutex.
+    std::vector<StatusClient> statusClients;
+    std::mutex statusClientsMutex;
+    StatusSnapshot status{};
+    std::vector<uint8_t> statusFrame; // encoder output, status_frame::maxFrameSize()
+    StatusPathStats jsonStats;
+    StatusPathStats binaryStats;
+    StatusPathStats collectStats; // gathering the snapshot, shared by both paths
+    unsigned long statsSince = 0;
 };
 
 #endif // WEBUIPLUGIN_H
@@ -103,22 +103,10 @@ DefaultUI::DefaultUI(Controller *controller, Driver *driver, PluginManager *plug
 void DefaultUI::init() {
     profileManager = controller->getProfileManager();
     auto triggerRender = [this](Event const &) { rerender = true; };
-    pluginManager->on("boiler:currentTemperature:change", [=](Event const &event) {
-        int newTemp = static_cast<int>(event.getFloat("value"));
-        if (newTemp != currentTemp) {
-            currentTemp = newTemp;
-            rerender = true;
-        }
-    });
-    pluginManager->on("boiler:pressure:change", [=](Event const &event) {
-        float newPressure = event.getFloat("value");
-        if (round(newPressure * 10.0f) != round(pressure * 10.0f)) {
-            pressure = newPressure;
-            rerender = true;
-        }
-    });
-    pluginManager->on("boiler:targetTemperature:change", [=](Event const &event) {
-        int newTemp = static_cast<int>(event.getFloat("value"));
+    pluginManager->on(events::BOILER_CURRENT_TEMPERATURE_CHANGE, temperatureSlot);
+    pluginManager->on(events::BOILER_PRESSURE_CHANGE, pressureSlot);
+    pluginManager->on(events::BOILER_TARGET_TEMPERATURE_CHANGE, [=](Event const &event) {
+        int newTemp = static_cast<int>(event.as<TempChanged>().value);
         if (newTemp != targetTemp) {
             targetTemp = newTemp;
             rerender = true;
@@ -130,8 +118,8 @@ void DefaultUI::init() {
     pluginManager->on("controller:grindVolume:change", [=](Event const &event) { rerender = true; });
     pluginManager->on("controller:process:end", triggerRender);
     pluginManager->on("controller:process:start", triggerRender);
-    pluginManager->on("controller:mode:change", [this](Event const &event) {
-        mode = event.getInt("value");
+    pluginManager->on(events::CONTROLLER_MODE_CHANGE, [this](Event const &event) {
+        mode = event.as<ModeChanged>().value;
         switch (mode) {
         case MODE_STANDBY:
             changeScreen(SCREEN_ID_STANDBY_SCREEN);
@@ -218,18 +206,39 @@ void DefaultUI::init() {
     pluginManager->on("profiles:profile:favorite", [this](Event const &event) { reloadProfiles(); });
     pluginManager->on("profiles:profile:unfavorite", [this](Event const &event) { reloadProfiles(); });
     pluginManager->on("profiles:profile:save", [this](Event const &event) { reloadProfiles(); });
-    pluginManager->on("controller:volumetric-measurement:bluetooth:change", [=](Event const &event) {
-        double newWeight = event.getFloat("value");
+    pluginManager->on(events::VOLUMETRIC_BLUETOOTH_CHANGE, bluetoothWeightSlot);
+    xTaskCreatePinnedToCore(profileLoopTask, "DefaultUI::loopProfiles", configMINIMAL_STACK_SIZE * 4, this, 1, &profileTaskHandle,
+                            0);
+}
+
+void DefaultUI::pollSensors() {
+    TempChanged temperature;
+    if (temperatureSlot.poll(temperature)) {
+        int newTemp = static_cast<int>(temperature.value);
+        if (newTemp != currentTemp) {
+            currentTemp = newTemp;
+            rerender = true;
+        }
+    }
+    PressureChanged newPressure;
+    if (pressureSlot.poll(newPressure)) {
+        if (round(newPressure.value * 10.0f) != round(pressure * 10.0f)) {
+            pressure = newPressure.value;
+            rerender = true;
+        }
+    }
+    WeightChanged weight;
+    if (bluetoothWeightSlot.poll(weight)) {
+        double newWeight = weight.value;
         if (round(newWeight * 10.0) != round(bluetoothWeight * 10.0)) {
             bluetoothWeight = newWeight;
             rerender = true;
         }
-    });
-    xTaskCreatePinnedToCore(profileLoopTask, "DefaultUI::loopProfiles", configMINIMAL_STACK_SIZE * 4, this, 1, &profileTaskHandle,
-                            0);
+    }
 }
 
 void DefaultUI::loop() {
+    pollSensors();
     const unsigned long now = ::millis();
     const unsigned long diff = now - lastRender;
 
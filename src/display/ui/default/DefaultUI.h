@@ -91,6 +91,7 @@ class DefaultUI {
     int isTemperatureStable = false;
     unsigned long lastTempLog = 0;
 
+    void pollSensors(); // takes the latest sensor values, once per loop
     void updateTempHistory();
     void updateTempStableFlag();
     void reloadProfiles();
@@ -121,6 +122,10 @@ class DefaultUI {
     float currentTemp = 0.0f;
     float targetTemp = 0.0f;
     double bluetoothWeight = 0.0;
+    // Sensor events fire on every reading; the UI only needs the latest per loop
+    EventSlot<TempChanged> temperatureSlot;
+    EventSlot<PressureChanged> pressureSlot;
+    EventSlot<WeightChanged> bluetoothWeightSlot;
     BrewScreenState brewScreenState = BrewScreenState::Brew;
 
     // EEZ Structs
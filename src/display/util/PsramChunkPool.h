@@ -0,0 +1,58 @@
+#ifndef PSRAMCHUNKPOOL_H
+#define PSRAMCHUNKPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <esp_heap_caps.h>
+#include <mutex>
+
+// A fixed set of equally sized buffers in PSRAM, allocated on first use and
+// then handed out and returned for the life of the firmware. Used for the
+// read-ahead chunks of .slog downloads so that a burst of shot file requests
+// reuses the same few buffers instead of allocating per request and
+// fragmenting the internal heap AsyncTCP depends on.
+//
+// acquire() returns nullptr when every buffer is in use (or PSRAM is
+// exhausted); callers then read straight into the response buffer instead.
+template <size_t ChunkSize, size_t Count> class PsramChunkPool {
+  public:
+    static constexpr size_t CHUNK_SIZE = ChunkSize;
+
+    uint8_t *acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < Count; i++) {
+            if (inUse[i]) {
+                continue;
+            }
+            if (chunks[i] == nullptr) {
+                chunks[i] = static_cast<uint8_t *>(heap_caps_malloc(ChunkSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+                if (chunks[i] == nullptr) {
+                    return nullptr;
+                }
+            }
+            inUse[i] = true;
+            return chunks[i];
+        }
+        return nullptr;
+    }
+
+    void release(uint8_t *chunk) {
+        if (chunk == nullptr) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < Count; i++) {
+            if (chunks[i] == chunk) {
+                inUse[i] = false;
+                return;
+            }
+        }
+    }
+
+  private:
+    uint8_t *chunks[Count] = {};
+    bool inUse[Count] = {};
+    std::mutex mutex;
+};
+
+#endif // PSRAMCHUNKPOOL_H
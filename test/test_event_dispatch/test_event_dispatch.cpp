@@ -0,0 +1,642 @@
+// Unit tests + benchmark: event ids, payload and PluginManager dispatch.
+// Host-side, no ESP32/Arduino runtime — pio test -e native_events.
+//
+// Groups:
+//   A — event ids and the inline payload, typed payloads and the key shim
+//   B — dispatch order, propagation, late registration
+//   C — async delivery: lanes, overflow counters, the lock-free queue
+//   D — coalesced subscriptions: latest value since the last poll, the seqlock
+//   E — benchmark: events/s and heap allocations per trigger, against a model
+//       of the previous std::map<std::string> / heap payload dispatch
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Direct-include the PluginManager TU (the native env builds no src/ files);
+// ESP_LOG* come from Arduino on the device.
+#define ESP_LOGV(tag, fmt, ...) ((void)0)
+#define ESP_LOGE(tag, fmt, ...) ((void)0)
+#define ESP_LOGW(tag, fmt, ...) ((void)0)
+#include "display/core/PluginManager.cpp"
+
+// ---------------------------------------------------------------------------
+// Heap allocation counter
+// ---------------------------------------------------------------------------
+
+static size_t g_allocations = 0;
+
+void *operator new(size_t size) {
+    g_allocations++;
+    if (void *p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+// Event names registered on the device, so the benchmark table has a
+// realistic size and the hashes are checked for collisions.
+static const char *const EVENT_NAMES[] = {
+    "boiler:currentTemperature:change",
+    "boiler:pressure:change",
+    "boiler:targetTemperature:change",
+    "pump:flow:change",
+    "pump:puck-flow:change",
+    "pump:puck-resistance:change",
+    "controller:volumetric-measurement:estimation:change",
+    "controller:volumetric-measurement:bluetooth:change",
+    "controller:volumetric-measurement:scale-flow:change",
+    "controller:targetVolume:change",
+    "controller:targetDuration:change",
+    "controller:grindDuration:change",
+    "controller:grindVolume:change",
+    "controller:process:start",
+    "controller:process:end",
+    "controller:mode:change",
+    "controller:brew:prestart",
+    "controller:brew:start",
+    "controller:brew:end",
+    "controller:brew:clear",
+    "controller:grind:start",
+    "controller:grind:end",
+    "controller:bluetooth:init",
+    "controller:bluetooth:waiting",
+    "controller:bluetooth:connect",
+    "controller:bluetooth:disconnect",
+    "controller:wifi:connect",
+    "controller:wifi:disconnect",
+    "controller:startup",
+    "controller:ready",
+    "controller:error",
+    "controller:protocol:mismatch",
+    "controller:tof:change",
+    "controller:autotune:start",
+    "controller:autotune:result",
+    "controller:autotune:failed",
+    "ota:update:start",
+    "ota:update:end",
+    "ota:update:status",
+    "ota:update:phase",
+    "ota:update:progress",
+    "profiles:profile:save",
+    "profiles:profile:select",
+    "profiles:profile:favorite",
+    "profiles:profile:unfavorite",
+    "settings:changed",
+    "autowakeup:activated",
+    "mqtt:service",
+    "evt:history-rebuild-progress",
+    "evt:history-shot-saved",
+    "evt:shot-finished-stats",
+};
+static constexpr size_t EVENT_NAME_COUNT = sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]);
+
+// Stands in for Plugin; PluginManager::setup() is not needed here
+static void register_all(PluginManager &pm, float &sink) {
+    for (const char *name : EVENT_NAMES) {
+        pm.on(name, [&sink](Event &event) { sink += event.getFloat("value"); });
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Group A — ids and payload
+// ---------------------------------------------------------------------------
+
+static void test_event_ids_are_compile_time_and_unique() {
+    static_assert(events::BOILER_PRESSURE_CHANGE.id == eventId("boiler:pressure:change"), "constexpr id");
+    constexpr EventKey key("controller:ready");
+    static_assert(key.id != 0, "hashed at compile time");
+
+    for (size_t i = 0; i < EVENT_NAME_COUNT; i++) {
+        for (size_t j = i + 1; j < EVENT_NAME_COUNT; j++) {
+            TEST_ASSERT_TRUE(eventId(EVENT_NAMES[i]) != eventId(EVENT_NAMES[j]));
+        }
+    }
+}
+
+static void test_payload_is_inline() {
+    Event event;
+    event.setInt("total", 12);
+    event.setFloat("value", 93.5f);
+    event.setString("status", "scanning");
+    TEST_ASSERT_EQUAL_INT(12, event.getInt("total"));
+    TEST_ASSERT_EQUAL_FLOAT(93.5f, event.getFloat("value"));
+    TEST_ASSERT_EQUAL_STRING("scanning", event.getText("status"));
+    // Wrong type or missing key: the old defaults
+    TEST_ASSERT_EQUAL_INT(0, event.getInt("value"));
+    TEST_ASSERT_EQUAL_STRING("", event.getText("missing"));
+
+    // Copies carry their own text
+    Event copy = event;
+    event.setString("other", "x");
+    TEST_ASSERT_EQUAL_STRING("scanning", copy.getText("status"));
+}
+
+static void test_payload_capacity() {
+    Event event;
+    for (int i = 0; i < static_cast<int>(EVENT_MAX_ENTRIES) + 2; i++) {
+        event.setInt("n", i);
+    }
+    TEST_ASSERT_EQUAL_UINT32(EVENT_MAX_ENTRIES, event.size());
+
+    Event text;
+    text.setString("id", "0123456789abcdef0123456789abcdef0123"); // 36 chars: a profile id
+    text.setString("status", "a status longer than what is left of the buffer");
+    TEST_ASSERT_EQUAL_STRING("0123456789abcdef0123456789abcdef0123", text.getText("id"));
+    TEST_ASSERT_EQUAL_UINT32(EVENT_TEXT_SIZE - 36 - 2, strlen(text.getText("status")));
+}
+
+static void test_typed_payload_round_trip() {
+    Event event;
+    event.set(TempChanged{93.5f});
+    TEST_ASSERT_EQUAL_FLOAT(93.5f, event.as<TempChanged>().value);
+    // Key shim: listeners still reading by key see the typed fields
+    TEST_ASSERT_EQUAL_FLOAT(93.5f, event.getFloat("value"));
+    TEST_ASSERT_EQUAL_INT(0, event.getInt("value"));
+    TEST_ASSERT_EQUAL_UINT32(0, event.size());
+
+    // Key-based values still fit after the payload
+    event.setString("source", "scale");
+    TEST_ASSERT_EQUAL_STRING("scale", event.getText("source"));
+    TEST_ASSERT_EQUAL_FLOAT(93.5f, event.as<TempChanged>().value);
+
+    // Set again: replaces
+    event.set(ModeChanged{2});
+    TEST_ASSERT_EQUAL_INT(2, event.as<ModeChanged>().value);
+    TEST_ASSERT_EQUAL_STRING("", event.getText("source"));
+}
+
+static void test_typed_payload_from_keys() {
+    // Third-party plugins triggering with keys: as<T>() fills T by key
+    Event keyed;
+    keyed.setFloat("value", 9.1f);
+    TEST_ASSERT_EQUAL_FLOAT(9.1f, keyed.as<PressureChanged>().value);
+    TEST_ASSERT_EQUAL_INT(0, keyed.as<ModeChanged>().value); // no int "value"
+
+    // Another payload type with the same keys converts too
+    Event typed;
+    typed.set(FlowChanged{2.5f});
+    TEST_ASSERT_EQUAL_FLOAT(2.5f, typed.as<WeightChanged>().value);
+}
+
+// A payload with text, as a plugin might define one
+struct ProfileSelected {
+    char id[37];
+    int favorite;
+};
+template <> struct EventPayloadTraits<ProfileSelected> {
+    static constexpr EventField fields[] = {
+        {"id", EventDataType::EVENT_TYPE_STRING, offsetof(ProfileSelected, id), sizeof(ProfileSelected::id)},
+        {"favorite", EventDataType::EVENT_TYPE_INT, offsetof(ProfileSelected, favorite), sizeof(int)}};
+};
+
+static void test_typed_payload_text() {
+    ProfileSelected selected{};
+    strcpy(selected.id, "7d1c0e4b-3e8a-4f8e-9a52-0f6d2c4b1a99");
+    selected.favorite = 1;
+    Event event;
+    event.set(selected);
+    TEST_ASSERT_EQUAL_STRING(selected.id, event.getText("id"));
+    TEST_ASSERT_EQUAL_INT(1, event.getInt("favorite"));
+
+    Event keyed;
+    keyed.setString("id", "short-id");
+    ProfileSelected read = keyed.as<ProfileSelected>();
+    TEST_ASSERT_EQUAL_STRING("short-id", read.id);
+    TEST_ASSERT_EQUAL_INT(0, read.favorite);
+}
+
+// ---------------------------------------------------------------------------
+// Group B — dispatch
+// ---------------------------------------------------------------------------
+
+static void test_dispatch_order_and_propagation() {
+    PluginManager pm;
+    std::string calls;
+    pm.on("controller:mode:change", [&](Event &) { calls += "a"; });
+    pm.on("controller:ready", [&](Event &) { calls += "r"; });
+    pm.on("controller:mode:change", [&](Event &event) {
+        calls += "b";
+        event.stopPropagation = true;
+    });
+    pm.on("controller:mode:change", [&](Event &) { calls += "c"; });
+
+    Event result = pm.trigger("controller:mode:change", "value", 3);
+    TEST_ASSERT_EQUAL_STRING("ab", calls.c_str());
+    TEST_ASSERT_TRUE(result.stopPropagation);
+    TEST_ASSERT_EQUAL_INT(3, result.getInt("value"));
+
+    calls.clear();
+    pm.trigger("controller:unknown");
+    TEST_ASSERT_EQUAL_STRING("", calls.c_str());
+}
+
+static void test_listener_may_register_during_dispatch() {
+    PluginManager pm;
+    int late = 0;
+    pm.on("controller:ready", [&](Event &) { pm.on("controller:ready", [&](Event &) { late++; }); });
+    pm.trigger("controller:ready");
+    TEST_ASSERT_EQUAL_INT(0, late); // registered for the next dispatch
+    pm.trigger("controller:ready");
+    TEST_ASSERT_EQUAL_INT(1, late);
+}
+
+static void test_listener_can_change_payload() {
+    // Controller::setMode reads back what listeners left in the event
+    PluginManager pm;
+    pm.on(events::CONTROLLER_MODE_CHANGE, [](Event &event) {
+        if (event.as<ModeChanged>().value == 3) {
+            event.set(ModeChanged{1});
+        }
+    });
+    Event event = pm.trigger(events::CONTROLLER_MODE_CHANGE, ModeChanged{3});
+    TEST_ASSERT_EQUAL_INT(1, event.as<ModeChanged>().value);
+
+    // Key-based: the first entry wins, as before
+    pm.on(events::BOILER_CURRENT_TEMPERATURE_CHANGE, [](Event &event) { event.setFloat("value", 1.0f); });
+    event = pm.trigger(events::BOILER_CURRENT_TEMPERATURE_CHANGE, "value", 93.0f);
+    TEST_ASSERT_EQUAL_FLOAT(93.0f, event.getFloat("value"));
+}
+
+// ---------------------------------------------------------------------------
+// Group C — async delivery
+// ---------------------------------------------------------------------------
+
+static void test_async_listeners_run_on_dispatch() {
+    PluginManager pm;
+    std::string calls;
+    pm.on(
+        events::CONTROLLER_MODE_CHANGE,
+        [&](Event &event) {
+            calls += "a" + std::to_string(event.as<ModeChanged>().value);
+            event.set(ModeChanged{9}); // only the worker's copy
+        },
+        EventDelivery::ASYNC);
+    pm.on(events::CONTROLLER_MODE_CHANGE, [&](Event &event) {
+        calls += "s";
+        event.set(ModeChanged{2});
+    });
+
+    Event result = pm.trigger(events::CONTROLLER_MODE_CHANGE, ModeChanged{1});
+    TEST_ASSERT_EQUAL_STRING("s", calls.c_str());
+    TEST_ASSERT_EQUAL_INT(2, result.as<ModeChanged>().value);
+
+    // The async listener sees the event as the sync ones left it
+    TEST_ASSERT_TRUE(pm.dispatchQueued());
+    TEST_ASSERT_EQUAL_STRING("sa2", calls.c_str());
+    TEST_ASSERT_FALSE(pm.dispatchQueued());
+}
+
+static void test_async_high_lane_first() {
+    PluginManager pm;
+    std::string calls;
+    pm.on(events::BOILER_PRESSURE_CHANGE, [&](Event &) { calls += "t"; }, EventDelivery::ASYNC_LOW);
+    pm.on("controller:brew:start", [&](Event &) { calls += "B"; }, EventDelivery::ASYNC);
+    pm.on("controller:brew:end", [&](Event &) { calls += "E"; }, EventDelivery::ASYNC);
+
+    pm.trigger(events::BOILER_PRESSURE_CHANGE, PressureChanged{1.0f});
+    pm.trigger("controller:brew:start");
+    pm.trigger(events::BOILER_PRESSURE_CHANGE, PressureChanged{2.0f});
+    pm.trigger("controller:brew:end");
+    while (pm.dispatchQueued()) {
+    }
+    TEST_ASSERT_EQUAL_STRING("BEtt", calls.c_str());
+}
+
+static void test_async_skipped_when_propagation_stopped() {
+    PluginManager pm;
+    int async = 0;
+    pm.on("controller:ready", [&](Event &) { async++; }, EventDelivery::ASYNC);
+    pm.on("controller:ready", [](Event &event) { event.stopPropagation = true; });
+    pm.trigger("controller:ready");
+    TEST_ASSERT_FALSE(pm.dispatchQueued());
+    TEST_ASSERT_EQUAL_INT(0, async);
+}
+
+static void test_async_overflow_counters() {
+    PluginManager pm;
+    int delivered = 0;
+    pm.on(events::PUMP_FLOW_CHANGE, [&](Event &) { delivered++; }, EventDelivery::ASYNC_LOW);
+    for (size_t i = 0; i < EVENT_QUEUE_SIZE + 3; i++) {
+        pm.trigger(events::PUMP_FLOW_CHANGE, FlowChanged{static_cast<float>(i)});
+    }
+    EventLaneStats low = pm.getLaneStats(EventDelivery::ASYNC_LOW);
+    TEST_ASSERT_EQUAL_UINT32(EVENT_QUEUE_SIZE, low.queued);
+    TEST_ASSERT_EQUAL_UINT32(3, low.dropped);
+    TEST_ASSERT_EQUAL_UINT32(EVENT_QUEUE_SIZE, low.maxDepth);
+    TEST_ASSERT_EQUAL_UINT32(0, pm.getLaneStats(EventDelivery::ASYNC).queued);
+
+    // Telemetry backlog does not hold up the high lane
+    int control = 0;
+    pm.on("controller:brew:start", [&](Event &) { control++; }, EventDelivery::ASYNC);
+    pm.trigger("controller:brew:start");
+    TEST_ASSERT_TRUE(pm.dispatchQueued());
+    TEST_ASSERT_EQUAL_INT(1, control);
+    TEST_ASSERT_EQUAL_INT(0, delivered);
+
+    while (pm.dispatchQueued()) {
+    }
+    TEST_ASSERT_EQUAL_INT(static_cast<int>(EVENT_QUEUE_SIZE), delivered);
+}
+
+static void test_event_queue_many_producers() {
+    constexpr int PRODUCERS = 4;
+    constexpr int PER_PRODUCER = 20000;
+    EventQueue<int, 64> queue;
+    std::vector<int> seen(PRODUCERS * PER_PRODUCER, 0);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < PER_PRODUCER; i++) {
+                while (!queue.push(p * PER_PRODUCER + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    int received = 0;
+    int lastOf[PRODUCERS] = {-1, -1, -1, -1};
+    bool ordered = true;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        int value;
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        seen[value]++;
+        // Each producer's values come out in the order it pushed them
+        const int producer = value / PER_PRODUCER;
+        ordered = ordered && value > lastOf[producer];
+        lastOf[producer] = value;
+        received++;
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    int value;
+    TEST_ASSERT_FALSE(queue.pop(value));
+    TEST_ASSERT_TRUE(ordered);
+    for (int count : seen) {
+        TEST_ASSERT_EQUAL_INT(1, count);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Group D — coalesced subscriptions
+// ---------------------------------------------------------------------------
+
+static void test_slot_keeps_latest_since_poll() {
+    PluginManager pm;
+    EventSlot<TempChanged> slot;
+    pm.on(events::BOILER_CURRENT_TEMPERATURE_CHANGE, slot);
+
+    TempChanged temp{0.0f};
+    TEST_ASSERT_FALSE(slot.poll(temp));
+    TEST_ASSERT_FALSE(slot.read(temp));
+
+    for (float value : {93.0f, 94.0f, 95.0f}) {
+        pm.trigger(events::BOILER_CURRENT_TEMPERATURE_CHANGE, TempChanged{value});
+    }
+    TEST_ASSERT_TRUE(slot.poll(temp));
+    TEST_ASSERT_EQUAL_FLOAT(95.0f, temp.value);
+    TEST_ASSERT_EQUAL_UINT32(3, slot.updates());
+    TEST_ASSERT_FALSE(slot.poll(temp)); // nothing new
+
+    // read() returns the latest whether or not it was polled
+    temp.value = 0.0f;
+    TEST_ASSERT_TRUE(slot.read(temp));
+    TEST_ASSERT_EQUAL_FLOAT(95.0f, temp.value);
+
+    // Keyed triggers land in the slot through as<T>()
+    pm.trigger(events::BOILER_CURRENT_TEMPERATURE_CHANGE, "value", 96.5f);
+    TEST_ASSERT_TRUE(slot.poll(temp));
+    TEST_ASSERT_EQUAL_FLOAT(96.5f, temp.value);
+}
+
+static void test_slot_with_listeners() {
+    PluginManager pm;
+    EventSlot<PressureChanged> slot;
+    int calls = 0;
+    bool stop = false;
+    pm.on(events::BOILER_PRESSURE_CHANGE, [&](Event &event) {
+        calls++;
+        event.stopPropagation = stop;
+    });
+    pm.on(events::BOILER_PRESSURE_CHANGE, slot);
+
+    pm.trigger(events::BOILER_PRESSURE_CHANGE, PressureChanged{9.0f});
+    PressureChanged pressure{0.0f};
+    TEST_ASSERT_TRUE(slot.poll(pressure));
+    TEST_ASSERT_EQUAL_FLOAT(9.0f, pressure.value);
+    TEST_ASSERT_EQUAL_INT(1, calls);
+
+    // A slot is a listener in registration order, so propagation applies
+    stop = true;
+    pm.trigger(events::BOILER_PRESSURE_CHANGE, PressureChanged{3.0f});
+    TEST_ASSERT_FALSE(slot.poll(pressure));
+    TEST_ASSERT_EQUAL_INT(2, calls);
+}
+
+struct SlotTriple {
+    uint32_t a, b, c;
+};
+
+static void test_slot_reader_never_sees_torn_value() {
+    constexpr uint32_t STORES = 200000;
+    EventSlot<SlotTriple> slot;
+    std::atomic<bool> reading{false};
+    std::thread writer([&slot, &reading] {
+        while (!reading) {
+            std::this_thread::yield();
+        }
+        for (uint32_t i = 1; i <= STORES; i++) {
+            slot.store(SlotTriple{i, i, i});
+            if (i % 64 == 0) {
+                std::this_thread::yield(); // let the reader in mid-stream
+            }
+        }
+    });
+    reading = true;
+    uint32_t last = 0;
+    uint32_t polls = 0;
+    bool consistent = true;
+    bool increasing = true;
+    while (last < STORES) {
+        SlotTriple value;
+        if (!slot.poll(value)) {
+            continue;
+        }
+        consistent = consistent && value.a == value.b && value.b == value.c;
+        increasing = increasing && value.a > last;
+        last = value.a;
+        polls++;
+    }
+    writer.join();
+    TEST_ASSERT_TRUE(consistent);
+    TEST_ASSERT_TRUE(increasing);
+    TEST_ASSERT_TRUE(polls > 1);
+    TEST_ASSERT_EQUAL_UINT32(STORES, slot.updates()); // a single writer never drops
+    printf("[event slot] %u stores coalesced into %u polls\n", static_cast<unsigned>(STORES), static_cast<unsigned>(polls));
+}
+
+// ---------------------------------------------------------------------------
+// Group E — benchmark
+// ---------------------------------------------------------------------------
+
+// The previous PluginManager: name -> listeners in a std::map keyed by
+// std::string (count() then operator[] per trigger), payload entries holding
+// a heap key and value string each. std::string stands in for Arduino String.
+namespace legacy {
+struct Entry {
+    std::string key;
+    int intValue = 0;
+    float floatValue = 0.0f;
+    std::string stringValue;
+};
+struct Event {
+    std::string id;
+    std::vector<Entry> data;
+    bool stopPropagation = false;
+    float getFloat(const std::string &key) const {
+        for (const auto &entry : data) {
+            if (entry.key == key) {
+                return entry.floatValue;
+            }
+        }
+        return 0.0f;
+    }
+};
+struct Bus {
+    std::map<std::string, std::vector<std::function<void(Event &)>>> listeners;
+    void on(const std::string &id, std::function<void(Event &)> cb) { listeners[id].push_back(std::move(cb)); }
+    Event trigger(const std::string &id, const std::string &key, float value) {
+        Event event;
+        event.id = id;
+        event.data.push_back(Entry{key, 0, value, ""});
+        if (listeners.count(std::string(event.id.c_str()))) {
+            for (auto const &callback : listeners[std::string(event.id.c_str())]) {
+                callback(event);
+                if (event.stopPropagation) {
+                    break;
+                }
+            }
+        }
+        return event;
+    }
+};
+} // namespace legacy
+
+template <typename Fire> static void measure(const char *label, size_t iterations, Fire fire, double &perSecond, double &allocations) {
+    fire(); // warm up
+    const size_t before = g_allocations;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        fire();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    perSecond = iterations / seconds;
+    allocations = static_cast<double>(g_allocations - before) / iterations;
+    printf("[event bench] %-8s %10.0f events/s, %5.2f heap allocations/trigger\n", label, perSecond, allocations);
+}
+
+static void test_benchmark_trigger() {
+    const size_t iterations = 200000;
+    float sink = 0.0f;
+
+    PluginManager pm;
+    register_all(pm, sink);
+    legacy::Bus bus;
+    for (const char *name : EVENT_NAMES) {
+        bus.on(name, [&sink](legacy::Event &event) { sink += event.getFloat("value"); });
+    }
+
+    double interned = 0, internedAllocs = 0, literal = 0, literalAllocs = 0, old = 0, oldAllocs = 0;
+    printf("\n[event bench] %zu event names, one listener each; firing %s\n", EVENT_NAME_COUNT,
+           events::BOILER_CURRENT_TEMPERATURE_CHANGE.name);
+    measure("interned", iterations, [&] { pm.trigger(events::BOILER_CURRENT_TEMPERATURE_CHANGE, "value", 93.1f); }, interned,
+            internedAllocs);
+    // A literal is hashed at the call site at runtime unless the compiler folds it
+    measure("literal", iterations, [&] { pm.trigger("boiler:currentTemperature:change", "value", 93.1f); }, literal,
+            literalAllocs);
+    measure("legacy", iterations, [&] { bus.trigger("boiler:currentTemperature:change", "value", 93.1f); }, old, oldAllocs);
+    printf("[event bench] interned is %.1fx legacy\n", interned / old);
+
+    // Typed payload, read with as<T>() instead of getFloat("value")
+    PluginManager typedPm;
+    for (const char *name : EVENT_NAMES) {
+        typedPm.on(name, [&sink](Event &event) { sink += event.as<TempChanged>().value; });
+    }
+    double typed = 0, typedAllocs = 0;
+    measure("typed", iterations, [&] { typedPm.trigger(events::BOILER_CURRENT_TEMPERATURE_CHANGE, TempChanged{93.1f}); },
+            typed, typedAllocs);
+
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, static_cast<float>(internedAllocs));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, static_cast<float>(literalAllocs));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, static_cast<float>(typedAllocs));
+
+    // Async round trip: enqueue on trigger, then the worker's dispatch
+    PluginManager asyncPm;
+    for (const char *name : EVENT_NAMES) {
+        asyncPm.on(name, [&sink](Event &event) { sink += event.as<TempChanged>().value; }, EventDelivery::ASYNC_LOW);
+    }
+    double async = 0, asyncAllocs = 0;
+    measure("async", iterations, [&] {
+        asyncPm.trigger(events::BOILER_CURRENT_TEMPERATURE_CHANGE, TempChanged{93.1f});
+        asyncPm.dispatchQueued();
+    }, async, asyncAllocs);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, static_cast<float>(asyncAllocs));
+    TEST_ASSERT_EQUAL_UINT32(0, asyncPm.getLaneStats(EventDelivery::ASYNC_LOW).dropped);
+
+    // Coalesced: the trigger only overwrites the slot, the subscriber polls
+    PluginManager slotPm;
+    EventSlot<TempChanged> slot;
+    slotPm.on(events::BOILER_CURRENT_TEMPERATURE_CHANGE, slot);
+    double coalesced = 0, coalescedAllocs = 0;
+    measure("slot", iterations, [&] { slotPm.trigger(events::BOILER_CURRENT_TEMPERATURE_CHANGE, TempChanged{93.1f}); },
+            coalesced, coalescedAllocs);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, static_cast<float>(coalescedAllocs));
+    TempChanged latest{0.0f};
+    TEST_ASSERT_TRUE(slot.poll(latest));
+    TEST_ASSERT_EQUAL_FLOAT(93.1f, latest.value);
+    TEST_ASSERT_TRUE(interned > old);
+    TEST_ASSERT_TRUE(sink > 0.0f);
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_event_ids_are_compile_time_and_unique);
+    RUN_TEST(test_payload_is_inline);
+    RUN_TEST(test_payload_capacity);
+    RUN_TEST(test_typed_payload_round_trip);
+    RUN_TEST(test_typed_payload_from_keys);
+    RUN_TEST(test_typed_payload_text);
+    RUN_TEST(test_dispatch_order_and_propagation);
+    RUN_TEST(test_listener_may_register_during_dispatch);
+    RUN_TEST(test_listener_can_change_payload);
+    RUN_TEST(test_async_listeners_run_on_dispatch);
+    RUN_TEST(test_async_high_lane_first);
+    RUN_TEST(test_async_skipped_when_propagation_stopped);
+    RUN_TEST(test_async_overflow_counters);
+    RUN_TEST(test_event_queue_many_producers);
+    RUN_TEST(test_slot_keeps_latest_since_poll);
+    RUN_TEST(test_slot_with_listeners);
+    RUN_TEST(test_slot_reader_never_sees_torn_value);
+    RUN_TEST(test_benchmark_trigger);
+    return UNITY_END();
+}
@@ -0,0 +1,250 @@
+// Unit tests: event bus tracing (GAGGIMATE_EVENT_TRACE).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_events.
+//
+// Groups:
+//   A — listener labels
+//   B — per-listener / per-event timings, nesting depth, async end to end
+//   C — reset, ring, top-N report
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Direct-include the PluginManager and EventTrace TUs with tracing compiled in
+#define GAGGIMATE_EVENT_TRACE
+#define ESP_LOGV(tag, fmt, ...) ((void)0)
+#define ESP_LOGE(tag, fmt, ...) ((void)0)
+#define ESP_LOGW(tag, fmt, ...) ((void)0)
+#include "display/core/EventTrace.cpp"
+#include "display/core/PluginManager.cpp"
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+static void busy_wait_us(uint32_t us) {
+    const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
+
+// Stands in for a plugin's setup(): the lambdas below are labelled after it
+struct SlowPlugin {
+    static void setup(PluginManager &pm) {
+        pm.on("controller:brew:start", [](Event &) { busy_wait_us(300); });
+        pm.on("controller:brew:start", [](Event &) { busy_wait_us(20); });
+    }
+};
+
+static std::string listener_label(const EventTraceListener &listener) {
+    char name[64];
+    EventTrace::label(listener.label, name, sizeof(name));
+    return name;
+}
+
+// ---------------------------------------------------------------------------
+// Group A — labels
+// ---------------------------------------------------------------------------
+
+static void test_label_from_registration() {
+    char out[64];
+    EventTrace::label("void PluginManager::on(EventKey, F&&, EventDelivery) [with F = "
+                      "MQTTPlugin::setup(Controller*, PluginManager*)::<lambda(const Event&)>]",
+                      out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("MQTTPlugin::setup", out);
+
+    EventTrace::label("void PluginManager::on(EventKey, F &&, EventDelivery) [F = (lambda at "
+                      "src/display/plugins/MQTTPlugin.cpp:137:5)]",
+                      out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("(lambda at src/display/plugins/MQTTPlugin.cpp:137:5)", out);
+
+    EventTrace::label("void PluginManager::on(EventKey, F&&, EventDelivery) [with F = std::function<void(Event&)>&]", out,
+                      sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("std::function", out);
+
+    EventTrace::label("void PluginManager::on(EventKey, EventSlot<T>&) [with T = TempChanged]", out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("EventSlot<TempChanged>", out);
+
+    EventTrace::label(nullptr, out, sizeof(out));
+    TEST_ASSERT_EQUAL_STRING("?", out);
+
+    // Registered through the real template
+    PluginManager pm;
+    SlowPlugin::setup(pm);
+    pm.trigger("controller:brew:start");
+    EventTraceListener top[2];
+    TEST_ASSERT_EQUAL_UINT32(2, pm.getTrace().topListeners(top, 2));
+    TEST_ASSERT_TRUE(listener_label(top[0]).find("SlowPlugin::setup") != std::string::npos);
+
+    // Coalesced subscriptions are labelled by their payload
+    PluginManager slotPm;
+    EventSlot<TempChanged> slot;
+    slotPm.on(events::BOILER_CURRENT_TEMPERATURE_CHANGE, slot);
+    slotPm.trigger(events::BOILER_CURRENT_TEMPERATURE_CHANGE, TempChanged{93.0f});
+    TEST_ASSERT_EQUAL_UINT32(1, slotPm.getTrace().topListeners(top, 1));
+    TEST_ASSERT_EQUAL_STRING("EventSlot<TempChanged>", listener_label(top[0]).c_str());
+}
+
+// ---------------------------------------------------------------------------
+// Group B — timings
+// ---------------------------------------------------------------------------
+
+static void test_listener_and_event_timings() {
+    PluginManager pm;
+    SlowPlugin::setup(pm);
+    for (int i = 0; i < 3; i++) {
+        pm.trigger("controller:brew:start");
+    }
+
+    EventTraceListener top[4];
+    TEST_ASSERT_EQUAL_UINT32(2, pm.getTrace().topListeners(top, 4));
+    TEST_ASSERT_EQUAL_UINT32(3, top[0].timing.calls);
+    TEST_ASSERT_TRUE(top[0].timing.maxUs >= 300);
+    TEST_ASSERT_TRUE(top[0].timing.totalUs >= 900);
+    TEST_ASSERT_TRUE(top[0].timing.totalUs > top[1].timing.totalUs);
+    TEST_ASSERT_EQUAL_STRING("controller:brew:start", top[0].event);
+    TEST_ASSERT_FALSE(top[0].async);
+
+    EventTraceEvent events[4];
+    TEST_ASSERT_EQUAL_UINT32(1, pm.getTrace().topEvents(events, 4));
+    TEST_ASSERT_EQUAL_UINT32(3, events[0].sync.calls);
+    // End to end covers both listeners
+    TEST_ASSERT_TRUE(events[0].sync.totalUs >= top[0].timing.totalUs + top[1].timing.totalUs);
+    TEST_ASSERT_EQUAL_UINT32(1, events[0].maxDepth);
+}
+
+static void test_nesting_depth() {
+    PluginManager pm;
+    pm.on("controller:grind:end", [&pm](Event &) { pm.trigger("controller:process:end"); });
+    pm.on("controller:process:end", [&pm](Event &) { pm.trigger("controller:brew:clear"); });
+    pm.trigger("controller:grind:end");
+
+    EventTraceEvent events[4];
+    const size_t count = pm.getTrace().topEvents(events, 4);
+    TEST_ASSERT_EQUAL_UINT32(3, count);
+    for (size_t i = 0; i < count; i++) {
+        const std::string name = events[i].name;
+        const int expected = name == "controller:grind:end" ? 1 : name == "controller:process:end" ? 2 : 3;
+        TEST_ASSERT_EQUAL_INT(expected, events[i].maxDepth);
+    }
+    // Outer events include the nested ones
+    TEST_ASSERT_EQUAL_STRING("controller:grind:end", events[0].name);
+}
+
+static void test_async_end_to_end() {
+    PluginManager pm;
+    pm.on(events::BOILER_PRESSURE_CHANGE, [](Event &) { busy_wait_us(100); }, EventDelivery::ASYNC_LOW);
+    pm.trigger(events::BOILER_PRESSURE_CHANGE, PressureChanged{9.0f});
+    busy_wait_us(200); // waiting in the lane
+    TEST_ASSERT_TRUE(pm.dispatchQueued());
+
+    EventTraceEvent events[1];
+    TEST_ASSERT_EQUAL_UINT32(1, pm.getTrace().topEvents(events, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, events[0].async.calls);
+    TEST_ASSERT_TRUE(events[0].async.maxUs >= 300);
+    TEST_ASSERT_TRUE(events[0].sync.maxUs < 100); // the caller only queued it
+
+    EventTraceListener top[1];
+    TEST_ASSERT_EQUAL_UINT32(1, pm.getTrace().topListeners(top, 1));
+    TEST_ASSERT_TRUE(top[0].async);
+    TEST_ASSERT_TRUE(top[0].timing.maxUs >= 100);
+}
+
+// ---------------------------------------------------------------------------
+// Group C — reset, ring, report
+// ---------------------------------------------------------------------------
+
+static void test_reset_and_ring() {
+    PluginManager pm;
+    pm.on("controller:ready", [](Event &) {});
+    pm.trigger("controller:ready");
+    pm.trigger("controller:startup");
+
+    // Oldest first: listener, then its trigger(), then the listener-less event
+    EventTraceRecord records[8];
+    TEST_ASSERT_EQUAL_UINT32(3, pm.getTrace().recent(records, 8));
+    TEST_ASSERT_EQUAL_UINT32(0, records[0].listener);
+    TEST_ASSERT_EQUAL_UINT32(EVENT_TRACE_NO_LISTENER, records[1].listener);
+    TEST_ASSERT_TRUE(records[1].id == eventId("controller:ready"));
+    TEST_ASSERT_TRUE(records[2].id == eventId("controller:startup"));
+    TEST_ASSERT_EQUAL_UINT32(1, pm.getTrace().recent(records, 1));
+    TEST_ASSERT_TRUE(records[0].id == eventId("controller:startup"));
+
+    pm.getTrace().reset();
+    EventTraceListener top[1];
+    EventTraceEvent events[1];
+    TEST_ASSERT_EQUAL_UINT32(0, pm.getTrace().recent(records, 8));
+    TEST_ASSERT_EQUAL_UINT32(0, pm.getTrace().topListeners(top, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, pm.getTrace().topEvents(events, 1));
+
+    // Listeners stay registered with the tracer
+    pm.trigger("controller:ready");
+    TEST_ASSERT_EQUAL_UINT32(1, pm.getTrace().topListeners(top, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, top[0].timing.calls);
+}
+
+static void test_ring_wraps() {
+    PluginManager pm;
+    for (size_t i = 0; i < EVENT_TRACE_RING_SIZE + 5; i++) {
+        pm.trigger(i % 2 ? "controller:tof:change" : "controller:ready");
+    }
+    EventTraceRecord records[EVENT_TRACE_RING_SIZE];
+    TEST_ASSERT_EQUAL_UINT32(EVENT_TRACE_RING_SIZE, pm.getTrace().recent(records, EVENT_TRACE_RING_SIZE));
+    // The last trigger (i = RING_SIZE + 4, even) is newest
+    TEST_ASSERT_TRUE(records[EVENT_TRACE_RING_SIZE - 1].id == eventId("controller:ready"));
+    TEST_ASSERT_TRUE(records[EVENT_TRACE_RING_SIZE - 2].id == eventId("controller:tof:change"));
+}
+
+static void test_print_report() {
+    PluginManager pm;
+    SlowPlugin::setup(pm);
+    pm.on("controller:brew:end", [](Event &) { busy_wait_us(50); }, EventDelivery::ASYNC);
+    pm.trigger("controller:brew:start");
+    pm.trigger("controller:brew:end");
+    pm.dispatchQueued();
+    printf("\n");
+    pm.getTrace().print(5);
+
+    // Slowest first
+    EventTraceListener top[3];
+    TEST_ASSERT_EQUAL_UINT32(3, pm.getTrace().topListeners(top, 3));
+    TEST_ASSERT_TRUE(top[0].timing.totalUs >= top[1].timing.totalUs);
+    TEST_ASSERT_TRUE(top[1].timing.totalUs >= top[2].timing.totalUs);
+    TEST_ASSERT_EQUAL_UINT32(1, pm.getTrace().topListeners(top, 1));
+    TEST_ASSERT_TRUE(top[0].timing.maxUs >= 300);
+}
+
+static void test_trace_overhead() {
+    PluginManager pm;
+    float sink = 0.0f;
+    pm.on(events::BOILER_CURRENT_TEMPERATURE_CHANGE, [&sink](Event &event) { sink += event.as<TempChanged>().value; });
+    const size_t iterations = 200000;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        pm.trigger(events::BOILER_CURRENT_TEMPERATURE_CHANGE, TempChanged{93.1f});
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("[event bench] traced   %10.0f events/s\n", iterations / seconds);
+    EventTraceEvent events[1];
+    TEST_ASSERT_EQUAL_UINT32(1, pm.getTrace().topEvents(events, 1));
+    TEST_ASSERT_EQUAL_UINT32(iterations, events[0].sync.calls);
+    TEST_ASSERT_TRUE(sink > 0.0f);
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_label_from_registration);
+    RUN_TEST(test_listener_and_event_timings);
+    RUN_TEST(test_nesting_depth);
+    RUN_TEST(test_async_end_to_end);
+    RUN_TEST(test_reset_and_ring);
+    RUN_TEST(test_ring_wraps);
+    RUN_TEST(test_print_report);
+    RUN_TEST(test_trace_overhead);
+    return UNITY_END();
+}
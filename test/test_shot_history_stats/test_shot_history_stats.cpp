@@ -0,0 +1,226 @@
+// Unit tests: running history statistics (models/shot_history_stats.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — totals follow adds, updates and removals
+//   B — day and week windows, profile slots and the overflow bucket
+//   C — stats.bin image round trip and generation check
+
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <display/models/shot_history_stats.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+static constexpr uint32_t MONDAY = 1760918400; // 2025-10-20 00:00 UTC
+
+static ShotIndexEntry shot(uint32_t id, uint32_t timestamp, const char *profileId = "p1") {
+    ShotIndexEntry e{};
+    e.id = id;
+    e.timestamp = timestamp;
+    e.duration = 30000;
+    e.volume = 360;     // 36.0 g
+    e.avgPressure = 80; // 8.0 bar
+    e.flags = SHOT_FLAG_COMPLETED;
+    strncpy(e.profileId, profileId, sizeof(e.profileId) - 1);
+    strncpy(e.profileName, profileId, sizeof(e.profileName) - 1);
+    return e;
+}
+
+struct Period {
+    uint32_t key;
+    uint32_t count;
+};
+
+template <typename Stats> static std::vector<Period> days_of(const Stats &stats) {
+    std::vector<Period> out;
+    stats.forEachDay([&](uint32_t day, const ShotStatsBucket &bucket) { out.push_back({day, bucket.count}); });
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Group A — totals
+// ---------------------------------------------------------------------------
+
+static void test_add_update_remove() {
+    ShotHistoryStats<> stats;
+    stats.clear();
+    ShotIndexEntry a = shot(1, MONDAY + 3600);
+    ShotIndexEntry b = shot(2, MONDAY + 7200);
+    b.duration = 20000;
+    b.volume = 0; // no scale, no yield
+    b.avgPressure = 90;
+    stats.add(a);
+    stats.add(b);
+
+    const ShotStatsBucket &total = stats.totals();
+    TEST_ASSERT_EQUAL_UINT32(2, total.count);
+    TEST_ASSERT_EQUAL_UINT32(50000, total.durationMs);
+    TEST_ASSERT_EQUAL_UINT32(1, total.yieldCount);
+    TEST_ASSERT_EQUAL_UINT32(360, total.yieldSum);
+    TEST_ASSERT_EQUAL_UINT32(2, total.pressureCount);
+    TEST_ASSERT_EQUAL_UINT32(170, total.pressureSum);
+    TEST_ASSERT_EQUAL_UINT32(2, total.ratings[0]);
+
+    // Rating a shot: remove the old state, add the new one
+    ShotIndexEntry rated = a;
+    rated.rating = 4;
+    rated.volume = 400;
+    stats.remove(a);
+    stats.add(rated);
+    TEST_ASSERT_EQUAL_UINT32(2, total.count);
+    TEST_ASSERT_EQUAL_UINT32(1, total.ratings[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, total.ratings[4]);
+    TEST_ASSERT_EQUAL_UINT32(400, total.yieldSum);
+
+    stats.remove(rated);
+    stats.remove(b);
+    const ShotStatsBucket empty{};
+    TEST_ASSERT_EQUAL_MEMORY(&empty, &total, sizeof(empty));
+    TEST_ASSERT_EQUAL_UINT32(0, days_of(stats).size());
+}
+
+static void test_only_completed_live_shots_count() {
+    ShotHistoryStats<> stats;
+    stats.clear();
+    ShotIndexEntry early = shot(1, MONDAY);
+    early.flags = 0; // in progress
+    ShotIndexEntry deleted = shot(2, MONDAY);
+    deleted.flags |= SHOT_FLAG_DELETED;
+    stats.add(early);
+    stats.add(deleted);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.totals().count);
+
+    // Removing a shot twice (e.g. a replayed delete) cannot wrap the sums
+    ShotIndexEntry a = shot(3, MONDAY);
+    stats.add(a);
+    stats.remove(a);
+    stats.remove(a);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.totals().count);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.totals().durationMs);
+}
+
+// ---------------------------------------------------------------------------
+// Group B — periods and profiles
+// ---------------------------------------------------------------------------
+
+static void test_days_and_weeks() {
+    ShotHistoryStats<> stats;
+    stats.clear();
+    const uint32_t monday = shot_history_stats::dayOf(MONDAY);
+    TEST_ASSERT_EQUAL_UINT32(MONDAY, shot_history_stats::weekStart(shot_history_stats::weekOf(monday)));
+    TEST_ASSERT_EQUAL_UINT32(shot_history_stats::weekOf(monday), shot_history_stats::weekOf(monday + 6));
+    TEST_ASSERT_EQUAL_UINT32(shot_history_stats::weekOf(monday) + 1, shot_history_stats::weekOf(monday + 7));
+
+    stats.add(shot(1, MONDAY + 60));
+    stats.add(shot(2, MONDAY + 120));
+    stats.add(shot(3, MONDAY + 86400 * 6)); // Sunday, same week
+    stats.add(shot(4, MONDAY + 86400 * 7)); // next Monday
+    stats.add(shot(5, 1000));               // clock not set: totals only
+    TEST_ASSERT_EQUAL_UINT32(5, stats.totals().count);
+
+    const std::vector<Period> days = days_of(stats);
+    TEST_ASSERT_EQUAL_UINT32(3, days.size());
+    TEST_ASSERT_EQUAL_UINT32(monday, days[0].key);
+    TEST_ASSERT_EQUAL_UINT32(2, days[0].count);
+    TEST_ASSERT_EQUAL_UINT32(monday + 6, days[1].key);
+    TEST_ASSERT_EQUAL_UINT32(monday + 7, days[2].key);
+
+    std::vector<Period> weeks;
+    stats.forEachWeek([&](uint32_t week, const ShotStatsBucket &bucket) { weeks.push_back({week, bucket.count}); });
+    TEST_ASSERT_EQUAL_UINT32(2, weeks.size());
+    TEST_ASSERT_EQUAL_UINT32(3, weeks[0].count);
+    TEST_ASSERT_EQUAL_UINT32(1, weeks[1].count);
+
+    // A day SHOT_STATS_DAYS later takes over the slot of the first one, which
+    // then falls out of the window; shots from it are no longer counted there.
+    stats.add(shot(6, MONDAY + 86400 * SHOT_STATS_DAYS));
+    stats.add(shot(7, MONDAY + 300));
+    const std::vector<Period> later = days_of(stats);
+    TEST_ASSERT_EQUAL_UINT32(3, later.size());
+    TEST_ASSERT_EQUAL_UINT32(monday + 6, later[0].key);
+    TEST_ASSERT_EQUAL_UINT32(monday + SHOT_STATS_DAYS, later[2].key);
+    TEST_ASSERT_EQUAL_UINT32(1, later[2].count);
+    stats.remove(shot(1, MONDAY + 60)); // outside the window: the new day keeps its shot
+    TEST_ASSERT_EQUAL_UINT32(1, days_of(stats)[2].count);
+}
+
+static void test_profile_overflow() {
+    ShotHistoryStats<> stats;
+    stats.clear();
+    char id[16];
+    for (uint32_t i = 0; i < SHOT_STATS_PROFILES; i++) {
+        snprintf(id, sizeof(id), "p%u", (unsigned)i);
+        stats.add(shot(i + 1, MONDAY, id));
+    }
+    stats.add(shot(100, MONDAY, "extra"));
+    stats.add(shot(101, MONDAY, "p0"));
+    TEST_ASSERT_EQUAL_UINT32(1, stats.otherProfiles().count);
+
+    uint32_t profiles = 0, p0 = 0;
+    stats.forEachProfile([&](const char *profileId, const char *, const ShotStatsBucket &bucket) {
+        profiles++;
+        if (strcmp(profileId, "p0") == 0) {
+            p0 = bucket.count;
+        }
+    });
+    TEST_ASSERT_EQUAL_UINT32(SHOT_STATS_PROFILES, profiles);
+    TEST_ASSERT_EQUAL_UINT32(2, p0);
+
+    // A freed slot is only handed out once the overflow bucket is empty, so
+    // "extra" keeps counting where its first shot went.
+    stats.remove(shot(2, MONDAY, "p1"));
+    stats.add(shot(102, MONDAY, "extra"));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.otherProfiles().count);
+    stats.remove(shot(100, MONDAY, "extra"));
+    stats.remove(shot(102, MONDAY, "extra"));
+    TEST_ASSERT_EQUAL_UINT32(0, stats.otherProfiles().count);
+    stats.add(shot(103, MONDAY, "extra"));
+    TEST_ASSERT_EQUAL_UINT32(0, stats.otherProfiles().count);
+}
+
+// ---------------------------------------------------------------------------
+// Group C — image
+// ---------------------------------------------------------------------------
+
+static void test_image_round_trip() {
+    ShotHistoryStats<> stats;
+    stats.clear();
+    stats.add(shot(1, MONDAY, "a"));
+    stats.add(shot(2, MONDAY + 86400 * 8, "b"));
+    std::vector<uint8_t> image(stats.imageSize());
+    stats.writeImage(image.data(), 7);
+
+    ShotHistoryStats<> loaded;
+    TEST_ASSERT_TRUE(loaded.readImage(image.data(), image.size(), 7));
+    TEST_ASSERT_EQUAL_MEMORY(&stats.totals(), &loaded.totals(), sizeof(ShotStatsBucket));
+    TEST_ASSERT_EQUAL_UINT32(2, days_of(loaded).size());
+    loaded.remove(shot(1, MONDAY, "a"));
+    TEST_ASSERT_EQUAL_UINT32(1, loaded.totals().count);
+
+    // Written for another index generation, truncated or corrupt: rejected and cleared
+    TEST_ASSERT_FALSE(loaded.readImage(image.data(), image.size(), 8));
+    TEST_ASSERT_EQUAL_UINT32(0, loaded.totals().count);
+    TEST_ASSERT_FALSE(loaded.readImage(image.data(), image.size() - 1, 7));
+    image[0] ^= 0xFF;
+    TEST_ASSERT_FALSE(loaded.readImage(image.data(), image.size(), 7));
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_add_update_remove);
+    RUN_TEST(test_only_completed_live_shots_count);
+    RUN_TEST(test_days_and_weeks);
+    RUN_TEST(test_profile_overflow);
+    RUN_TEST(test_image_round_trip);
+    return UNITY_END();
+}
@@ -0,0 +1,150 @@
+// Unit tests: shot index mutation journal (models/shot_index_journal.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — record round trip (all op types, streaming in odd-sized chunks)
+//   B — crash safety (torn tail, flipped bit, garbage after a good prefix)
+
+#include <unity.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <display/models/shot_index_journal.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+static ShotIndexEntry make_entry(uint32_t id) {
+    ShotIndexEntry e{};
+    e.id = id;
+    e.timestamp = 1700000000u + id;
+    e.duration = 28000;
+    e.volume = 365;
+    e.flags = SHOT_FLAG_COMPLETED;
+    strcpy(e.profileId, "classic");
+    strcpy(e.profileName, "Classic 9 bar");
+    e.avgTemp = 932;
+    e.maxPressure = 91;
+    e.avgFlow = 210;
+    return e;
+}
+
+static std::vector<ShotIndexJournalOp> sample_ops() {
+    return {ShotIndexJournalOp::upsert(make_entry(41)), ShotIndexJournalOp::setRating(41, 4, 372),
+            ShotIndexJournalOp::upsert(make_entry(42)), ShotIndexJournalOp::remove(40)};
+}
+
+static std::vector<uint8_t> encode_all(const std::vector<ShotIndexJournalOp> &ops) {
+    std::vector<uint8_t> out;
+    uint8_t record[SHOT_INDEX_JOURNAL_MAX_RECORD];
+    for (const auto &op : ops) {
+        const size_t n = shot_index_journal::encode(op, record);
+        out.insert(out.end(), record, record + n);
+    }
+    return out;
+}
+
+static std::vector<ShotIndexJournalOp> replay(const std::vector<uint8_t> &bytes, size_t chunk,
+                                              shot_index_journal::Reader &reader) {
+    std::vector<ShotIndexJournalOp> ops;
+    for (size_t pos = 0; pos < bytes.size(); pos += chunk) {
+        const size_t n = std::min(chunk, bytes.size() - pos);
+        reader.feed(bytes.data() + pos, n, [&](const ShotIndexJournalOp &op) { ops.push_back(op); });
+    }
+    return ops;
+}
+
+static void assert_same_op(const ShotIndexJournalOp &a, const ShotIndexJournalOp &b) {
+    TEST_ASSERT_EQUAL_UINT8(a.type, b.type);
+    TEST_ASSERT_EQUAL_UINT32(a.id, b.id);
+    if (a.type == ShotIndexJournalOp::Upsert) {
+        TEST_ASSERT_EQUAL_MEMORY(&a.entry, &b.entry, sizeof(ShotIndexEntry));
+    }
+    if (a.type == ShotIndexJournalOp::Rating) {
+        TEST_ASSERT_EQUAL_UINT8(a.rating, b.rating);
+        TEST_ASSERT_EQUAL_UINT16(a.volume, b.volume);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Group A — round trip
+// ---------------------------------------------------------------------------
+
+static void test_record_sizes() {
+    uint8_t record[SHOT_INDEX_JOURNAL_MAX_RECORD];
+    TEST_ASSERT_EQUAL_UINT32(136, shot_index_journal::encode(ShotIndexJournalOp::upsert(make_entry(1)), record));
+    TEST_ASSERT_EQUAL_UINT32(12, shot_index_journal::encode(ShotIndexJournalOp::remove(1), record));
+    TEST_ASSERT_EQUAL_UINT32(15, shot_index_journal::encode(ShotIndexJournalOp::setRating(1, 5, 0), record));
+}
+
+static void test_round_trip_any_chunking() {
+    const auto ops = sample_ops();
+    const auto bytes = encode_all(ops);
+    for (size_t chunk : {size_t(1), size_t(7), size_t(256), bytes.size()}) {
+        shot_index_journal::Reader reader;
+        const auto decoded = replay(bytes, chunk, reader);
+        TEST_ASSERT_EQUAL_UINT32(ops.size(), decoded.size());
+        for (size_t i = 0; i < ops.size(); i++) {
+            assert_same_op(ops[i], decoded[i]);
+        }
+        TEST_ASSERT_FALSE(reader.damaged());
+        TEST_ASSERT_EQUAL_UINT32(bytes.size(), reader.valid());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Group B — crash safety
+// ---------------------------------------------------------------------------
+
+static void test_torn_tail_is_skipped() {
+    const auto ops = sample_ops();
+    auto bytes = encode_all(ops);
+    const size_t goodPrefix = bytes.size() - 12; // last record is a 12-byte delete
+    bytes.resize(bytes.size() - 5);              // power cut mid-write
+
+    shot_index_journal::Reader reader;
+    const auto decoded = replay(bytes, 64, reader);
+    TEST_ASSERT_EQUAL_UINT32(3, decoded.size());
+    TEST_ASSERT_TRUE(reader.damaged());
+    TEST_ASSERT_EQUAL_UINT32(goodPrefix, reader.valid());
+}
+
+static void test_bad_crc_stops_replay() {
+    auto bytes = encode_all(sample_ops());
+    bytes[136 + 6] ^= 0x10; // flip a bit in the rating record's payload
+
+    shot_index_journal::Reader reader;
+    const auto decoded = replay(bytes, 32, reader);
+    TEST_ASSERT_EQUAL_UINT32(1, decoded.size()); // only the first upsert survives
+    TEST_ASSERT_TRUE(reader.damaged());
+    TEST_ASSERT_EQUAL_UINT32(136, reader.valid());
+}
+
+static void test_garbage_after_good_records() {
+    auto bytes = encode_all(sample_ops());
+    const size_t good = bytes.size();
+    const uint8_t garbage[] = {0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00};
+    bytes.insert(bytes.end(), garbage, garbage + sizeof(garbage));
+
+    shot_index_journal::Reader reader;
+    const auto decoded = replay(bytes, 5, reader);
+    TEST_ASSERT_EQUAL_UINT32(4, decoded.size());
+    TEST_ASSERT_TRUE(reader.damaged());
+    TEST_ASSERT_EQUAL_UINT32(good, reader.valid());
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_record_sizes);
+    RUN_TEST(test_round_trip_any_chunking);
+    RUN_TEST(test_torn_tail_is_skipped);
+    RUN_TEST(test_bad_crc_stops_replay);
+    RUN_TEST(test_garbage_after_good_records);
+    return UNITY_END();
+}
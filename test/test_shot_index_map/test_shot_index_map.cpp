@@ -0,0 +1,262 @@
+// Unit tests + benchmark: id -> slot map over /h/index.bin (models/shot_index_map.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — map behaviour (dense ids, gaps, duplicates, ids outside the dense span)
+//   B — benchmark: file I/O per index operation, linear scan vs map, 1k and 10k entries
+//
+// The benchmark runs the index operations against an in-memory index file that
+// counts seeks/reads/writes the way ShotHistoryPlugin issues them, so the numbers
+// are the flash operations each request costs on the device.
+
+#include <unity.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <display/models/shot_index_map.h>
+#include <display/models/shot_log_format.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+struct IoCount {
+    size_t seeks = 0;
+    size_t reads = 0;
+    size_t writes = 0;
+    size_t bytes = 0;
+
+    size_t ops() const { return seeks + reads + writes; }
+};
+
+// index.bin stand-in: entries addressed by slot, every access counted.
+struct CountingIndex {
+    std::vector<ShotIndexEntry> entries;
+    IoCount io;
+
+    void read(uint32_t slot, ShotIndexEntry &out) {
+        io.seeks++;
+        io.reads++;
+        io.bytes += sizeof(ShotIndexEntry);
+        out = entries[slot];
+    }
+
+    void write(uint32_t slot, const ShotIndexEntry &in) {
+        io.seeks++;
+        io.writes++;
+        io.bytes += sizeof(ShotIndexEntry);
+        entries[slot] = in;
+    }
+
+    // Sequential read of n entries in one call (loadIndexMap's chunked pass).
+    void readChunk(uint32_t slot, size_t n) {
+        io.reads++;
+        io.bytes += n * sizeof(ShotIndexEntry);
+        (void)slot;
+    }
+};
+
+static CountingIndex make_index(uint32_t count, uint32_t firstId = 1) {
+    CountingIndex index;
+    index.entries.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        index.entries[i].id = firstId + i;
+        index.entries[i].flags = SHOT_FLAG_COMPLETED;
+    }
+    return index;
+}
+
+// Previous findEntryPosition(): read entries from the start until the id matches.
+static int linear_find(CountingIndex &index, uint32_t id) {
+    for (uint32_t i = 0; i < index.entries.size(); i++) {
+        ShotIndexEntry entry{};
+        index.read(i, entry);
+        if (entry.id == id) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// Previous markIndexDeleted(): always visits every entry to catch duplicates.
+static void linear_delete(CountingIndex &index, uint32_t id) {
+    for (uint32_t i = 0; i < index.entries.size(); i++) {
+        ShotIndexEntry entry{};
+        index.read(i, entry);
+        if (entry.id == id) {
+            entry.flags |= SHOT_FLAG_DELETED;
+            index.write(i, entry);
+        }
+    }
+}
+
+static void load_map(CountingIndex &index, ShotIndexMap<> &map) {
+    constexpr size_t CHUNK_ENTRIES = 16; // one sequential pass in 2 KB reads
+    map.clear();
+    index.io.seeks++;
+    for (uint32_t slot = 0; slot < index.entries.size(); slot += CHUNK_ENTRIES) {
+        const size_t n = std::min<size_t>(CHUNK_ENTRIES, index.entries.size() - slot);
+        index.readChunk(slot, n);
+        for (size_t i = 0; i < n; i++) {
+            map.insert(index.entries[slot + i].id, slot + i);
+        }
+    }
+}
+
+static void mapped_delete(CountingIndex &index, const ShotIndexMap<> &map, uint32_t id) {
+    map.forEachSlot(id, [&](uint32_t slot) {
+        ShotIndexEntry entry{};
+        index.read(slot, entry);
+        if (entry.id == id) {
+            entry.flags |= SHOT_FLAG_DELETED;
+            index.write(slot, entry);
+        }
+    });
+}
+
+// ---------------------------------------------------------------------------
+// Group A — map behaviour
+// ---------------------------------------------------------------------------
+
+static void test_dense_ids() {
+    ShotIndexMap<> map;
+    for (uint32_t i = 0; i < 1000; i++) {
+        map.insert(100 + i, i);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1000, map.size());
+    uint32_t slot = 0;
+    TEST_ASSERT_TRUE(map.find(100, slot));
+    TEST_ASSERT_EQUAL_UINT32(0, slot);
+    TEST_ASSERT_TRUE(map.find(1099, slot));
+    TEST_ASSERT_EQUAL_UINT32(999, slot);
+    TEST_ASSERT_FALSE(map.find(99, slot));
+    TEST_ASSERT_FALSE(map.find(1100, slot));
+}
+
+static void test_gaps_and_lower_ids() {
+    ShotIndexMap<> map;
+    map.insert(50, 0);
+    map.insert(60, 1); // rebuilt index after shots 51-59 were deleted
+    map.insert(10, 2); // lower id than the first one seen
+    uint32_t slot = 0;
+    TEST_ASSERT_FALSE(map.find(55, slot));
+    TEST_ASSERT_TRUE(map.find(60, slot));
+    TEST_ASSERT_EQUAL_UINT32(1, slot);
+    TEST_ASSERT_TRUE(map.find(10, slot));
+    TEST_ASSERT_EQUAL_UINT32(2, slot);
+    TEST_ASSERT_TRUE(map.find(50, slot));
+    TEST_ASSERT_EQUAL_UINT32(0, slot);
+}
+
+static void test_duplicates_reach_every_slot() {
+    ShotIndexMap<> map;
+    map.insert(7, 0);
+    map.insert(8, 1);
+    map.insert(7, 2); // id reused after an early entry was marked deleted
+    uint32_t slot = 0;
+    TEST_ASSERT_TRUE(map.find(7, slot));
+    TEST_ASSERT_EQUAL_UINT32(2, slot); // newest wins
+
+    std::vector<uint32_t> slots;
+    TEST_ASSERT_EQUAL_UINT32(2, map.forEachSlot(7, [&](uint32_t s) { slots.push_back(s); }));
+    TEST_ASSERT_EQUAL_UINT32(2, slots[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, slots[1]);
+    TEST_ASSERT_EQUAL_UINT32(1, map.forEachSlot(8, [](uint32_t) {}));
+    TEST_ASSERT_EQUAL_UINT32(0, map.forEachSlot(9, [](uint32_t) {}));
+}
+
+static void test_out_of_span_ids() {
+    ShotIndexMap<> map;
+    map.insert(1, 0);
+    map.insert(1 + ShotIndexMap<>::MAX_SPAN * 4, 1); // stray file with a bogus number
+    map.insert(2, 2);
+    uint32_t slot = 0;
+    TEST_ASSERT_TRUE(map.find(1 + ShotIndexMap<>::MAX_SPAN * 4, slot));
+    TEST_ASSERT_EQUAL_UINT32(1, slot);
+    TEST_ASSERT_TRUE(map.find(2, slot));
+    TEST_ASSERT_EQUAL_UINT32(2, slot);
+    TEST_ASSERT_EQUAL_UINT32(3, map.size());
+}
+
+// ---------------------------------------------------------------------------
+// Group B — benchmark: I/O per operation
+// ---------------------------------------------------------------------------
+
+static void bench(uint32_t entries) {
+    constexpr uint32_t OPS = 100;
+    const uint32_t firstId = 1;
+
+    // Lookups are spread across the index; shots near the end are the common case
+    // (rating a shot just pulled), old ones the worst case for the linear scan.
+    std::vector<uint32_t> ids;
+    for (uint32_t i = 0; i < OPS; i++) {
+        ids.push_back(firstId + (i * 7919u) % entries);
+    }
+
+    CountingIndex linear = make_index(entries, firstId);
+    for (uint32_t id : ids) {
+        TEST_ASSERT_TRUE(linear_find(linear, id) >= 0);
+    }
+    const IoCount linearFind = linear.io;
+    linear.io = {};
+    for (uint32_t id : ids) {
+        linear_delete(linear, id);
+    }
+    const IoCount linearDelete = linear.io;
+
+    CountingIndex mapped = make_index(entries, firstId);
+    ShotIndexMap<> map;
+    load_map(mapped, map);
+    const IoCount load = mapped.io;
+    mapped.io = {};
+    for (uint32_t id : ids) {
+        uint32_t slot = 0;
+        TEST_ASSERT_TRUE(map.find(id, slot));
+        TEST_ASSERT_EQUAL_UINT32(id, mapped.entries[slot].id);
+        ShotIndexEntry entry{};
+        mapped.read(slot, entry); // updateIndexMetadata reads the entry it found
+    }
+    const IoCount mappedFind = mapped.io;
+    mapped.io = {};
+    for (uint32_t id : ids) {
+        mapped_delete(mapped, map, id);
+    }
+    const IoCount mappedDelete = mapped.io;
+
+    for (uint32_t i = 0; i < entries; i++) {
+        TEST_ASSERT_EQUAL_UINT8(linear.entries[i].flags, mapped.entries[i].flags);
+    }
+
+    printf("\n[shot_index bench] %u entries, %u ops each\n", entries, OPS);
+    printf("[shot_index bench] map load (once):  %6zu I/O ops, %8zu bytes\n", load.ops(), load.bytes);
+    printf("[shot_index bench] lookup  linear: %10.1f I/O/op %10.0f bytes/op | map: %4.1f I/O/op %6.0f bytes/op\n",
+           static_cast<double>(linearFind.ops()) / OPS, static_cast<double>(linearFind.bytes) / OPS,
+           static_cast<double>(mappedFind.ops()) / OPS, static_cast<double>(mappedFind.bytes) / OPS);
+    printf("[shot_index bench] delete  linear: %10.1f I/O/op %10.0f bytes/op | map: %4.1f I/O/op %6.0f bytes/op\n",
+           static_cast<double>(linearDelete.ops()) / OPS, static_cast<double>(linearDelete.bytes) / OPS,
+           static_cast<double>(mappedDelete.ops()) / OPS, static_cast<double>(mappedDelete.bytes) / OPS);
+
+    TEST_ASSERT_EQUAL_UINT32(2 * OPS, mappedFind.ops());   // one seek + one read per lookup
+    TEST_ASSERT_EQUAL_UINT32(4 * OPS, mappedDelete.ops());   // read + write back, each with a seek
+    TEST_ASSERT_LESS_THAN(linearFind.ops(), mappedFind.ops() * 10);
+}
+
+static void test_benchmark_1k() { bench(1000); }
+static void test_benchmark_10k() { bench(10000); }
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_dense_ids);
+    RUN_TEST(test_gaps_and_lower_ids);
+    RUN_TEST(test_duplicates_reach_every_slot);
+    RUN_TEST(test_out_of_span_ids);
+    RUN_TEST(test_benchmark_1k);
+    RUN_TEST(test_benchmark_10k);
+    return UNITY_END();
+}
@@ -0,0 +1,145 @@
+// Unit tests: server-side shot index query (models/shot_index_query.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — filters (profile, time range, rating, aggregates, flags)
+//   B — sorting and paging
+
+#include <unity.h>
+
+#include <cstring>
+#include <vector>
+
+#include <display/models/shot_index_query.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+// 20 shots, ids 1..20 one hour apart, alternating between two profiles.
+// Rating cycles 0..5; aggregates rise with the id; every 7th shot is deleted.
+static std::vector<ShotIndexEntry> fixture() {
+    std::vector<ShotIndexEntry> entries(20);
+    for (uint32_t i = 0; i < entries.size(); i++) {
+        ShotIndexEntry &e = entries[i];
+        e.id = i + 1;
+        e.timestamp = 1700000000u + i * 3600u;
+        e.duration = 25000 + (i % 5) * 1000;
+        e.volume = 360 + i;
+        e.rating = i % 6;
+        e.flags = SHOT_FLAG_COMPLETED | (e.rating ? SHOT_FLAG_HAS_NOTES : 0) | (e.id % 7 == 0 ? SHOT_FLAG_DELETED : 0);
+        strcpy(e.profileId, i % 2 ? "lever" : "classic");
+        e.avgTemp = 900 + i;
+        e.maxPressure = 80 + i;
+        e.avgFlow = 150 + i * 5;
+    }
+    return entries;
+}
+
+static std::vector<uint32_t> ids(const std::vector<ShotIndexEntry> &entries, const std::vector<uint32_t> &slots) {
+    std::vector<uint32_t> out;
+    for (uint32_t slot : slots) {
+        out.push_back(entries[slot].id);
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Group A — filters
+// ---------------------------------------------------------------------------
+
+static void test_default_skips_deleted_newest_first() {
+    auto entries = fixture();
+    ShotIndexQuery q;
+    std::vector<uint32_t> slots;
+    TEST_ASSERT_EQUAL_UINT32(18, runShotIndexQuery(entries.data(), entries.size(), q, slots));
+    TEST_ASSERT_EQUAL_UINT32(18, slots.size());
+    TEST_ASSERT_EQUAL_UINT32(20, entries[slots.front()].id);
+    TEST_ASSERT_EQUAL_UINT32(1, entries[slots.back()].id);
+}
+
+static void test_profile_and_time_range() {
+    auto entries = fixture();
+    ShotIndexQuery q;
+    strcpy(q.profileId, "lever");
+    q.fromTimestamp = 1700000000u + 4 * 3600u;
+    q.toTimestamp = 1700000000u + 11 * 3600u;
+    q.descending = false;
+    std::vector<uint32_t> slots;
+    runShotIndexQuery(entries.data(), entries.size(), q, slots);
+    const std::vector<uint32_t> expected = {6, 8, 10, 12}; // id 14 is out of range, odd slots are "lever"
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), slots.size());
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected.data(), ids(entries, slots).data(), expected.size());
+}
+
+static void test_rating_aggregates_and_flags() {
+    auto entries = fixture();
+    ShotIndexQuery q;
+    q.minRating = 4;
+    q.minMaxPressure = 85;
+    q.maxAvgFlow = 220;
+    q.requiredFlags = SHOT_FLAG_HAS_NOTES;
+    q.descending = false;
+    std::vector<uint32_t> slots;
+    runShotIndexQuery(entries.data(), entries.size(), q, slots);
+    // rating >= 4: ids 5,6,11,12,17,18; maxPressure >= 85: id >= 6; avgFlow <= 220: id <= 15
+    const std::vector<uint32_t> expected = {6, 11, 12};
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), slots.size());
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected.data(), ids(entries, slots).data(), expected.size());
+
+    ShotIndexQuery deleted;
+    deleted.requiredFlags = SHOT_FLAG_DELETED;
+    deleted.excludedFlags = 0;
+    TEST_ASSERT_EQUAL_UINT32(2, runShotIndexQuery(entries.data(), entries.size(), deleted, slots));
+}
+
+// ---------------------------------------------------------------------------
+// Group B — sorting and paging
+// ---------------------------------------------------------------------------
+
+static void test_sort_by_rating_ties_by_id() {
+    auto entries = fixture();
+    ShotIndexQuery q;
+    q.sortKey = ShotIndexSortKey::Rating;
+    q.limit = 4;
+    std::vector<uint32_t> slots;
+    runShotIndexQuery(entries.data(), entries.size(), q, slots);
+    const std::vector<uint32_t> expected = {18, 12, 6, 17}; // rating 5 newest first, then rating 4
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected.data(), ids(entries, slots).data(), expected.size());
+}
+
+static void test_paging() {
+    auto entries = fixture();
+    ShotIndexQuery q;
+    q.offset = 15;
+    q.limit = 10;
+    std::vector<uint32_t> slots;
+    TEST_ASSERT_EQUAL_UINT32(18, runShotIndexQuery(entries.data(), entries.size(), q, slots));
+    const std::vector<uint32_t> expected = {3, 2, 1};
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), slots.size());
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected.data(), ids(entries, slots).data(), expected.size());
+
+    q.offset = 100;
+    TEST_ASSERT_EQUAL_UINT32(18, runShotIndexQuery(entries.data(), entries.size(), q, slots));
+    TEST_ASSERT_EQUAL_UINT32(0, slots.size());
+
+    q.offset = 0;
+    q.limit = ShotIndexQuery::MAX_LIMIT * 4;
+    q.sortKey = ShotIndexSortKey::AvgFlow;
+    runShotIndexQuery(entries.data(), entries.size(), q, slots);
+    TEST_ASSERT_EQUAL_UINT32(18, slots.size());
+    TEST_ASSERT_EQUAL_UINT32(20, entries[slots.front()].id);
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_default_skips_deleted_newest_first);
+    RUN_TEST(test_profile_and_time_range);
+    RUN_TEST(test_rating_aggregates_and_flags);
+    RUN_TEST(test_sort_by_rating_ties_by_id);
+    RUN_TEST(test_paging);
+    return UNITY_END();
+}
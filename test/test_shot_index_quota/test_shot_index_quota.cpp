@@ -0,0 +1,149 @@
+// Unit tests: shot history storage quota (models/shot_index_quota.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — bytes to free (budget, free-space floor)
+//   B — eviction order (oldest, unrated first), protection and the recording shot,
+//       protected shots giving way to the free-space floor
+
+#include <unity.h>
+
+#include <vector>
+
+#include <display/models/shot_index_quota.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+// 10 shots of 10 KB, ids 1..10 stored out of order. Shot 3 is deleted, shots
+// 2 and 6 are rated (2 and 5 stars), shot 4 has notes without a rating and
+// shot 8 predates file sizes in the index.
+static std::vector<ShotIndexEntry> fixture() {
+    const uint32_t order[] = {2, 1, 3, 4, 5, 6, 7, 8, 10, 9};
+    std::vector<ShotIndexEntry> entries(10);
+    for (size_t i = 0; i < entries.size(); i++) {
+        ShotIndexEntry &e = entries[i];
+        e.id = order[i];
+        e.flags = SHOT_FLAG_COMPLETED;
+        e.fileSize = 10 * 1024;
+    }
+    entries[2].flags |= SHOT_FLAG_DELETED;
+    entries[0].rating = 2;
+    entries[0].flags |= SHOT_FLAG_HAS_NOTES;
+    entries[5].rating = 5;
+    entries[5].flags |= SHOT_FLAG_HAS_NOTES;
+    entries[3].flags |= SHOT_FLAG_HAS_NOTES;
+    entries[7].fileSize = 0;
+    return entries;
+}
+
+static std::vector<uint32_t> picked_ids(const std::vector<ShotIndexEntry> &entries, const std::vector<uint32_t> &slots) {
+    std::vector<uint32_t> out;
+    for (uint32_t slot : slots) {
+        out.push_back(entries[slot].id);
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Group A — bytes to free
+// ---------------------------------------------------------------------------
+
+static void test_bytes_to_free() {
+    ShotQuota quota;
+    quota.minFreeBytes = 500 * 1024;
+    TEST_ASSERT_EQUAL_UINT32(0, shot_index_quota::bytesToFree(90 * 1024, 600 * 1024, quota));
+    TEST_ASSERT_EQUAL_UINT32(100 * 1024, shot_index_quota::bytesToFree(90 * 1024, 400 * 1024, quota));
+
+    quota.maxBytes = 64 * 1024; // over budget by 26 KB, the free-space deficit is larger
+    TEST_ASSERT_EQUAL_UINT32(100 * 1024, shot_index_quota::bytesToFree(90 * 1024, 400 * 1024, quota));
+    TEST_ASSERT_EQUAL_UINT32(26 * 1024, shot_index_quota::bytesToFree(90 * 1024, 600 * 1024, quota));
+
+    std::vector<ShotIndexEntry> entries = fixture();
+    TEST_ASSERT_EQUAL_UINT32(0, shot_index_quota::entryBytes(entries[2]));
+    TEST_ASSERT_EQUAL_UINT32(SHOT_QUOTA_UNKNOWN_FILE_BYTES, shot_index_quota::entryBytes(entries[7]));
+}
+
+// ---------------------------------------------------------------------------
+// Group B — eviction order
+// ---------------------------------------------------------------------------
+
+static void test_oldest_first_skips_protected_and_recording() {
+    std::vector<ShotIndexEntry> entries = fixture();
+    std::vector<uint32_t> slots;
+    ShotQuota quota;
+    const uint64_t freed = shot_index_quota::plan(entries.data(), entries.size(), 25 * 1024, quota, 1, slots);
+    // 1 is recording, 2 and 4 are annotated, 3 is gone
+    const std::vector<uint32_t> expected = {5, 7, 8};
+    TEST_ASSERT_TRUE(picked_ids(entries, slots) == expected);
+    TEST_ASSERT_EQUAL_UINT32(28 * 1024, freed); // 8 counts with the assumed size
+}
+
+static void test_unrated_first() {
+    std::vector<ShotIndexEntry> entries = fixture();
+    std::vector<uint32_t> slots;
+    ShotQuota quota;
+    quota.policy = ShotEvictionPolicy::UnratedFirst;
+    quota.protectAnnotated = false;
+    shot_index_quota::plan(entries.data(), entries.size(), 1000 * 1024, quota, 0, slots);
+    // Plain shots oldest first, then notes only, then 2 stars, then 5 stars
+    const std::vector<uint32_t> expected = {1, 5, 7, 8, 9, 10, 4, 2, 6};
+    TEST_ASSERT_TRUE(picked_ids(entries, slots) == expected);
+
+    quota.policy = ShotEvictionPolicy::Oldest;
+    shot_index_quota::plan(entries.data(), entries.size(), 15 * 1024, quota, 0, slots);
+    const std::vector<uint32_t> oldest = {1, 2};
+    TEST_ASSERT_TRUE(picked_ids(entries, slots) == oldest);
+}
+
+static void test_nothing_left_to_evict() {
+    std::vector<ShotIndexEntry> entries = fixture();
+    std::vector<uint32_t> slots;
+    ShotQuota quota;
+    TEST_ASSERT_EQUAL_UINT32(0, shot_index_quota::plan(entries.data(), entries.size(), 0, quota, 0, slots));
+    TEST_ASSERT_EQUAL_UINT32(0, slots.size());
+
+    // Everything unprotected goes and the shortfall shows in the result
+    const uint64_t freed = shot_index_quota::plan(entries.data(), entries.size(), 1000 * 1024, quota, 0, slots);
+    TEST_ASSERT_EQUAL_UINT32(6, slots.size());
+    TEST_ASSERT_EQUAL_UINT32(58 * 1024, freed);
+}
+
+static void test_floor_evicts_protected_oldest_first() {
+    std::vector<ShotIndexEntry> entries = fixture();
+    std::vector<uint32_t> slots;
+    ShotQuota quota;
+    quota.minFreeBytes = 500 * 1024;
+    TEST_ASSERT_EQUAL_UINT32(80 * 1024, shot_index_quota::floorBytesToFree(420 * 1024, quota));
+    TEST_ASSERT_EQUAL_UINT32(0, shot_index_quota::floorBytesToFree(600 * 1024, quota));
+
+    // The budget alone never reaches protected shots
+    uint64_t freed = shot_index_quota::plan(entries.data(), entries.size(), 80 * 1024, quota, 0, slots, 0);
+    TEST_ASSERT_EQUAL_UINT32(6, slots.size());
+    TEST_ASSERT_EQUAL_UINT32(58 * 1024, freed);
+
+    // Under the floor they follow the unprotected ones, oldest first and only as many as needed
+    freed = shot_index_quota::plan(entries.data(), entries.size(), 70 * 1024, quota, 0, slots, 70 * 1024);
+    const std::vector<uint32_t> expected = {1, 5, 7, 8, 9, 10, 2, 4};
+    TEST_ASSERT_TRUE(picked_ids(entries, slots) == expected);
+    TEST_ASSERT_EQUAL_UINT32(78 * 1024, freed);
+
+    // The recording shot stays even then
+    freed = shot_index_quota::plan(entries.data(), entries.size(), 1000 * 1024, quota, 6, slots, 1000 * 1024);
+    TEST_ASSERT_EQUAL_UINT32(8, slots.size());
+    TEST_ASSERT_EQUAL_UINT32(78 * 1024, freed);
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bytes_to_free);
+    RUN_TEST(test_oldest_first_skips_protected_and_recording);
+    RUN_TEST(test_unrated_first);
+    RUN_TEST(test_nothing_left_to_evict);
+    RUN_TEST(test_floor_evicts_protected_oldest_first);
+    return UNITY_END();
+}
@@ -0,0 +1,148 @@
+// Unit tests: multi-shot batch container helpers (models/shot_log_batch.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — request parsing (id lists, field masks)
+//   B — field projection (sample records, section header)
+//   C — bounded ring (wrap-around, partial pushes)
+
+#include <unity.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <display/models/shot_log_batch.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+static ShotLogSample make_sample() {
+    ShotLogSample s{};
+    s.t = 40;
+    s.tt = 930;
+    s.ct = 928;
+    s.tp = 90;
+    s.cp = 87;
+    s.fl = 210;
+    s.v = 365;
+    s.si = 0x0005;
+    return s;
+}
+
+// ---------------------------------------------------------------------------
+// Group A — request parsing
+// ---------------------------------------------------------------------------
+
+static void test_parse_ids() {
+    uint32_t ids[8];
+    TEST_ASSERT_EQUAL_UINT32(4, shot_log_batch::parseIds("12,13,,000014,x7,15", ids, 8));
+    const uint32_t expected[] = {12, 13, 14, 15};
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(expected, ids, 4);
+
+    TEST_ASSERT_EQUAL_UINT32(2, shot_log_batch::parseIds("1,2,3,4", ids, 2));
+    TEST_ASSERT_EQUAL_UINT32(0, shot_log_batch::parseIds("", ids, 8));
+    TEST_ASSERT_EQUAL_UINT32(0, shot_log_batch::parseIds(nullptr, ids, 8));
+}
+
+static void test_normalize_mask() {
+    TEST_ASSERT_EQUAL_UINT32(0, shot_log_batch::normalizeMask(0));
+    TEST_ASSERT_EQUAL_UINT32(0, shot_log_batch::normalizeMask(SHOT_LOG_FIELDS_MASK_ALL));
+    TEST_ASSERT_EQUAL_UINT32(0, shot_log_batch::normalizeMask(0xFFFFFFFF));
+    TEST_ASSERT_EQUAL_UINT32(SHOT_LOG_FIELD_T | SHOT_LOG_FIELD_CP,
+                             shot_log_batch::normalizeMask(SHOT_LOG_FIELD_T | SHOT_LOG_FIELD_CP | 0x10000));
+}
+
+// ---------------------------------------------------------------------------
+// Group B — projection
+// ---------------------------------------------------------------------------
+
+static void test_project_sample() {
+    const uint32_t mask = SHOT_LOG_FIELD_T | SHOT_LOG_FIELD_CP | SHOT_LOG_FIELD_FL | SHOT_LOG_FIELD_V;
+    TEST_ASSERT_EQUAL_UINT32(8, shot_log_batch::sampleSize(mask));
+    TEST_ASSERT_EQUAL_UINT32(SHOT_LOG_SAMPLE_SIZE, shot_log_batch::sampleSize(0));
+
+    uint8_t out[SHOT_LOG_SAMPLE_SIZE];
+    TEST_ASSERT_EQUAL_UINT32(8, shot_log_batch::projectSample(make_sample(), mask, out));
+    uint16_t fields[4];
+    memcpy(fields, out, sizeof(fields));
+    TEST_ASSERT_EQUAL_UINT16(40, fields[0]);
+    TEST_ASSERT_EQUAL_UINT16(87, fields[1]);
+    TEST_ASSERT_EQUAL_UINT16(210, fields[2]);
+    TEST_ASSERT_EQUAL_UINT16(365, fields[3]);
+}
+
+static void test_project_header() {
+    ShotLogHeader header{};
+    header.magic = SHOT_LOG_MAGIC;
+    header.version = SHOT_LOG_VERSION_DELTA;
+    header.reserved0 = SHOT_LOG_SAMPLE_SIZE;
+    header.fieldsMask = SHOT_LOG_FIELDS_MASK_ALL;
+    header.sampleCount = 120;
+    shot_log_batch::projectHeader(header, SHOT_LOG_FIELD_T | SHOT_LOG_FIELD_CP);
+    TEST_ASSERT_EQUAL_UINT8(SHOT_LOG_VERSION_RAW, header.version);
+    TEST_ASSERT_EQUAL_UINT8(4, header.reserved0);
+    TEST_ASSERT_EQUAL_UINT32(SHOT_LOG_FIELD_T | SHOT_LOG_FIELD_CP, header.fieldsMask);
+    TEST_ASSERT_EQUAL_UINT32(120, header.sampleCount);
+}
+
+// ---------------------------------------------------------------------------
+// Group C — ring
+// ---------------------------------------------------------------------------
+
+static void test_ring_wraps_and_bounds() {
+    uint8_t storage[10];
+    shot_log_batch::ByteRing ring(storage, sizeof(storage));
+    const uint8_t in[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+    TEST_ASSERT_EQUAL_UINT32(7, ring.push(in, 7));
+    uint8_t out[16];
+    TEST_ASSERT_EQUAL_UINT32(5, ring.pop(out, 5));
+    TEST_ASSERT_EQUAL_UINT8(5, out[4]);
+
+    // 2 left, 8 free: the push wraps around the end of the storage
+    TEST_ASSERT_EQUAL_UINT32(8, ring.push(in + 4, 8));
+    TEST_ASSERT_EQUAL_UINT32(0, ring.space());
+    TEST_ASSERT_EQUAL_UINT32(0, ring.push(in, 1)); // full: nothing is overwritten
+    TEST_ASSERT_EQUAL_UINT32(10, ring.pop(out, sizeof(out)));
+    const uint8_t expected[] = {6, 7, 5, 6, 7, 8, 9, 10, 11, 12};
+    TEST_ASSERT_EQUAL_MEMORY(expected, out, sizeof(expected));
+
+    TEST_ASSERT_EQUAL_UINT32(3, ring.pushZeros(3));
+    TEST_ASSERT_EQUAL_UINT32(3, ring.pop(out, 8));
+    TEST_ASSERT_EQUAL_UINT8(0, out[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, ring.size());
+}
+
+// A container streamed through a small ring comes out byte-identical.
+static void test_ring_streams_large_payload() {
+    std::vector<uint8_t> payload(5000);
+    for (size_t i = 0; i < payload.size(); i++) {
+        payload[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    uint8_t storage[256];
+    shot_log_batch::ByteRing ring(storage, sizeof(storage));
+    std::vector<uint8_t> out;
+    size_t in = 0;
+    uint8_t chunk[100];
+    while (out.size() < payload.size()) {
+        in += ring.push(payload.data() + in, std::min<size_t>(77, payload.size() - in));
+        const size_t n = ring.pop(chunk, sizeof(chunk));
+        out.insert(out.end(), chunk, chunk + n);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(payload.data(), out.data(), payload.size());
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_parse_ids);
+    RUN_TEST(test_normalize_mask);
+    RUN_TEST(test_project_sample);
+    RUN_TEST(test_project_header);
+    RUN_TEST(test_ring_wraps_and_bounds);
+    RUN_TEST(test_ring_streams_large_payload);
+    return UNITY_END();
+}
@@ -0,0 +1,263 @@
+// Unit tests + benchmark: v6 delta/varint .slog sample codec (models/shot_log_codec.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — round trip (v6 blocks, raw v5 records, byte-at-a-time streaming, truncation)
+//   B — benchmark: bytes per shot and decode throughput, v5 vs v6
+//
+// The benchmark runs on synthetic shots by default. Point GM_SHOT_LOG_DIR at a
+// directory of recorded .slog files (e.g. copied from /h on the device, or
+// sim_data/littlefs/h from the simulator) to run it on real shots instead.
+
+#include <unity.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+#include <display/models/shot_log_codec.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+// Plausible 9-bar shot: 8 s preinfusion at 2 bar, ramp, 9 bar hold with a
+// slowly declining flow, then extended recording while the scale settles.
+// Sensor noise is quantised to the field resolution like record() does.
+static std::vector<ShotLogSample> synthetic_shot(uint32_t seed, uint16_t samples = 140) {
+    std::vector<ShotLogSample> out;
+    out.reserve(samples);
+    float weight = 0.0f;
+    for (uint16_t i = 0; i < samples; i++) {
+        seed = seed * 1103515245u + 12345u;
+        const float noise = (static_cast<float>((seed >> 16) & 0x7fff) / 32767.0f) * 2.0f - 1.0f;
+        const float t = i * 0.25f;
+        const bool preinfusion = t < 8.0f;
+        const float targetPressure = preinfusion ? 2.0f : 9.0f;
+        const float pressure = preinfusion ? 2.0f * std::min(1.0f, t / 2.0f) : std::min(9.0f, 2.0f + (t - 8.0f) * 3.0f);
+        const float flow = preinfusion ? 1.5f : std::max(0.0f, 2.2f - (t - 8.0f) * 0.02f);
+        const float puckFlow = t < 10.0f ? 0.0f : flow * 0.9f;
+        weight += puckFlow * 0.25f;
+
+        ShotLogSample s{};
+        s.t = i;
+        s.tt = 930;
+        s.ct = static_cast<uint16_t>(925 + std::lround(noise * 3.0f));
+        s.tp = static_cast<uint16_t>(targetPressure * 10.0f);
+        s.cp = static_cast<uint16_t>(std::lround((pressure + noise * 0.1f) * 10.0f));
+        s.fl = static_cast<int16_t>(std::lround((flow + noise * 0.05f) * 100.0f));
+        s.tf = 0;
+        s.pf = static_cast<int16_t>(std::lround(puckFlow * 100.0f));
+        s.vf = static_cast<int16_t>(std::lround(puckFlow * 100.0f + noise * 4.0f));
+        s.v = static_cast<uint16_t>(std::lround(weight * 10.0f));
+        s.ev = static_cast<uint16_t>(std::lround(weight * 10.0f));
+        s.pr = static_cast<uint16_t>(pressure > 0.5f && puckFlow > 0.1f ? std::lround(pressure / puckFlow * 100.0f) : 0);
+        s.si = SYSTEM_INFO_BLUETOOTH_SCALE_CONNECTED | SYSTEM_INFO_VOLUMETRIC_AVAILABLE;
+        out.push_back(s);
+    }
+    return out;
+}
+
+static std::vector<uint8_t> encode_v6(const std::vector<ShotLogSample> &samples) {
+    std::vector<uint8_t> out;
+    shot_log::Encoder encoder;
+    auto drain = [&]() {
+        const uint8_t *data = encoder.data();
+        out.insert(out.end(), data, data + encoder.size());
+        encoder.reset();
+    };
+    for (const auto &s : samples) {
+        if (encoder.push(s)) {
+            drain();
+        }
+    }
+    if (encoder.finish()) {
+        drain();
+    }
+    return out;
+}
+
+static std::vector<uint8_t> encode_v5(const std::vector<ShotLogSample> &samples) {
+    const auto *p = reinterpret_cast<const uint8_t *>(samples.data());
+    return std::vector<uint8_t>(p, p + samples.size() * sizeof(ShotLogSample));
+}
+
+static std::vector<ShotLogSample> decode(const std::vector<uint8_t> &bytes, uint8_t version, size_t chunk = 256) {
+    std::vector<ShotLogSample> out;
+    shot_log::Decoder decoder(version);
+    for (size_t pos = 0; pos < bytes.size(); pos += chunk) {
+        const size_t n = std::min(chunk, bytes.size() - pos);
+        decoder.feed(bytes.data() + pos, n, [&](const ShotLogSample &s) {
+            out.push_back(s);
+            return true;
+        });
+    }
+    return out;
+}
+
+static bool same(const std::vector<ShotLogSample> &a, const std::vector<ShotLogSample> &b) {
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(ShotLogSample)) == 0);
+}
+
+// Loads the samples of every .slog under GM_SHOT_LOG_DIR (raw v5 or v6).
+static std::vector<std::vector<ShotLogSample>> recorded_shots() {
+    std::vector<std::vector<ShotLogSample>> shots;
+    const char *dir = std::getenv("GM_SHOT_LOG_DIR");
+    if (dir == nullptr) {
+        return shots;
+    }
+    DIR *d = opendir(dir);
+    if (d == nullptr) {
+        return shots;
+    }
+    while (dirent *e = readdir(d)) {
+        const std::string name = e->d_name;
+        if (name.size() < 5 || name.compare(name.size() - 5, 5, ".slog") != 0) {
+            continue;
+        }
+        FILE *f = fopen((std::string(dir) + "/" + name).c_str(), "rb");
+        if (f == nullptr) {
+            continue;
+        }
+        std::vector<uint8_t> bytes;
+        uint8_t buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+            bytes.insert(bytes.end(), buf, buf + n);
+        }
+        fclose(f);
+        ShotLogHeader header{};
+        if (bytes.size() < sizeof(header)) {
+            continue;
+        }
+        memcpy(&header, bytes.data(), sizeof(header));
+        if (header.magic != SHOT_LOG_MAGIC || header.version < SHOT_LOG_VERSION_RAW ||
+            header.fieldsMask != SHOT_LOG_FIELDS_MASK_ALL) {
+            continue;
+        }
+        std::vector<uint8_t> body(bytes.begin() + header.headerSize, bytes.end());
+        shots.push_back(decode(body, header.version));
+    }
+    closedir(d);
+    return shots;
+}
+
+// ---------------------------------------------------------------------------
+// Group A — round trip
+// ---------------------------------------------------------------------------
+
+static void test_v6_round_trip() {
+    const auto shot = synthetic_shot(1u);
+    const auto decoded = decode(encode_v6(shot), SHOT_LOG_VERSION_DELTA);
+    TEST_ASSERT_TRUE_MESSAGE(same(shot, decoded), "v6 decode must reproduce every sample bit-exactly");
+}
+
+static void test_v5_passthrough() {
+    const auto shot = synthetic_shot(2u);
+    const auto decoded = decode(encode_v5(shot), SHOT_LOG_VERSION_RAW, 7);
+    TEST_ASSERT_TRUE_MESSAGE(same(shot, decoded), "raw v5 records must decode unchanged");
+}
+
+static void test_byte_at_a_time_and_extremes() {
+    // Full-range swings exercise the 3-byte varints and 16-bit wraparound.
+    auto shot = synthetic_shot(3u, 70);
+    shot[10].cp = 0xFFFF;
+    shot[11].cp = 0;
+    shot[12].fl = -2000;
+    shot[13].fl = 2000;
+    shot[40].t = 500; // tick jump (e.g. decimated stretch)
+    shot[41].t = 501;
+    const auto decoded = decode(encode_v6(shot), SHOT_LOG_VERSION_DELTA, 1);
+    TEST_ASSERT_TRUE(same(shot, decoded));
+}
+
+static void test_truncated_block_is_dropped() {
+    const auto shot = synthetic_shot(4u, 100);
+    auto bytes = encode_v6(shot);
+    bytes.resize(bytes.size() - 5); // power loss in the middle of the last block
+    shot_log::Decoder decoder(SHOT_LOG_VERSION_DELTA);
+    uint32_t count = 0;
+    TEST_ASSERT_TRUE(decoder.feed(bytes.data(), bytes.size(), [&](const ShotLogSample &) {
+        count++;
+        return true;
+    }));
+    TEST_ASSERT_EQUAL(96u, count); // three complete 32-sample blocks
+    TEST_ASSERT_TRUE(decoder.buffered() > 0);
+}
+
+static void test_corrupt_block_header_fails() {
+    std::vector<uint8_t> bytes = {0, 0, 0};
+    shot_log::Decoder decoder(SHOT_LOG_VERSION_DELTA);
+    TEST_ASSERT_FALSE(decoder.feed(bytes.data(), bytes.size(), [](const ShotLogSample &) { return true; }));
+    TEST_ASSERT_TRUE(decoder.corrupt());
+}
+
+// ---------------------------------------------------------------------------
+// Group B — benchmark
+// ---------------------------------------------------------------------------
+
+static double decode_msamples_per_sec(const std::vector<uint8_t> &bytes, uint8_t version, size_t samples) {
+    constexpr int ROUNDS = 200;
+    volatile uint32_t sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < ROUNDS; r++) {
+        shot_log::Decoder decoder(version);
+        decoder.feed(bytes.data(), bytes.size(), [&](const ShotLogSample &s) {
+            sink = sink + s.cp;
+            return true;
+        });
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return secs > 0.0 ? (static_cast<double>(samples) * ROUNDS) / secs / 1e6 : 0.0;
+}
+
+static void test_benchmark_v5_vs_v6() {
+    auto shots = recorded_shots();
+    const bool recorded = !shots.empty();
+    if (!recorded) {
+        for (uint32_t seed = 1; seed <= 20; seed++) {
+            shots.push_back(synthetic_shot(seed * 7919u, static_cast<uint16_t>(100 + seed * 5)));
+        }
+    }
+
+    size_t samples = 0, v5Bytes = 0, v6Bytes = 0;
+    double v5Rate = 0.0, v6Rate = 0.0;
+    for (const auto &shot : shots) {
+        const auto v5 = encode_v5(shot);
+        const auto v6 = encode_v6(shot);
+        TEST_ASSERT_TRUE(same(shot, decode(v6, SHOT_LOG_VERSION_DELTA)));
+        samples += shot.size();
+        v5Bytes += v5.size();
+        v6Bytes += v6.size();
+        v5Rate += decode_msamples_per_sec(v5, SHOT_LOG_VERSION_RAW, shot.size());
+        v6Rate += decode_msamples_per_sec(v6, SHOT_LOG_VERSION_DELTA, shot.size());
+    }
+
+    const double n = static_cast<double>(shots.size());
+    printf("\n[shot_log bench] %s shots: %zu, samples: %zu\n", recorded ? "recorded" : "synthetic", shots.size(), samples);
+    printf("[shot_log bench] v5: %8.0f bytes/shot (+%u header), %6.2f bytes/sample, decode %7.2f Msamples/s\n",
+           (v5Bytes / n), SHOT_LOG_HEADER_SIZE, static_cast<double>(v5Bytes) / samples, v5Rate / n);
+    printf("[shot_log bench] v6: %8.0f bytes/shot (+%u header), %6.2f bytes/sample, decode %7.2f Msamples/s\n",
+           (v6Bytes / n), SHOT_LOG_HEADER_SIZE, static_cast<double>(v6Bytes) / samples, v6Rate / n);
+    printf("[shot_log bench] v6/v5 sample bytes: %.1f%%\n", 100.0 * v6Bytes / v5Bytes);
+
+    TEST_ASSERT_LESS_THAN_MESSAGE(v5Bytes, v6Bytes, "v6 must be smaller than v5");
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_v6_round_trip);
+    RUN_TEST(test_v5_passthrough);
+    RUN_TEST(test_byte_at_a_time_and_extremes);
+    RUN_TEST(test_truncated_block_is_dropped);
+    RUN_TEST(test_corrupt_block_header_fails);
+    RUN_TEST(test_benchmark_v5_vs_v6);
+    return UNITY_END();
+}
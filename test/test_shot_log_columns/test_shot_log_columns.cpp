@@ -0,0 +1,175 @@
+// Unit tests: column-major .slog projection (models/shot_log_columns.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — transposing rows into columns (offsets, partial copies)
+//   B — round trip: v6 file -> projected columns -> Reader
+//   C — Reader validation
+
+#include <unity.h>
+
+#include <vector>
+
+#include <display/models/shot_log_codec.h>
+#include <display/models/shot_log_columns.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+static ShotLogSample make_sample(uint16_t i) {
+    ShotLogSample s{};
+    s.t = i;
+    s.tt = 930;
+    s.ct = static_cast<uint16_t>(900 + i % 7);
+    s.tp = 90;
+    s.cp = static_cast<uint16_t>(i * 3);
+    s.fl = static_cast<uint16_t>(200 + i);
+    s.v = static_cast<uint16_t>(i * 5);
+    s.si = 0x0005;
+    return s;
+}
+
+static ShotLogHeader make_header(uint32_t count) {
+    ShotLogHeader header{};
+    header.magic = SHOT_LOG_MAGIC;
+    header.version = SHOT_LOG_VERSION_DELTA;
+    header.reserved0 = SHOT_LOG_SAMPLE_SIZE;
+    header.headerSize = SHOT_LOG_HEADER_SIZE;
+    header.fieldsMask = SHOT_LOG_FIELDS_MASK_ALL;
+    header.sampleCount = count;
+    return header;
+}
+
+// Encodes count samples as the v6 sample section of a .slog file.
+static std::vector<uint8_t> encode_samples(uint16_t count) {
+    std::vector<uint8_t> out;
+    shot_log::Encoder encoder;
+    for (uint16_t i = 0; i < count; i++) {
+        if (encoder.push(make_sample(i))) {
+            out.insert(out.end(), encoder.data(), encoder.data() + encoder.size());
+            encoder.reset();
+        }
+    }
+    if (encoder.finish()) {
+        out.insert(out.end(), encoder.data(), encoder.data() + encoder.size());
+    }
+    return out;
+}
+
+static const uint32_t CHART_MASK = SHOT_LOG_FIELD_T | SHOT_LOG_FIELD_CP | SHOT_LOG_FIELD_FL | SHOT_LOG_FIELD_V;
+
+// Builds a full columnar response the way the firmware does, copying the
+// columns out in step-byte pieces.
+static std::vector<uint8_t> build_response(uint16_t count, uint32_t mask, size_t step) {
+    ShotLogHeader header = make_header(count);
+    std::vector<uint8_t> samples = encode_samples(count);
+    std::vector<uint16_t> rows;
+    shot_log::Decoder decoder(header.version);
+    decoder.feed(samples.data(), samples.size(), [&](const ShotLogSample &sample) {
+        shot_log_columns::appendRow(rows, sample, mask);
+        return true;
+    });
+    shot_log_columns::makeHeader(header, mask);
+
+    const uint8_t fields = shot_log_batch::fieldCount(mask);
+    std::vector<uint8_t> out(sizeof(header) + rows.size() * sizeof(uint16_t));
+    memcpy(out.data(), &header, sizeof(header));
+    for (size_t offset = 0; offset < rows.size() * sizeof(uint16_t);) {
+        offset += shot_log_columns::copyColumns(rows.data(), fields, count, offset, out.data() + sizeof(header) + offset,
+                                                step);
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Group A — transpose
+// ---------------------------------------------------------------------------
+
+static void test_copy_columns_transposes() {
+    // 3 rows of (a, b)
+    const uint16_t rows[] = {1, 10, 2, 20, 3, 30};
+    uint8_t out[12];
+    TEST_ASSERT_EQUAL_UINT32(12, shot_log_columns::copyColumns(rows, 2, 3, 0, out, sizeof(out)));
+    const uint8_t expected[] = {1, 0, 2, 0, 3, 0, 10, 0, 20, 0, 30, 0};
+    TEST_ASSERT_EQUAL_MEMORY(expected, out, sizeof(expected));
+
+    // An odd offset starts in the middle of a value
+    TEST_ASSERT_EQUAL_UINT32(3, shot_log_columns::copyColumns(rows, 2, 3, 5, out, 3));
+    TEST_ASSERT_EQUAL_MEMORY(expected + 5, out, 3);
+
+    // Past the end
+    TEST_ASSERT_EQUAL_UINT32(2, shot_log_columns::copyColumns(rows, 2, 3, 10, out, 8));
+    TEST_ASSERT_EQUAL_UINT32(0, shot_log_columns::copyColumns(rows, 2, 3, 12, out, 8));
+}
+
+// ---------------------------------------------------------------------------
+// Group B — round trip
+// ---------------------------------------------------------------------------
+
+static void test_round_trip_chart_fields() {
+    const uint16_t count = 150;
+    std::vector<uint8_t> response = build_response(count, CHART_MASK, 7);
+    TEST_ASSERT_EQUAL_UINT32(SHOT_LOG_HEADER_SIZE + count * 8, response.size());
+
+    shot_log_columns::Reader reader;
+    TEST_ASSERT_TRUE(reader.parse(response.data(), response.size()));
+    TEST_ASSERT_EQUAL_UINT32(count, reader.count());
+    TEST_ASSERT_EQUAL_UINT32(count, reader.header().sampleCount);
+    TEST_ASSERT_TRUE(reader.has(SHOT_LOG_FIELD_CP));
+    TEST_ASSERT_FALSE(reader.has(SHOT_LOG_FIELD_CT));
+
+    for (uint16_t i = 0; i < count; i++) {
+        const ShotLogSample expected = make_sample(i);
+        ShotLogSample sample;
+        reader.sample(i, sample);
+        TEST_ASSERT_EQUAL_UINT16(expected.t, sample.t);
+        TEST_ASSERT_EQUAL_UINT16(expected.cp, sample.cp);
+        TEST_ASSERT_EQUAL_UINT16(expected.fl, sample.fl);
+        TEST_ASSERT_EQUAL_UINT16(expected.v, sample.v);
+        TEST_ASSERT_EQUAL_UINT16(0, sample.ct); // not selected
+    }
+
+    // Columns are contiguous: the cp column follows the t column
+    const uint8_t *cp = response.data() + SHOT_LOG_HEADER_SIZE + count * 2;
+    TEST_ASSERT_EQUAL_UINT16(make_sample(10).cp, static_cast<uint16_t>(cp[20] | (cp[21] << 8)));
+}
+
+static void test_single_field() {
+    std::vector<uint8_t> response = build_response(40, SHOT_LOG_FIELD_SI, 64);
+    shot_log_columns::Reader reader;
+    TEST_ASSERT_TRUE(reader.parse(response.data(), response.size()));
+    TEST_ASSERT_EQUAL_UINT32(40, reader.count());
+    TEST_ASSERT_EQUAL_UINT16(0x0005, reader.value(SHOT_LOG_FIELD_SI, 39));
+    TEST_ASSERT_EQUAL_UINT16(0, reader.value(SHOT_LOG_FIELD_SI, 40)); // out of range
+}
+
+// ---------------------------------------------------------------------------
+// Group C — validation
+// ---------------------------------------------------------------------------
+
+static void test_reader_rejects_stored_files() {
+    ShotLogHeader header = make_header(0);
+    shot_log_columns::Reader reader;
+    TEST_ASSERT_FALSE(reader.parse(reinterpret_cast<const uint8_t *>(&header), sizeof(header)));
+    TEST_ASSERT_EQUAL_UINT32(0, reader.count());
+
+    // Sample size must agree with the mask
+    shot_log_columns::makeHeader(header, CHART_MASK);
+    TEST_ASSERT_TRUE(reader.parse(reinterpret_cast<const uint8_t *>(&header), sizeof(header)));
+    header.reserved0 = 6;
+    TEST_ASSERT_FALSE(reader.parse(reinterpret_cast<const uint8_t *>(&header), sizeof(header)));
+    TEST_ASSERT_FALSE(reader.parse(nullptr, 0));
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_copy_columns_transposes);
+    RUN_TEST(test_round_trip_chart_fields);
+    RUN_TEST(test_single_field);
+    RUN_TEST(test_reader_rejects_stored_files);
+    return UNITY_END();
+}
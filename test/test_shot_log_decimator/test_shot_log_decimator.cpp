@@ -0,0 +1,175 @@
+// Unit tests: adaptive decimation for high-rate recording (models/shot_log_decimator.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — pass-through at the standard rate
+//   B — steady stretches and changes at a high rate
+//   C — full-rate window around phase transitions, flush
+
+#include <unity.h>
+
+#include <vector>
+
+#include <display/models/shot_log_decimator.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+static ShotLogSample steady_sample(uint16_t ms) {
+    ShotLogSample s{};
+    s.t = ms;
+    s.tt = 930;
+    s.tp = 90;
+    s.cp = 90;
+    s.fl = 200;
+    s.pf = 180;
+    return s;
+}
+
+struct Recorder {
+    ShotLogDecimator decimator;
+    std::vector<ShotLogSample> stored;
+
+    void push(const ShotLogSample &s) {
+        decimator.push(s, [this](const ShotLogSample &out) { stored.push_back(out); });
+    }
+    void flush() {
+        decimator.flush([this](const ShotLogSample &out) { stored.push_back(out); });
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Group A — pass-through
+// ---------------------------------------------------------------------------
+
+static void test_standard_rate_stores_everything() {
+    Recorder r;
+    r.decimator.reset(SHOT_LOG_SAMPLE_INTERVAL_MS);
+    for (uint16_t i = 0; i < 20; i++) {
+        r.push(steady_sample(i * 250));
+        TEST_ASSERT_EQUAL_UINT32(i + 1, r.stored.size()); // nothing held back
+    }
+    TEST_ASSERT_EQUAL_UINT32(20, r.decimator.markTransition());
+}
+
+// ---------------------------------------------------------------------------
+// Group B — decimation
+// ---------------------------------------------------------------------------
+
+// 30 s of steady extraction at 50 ms stores about as much as at 250 ms.
+static void test_steady_stretch_falls_back_to_standard_rate() {
+    Recorder r;
+    r.decimator.reset(50);
+    for (uint16_t i = 0; i < 600; i++) {
+        r.push(steady_sample(i * 50));
+    }
+    r.flush();
+    TEST_ASSERT_EQUAL_UINT32(121, r.stored.size()); // every 5th sample plus the final one
+    TEST_ASSERT_EQUAL_UINT32(r.stored.size(), r.decimator.storedCount());
+    for (size_t i = 1; i + 1 < r.stored.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT16(250, r.stored[i].t - r.stored[i - 1].t);
+    }
+    TEST_ASSERT_EQUAL_UINT16(29950, r.stored.back().t);
+}
+
+// Sampling jitter doesn't stretch the steady cadence to 300 ms.
+static void test_jitter_keeps_standard_cadence() {
+    Recorder r;
+    r.decimator.reset(50);
+    for (uint16_t i = 0; i < 200; i++) {
+        r.push(steady_sample(static_cast<uint16_t>(i * 50 + (i % 3) * 3))); // 0, +3 or +6 ms late
+    }
+    r.flush();
+    for (size_t i = 1; i + 1 < r.stored.size(); i++) {
+        const uint16_t gap = r.stored[i].t - r.stored[i - 1].t;
+        TEST_ASSERT_TRUE(gap >= 240 && gap <= 260);
+    }
+}
+
+// A pressure ramp keeps the samples where pressure moved by the threshold.
+static void test_changes_are_kept() {
+    Recorder r;
+    r.decimator.reset(50);
+    for (uint16_t i = 0; i < 100; i++) {
+        ShotLogSample s = steady_sample(i * 50);
+        if (i >= 40 && i < 60) {
+            s.cp = static_cast<uint16_t>(90 + (i - 39) * 2); // +0.2 bar every 50 ms
+        } else if (i >= 60) {
+            s.cp = 130;
+        }
+        if (i == 80) {
+            s.si = SYSTEM_INFO_EXTENDED_RECORDING;
+        }
+        r.push(s);
+    }
+    r.flush();
+    size_t ramp = 0;
+    bool sawStateChange = false;
+    for (const ShotLogSample &s : r.stored) {
+        ramp += s.t >= 2000 && s.t < 3000;
+        sawStateChange |= s.t == 4000;
+    }
+    TEST_ASSERT_EQUAL_UINT32(20, ramp);
+    TEST_ASSERT_TRUE(sawStateChange);
+    TEST_ASSERT_TRUE(r.stored.size() < 50);
+}
+
+// ---------------------------------------------------------------------------
+// Group C — transitions
+// ---------------------------------------------------------------------------
+
+static void test_full_rate_window_around_transition() {
+    Recorder r;
+    r.decimator.reset(50); // 500 ms window = 10 samples either side
+    uint32_t transitionIndex = 0;
+    for (uint16_t i = 0; i < 200; i++) {
+        if (i == 103) {
+            transitionIndex = r.decimator.markTransition();
+        }
+        r.push(steady_sample(i * 50));
+    }
+    r.flush();
+
+    // Samples 93..113 are all stored, and the returned index points at sample 103
+    TEST_ASSERT_EQUAL_UINT16(103 * 50, r.stored[transitionIndex].t);
+    size_t first = 0;
+    while (r.stored[first].t < 93 * 50) {
+        first++;
+    }
+    for (uint16_t i = 93; i <= 113; i++) {
+        TEST_ASSERT_EQUAL_UINT16(i * 50, r.stored[first + i - 93].t);
+    }
+    // Outside the window the standard cadence resumes
+    TEST_ASSERT_EQUAL_UINT16(90 * 50, r.stored[first - 1].t);
+    TEST_ASSERT_EQUAL_UINT16(118 * 50, r.stored[first + 21].t);
+}
+
+static void test_transition_at_start_and_short_shot() {
+    Recorder r;
+    r.decimator.reset(100);
+    TEST_ASSERT_EQUAL_UINT32(0, r.decimator.markTransition());
+    for (uint16_t i = 0; i < 3; i++) {
+        r.push(steady_sample(i * 100));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, r.stored.size()); // still held back
+    TEST_ASSERT_EQUAL_UINT32(3, r.decimator.markTransition());
+    r.push(steady_sample(300));
+    r.flush();
+    TEST_ASSERT_EQUAL_UINT32(4, r.stored.size());
+    TEST_ASSERT_EQUAL_UINT16(300, r.stored[3].t);
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_standard_rate_stores_everything);
+    RUN_TEST(test_steady_stretch_falls_back_to_standard_rate);
+    RUN_TEST(test_jitter_keeps_standard_cadence);
+    RUN_TEST(test_changes_are_kept);
+    RUN_TEST(test_full_rate_window_around_transition);
+    RUN_TEST(test_transition_at_start_and_short_shot);
+    return UNITY_END();
+}
@@ -0,0 +1,89 @@
+// Unit tests: .slog HTTP range and ETag helpers (models/shot_log_http.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — Range header parsing (explicit, open-ended, suffix, clamping, fallbacks, 416)
+//   B — ETag formatting and If-None-Match matching
+
+#include <unity.h>
+
+#include <display/models/shot_log_http.h>
+
+// ---------------------------------------------------------------------------
+// Group A — Range parsing
+// ---------------------------------------------------------------------------
+
+static void test_explicit_and_open_ranges() {
+    ShotLogByteRange r;
+    TEST_ASSERT_TRUE(shot_log_http::parseRange("bytes=0-511", 4096, r) == ShotLogRangeStatus::Partial);
+    TEST_ASSERT_EQUAL_UINT32(0, r.start);
+    TEST_ASSERT_EQUAL_UINT32(512, r.length);
+
+    TEST_ASSERT_TRUE(shot_log_http::parseRange("bytes=512-", 4096, r) == ShotLogRangeStatus::Partial);
+    TEST_ASSERT_EQUAL_UINT32(512, r.start);
+    TEST_ASSERT_EQUAL_UINT32(3584, r.length);
+
+    // End past EOF is clamped to the last byte
+    TEST_ASSERT_TRUE(shot_log_http::parseRange("bytes=4000-99999999999", 4096, r) == ShotLogRangeStatus::Partial);
+    TEST_ASSERT_EQUAL_UINT32(4000, r.start);
+    TEST_ASSERT_EQUAL_UINT32(96, r.length);
+}
+
+static void test_suffix_ranges() {
+    ShotLogByteRange r;
+    TEST_ASSERT_TRUE(shot_log_http::parseRange("bytes=-100", 4096, r) == ShotLogRangeStatus::Partial);
+    TEST_ASSERT_EQUAL_UINT32(3996, r.start);
+    TEST_ASSERT_EQUAL_UINT32(100, r.length);
+
+    TEST_ASSERT_TRUE(shot_log_http::parseRange("bytes=-10000", 4096, r) == ShotLogRangeStatus::Partial);
+    TEST_ASSERT_EQUAL_UINT32(0, r.start);
+    TEST_ASSERT_EQUAL_UINT32(4096, r.length);
+}
+
+static void test_fallback_to_full_file() {
+    ShotLogByteRange r;
+    const char *ignored[] = {nullptr, "", "items=0-1", "bytes=0-1,5-9", "bytes=abc", "bytes=10-5", "bytes=5-x"};
+    for (const char *header : ignored) {
+        TEST_ASSERT_TRUE(shot_log_http::parseRange(header, 4096, r) == ShotLogRangeStatus::Full);
+        TEST_ASSERT_EQUAL_UINT32(0, r.start);
+        TEST_ASSERT_EQUAL_UINT32(4096, r.length);
+    }
+}
+
+static void test_unsatisfiable() {
+    ShotLogByteRange r;
+    TEST_ASSERT_TRUE(shot_log_http::parseRange("bytes=4096-", 4096, r) == ShotLogRangeStatus::Unsatisfiable);
+    TEST_ASSERT_TRUE(shot_log_http::parseRange("bytes=-0", 4096, r) == ShotLogRangeStatus::Unsatisfiable);
+    TEST_ASSERT_TRUE(shot_log_http::parseRange("bytes=0-", 0, r) == ShotLogRangeStatus::Unsatisfiable);
+}
+
+// ---------------------------------------------------------------------------
+// Group B — ETag
+// ---------------------------------------------------------------------------
+
+static void test_etag_format_and_match() {
+    char etag[40];
+    TEST_ASSERT_EQUAL_UINT32(13, shot_log_http::formatEtag(etag, sizeof(etag), 42, 310, 0x1f40));
+    TEST_ASSERT_EQUAL_STRING("\"42-310-1f40\"", etag);
+
+    TEST_ASSERT_TRUE(shot_log_http::etagMatches("\"42-310-1f40\"", etag));
+    TEST_ASSERT_TRUE(shot_log_http::etagMatches("W/\"42-310-1f40\"", etag));
+    TEST_ASSERT_TRUE(shot_log_http::etagMatches("\"41-300-1000\", \"42-310-1f40\"", etag));
+    TEST_ASSERT_TRUE(shot_log_http::etagMatches("*", etag));
+    TEST_ASSERT_FALSE(shot_log_http::etagMatches("\"42-311-1f40\"", etag)); // shot still growing
+    TEST_ASSERT_FALSE(shot_log_http::etagMatches("\"42-310-1f40", etag));
+    TEST_ASSERT_FALSE(shot_log_http::etagMatches(nullptr, etag));
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_explicit_and_open_ranges);
+    RUN_TEST(test_suffix_ranges);
+    RUN_TEST(test_fallback_to_full_file);
+    RUN_TEST(test_unsatisfiable);
+    RUN_TEST(test_etag_format_and_match);
+    return UNITY_END();
+}
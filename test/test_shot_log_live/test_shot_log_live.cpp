@@ -0,0 +1,147 @@
+// Unit tests: live shot stream frames (models/shot_log_live.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — frame layout (write, read back, length checks)
+//   B — sample batching and stored indices
+
+#include <unity.h>
+
+#include <string.h>
+#include <vector>
+
+#include <display/models/shot_log_live.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+static ShotLogSample make_sample(uint16_t t) {
+    ShotLogSample s{};
+    s.t = t;
+    s.ct = 930;
+    s.cp = 87;
+    s.fl = -12;
+    s.v = 365;
+    return s;
+}
+
+static std::vector<uint8_t> frame_of(uint8_t type, uint8_t flags, uint16_t count, uint32_t index, const void *payload) {
+    std::vector<uint8_t> out(shot_log_live::frameSize(type, count));
+    out.resize(shot_log_live::writeFrame(out.data(), type, flags, count, 42, index, payload));
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Group A — frames
+// ---------------------------------------------------------------------------
+
+static void test_sample_frame_round_trip() {
+    const ShotLogSample samples[3] = {make_sample(0), make_sample(100), make_sample(200)};
+    const std::vector<uint8_t> frame = frame_of(SHOT_LIVE_SAMPLES, 0, 3, 17, samples);
+    TEST_ASSERT_EQUAL_UINT32(16 + 3 * SHOT_LOG_SAMPLE_SIZE, frame.size());
+
+    ShotLiveFrameHeader header{};
+    const uint8_t *payload = nullptr;
+    TEST_ASSERT_TRUE(shot_log_live::readFrame(frame.data(), frame.size(), header, payload));
+    TEST_ASSERT_EQUAL_UINT8(SHOT_LIVE_SAMPLES, header.type);
+    TEST_ASSERT_EQUAL_UINT16(3, header.count);
+    TEST_ASSERT_EQUAL_UINT32(42, header.shotId);
+    TEST_ASSERT_EQUAL_UINT32(17, header.index);
+    // The records are the .slog sample layout, byte for byte
+    TEST_ASSERT_EQUAL_MEMORY(samples, payload, sizeof(samples));
+}
+
+static void test_header_and_phase_frames() {
+    ShotLogHeader log{};
+    log.magic = SHOT_LOG_MAGIC;
+    log.sampleCount = 12;
+    const std::vector<uint8_t> end = frame_of(SHOT_LIVE_END, SHOT_LIVE_FLAG_DISCARDED, 1, 0, &log);
+    TEST_ASSERT_EQUAL_UINT32(16 + SHOT_LOG_HEADER_SIZE, end.size());
+
+    ShotLiveFrameHeader header{};
+    const uint8_t *payload = nullptr;
+    TEST_ASSERT_TRUE(shot_log_live::readFrame(end.data(), end.size(), header, payload));
+    TEST_ASSERT_EQUAL_UINT8(SHOT_LIVE_FLAG_DISCARDED, header.flags);
+    ShotLogHeader copy{};
+    memcpy(&copy, payload, sizeof(copy));
+    TEST_ASSERT_EQUAL_UINT32(12, copy.sampleCount);
+
+    PhaseTransition transition{};
+    transition.sampleIndex = 9;
+    strcpy(transition.phaseName, "Bloom");
+    const std::vector<uint8_t> phase = frame_of(SHOT_LIVE_PHASE, 0, 1, 2, &transition);
+    TEST_ASSERT_EQUAL_UINT32(16 + sizeof(PhaseTransition), phase.size());
+    TEST_ASSERT_TRUE(shot_log_live::readFrame(phase.data(), phase.size(), header, payload));
+    TEST_ASSERT_EQUAL_UINT32(2, header.index);
+    TEST_ASSERT_EQUAL_MEMORY(&transition, payload, sizeof(transition));
+}
+
+static void test_rejects_malformed_frames() {
+    const ShotLogSample samples[2] = {make_sample(0), make_sample(100)};
+    std::vector<uint8_t> frame = frame_of(SHOT_LIVE_SAMPLES, 0, 2, 0, samples);
+    ShotLiveFrameHeader header{};
+    const uint8_t *payload = nullptr;
+
+    TEST_ASSERT_FALSE(shot_log_live::readFrame(frame.data(), frame.size() - 1, header, payload));
+    TEST_ASSERT_FALSE(shot_log_live::readFrame(frame.data(), 10, header, payload));
+
+    std::vector<uint8_t> badType = frame;
+    badType[4] = 9;
+    TEST_ASSERT_FALSE(shot_log_live::readFrame(badType.data(), badType.size(), header, payload));
+
+    std::vector<uint8_t> badMagic = frame;
+    badMagic[0] ^= 0xFF;
+    TEST_ASSERT_FALSE(shot_log_live::readFrame(badMagic.data(), badMagic.size(), header, payload));
+
+    // START and END carry exactly one header
+    TEST_ASSERT_EQUAL_UINT32(0, shot_log_live::payloadSize(SHOT_LIVE_START, 2));
+}
+
+// ---------------------------------------------------------------------------
+// Group B — batching
+// ---------------------------------------------------------------------------
+
+static void test_batch_numbers_stored_samples() {
+    shot_log_live::SampleBatch batch;
+    batch.reset();
+    batch.push(make_sample(0));
+    batch.push(make_sample(50));
+    TEST_ASSERT_EQUAL_UINT16(2, batch.count());
+    TEST_ASSERT_EQUAL_UINT32(0, batch.firstIndex());
+    TEST_ASSERT_EQUAL_UINT16(50, batch.data()[1].t);
+
+    // Cleared without sending (no subscriber): numbering carries on
+    batch.clear();
+    batch.push(make_sample(100));
+    TEST_ASSERT_EQUAL_UINT16(1, batch.count());
+    TEST_ASSERT_EQUAL_UINT32(2, batch.firstIndex());
+    TEST_ASSERT_EQUAL_UINT32(3, batch.nextIndex());
+
+    batch.reset();
+    TEST_ASSERT_EQUAL_UINT16(0, batch.count());
+    TEST_ASSERT_EQUAL_UINT32(0, batch.nextIndex());
+}
+
+static void test_batch_reports_full() {
+    shot_log_live::SampleBatch batch;
+    batch.reset();
+    for (uint16_t i = 0; i + 1 < SHOT_LIVE_MAX_SAMPLES; i++) {
+        TEST_ASSERT_FALSE(batch.push(make_sample(i)));
+    }
+    TEST_ASSERT_TRUE(batch.push(make_sample(999)));
+    TEST_ASSERT_EQUAL_UINT16(SHOT_LIVE_MAX_SAMPLES, batch.count());
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_sample_frame_round_trip);
+    RUN_TEST(test_header_and_phase_frames);
+    RUN_TEST(test_rejects_malformed_frames);
+    RUN_TEST(test_batch_numbers_stored_samples);
+    RUN_TEST(test_batch_reports_full);
+    return UNITY_END();
+}
@@ -0,0 +1,89 @@
+// Unit tests: sample timestamps and jitter statistics (models/shot_log_timing.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — timeline (tick index files, millisecond timestamps across the 16-bit wrap)
+//   B — jitter histogram (max, percentiles, long gaps)
+
+#include <unity.h>
+
+#include <display/models/shot_log_timing.h>
+
+// ---------------------------------------------------------------------------
+// Group A — timeline
+// ---------------------------------------------------------------------------
+
+static void test_tick_index_files() {
+    ShotLogHeader header{};
+    header.sampleInterval = 250;
+    ShotLogTimeline timeline;
+    timeline.reset(header);
+    TEST_ASSERT_EQUAL_UINT32(0, timeline.next(0));
+    TEST_ASSERT_EQUAL_UINT32(250, timeline.next(1));
+    TEST_ASSERT_EQUAL_UINT32(1500, timeline.next(6)); // decimated: ticks can skip
+
+    header.sampleInterval = 0; // very old files
+    timeline.reset(header);
+    TEST_ASSERT_EQUAL_UINT32(500, timeline.next(2));
+}
+
+static void test_ms_timestamps_unwrap() {
+    ShotLogHeader header{};
+    header.sampleInterval = 250;
+    header.flags = SHOT_LOG_FLAG_MS_TIMESTAMPS;
+    ShotLogTimeline timeline;
+    timeline.reset(header);
+    TEST_ASSERT_EQUAL_UINT32(12, timeline.next(12));
+    TEST_ASSERT_EQUAL_UINT32(265, timeline.next(265));
+    TEST_ASSERT_EQUAL_UINT32(65400, timeline.next(65400));
+    TEST_ASSERT_EQUAL_UINT32(65652, timeline.next(116)); // 65652 mod 65536
+    TEST_ASSERT_EQUAL_UINT32(131100, timeline.next(28)); // 131100 mod 65536 = 28, after a long gap
+}
+
+// ---------------------------------------------------------------------------
+// Group B — jitter
+// ---------------------------------------------------------------------------
+
+static void test_jitter_percentiles() {
+    ShotLogJitter jitter;
+    jitter.reset();
+    TEST_ASSERT_EQUAL_UINT16(0, jitter.maxGap());
+    TEST_ASSERT_EQUAL_UINT16(0, jitter.percentile(990));
+
+    // 990 gaps of 250 ms, 9 of 270 ms and one of 400 ms
+    for (int i = 0; i < 990; i++) {
+        jitter.add(250);
+    }
+    for (int i = 0; i < 9; i++) {
+        jitter.add(270);
+    }
+    jitter.add(400);
+    TEST_ASSERT_EQUAL_UINT16(400, jitter.maxGap());
+    TEST_ASSERT_EQUAL_UINT16(250, jitter.percentile(990));
+    TEST_ASSERT_EQUAL_UINT16(270, jitter.percentile(999));
+    TEST_ASSERT_EQUAL_UINT16(400, jitter.percentile(1000));
+    TEST_ASSERT_EQUAL_UINT16(250, jitter.percentile(500));
+}
+
+static void test_jitter_long_gaps() {
+    ShotLogJitter jitter;
+    jitter.reset();
+    for (int i = 0; i < 10; i++) {
+        jitter.add(2000); // past the histogram: the percentile reports the exact maximum
+    }
+    jitter.add(100000);
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, jitter.maxGap());
+    TEST_ASSERT_EQUAL_UINT16(UINT16_MAX, jitter.percentile(990));
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_tick_index_files);
+    RUN_TEST(test_ms_timestamps_unwrap);
+    RUN_TEST(test_jitter_percentiles);
+    RUN_TEST(test_jitter_long_gaps);
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+// Unit tests: log-structured shot notes store (models/shot_notes_store.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — record round trip (streaming in odd-sized chunks, payload offsets)
+//   B — directory (newest record wins, erase, compaction threshold)
+//   C — crash safety (torn tail, flipped bit)
+
+#include <unity.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <display/models/shot_notes_store.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+struct Log {
+    std::vector<uint8_t> bytes;
+
+    Log() {
+        bytes.resize(SHOT_NOTES_FILE_HEADER_SIZE);
+        shot_notes_store::encodeFileHeader(bytes.data());
+    }
+    void put(uint32_t id, const std::string &json) { append(ShotNotesRecord::Put, id, json); }
+    void erase(uint32_t id) { append(ShotNotesRecord::Erase, id, ""); }
+    void append(ShotNotesRecord::Type type, uint32_t id, const std::string &json) {
+        std::vector<uint8_t> record(shot_notes_store::recordSize(json.size()));
+        const size_t n = shot_notes_store::encode(type, id, reinterpret_cast<const uint8_t *>(json.data()), json.size(),
+                                                  record.data());
+        bytes.insert(bytes.end(), record.begin(), record.begin() + n);
+    }
+};
+
+struct Scanned {
+    ShotNotesDirectory<> directory;
+    shot_notes_store::Scanner scanner;
+};
+
+static void scan(const std::vector<uint8_t> &bytes, size_t chunk, Scanned &out) {
+    for (size_t pos = SHOT_NOTES_FILE_HEADER_SIZE; pos < bytes.size(); pos += chunk) {
+        const size_t n = std::min(chunk, bytes.size() - pos);
+        out.scanner.feed(bytes.data() + pos, n, [&](ShotNotesRecord::Type type, uint32_t id, size_t offset, size_t length) {
+            out.directory.apply(type, id, offset, length);
+        });
+    }
+}
+
+static std::string payload(const std::vector<uint8_t> &bytes, const ShotNotesDirectory<>::Entry *entry) {
+    if (entry == nullptr) {
+        return "<missing>";
+    }
+    return std::string(reinterpret_cast<const char *>(bytes.data() + entry->offset), entry->length);
+}
+
+// ---------------------------------------------------------------------------
+// Group A — round trip
+// ---------------------------------------------------------------------------
+
+static void test_round_trip_in_chunks() {
+    Log log;
+    log.put(12, "{\"rating\":4,\"notes\":\"sweet\"}");
+    log.put(7, "{\"rating\":2}");
+    log.put(300, "{\"beanType\":\"Kenya\"}");
+    TEST_ASSERT_TRUE(shot_notes_store::checkFileHeader(log.bytes.data(), log.bytes.size()));
+
+    for (size_t chunk : {size_t(1), size_t(3), size_t(7), size_t(64), size_t(4096)}) {
+        Scanned s;
+        scan(log.bytes, chunk, s);
+        TEST_ASSERT_FALSE(s.scanner.damaged());
+        TEST_ASSERT_EQUAL_UINT32(3, s.scanner.count());
+        TEST_ASSERT_EQUAL_UINT32(log.bytes.size(), s.scanner.valid());
+        TEST_ASSERT_EQUAL_UINT32(3, s.directory.size());
+        TEST_ASSERT_EQUAL_UINT32(7, s.directory[0].id); // sorted by id
+        TEST_ASSERT_TRUE(payload(log.bytes, s.directory.find(12)) == "{\"rating\":4,\"notes\":\"sweet\"}");
+        TEST_ASSERT_TRUE(payload(log.bytes, s.directory.find(300)) == "{\"beanType\":\"Kenya\"}");
+        TEST_ASSERT_NULL(s.directory.find(8));
+    }
+}
+
+static void test_bad_file_header() {
+    Log log;
+    TEST_ASSERT_FALSE(shot_notes_store::checkFileHeader(log.bytes.data(), 4));
+    log.bytes[0] ^= 0xFF;
+    TEST_ASSERT_FALSE(shot_notes_store::checkFileHeader(log.bytes.data(), log.bytes.size()));
+}
+
+// ---------------------------------------------------------------------------
+// Group B — directory
+// ---------------------------------------------------------------------------
+
+static void test_newest_record_wins_and_erase() {
+    Log log;
+    log.put(5, "{\"rating\":1}");
+    log.put(6, "{\"rating\":3}");
+    log.put(5, "{\"rating\":5,\"notes\":\"better\"}");
+    log.erase(6);
+    log.erase(99); // never had notes
+    Scanned s;
+    scan(log.bytes, 5, s);
+    TEST_ASSERT_EQUAL_UINT32(5, s.scanner.count());
+    TEST_ASSERT_EQUAL_UINT32(1, s.directory.size());
+    TEST_ASSERT_TRUE(payload(log.bytes, s.directory.find(5)) == "{\"rating\":5,\"notes\":\"better\"}");
+    TEST_ASSERT_NULL(s.directory.find(6));
+    const size_t live = SHOT_NOTES_FILE_HEADER_SIZE + shot_notes_store::recordSize(29);
+    TEST_ASSERT_EQUAL_UINT32(live, s.directory.liveBytes());
+}
+
+static void test_compaction_threshold() {
+    // Re-saving the same notes keeps one live record while the log keeps growing
+    Log log;
+    const std::string notes(200, 'x');
+    ShotNotesDirectory<> directory;
+    for (int i = 0; i < 100; i++) {
+        const size_t offset = log.bytes.size() + SHOT_NOTES_RECORD_HEADER_SIZE;
+        log.put(1 + i % 4, notes);
+        directory.apply(ShotNotesRecord::Put, 1 + i % 4, offset, notes.size());
+        if (log.bytes.size() < SHOT_NOTES_COMPACT_MIN_BYTES) {
+            TEST_ASSERT_FALSE(directory.needsCompaction(log.bytes.size())); // small logs are left alone
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, directory.size());
+    TEST_ASSERT_TRUE(directory.needsCompaction(log.bytes.size()));
+    TEST_ASSERT_FALSE(directory.needsCompaction(directory.liveBytes()));
+}
+
+// ---------------------------------------------------------------------------
+// Group C — crash safety
+// ---------------------------------------------------------------------------
+
+static void test_torn_tail() {
+    Log log;
+    log.put(1, "{\"rating\":3}");
+    const size_t good = log.bytes.size();
+    log.put(2, "{\"rating\":4}");
+    log.bytes.resize(log.bytes.size() - 3);
+    Scanned s;
+    scan(log.bytes, 16, s);
+    TEST_ASSERT_TRUE(s.scanner.damaged());
+    TEST_ASSERT_EQUAL_UINT32(good, s.scanner.valid());
+    TEST_ASSERT_EQUAL_UINT32(1, s.directory.size());
+}
+
+static void test_flipped_bit_stops_scan() {
+    Log log;
+    log.put(1, "{\"rating\":3}");
+    const size_t good = log.bytes.size();
+    log.put(2, "{\"rating\":4}");
+    log.put(3, "{\"rating\":5}");
+    log.bytes[good + SHOT_NOTES_RECORD_HEADER_SIZE + 2] ^= 0x01; // inside the payload of shot 2
+    Scanned s;
+    scan(log.bytes, 9, s);
+    TEST_ASSERT_TRUE(s.scanner.damaged());
+    TEST_ASSERT_EQUAL_UINT32(good, s.scanner.valid());
+    TEST_ASSERT_NULL(s.directory.find(2));
+    TEST_ASSERT_NULL(s.directory.find(3)); // nothing after the damage is trusted
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_round_trip_in_chunks);
+    RUN_TEST(test_bad_file_header);
+    RUN_TEST(test_newest_record_wins_and_erase);
+    RUN_TEST(test_compaction_threshold);
+    RUN_TEST(test_torn_tail);
+    RUN_TEST(test_flipped_bit_stops_scan);
+    return UNITY_END();
+}
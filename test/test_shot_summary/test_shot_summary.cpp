@@ -0,0 +1,230 @@
+// Unit tests: per-shot summary builder (models/shot_summary.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — scalar features (first drip, peaks, pressure integral, brew end)
+//   B — weight error against the brew delay
+//   C — phase durations and the 32-point curves
+
+#include <unity.h>
+
+#include <display/models/shot_summary.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+static ShotLogSample brew_sample(uint16_t i) {
+    ShotLogSample s{};
+    s.t = i;
+    s.cp = 90;                                        // 9.0 bar
+    s.fl = static_cast<int16_t>(i < 20 ? 400 : 200); // 4 then 2 ml/s
+    s.v = static_cast<uint16_t>(i > 30 ? (i - 30) * 5 : 0);
+    s.vf = 200; // 2 g/s
+    s.si = SYSTEM_INFO_BLUETOOTH_SCALE_CONNECTED | SYSTEM_INFO_SHOT_STARTED_VOLUMETRIC;
+    return s;
+}
+
+static ShotLogHeader make_header() {
+    ShotLogHeader header{};
+    header.magic = SHOT_LOG_MAGIC;
+    header.sampleInterval = SHOT_LOG_SAMPLE_INTERVAL_MS;
+    header.brewDelayMs = 1000;
+    header.finalWeight = 360; // 36.0 g
+    header.phaseTransitionCount = 2;
+    header.phaseTransitions[0].sampleIndex = 0;
+    header.phaseTransitions[1].sampleIndex = 40;
+    return header;
+}
+
+// 100 brew samples (25 s) followed by 8 extended-recording samples.
+static ShotSummary summarize(const ShotLogHeader &header) {
+    ShotSummaryBuilder builder;
+    builder.reset();
+    for (uint16_t i = 0; i < 100; i++) {
+        builder.push(brew_sample(i), header);
+    }
+    for (uint16_t i = 100; i < 108; i++) {
+        ShotLogSample s = brew_sample(i);
+        s.cp = 0;
+        s.fl = 900; // must not count as peak flow
+        s.si |= SYSTEM_INFO_EXTENDED_RECORDING;
+        builder.push(s, header);
+    }
+    ShotSummary summary;
+    builder.finish(header, 42, summary);
+    return summary;
+}
+
+// ---------------------------------------------------------------------------
+// Group A — scalar features
+// ---------------------------------------------------------------------------
+
+static void test_scalar_features() {
+    const ShotSummary summary = summarize(make_header());
+    TEST_ASSERT_EQUAL_UINT32(42, summary.id);
+    TEST_ASSERT_EQUAL_UINT32(25000, summary.brewMs); // extended recording excluded
+    TEST_ASSERT_EQUAL_UINT16(90, summary.peakPressure);
+    TEST_ASSERT_EQUAL_INT16(400, summary.peakFlow);
+    TEST_ASSERT_EQUAL_UINT32(90 * 25, summary.pressureIntegral); // 9 bar × 25 s, bar·s * 10
+
+    // 1.0 g first reached at sample 32 = 8 s
+    TEST_ASSERT_TRUE(summary.flags & SHOT_SUMMARY_HAS_DRIP);
+    TEST_ASSERT_EQUAL_UINT32(8000, summary.firstDripMs);
+    TEST_ASSERT_TRUE(summary.flags & SHOT_SUMMARY_VOLUMETRIC);
+}
+
+static void test_empty_shot() {
+    ShotSummaryBuilder builder;
+    builder.reset();
+    ShotSummary summary;
+    builder.finish(make_header(), 7, summary);
+    TEST_ASSERT_EQUAL_UINT32(7, summary.id);
+    TEST_ASSERT_EQUAL_UINT32(0, summary.brewMs);
+    TEST_ASSERT_EQUAL_UINT8(0, summary.curvePoints);
+    TEST_ASSERT_EQUAL_UINT8(0, summary.flags);
+}
+
+// ---------------------------------------------------------------------------
+// Group B — weight error
+// ---------------------------------------------------------------------------
+
+static void test_weight_error_against_brew_delay() {
+    const ShotSummary summary = summarize(make_header());
+    // Last brew sample: v = 69 * 5 = 34.5 g, vf = 2 g/s, brewDelay 1 s -> 36.5 g predicted
+    TEST_ASSERT_TRUE(summary.flags & SHOT_SUMMARY_HAS_WEIGHT);
+    TEST_ASSERT_EQUAL_UINT16(365, summary.predictedWeight);
+    TEST_ASSERT_EQUAL_UINT16(360, summary.finalWeight);
+    TEST_ASSERT_EQUAL_INT16(-5, summary.weightError);
+    TEST_ASSERT_EQUAL_UINT16(1000, summary.brewDelayMs);
+
+    ShotLogHeader noScale = make_header();
+    noScale.finalWeight = 0;
+    TEST_ASSERT_FALSE(summarize(noScale).flags & SHOT_SUMMARY_HAS_WEIGHT);
+}
+
+// ---------------------------------------------------------------------------
+// Group C — phases and curves
+// ---------------------------------------------------------------------------
+
+static void test_phase_durations() {
+    const ShotSummary summary = summarize(make_header());
+    TEST_ASSERT_EQUAL_UINT8(2, summary.phaseCount);
+    TEST_ASSERT_EQUAL_UINT32(10000, summary.phaseDurationMs[0]);
+    TEST_ASSERT_EQUAL_UINT32(15000, summary.phaseDurationMs[1]); // until the pump stopped
+}
+
+static void test_curves_follow_the_shot() {
+    const ShotSummary summary = summarize(make_header());
+    TEST_ASSERT_EQUAL_UINT8(SHOT_SUMMARY_CURVE_POINTS, summary.curvePoints);
+    for (uint8_t i = 0; i < SHOT_SUMMARY_CURVE_POINTS; i++) {
+        TEST_ASSERT_EQUAL_UINT16(90, summary.pressureCurve[i]);
+    }
+    // Flow drops from 4 to 2 ml/s at sample 20 of 100: the first points are
+    // at 4 ml/s and the last ones at 2 ml/s.
+    TEST_ASSERT_EQUAL_INT16(400, summary.flowCurve[0]);
+    TEST_ASSERT_EQUAL_INT16(400, summary.flowCurve[4]);
+    TEST_ASSERT_EQUAL_INT16(200, summary.flowCurve[SHOT_SUMMARY_CURVE_POINTS - 1]);
+}
+
+static void test_short_and_long_shots() {
+    const ShotLogHeader header = make_header();
+    ShotSummaryBuilder builder;
+    builder.reset();
+    for (uint16_t i = 0; i < 10; i++) {
+        ShotLogSample s{};
+        s.t = i;
+        s.cp = static_cast<uint16_t>(i * 10);
+        builder.push(s, header);
+    }
+    ShotSummary summary;
+    builder.finish(header, 1, summary);
+    TEST_ASSERT_EQUAL_UINT8(10, summary.curvePoints);
+    TEST_ASSERT_EQUAL_UINT16(90, summary.pressureCurve[9]);
+
+    // A ramp over 5000 samples stays a ramp: bucket merging keeps the points ordered
+    builder.reset();
+    for (uint32_t i = 0; i < 5000; i++) {
+        ShotLogSample s{};
+        s.t = static_cast<uint16_t>(i);
+        s.cp = static_cast<uint16_t>(i / 50);
+        builder.push(s, header);
+    }
+    builder.finish(header, 2, summary);
+    TEST_ASSERT_EQUAL_UINT8(SHOT_SUMMARY_CURVE_POINTS, summary.curvePoints);
+    for (uint8_t i = 1; i < SHOT_SUMMARY_CURVE_POINTS; i++) {
+        TEST_ASSERT_TRUE(summary.pressureCurve[i] > summary.pressureCurve[i - 1]);
+    }
+    TEST_ASSERT_TRUE(summary.pressureCurve[0] < 5);
+    TEST_ASSERT_TRUE(summary.pressureCurve[SHOT_SUMMARY_CURVE_POINTS - 1] > 94);
+}
+
+// A shot sampled every 50 ms and stored with gaps (decimated) summarizes
+// like the same shot sampled evenly: times come from the ticks.
+static void test_decimated_shot() {
+    ShotLogHeader header = make_header();
+    header.sampleInterval = 50;
+    header.phaseTransitions[1].sampleIndex = 0xFFFF; // set once the sample is known
+    ShotSummaryBuilder builder;
+    builder.reset();
+    uint16_t stored = 0;
+    for (uint16_t tick = 0; tick < 500; tick++) { // 25 s
+        const bool nearTransition = tick >= 190 && tick <= 210;
+        if (tick % 5 != 0 && !nearTransition && tick != 499) {
+            continue; // a steady stretch keeps every 5th sample (250 ms)
+        }
+        if (tick == 200) {
+            header.phaseTransitions[1].sampleIndex = stored;
+        }
+        ShotLogSample s = brew_sample(static_cast<uint16_t>(tick / 5));
+        s.t = tick;
+        builder.push(s, header);
+        stored++;
+    }
+    ShotSummary summary;
+    builder.finish(header, 3, summary);
+    TEST_ASSERT_EQUAL_UINT32(25000, summary.brewMs);
+    TEST_ASSERT_EQUAL_UINT32(10000, summary.phaseDurationMs[0]);
+    TEST_ASSERT_EQUAL_UINT32(15000, summary.phaseDurationMs[1]);
+    TEST_ASSERT_EQUAL_UINT32(90 * 25, summary.pressureIntegral);
+    TEST_ASSERT_EQUAL_UINT32(8000, summary.firstDripMs);
+    TEST_ASSERT_EQUAL_UINT8(SHOT_SUMMARY_CURVE_POINTS, summary.curvePoints);
+    TEST_ASSERT_EQUAL_INT16(400, summary.flowCurve[0]);
+    TEST_ASSERT_EQUAL_INT16(200, summary.flowCurve[SHOT_SUMMARY_CURVE_POINTS - 1]);
+}
+
+// Millisecond timestamps with jitter, past the 16-bit wrap at 65.5 s
+static void test_ms_timestamps() {
+    ShotLogHeader header = make_header();
+    header.flags = SHOT_LOG_FLAG_MS_TIMESTAMPS;
+    header.phaseTransitions[1].sampleIndex = 200;
+    ShotSummaryBuilder builder;
+    builder.reset();
+    for (uint32_t i = 0; i < 320; i++) { // 80 s
+        ShotLogSample s = brew_sample(static_cast<uint16_t>(i));
+        s.t = static_cast<uint16_t>(i * 250 + (i % 2) * 4); // every other sample 4 ms late
+        builder.push(s, header);
+    }
+    ShotSummary summary;
+    builder.finish(header, 4, summary);
+    TEST_ASSERT_EQUAL_UINT32(80004, summary.brewMs); // last sample (late) + one interval
+    TEST_ASSERT_EQUAL_UINT32(50000, summary.phaseDurationMs[0]);
+    TEST_ASSERT_EQUAL_UINT32(30004, summary.phaseDurationMs[1]);
+    TEST_ASSERT_EQUAL_UINT32(90 * 80, summary.pressureIntegral);
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_scalar_features);
+    RUN_TEST(test_empty_shot);
+    RUN_TEST(test_weight_error_against_brew_delay);
+    RUN_TEST(test_phase_durations);
+    RUN_TEST(test_curves_follow_the_shot);
+    RUN_TEST(test_short_and_long_shots);
+    RUN_TEST(test_decimated_shot);
+    RUN_TEST(test_ms_timestamps);
+    return UNITY_END();
+}
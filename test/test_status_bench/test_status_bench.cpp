@@ -0,0 +1,218 @@
+// Benchmark: the same machine status sent as JSON evt:status documents and as
+// binary status frames (models/status_json.h, models/status_frame.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Replays a scripted status stream (idle at the default 500 ms cadence, then a
+// brew at the 250 ms brew rate the web app asks for) through both encoders, the
+// way WebUIPlugin::sendStatus does for one client, and prints bytes per frame,
+// bytes/s and CPU time per frame for each.
+//
+// Groups:
+//   A — both encodings carry the same status
+//   B — benchmark: bytes/s and CPU time per frame, JSON against binary
+
+#include <unity.h>
+
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include <display/models/status_frame.h>
+#include <display/models/status_json.h>
+
+// Status ticks per second (see WebUIPlugin::sendStatus)
+static constexpr int IDLE_RATE = 2;
+static constexpr int BREW_RATE = 4;
+static constexpr int IDLE_SECONDS = 60;
+static constexpr int BREW_SECONDS = 30;
+static constexpr int ROUNDS = 50;
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+static StatusSnapshot make_idle() {
+    StatusSnapshot s{};
+    s.currentTemp = 92.125f;
+    s.targetTemp = 93.0f;
+    s.mode = 1;
+    status_frame::copyText(s.profileName, "Classic 9 bar");
+    status_frame::copyText(s.profileId, "c0ffee-0d15-ea5e");
+    s.capPressure = 1;
+    s.capDimming = 1;
+    s.targetWeight = 36.0f;
+    s.volumetric = 1;
+    s.brewTarget = 1;
+    s.brewDuration = 30.0f;
+    s.grindDuration = 15000;
+    s.waterLevel = 80;
+    s.rssi = -61;
+    s.latency = 24;
+    s.scaleConnected = 1;
+    s.scaleBattery = 87;
+    s.processActive = STATUS_NO_PROCESS;
+    return s;
+}
+
+// The status stream: idle, then a brew with every sensor moving each tick
+static std::vector<StatusSnapshot> make_stream() {
+    std::vector<StatusSnapshot> stream;
+    StatusSnapshot s = make_idle();
+    for (int i = 0; i < IDLE_SECONDS * IDLE_RATE; i++) {
+        s.currentTemp = 92.9f + 0.1f * sinf(i * 0.3f);
+        s.heaterPower = i % 10 < 3 ? 12.5f : 0.0f;
+        s.rssi = i % 7 == 0 ? -62 : -61;
+        stream.push_back(s);
+    }
+    s.processActive = 1;
+    s.processState = STATUS_PROCESS_INFUSION;
+    status_frame::copyText(s.processLabel, "Preinfusion");
+    s.processVolumetric = 1;
+    s.processTarget = 36.0f;
+    for (int i = 0; i < BREW_SECONDS * BREW_RATE; i++) {
+        const float t = i / static_cast<float>(BREW_RATE);
+        if (t >= 8.0f && s.processState == STATUS_PROCESS_INFUSION) {
+            s.processState = STATUS_PROCESS_BREW;
+            status_frame::copyText(s.processLabel, "Extraction");
+        }
+        s.currentTemp = 93.0f - 0.05f * t;
+        s.pressure = t < 8.0f ? 2.0f + 0.1f * t : 9.0f - 0.02f * (t - 8.0f);
+        s.targetPressure = t < 8.0f ? 3.0f : 9.0f;
+        s.pumpFlow = 2.0f + 0.03f * t;
+        s.pumpPower = 60.0f + 0.5f * t;
+        s.heaterPower = 40.0f + 0.25f * t;
+        s.scaleWeight = t < 8.0f ? 0.0f : 1.3f * (t - 8.0f);
+        s.puckResistance = 4.0f + 0.01f * t;
+        s.puckFlow = t < 8.0f ? 0.0f : 1.6f;
+        s.targetFlow = 2.5f;
+        s.processElapsed = static_cast<uint32_t>(t * 1000);
+        s.processProgress = s.scaleWeight;
+        stream.push_back(s);
+    }
+    return stream;
+}
+
+// JSON the way sendStatus builds it: fill the document, measure, serialize
+static size_t encode_json(JsonDocument &doc, const StatusSnapshot &s, std::vector<char> &out) {
+    status_frame::writeJson(doc, s);
+    const size_t len = measureJson(doc);
+    out.resize(len);
+    serializeJson(doc, out.data(), len);
+    return len;
+}
+
+// A binary frame the way sendStatus builds it: encode, then copy into the send buffer
+static size_t encode_binary(status_frame::Encoder &encoder, const StatusSnapshot &s, std::vector<uint8_t> &scratch,
+                            std::vector<uint8_t> &out) {
+    const size_t len = encoder.encode(s, scratch.data());
+    out.resize(len);
+    memcpy(out.data(), scratch.data(), len);
+    return len;
+}
+
+// ---------------------------------------------------------------------------
+// Group A — both encodings carry the same status
+// ---------------------------------------------------------------------------
+
+static void test_both_encodings_agree() {
+    const std::vector<StatusSnapshot> stream = make_stream();
+    JsonDocument doc;
+    std::vector<char> json;
+    status_frame::Encoder encoder;
+    std::vector<uint8_t> scratch(status_frame::maxFrameSize());
+    std::vector<uint8_t> frame;
+    StatusSnapshot received{};
+    uint16_t seq = 0;
+
+    for (const StatusSnapshot &s : stream) {
+        encode_binary(encoder, s, scratch, frame);
+        TEST_ASSERT_TRUE(status_frame::decode(frame.data(), frame.size(), received, seq));
+    }
+    encode_json(doc, stream.back(), json);
+
+    JsonDocument parsed;
+    TEST_ASSERT_TRUE(deserializeJson(parsed, json.data(), json.size()) == DeserializationError::Ok);
+    TEST_ASSERT_EQUAL_FLOAT(parsed["pr"].as<float>(), received.pressure);
+    TEST_ASSERT_EQUAL_FLOAT(parsed["cw"].as<float>(), received.scaleWeight);
+    TEST_ASSERT_EQUAL_STRING(parsed["p"].as<const char *>(), received.profileName);
+    TEST_ASSERT_EQUAL_STRING(parsed["process"]["l"].as<const char *>(), received.processLabel);
+    TEST_ASSERT_EQUAL_UINT32(parsed["process"]["e"].as<uint32_t>(), received.processElapsed);
+    TEST_ASSERT_EQUAL_UINT8(parsed["sbat"].as<uint8_t>(), received.scaleBattery);
+}
+
+// ---------------------------------------------------------------------------
+// Group B — benchmark
+// ---------------------------------------------------------------------------
+
+struct Measure {
+    size_t idleBytes = 0;
+    size_t brewBytes = 0;
+    double us = 0;
+};
+
+template <typename Encode> static Measure run(const std::vector<StatusSnapshot> &stream, Encode encode) {
+    const size_t idleFrames = IDLE_SECONDS * IDLE_RATE;
+    Measure m;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        for (size_t i = 0; i < stream.size(); i++) {
+            const size_t len = encode(stream[i], i == 0);
+            if (round == 0) {
+                (i < idleFrames ? m.idleBytes : m.brewBytes) += len;
+            }
+        }
+    }
+    m.us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+           (static_cast<double>(ROUNDS) * stream.size());
+    return m;
+}
+
+static void report(const char *label, const Measure &m) {
+    const double idleFrame = m.idleBytes / static_cast<double>(IDLE_SECONDS * IDLE_RATE);
+    const double brewFrame = m.brewBytes / static_cast<double>(BREW_SECONDS * BREW_RATE);
+    printf("[status bench] %-6s idle %6.1f B/frame %7.1f B/s | brew %6.1f B/frame %7.1f B/s | %6.2f us/frame\n", label,
+           idleFrame, idleFrame * IDLE_RATE, brewFrame, brewFrame * BREW_RATE, m.us);
+}
+
+static void test_benchmark_json_vs_binary() {
+    const std::vector<StatusSnapshot> stream = make_stream();
+
+    JsonDocument doc;
+    std::vector<char> json;
+    const Measure jsonMeasure = run(stream, [&](const StatusSnapshot &s, bool) { return encode_json(doc, s, json); });
+
+    // One subscription per round: the first frame of each round is a keyframe
+    status_frame::Encoder encoder;
+    std::vector<uint8_t> scratch(status_frame::maxFrameSize());
+    std::vector<uint8_t> frame;
+    const Measure binaryMeasure = run(stream, [&](const StatusSnapshot &s, bool first) {
+        if (first) {
+            encoder.reset();
+        }
+        return encode_binary(encoder, s, scratch, frame);
+    });
+
+    printf("\n[status bench] %d s idle at %d Hz, %d s brew at %d Hz, one client\n", IDLE_SECONDS, IDLE_RATE, BREW_SECONDS,
+           BREW_RATE);
+    report("json", jsonMeasure);
+    report("binary", binaryMeasure);
+    const double jsonTotal = jsonMeasure.idleBytes + jsonMeasure.brewBytes;
+    const double binaryTotal = binaryMeasure.idleBytes + binaryMeasure.brewBytes;
+    printf("[status bench] binary is %.1fx fewer bytes, %.1fx less CPU per frame\n", jsonTotal / binaryTotal,
+           jsonMeasure.us / binaryMeasure.us);
+
+    TEST_ASSERT_TRUE(binaryMeasure.idleBytes < jsonMeasure.idleBytes);
+    TEST_ASSERT_TRUE(binaryMeasure.brewBytes < jsonMeasure.brewBytes);
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_both_encodings_agree);
+    RUN_TEST(test_benchmark_json_vs_binary);
+    return UNITY_END();
+}
@@ -0,0 +1,176 @@
+// Unit tests: binary status frames (models/status_frame.h).
+// Host-side, no ESP32/Arduino runtime — pio test -e native_shot_log.
+//
+// Groups:
+//   A — keyframes and deltas
+//   B — text fields and malformed frames
+
+#include <unity.h>
+
+#include <string.h>
+#include <vector>
+
+#include <display/models/status_frame.h>
+
+// ---------------------------------------------------------------------------
+// Test fixture helpers
+// ---------------------------------------------------------------------------
+
+static StatusSnapshot make_status() {
+    StatusSnapshot s{};
+    s.currentTemp = 92.125f;
+    s.targetTemp = 93.0f;
+    s.pressure = 8.97f;
+    s.mode = 1;
+    status_frame::copyText(s.profileName, "Classic 9 bar");
+    status_frame::copyText(s.profileId, "c0ffee");
+    s.capPressure = 1;
+    s.rssi = -61;
+    s.latency = -1;
+    s.scaleBattery = STATUS_NO_BATTERY;
+    s.processActive = STATUS_NO_PROCESS;
+    return s;
+}
+
+static std::vector<uint8_t> encode(status_frame::Encoder &encoder, const StatusSnapshot &s) {
+    std::vector<uint8_t> out(status_frame::maxFrameSize());
+    out.resize(encoder.encode(s, out.data()));
+    return out;
+}
+
+static StatusFrameHeader header_of(const std::vector<uint8_t> &frame) {
+    StatusFrameHeader header{};
+    memcpy(&header, frame.data(), sizeof(header));
+    return header;
+}
+
+// ---------------------------------------------------------------------------
+// Group A — keyframes and deltas
+// ---------------------------------------------------------------------------
+
+static void test_keyframe_round_trip() {
+    status_frame::Encoder encoder;
+    const StatusSnapshot sent = make_status();
+    const std::vector<uint8_t> frame = encode(encoder, sent);
+
+    const StatusFrameHeader header = header_of(frame);
+    TEST_ASSERT_EQUAL_UINT32(STATUS_FRAME_MAGIC, header.magic);
+    TEST_ASSERT_EQUAL_UINT8(STATUS_FRAME_KEYFRAME, header.flags);
+    TEST_ASSERT_EQUAL_UINT16(0, header.seq);
+    TEST_ASSERT_TRUE(header.mask == (1ull << status_frame::FIELD_COUNT) - 1);
+
+    StatusSnapshot received{};
+    uint16_t seq = 99;
+    TEST_ASSERT_TRUE(status_frame::decode(frame.data(), frame.size(), received, seq));
+    TEST_ASSERT_EQUAL_UINT16(0, seq);
+    TEST_ASSERT_EQUAL_FLOAT(92.125f, received.currentTemp);
+    TEST_ASSERT_EQUAL_INT16(-61, received.rssi);
+    TEST_ASSERT_EQUAL_INT32(-1, received.latency);
+    TEST_ASSERT_EQUAL_STRING("Classic 9 bar", received.profileName);
+    TEST_ASSERT_EQUAL_UINT8(STATUS_NO_PROCESS, received.processActive);
+}
+
+static void test_delta_carries_changed_fields_only() {
+    status_frame::Encoder encoder;
+    StatusSnapshot s = make_status();
+    const std::vector<uint8_t> keyframe = encode(encoder, s);
+
+    // Nothing changed: a bare header
+    const std::vector<uint8_t> idle = encode(encoder, s);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(StatusFrameHeader), idle.size());
+    TEST_ASSERT_TRUE(header_of(idle).mask == 0);
+
+    s.pressure = 9.01f;
+    s.processElapsed = 1200;
+    const std::vector<uint8_t> delta = encode(encoder, s);
+    const StatusFrameHeader header = header_of(delta);
+    TEST_ASSERT_EQUAL_UINT8(0, header.flags);
+    TEST_ASSERT_EQUAL_UINT16(2, header.seq);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(StatusFrameHeader) + sizeof(float) + sizeof(uint32_t), delta.size());
+    TEST_ASSERT_TRUE(delta.size() * 4 < keyframe.size());
+
+    // Applied on top of the keyframe, the reader has the current state
+    StatusSnapshot received{};
+    uint16_t seq = 0;
+    TEST_ASSERT_TRUE(status_frame::decode(keyframe.data(), keyframe.size(), received, seq));
+    TEST_ASSERT_TRUE(status_frame::decode(idle.data(), idle.size(), received, seq));
+    TEST_ASSERT_TRUE(status_frame::decode(delta.data(), delta.size(), received, seq));
+    TEST_ASSERT_EQUAL_UINT16(2, seq);
+    TEST_ASSERT_EQUAL_FLOAT(9.01f, received.pressure);
+    TEST_ASSERT_EQUAL_UINT32(1200, received.processElapsed);
+    TEST_ASSERT_EQUAL_FLOAT(93.0f, received.targetTemp);
+}
+
+static void test_reset_sends_keyframe() {
+    status_frame::Encoder encoder;
+    const StatusSnapshot s = make_status();
+    encode(encoder, s);
+    encoder.reset();
+    const std::vector<uint8_t> frame = encode(encoder, s);
+    TEST_ASSERT_EQUAL_UINT8(STATUS_FRAME_KEYFRAME, header_of(frame).flags);
+    TEST_ASSERT_EQUAL_UINT16(1, header_of(frame).seq);
+}
+
+// ---------------------------------------------------------------------------
+// Group B — text and malformed frames
+// ---------------------------------------------------------------------------
+
+static void test_copy_text_cuts_at_character_boundary() {
+    char out[8];
+    // "abcdé" + "ü" is 9 bytes; the cut must not split the 2-byte "ü"
+    status_frame::copyText(out, "abcd\xC3\xA9\xC3\xBC");
+    TEST_ASSERT_EQUAL_STRING("abcd\xC3\xA9", out);
+
+    status_frame::copyText(out, nullptr);
+    TEST_ASSERT_EQUAL_STRING("", out);
+}
+
+static void test_text_change_and_max_size() {
+    status_frame::Encoder encoder;
+    StatusSnapshot s = make_status();
+    encode(encoder, s);
+
+    status_frame::copyText(s.processLabel, "Bloom");
+    const std::vector<uint8_t> delta = encode(encoder, s);
+    TEST_ASSERT_EQUAL_UINT32(sizeof(StatusFrameHeader) + 1 + 5, delta.size());
+
+    // A keyframe with every text field full still fits maxFrameSize()
+    memset(s.profileName, 'x', sizeof(s.profileName) - 1);
+    memset(s.profileId, 'y', sizeof(s.profileId) - 1);
+    memset(s.processLabel, 'z', sizeof(s.processLabel) - 1);
+    encoder.reset();
+    TEST_ASSERT_EQUAL_UINT32(status_frame::maxFrameSize(), encode(encoder, s).size());
+}
+
+static void test_rejects_malformed_frames() {
+    status_frame::Encoder encoder;
+    const std::vector<uint8_t> frame = encode(encoder, make_status());
+    StatusSnapshot state{};
+    uint16_t seq = 0;
+
+    TEST_ASSERT_FALSE(status_frame::decode(frame.data(), frame.size() - 1, state, seq));
+    TEST_ASSERT_FALSE(status_frame::decode(frame.data(), 8, state, seq));
+
+    std::vector<uint8_t> newer = frame;
+    newer[4] = STATUS_FRAME_VERSION + 1;
+    TEST_ASSERT_FALSE(status_frame::decode(newer.data(), newer.size(), state, seq));
+
+    // A field this reader does not know
+    std::vector<uint8_t> unknown = frame;
+    unknown[8 + status_frame::FIELD_COUNT / 8] |= 1 << (status_frame::FIELD_COUNT % 8);
+    TEST_ASSERT_FALSE(status_frame::decode(unknown.data(), unknown.size(), state, seq));
+}
+
+void setUp(void) { /* no framework-level setup needed */ }
+void tearDown(void) { /* no framework-level teardown needed */ }
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_keyframe_round_trip);
+    RUN_TEST(test_delta_carries_changed_fields_only);
+    RUN_TEST(test_reset_sends_keyframe);
+    RUN_TEST(test_copy_text_cuts_at_character_boundary);
+    RUN_TEST(test_text_change_and_max_size);
+    RUN_TEST(test_rejects_malformed_frames);
+    return UNITY_END();
+}
@@ -180,6 +180,70 @@ export function GeneralTab({
           </div>
         </div>
 
+        {/* Shot History */}
+        <div className='border-base-content/5 mt-6 border-t pt-6'>
+          <h3 className='text-md text-base-content mb-2 font-semibold'>Shot History</h3>
+          <p className='text-base-content/85 mb-4 text-sm opacity-70'>
+            Higher rates sample the shot more often. Steady parts of the shot are still stored at
+            the standard rate, so recordings only grow where pressure or flow change.
+          </p>
+          <SettingsFormField label='Sampling Rate' htmlFor='historyInterval' noMargin>
+            <select
+              id='historyInterval'
+              name='historyInterval'
+              className='select select-bordered w-full'
+              value={formData.historyInterval || 250}
+              onChange={onChange('historyInterval')}
+            >
+              <option value={250}>Standard (250 ms)</option>
+              <option value={100}>High (100 ms)</option>
+              <option value={50}>Very high (50 ms)</option>
+            </select>
+          </SettingsFormField>
+          <p className='text-base-content/85 mt-4 mb-4 text-sm opacity-70'>
+            When the history grows past its storage limit or the device runs low on space, shots
+            are removed in the order chosen below.
+          </p>
+          <div className='grid grid-cols-1 gap-4 md:grid-cols-2'>
+            <SettingsFormField label='Storage Limit' htmlFor='historyQuotaMb' noMargin>
+              <select
+                id='historyQuotaMb'
+                name='historyQuotaMb'
+                className='select select-bordered w-full'
+                value={formData.historyQuotaMb || 0}
+                onChange={onChange('historyQuotaMb')}
+              >
+                <option value={0}>Until space runs low</option>
+                <option value={1}>1 MB</option>
+                <option value={2}>2 MB</option>
+                <option value={5}>5 MB</option>
+                <option value={20}>20 MB</option>
+                <option value={100}>100 MB</option>
+              </select>
+            </SettingsFormField>
+            <SettingsFormField label='Remove First' htmlFor='historyEviction' noMargin>
+              <select
+                id='historyEviction'
+                name='historyEviction'
+                className='select select-bordered w-full'
+                value={formData.historyEviction || 0}
+                onChange={onChange('historyEviction')}
+              >
+                <option value={0}>Oldest shots</option>
+                <option value={1}>Unrated shots</option>
+              </select>
+            </SettingsFormField>
+          </div>
+          <div className='mt-4'>
+            <ToggleField
+              label='Keep rated and annotated shots'
+              htmlFor='historyProtectAnnotated'
+              checked={!!formData.historyProtectAnnotated}
+              onChange={onChange('historyProtectAnnotated')}
+            />
+          </div>
+        </div>
+
         {/* Buttons */}
         <div className='border-base-content/5 mt-6 border-t pt-6'>
           <h3 className='text-md text-base-content mb-2 font-semibold'>Physical Buttons</h3>
@@ -8,10 +8,14 @@
 
 import { parseBinaryIndex, indexToShotList } from '../../ShotHistory/parseBinaryIndex';
 import { parseBinaryShot } from '../../ShotHistory/parseBinaryShot';
+import { parseShotBatch } from '../../ShotHistory/parseShotBatch';
 import { indexedDBService } from './IndexedDBService';
 import { notesService } from './NotesService';
 import { getProfileDisplayLabel, getShotStorageKey } from '../utils/analyzerUtils';
 
+// SHOT_BATCH_MAX_SHOTS in shot_log_batch.h
+const BATCH_MAX_SHOTS = 100;
+
 const HISTORY_NOTES_DEFAULTS = {
   id: '',
   rating: 0,
@@ -306,14 +310,16 @@ class LibraryService {
    * Load full shot data
    * @param {string} id - Shot ID
    * @param {string} source - 'gaggimate' or 'browser'
+   * @param {number} [fieldsMask] - SHOT_LOG_FIELD_* bits to fetch (GaggiMate only); omit for all fields
    * @returns {Promise<Object>} Full shot data with samples
    */
-  async loadShot(id, source) {
+  async loadShot(id, source, fieldsMask) {
     const idStr = String(id);
 
     if (source === 'gaggimate') {
       const paddedId = idStr.padStart(6, '0');
-      const response = await fetch(`/api/history/${paddedId}.slog`);
+      const query = fieldsMask ? `?fieldsMask=${fieldsMask}` : '';
+      const response = await fetch(`/api/history/${paddedId}.slog${query}`);
 
       if (!response.ok) {
         throw new Error(`Failed to load shot ${idStr}: HTTP ${response.status}`);
@@ -333,6 +339,37 @@ class LibraryService {
     return shot;
   }
 
+  /**
+   * Load several GaggiMate shots with one request to /api/history/batch,
+   * falling back to one request per shot if the batch endpoint is unavailable
+   * @param {Array<string|number>} ids - Shot IDs
+   * @returns {Promise<Map<string, Object>>} Full shot data by id (missing shots are left out)
+   */
+  async loadShots(ids) {
+    const idStrs = ids.map(id => String(id));
+    if (idStrs.length === 0) return new Map();
+
+    const shots = new Map();
+    for (let start = 0; start < idStrs.length; start += BATCH_MAX_SHOTS) {
+      const chunk = idStrs.slice(start, start + BATCH_MAX_SHOTS);
+      try {
+        const response = await fetch(`/api/history/batch?ids=${chunk.join(',')}`);
+        if (!response.ok) throw new Error(`HTTP ${response.status}`);
+        const parsed = parseShotBatch(await response.arrayBuffer());
+        for (const [id, shot] of parsed) {
+          shot.source = 'gaggimate';
+          shots.set(id, shot);
+        }
+      } catch {
+        const loaded = await Promise.all(
+          chunk.map(id => this.loadShot(id, 'gaggimate').catch(() => null)),
+        );
+        loaded.forEach((shot, i) => shot && shots.set(chunk[i], shot));
+      }
+    }
+    return shots;
+  }
+
   /**
    * Load full profile data
    * @param {string} nameOrId - Profile name/ID (for GM: use label)
@@ -48,9 +48,12 @@ function getChartData(shot) {
   let phaseTransitions = [];
 
   if (shot.version >= 5 && shot.phaseTransitions) {
-    // Use phase transitions directly from header
+    // Use phase transitions directly from header. sampleIndex counts stored samples, which are
+    // not evenly spaced in high-res recordings, so take the time from the sample itself.
     phaseTransitions = shot.phaseTransitions.map(t => ({
-      time: (t.sampleIndex * (shot.sampleInterval || 250)) / 1000.0,
+      time: data[t.sampleIndex]
+        ? data[t.sampleIndex].t / 1000.0
+        : (t.sampleIndex * (shot.sampleInterval || 250)) / 1000.0,
       phaseNumber: t.phaseNumber,
       phaseDisplayNumber: t.phaseNumber + 1,
       phaseName: t.phaseName,
@@ -0,0 +1,22 @@
+import Card from '../../components/Card.jsx';
+import { HistoryChart } from './HistoryChart.jsx';
+
+// The shot being recorded, drawn like a saved one (see useLiveShot)
+export default function LiveShotCard({ shot }) {
+  return (
+    <Card sm={12} role='region'>
+      <div className='flex flex-row items-center gap-2'>
+        <span className='badge badge-error badge-sm animate-pulse'>REC</span>
+        <span className='flex-grow font-semibold'>{shot.profile || 'Current shot'}</span>
+        <span className='text-base-content/70 text-sm'>
+          #{shot.id} · {(shot.duration / 1000).toFixed(1)}s
+        </span>
+      </div>
+      {shot.samples.length > 0 ? (
+        <HistoryChart shot={shot} />
+      ) : (
+        <span className='text-base-content/70 py-8 text-center text-sm'>Waiting for samples…</span>
+      )}
+    </Card>
+  );
+}
@@ -24,6 +24,8 @@ import { useCallback, useEffect, useRef, useState, useContext, useMemo } from 'p
 import { computed } from '@preact/signals';
 import { Spinner } from '../../components/Spinner.jsx';
 import HistoryCard from './HistoryCard.jsx';
+import LiveShotCard from './LiveShotCard.jsx';
+import { useLiveShot } from './useLiveShot.js';
 import { parseBinaryShot } from './parseBinaryShot.js';
 import { parseBinaryIndex, indexToShotList } from './parseBinaryIndex.js';
 import { FontAwesomeIcon } from '@fortawesome/react-fontawesome';
@@ -101,6 +103,13 @@ export function ShotHistory() {
     return () => loadHistoryAbortRef.current?.abort();
   }, [connected.value]);
 
+  const liveShot = useLiveShot(apiService, connected.value);
+  const liveShotFinished = liveShot?.finished ?? false;
+  useEffect(() => {
+    // The finished shot is in the index now
+    if (liveShotFinished) loadHistory();
+  }, [liveShotFinished, liveShot?.id]);
+
   const onDelete = useCallback(
     async id => {
       setLoading(true);
@@ -274,6 +283,7 @@ export function ShotHistory() {
       </div>
 
       <div className='grid grid-cols-1 gap-3 lg:grid-cols-12'>
+        {liveShot && !liveShot.finished && <LiveShotCard shot={liveShot} />}
         {paginatedHistory.map((item, idx) => (
           <HistoryCard
             key={item.id}
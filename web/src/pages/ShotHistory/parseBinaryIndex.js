@@ -85,6 +85,7 @@ export function parseBinaryIndex(arrayBuffer) {
     const avgTempRaw = view.getUint16(base + 96, true);
     const maxPressureRaw = view.getUint16(base + 98, true);
     const avgFlowRaw = view.getUint16(base + 100, true);
+    const avgPressureRaw = view.getUint16(base + 110, true);
 
     // Convert volume from scaled integer to float
     const volumeFloat = volume > 0 ? volume / WEIGHT_SCALE : null;
@@ -101,6 +102,7 @@ export function parseBinaryIndex(arrayBuffer) {
       avgTemp: avgTempRaw > 0 ? avgTempRaw / TEMP_SCALE : null,
       maxPressure: maxPressureRaw > 0 ? maxPressureRaw / PRESSURE_SCALE : null,
       avgFlow: avgFlowRaw > 0 ? avgFlowRaw / FLOW_SCALE : null,
+      avgPressure: avgPressureRaw > 0 ? avgPressureRaw / PRESSURE_SCALE : null,
       // Computed flags
       completed: !!(flags & SHOT_FLAG_COMPLETED),
       deleted: !!(flags & SHOT_FLAG_DELETED),
@@ -142,6 +144,7 @@ export function indexToShotList(indexData) {
       avgTemp: entry.avgTemp,
       maxPressure: entry.maxPressure,
       avgFlow: entry.avgFlow,
+      avgPressure: entry.avgPressure,
       notes: null,
       loaded: false,
       data: null,
@@ -1,11 +1,17 @@
 // Parser for .slog binary shot files
-// Mirrors shot_log_format.h (keep in sync)
+// Mirrors shot_log_format.h / shot_log_codec.h (keep in sync)
 // Header: v4=128 bytes, v5+=512 bytes
+// Samples: fixed-size records up to v5, delta/varint-compressed blocks in v6,
+// column-major projections (?fieldsMask= downloads, shot_log_columns.h) in v7
 // Dynamic field parsing based on fieldsMask for future extensibility
 
 const HEADER_SIZE_V4 = 128;
 const HEADER_SIZE_V5 = 512;
 const MAGIC = 0x544f4853; // 'SHOT' - matches backend SHOT_LOG_MAGIC
+const VERSION_DELTA = 6; // SHOT_LOG_VERSION_DELTA
+const VERSION_COLUMNAR = 7; // SHOT_LOG_VERSION_COLUMNAR
+const BLOCK_HEADER_SIZE = 3; // SHOT_LOG_BLOCK_HEADER_SIZE
+const FLAG_MS_TIMESTAMPS = 0x0001; // SHOT_LOG_FLAG_MS_TIMESTAMPS: t is ms since shot start, mod 65536
 
 const TEMP_SCALE = 10;
 const PRESSURE_SCALE = 10;
@@ -14,7 +20,7 @@ const WEIGHT_SCALE = 10;
 const RESISTANCE_SCALE = 100;
 
 // Field bit positions (must match shot_log_format.h)
-const FIELD_BITS = {
+export const FIELD_BITS = {
   T: 0, // tick
   TT: 1, // target temp
   CT: 2, // current temp
@@ -89,6 +95,85 @@ function countSetBits(n) {
   return count;
 }
 
+function readVarint(bytes, pos, end) {
+  let value = 0;
+  for (let i = 0; i < 3 && pos + i < end; i++) {
+    const b = bytes[pos + i];
+    value |= (b & 0x7f) << (7 * i);
+    if ((b & 0x80) === 0) return { value: value & 0xffff, size: i + 1 };
+  }
+  return null;
+}
+
+// Decode v6 sample blocks (see shot_log_format.h) into rows of raw uint16 field
+// values. Stops at the first truncated or corrupt block; the bytes left over are
+// reported as trailingBytes, like a partial record in the fixed-size layout.
+function decodeDeltaSamples(view, start, fieldCount, maxSamples) {
+  const bytes = new Uint8Array(view.buffer, view.byteOffset, view.byteLength);
+  const end = view.byteLength;
+  const rows = [];
+  let pos = start;
+  while (pos + BLOCK_HEADER_SIZE <= end && rows.length < maxSamples) {
+    const count = bytes[pos];
+    const payloadSize = view.getUint16(pos + 1, true);
+    const payloadStart = pos + BLOCK_HEADER_SIZE;
+    const payloadEnd = payloadStart + payloadSize;
+    if (count === 0 || payloadSize < fieldCount * 2 || payloadEnd > end) break;
+
+    const fields = new Uint16Array(fieldCount);
+    for (let i = 0; i < fieldCount; i++) fields[i] = view.getUint16(payloadStart + i * 2, true);
+    const blockRows = [fields.slice()];
+    let p = payloadStart + fieldCount * 2;
+    let tickStep = 0;
+    let ok = true;
+    for (let s = 1; s < count && ok; s++) {
+      if (p + 2 > payloadEnd) {
+        ok = false;
+        break;
+      }
+      const mask = view.getUint16(p, true);
+      p += 2;
+      for (let i = 0; i < fieldCount; i++) {
+        let delta = 0;
+        if (mask & (1 << i)) {
+          const v = readVarint(bytes, p, payloadEnd);
+          if (!v) {
+            ok = false;
+            break;
+          }
+          p += v.size;
+          delta = (v.value >>> 1) ^ -(v.value & 1); // zigzag
+        }
+        if (i === 0) {
+          tickStep = (tickStep + delta) & 0xffff;
+          delta = tickStep;
+        }
+        fields[i] = (fields[i] + delta) & 0xffff;
+      }
+      if (ok) blockRows.push(fields.slice());
+    }
+    if (!ok) break;
+    rows.push(...blockRows);
+    pos = payloadEnd;
+  }
+  return { rows: rows.slice(0, maxSamples), trailingBytes: end - pos };
+}
+
+// Transposes the columns of a v7 download back into rows of raw uint16 values,
+// the same shape decodeDeltaSamples returns
+function decodeColumns(view, start, fieldCount) {
+  const count = Math.floor((view.byteLength - start) / (fieldCount * 2));
+  const rows = new Array(count);
+  for (let i = 0; i < count; i++) {
+    const row = new Array(fieldCount);
+    for (let f = 0; f < fieldCount; f++) {
+      row[f] = view.getUint16(start + (f * count + i) * 2, true);
+    }
+    rows[i] = row;
+  }
+  return rows;
+}
+
 // Phase exit reason codes (must match PhaseExitReason in shot_log_format.h / profile.h).
 // 0 (unknown) is also what legacy files carry in the formerly-reserved byte.
 export const PHASE_EXIT_REASON_LABELS = {
@@ -167,6 +252,7 @@ export function parseBinaryShot(arrayBuffer, id) {
 
   // Parse common header fields
   const sampleInterval = view.getUint16(8, true);
+  const headerFlags = view.getUint16(10, true); // reserved (0) before flags existed
   const fieldsMask = view.getUint32(12, true);
   const sampleCountHeader = view.getUint32(16, true);
   const durationHeader = view.getUint32(20, true);
@@ -181,6 +267,10 @@ export function parseBinaryShot(arrayBuffer, id) {
   let phaseTransitions = [];
   let finalExitReason = 0;
   let brewDelay = 0;
+  let lateSamples = 0;
+  let droppedSamples = 0;
+  let maxGapMs = 0;
+  let p99GapMs = 0;
   if (version >= 5) {
     const transitionCount = view.getUint8(110 + 12 * 29); // After 12 PhaseTransitions
     phaseTransitions = parsePhaseTransitions(view, transitionCount);
@@ -188,6 +278,12 @@ export function parseBinaryShot(arrayBuffer, id) {
     finalExitReason = view.getUint8(110 + 12 * 29 + 1);
     // brewDelayMs (ms) follows finalExitReason; legacy files read 0 (was reserved padding).
     brewDelay = view.getUint16(110 + 12 * 29 + 2, true);
+    // Sampling health counters follow brewDelayMs; 0 in older files.
+    lateSamples = view.getUint16(110 + 12 * 29 + 4, true);
+    droppedSamples = view.getUint16(110 + 12 * 29 + 6, true);
+    // Inter-sample gap statistics follow; 0 in older files.
+    maxGapMs = view.getUint16(110 + 12 * 29 + 8, true);
+    p99GapMs = view.getUint16(110 + 12 * 29 + 10, true);
   }
 
   // Calculate expected sample size from fieldsMask
@@ -227,13 +323,33 @@ export function parseBinaryShot(arrayBuffer, id) {
     throw new Error('Data size misaligned');
   }
   const sampleSize = deviceSampleSize;
-  const fullSampleBytes = Math.floor(dataBytes / sampleSize) * sampleSize;
-  const trailingBytes = dataBytes - fullSampleBytes;
-  const inferredSamples = fullSampleBytes / sampleSize;
+  let trailingBytes;
+  let inferredSamples;
+  let deltaRows = null;
+  if (version === VERSION_COLUMNAR) {
+    deltaRows = decodeColumns(view, headerSize, fieldCount);
+    trailingBytes = dataBytes % sampleSize;
+    inferredSamples = deltaRows.length;
+  } else if (version >= VERSION_DELTA) {
+    const decoded = decodeDeltaSamples(view, headerSize, fieldCount, Infinity);
+    deltaRows = decoded.rows;
+    trailingBytes = decoded.trailingBytes;
+    inferredSamples = deltaRows.length;
+  } else {
+    const fullSampleBytes = Math.floor(dataBytes / sampleSize) * sampleSize;
+    trailingBytes = dataBytes - fullSampleBytes;
+    inferredSamples = fullSampleBytes / sampleSize;
+  }
   const maxSamples = sampleCountHeader
     ? Math.min(sampleCountHeader, inferredSamples)
     : inferredSamples;
 
+  // Millisecond timestamps wrap at 16 bits; consecutive samples are never that far apart,
+  // so summing the wrapped differences recovers the time (see shot_log_timing.h).
+  const msTimestamps = (headerFlags & FLAG_MS_TIMESTAMPS) !== 0;
+  let timeMs = 0;
+  let lastRawTime = null;
+
   for (let i = 0; i < maxSamples; i++) {
     const base = headerSize + i * sampleSize;
     const sample = {};
@@ -244,14 +360,21 @@ export function parseBinaryShot(arrayBuffer, id) {
       const offset = base + fieldIdx * 2; // Each field is 2 bytes
 
       let rawValue;
-      if (field.type === 'int16') {
+      if (deltaRows) {
+        rawValue = deltaRows[i][fieldIdx];
+        if (field.type === 'int16' && rawValue >= 0x8000) rawValue -= 0x10000;
+      } else if (field.type === 'int16') {
         rawValue = view.getInt16(offset, true);
       } else {
         rawValue = view.getUint16(offset, true);
       }
 
       let finalValue;
-      if (field.transform) {
+      if (msTimestamps && field.bitPos === FIELD_BITS.T) {
+        timeMs = lastRawTime === null ? rawValue : timeMs + ((rawValue - lastRawTime) & 0xffff);
+        lastRawTime = rawValue;
+        finalValue = timeMs;
+      } else if (field.transform) {
         finalValue = field.transform(rawValue, sampleInterval);
       } else if (field.scale) {
         finalValue = rawValue / field.scale;
@@ -314,5 +437,9 @@ export function parseBinaryShot(arrayBuffer, id) {
     finalExitReason, // v5+ reason the shot ended (last phase exit or manual abort)
     finalExitReasonLabel: PHASE_EXIT_REASON_LABELS[finalExitReason] ?? 'Unknown',
     brewDelay, // v5+ predictive brew delay (ms) the shot ran with
+    lateSamples, // samples recorded more than half an interval late
+    droppedSamples, // sample intervals missed entirely
+    maxGapMs, // longest gap between samples taken
+    p99GapMs, // 99th percentile of the gaps between samples taken
   };
 }
@@ -0,0 +1,44 @@
+// Parser for /api/history/batch containers
+// Mirrors shot_log_batch.h ShotBatchHeader and ShotBatchEntry (keep in sync)
+
+import { parseBinaryShot } from './parseBinaryShot';
+
+const BATCH_HEADER_SIZE = 16;
+const BATCH_ENTRY_SIZE = 20;
+const BATCH_MAGIC = 0x54414253; // 'SBAT'
+
+const SHOT_BATCH_MISSING = 0x01;
+
+/**
+ * Parse a batch container into shots
+ * @param {ArrayBuffer} arrayBuffer - The container returned by /api/history/batch
+ * @returns {Map<string, Object>} Parsed shots by id (missing shots are left out)
+ */
+export function parseShotBatch(arrayBuffer) {
+  const view = new DataView(arrayBuffer);
+  if (view.byteLength < BATCH_HEADER_SIZE) throw new Error('Batch too small for header');
+
+  const magic = view.getUint32(0, true);
+  if (magic !== BATCH_MAGIC) {
+    throw new Error(
+      `Bad batch magic: expected 0x${BATCH_MAGIC.toString(16)}, got 0x${magic.toString(16)}`,
+    );
+  }
+  const count = view.getUint16(6, true);
+  if (view.byteLength < BATCH_HEADER_SIZE + count * BATCH_ENTRY_SIZE) {
+    throw new Error('Batch too small for directory');
+  }
+
+  const shots = new Map();
+  for (let i = 0; i < count; i++) {
+    const base = BATCH_HEADER_SIZE + i * BATCH_ENTRY_SIZE;
+    const id = String(view.getUint32(base, true));
+    const offset = view.getUint32(base + 4, true);
+    const length = view.getUint32(base + 8, true);
+    const flags = view.getUint8(base + 16);
+    if (flags & SHOT_BATCH_MISSING || offset + length > view.byteLength) continue;
+    // Each section is a complete .slog file (projected ones use the v5 layout)
+    shots.set(id, parseBinaryShot(arrayBuffer.slice(offset, offset + length), id));
+  }
+  return shots;
+}
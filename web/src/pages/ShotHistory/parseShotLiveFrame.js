@@ -0,0 +1,121 @@
+// Parser for live shot stream frames (req:history:live)
+// Mirrors shot_log_live.h ShotLiveFrameHeader (keep in sync)
+
+import { parseBinaryShot } from './parseBinaryShot';
+
+const FRAME_HEADER_SIZE = 16;
+const LIVE_MAGIC = 0x564c4853; // 'SHLV'
+const LOG_HEADER_SIZE = 512;
+const SAMPLE_SIZE = 26;
+const TRANSITION_SIZE = 29;
+const TRANSITIONS_OFFSET = 110; // ShotLogHeader.phaseTransitions
+const TRANSITION_COUNT_OFFSET = TRANSITIONS_OFFSET + 12 * TRANSITION_SIZE;
+const VERSION_RAW = 5; // SHOT_LOG_VERSION_RAW
+
+export const LIVE_FRAME = { START: 1, SAMPLES: 2, PHASE: 3, END: 4 };
+export const LIVE_FLAG_RESYNC = 0x01;
+export const LIVE_FLAG_DISCARDED = 0x02;
+
+/**
+ * Parse one binary websocket message of the live stream
+ * @param {ArrayBuffer} arrayBuffer - The binary frame
+ * @returns {Object|null} { type, flags, count, shotId, index, payload } or null if not a live frame
+ */
+export function parseShotLiveFrame(arrayBuffer) {
+  if (arrayBuffer.byteLength < FRAME_HEADER_SIZE) return null;
+  const view = new DataView(arrayBuffer);
+  if (view.getUint32(0, true) !== LIVE_MAGIC) return null;
+  return {
+    type: view.getUint8(4),
+    flags: view.getUint8(5),
+    count: view.getUint16(6, true),
+    shotId: view.getUint32(8, true),
+    index: view.getUint32(12, true),
+    payload: new Uint8Array(arrayBuffer, FRAME_HEADER_SIZE),
+  };
+}
+
+/**
+ * Collects the frames of the shot being recorded. toShot() returns it in the
+ * parseBinaryShot() format, so live charts render exactly what gets saved.
+ */
+export class LiveShot {
+  header = null; // Uint8Array, the .slog header
+  samples = [];
+  firstIndex = 0; // stored index of samples[0] (> 0 after a mid-shot resync)
+  shotId = null;
+  finished = false;
+  discarded = false;
+
+  /**
+   * @param {Object} frame - A frame from parseShotLiveFrame()
+   * @returns {boolean} true if the shot changed
+   */
+  push(frame) {
+    if (frame.type === LIVE_FRAME.START) {
+      // A resync of the shot already being followed adds nothing
+      if (frame.shotId === this.shotId && !this.finished) return false;
+      this.header = frame.payload.slice(0, LOG_HEADER_SIZE);
+      this.samples = [];
+      this.firstIndex = frame.index;
+      this.shotId = frame.shotId;
+      this.finished = false;
+      this.discarded = false;
+      return true;
+    }
+    if (frame.shotId !== this.shotId || !this.header) return false;
+
+    if (frame.type === LIVE_FRAME.SAMPLES) {
+      for (let i = 0; i < frame.count; i++) {
+        const position = frame.index + i - this.firstIndex;
+        if (position < 0) continue;
+        this.samples[position] = frame.payload.slice(i * SAMPLE_SIZE, (i + 1) * SAMPLE_SIZE);
+      }
+    } else if (frame.type === LIVE_FRAME.PHASE) {
+      for (let i = 0; i < frame.count && frame.index + i < 12; i++) {
+        const offset = TRANSITIONS_OFFSET + (frame.index + i) * TRANSITION_SIZE;
+        const record = frame.payload.subarray(i * TRANSITION_SIZE, (i + 1) * TRANSITION_SIZE);
+        this.header.set(record, offset);
+        this.header[TRANSITION_COUNT_OFFSET] = Math.max(
+          this.header[TRANSITION_COUNT_OFFSET],
+          frame.index + i + 1,
+        );
+      }
+    } else if (frame.type === LIVE_FRAME.END) {
+      this.header = frame.payload.slice(0, LOG_HEADER_SIZE);
+      this.finished = true;
+      this.discarded = (frame.flags & LIVE_FLAG_DISCARDED) !== 0;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * The samples so far as a raw (v5) .slog image
+   * @returns {ArrayBuffer}
+   */
+  toArrayBuffer() {
+    const samples = this.samples.filter(Boolean);
+    const out = new Uint8Array(LOG_HEADER_SIZE + samples.length * SAMPLE_SIZE);
+    out.set(this.header);
+    const view = new DataView(out.buffer);
+    view.setUint8(4, VERSION_RAW);
+    view.setUint32(16, samples.length, true);
+    // After a resync the file starts at firstIndex; move the transitions along
+    for (let i = 0; i < out[TRANSITION_COUNT_OFFSET] && i < 12; i++) {
+      const offset = TRANSITIONS_OFFSET + i * TRANSITION_SIZE;
+      view.setUint16(offset, Math.max(0, view.getUint16(offset, true) - this.firstIndex), true);
+    }
+    samples.forEach((sample, i) => out.set(sample, LOG_HEADER_SIZE + i * SAMPLE_SIZE));
+    return out.buffer;
+  }
+
+  /**
+   * @returns {Object|null} The shot as parsed by parseBinaryShot(), null before START
+   */
+  toShot() {
+    if (!this.header) return null;
+    return parseBinaryShot(this.toArrayBuffer(), String(this.shotId));
+  }
+}
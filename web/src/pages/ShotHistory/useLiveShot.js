@@ -0,0 +1,46 @@
+import { useEffect, useState } from 'preact/hooks';
+import { LiveShot, parseShotLiveFrame } from './parseShotLiveFrame.js';
+
+/**
+ * Follows the shot being recorded over the live stream (req:history:live).
+ * The chart is built from the same samples the firmware writes to the .slog,
+ * so it matches the saved shot exactly.
+ * @param {ApiService} apiService
+ * @param {boolean} connected - (Re)subscribes whenever the socket (re)connects
+ * @returns {Object|null} The shot as parsed by parseBinaryShot(), plus
+ *   `finished`; null when no shot has been seen or it was discarded
+ */
+export function useLiveShot(apiService, connected) {
+  const [shot, setShot] = useState(null);
+
+  useEffect(() => {
+    if (!connected) return undefined;
+    const live = new LiveShot();
+    let renderFrame = null;
+    const render = () => {
+      renderFrame = null;
+      setShot(live.discarded ? null : { ...live.toShot(), finished: live.finished });
+    };
+    const listenerId = apiService.on('binary', data => {
+      const frame = parseShotLiveFrame(data);
+      if (!frame || !live.push(frame)) return;
+      // A resync or a batch can bring several frames at once: parse once per paint
+      if (renderFrame === null) renderFrame = requestAnimationFrame(render);
+    });
+    apiService
+      .request({ tp: 'req:history:live', enable: true })
+      .catch(e => console.error('Failed to subscribe to the live shot', e));
+
+    return () => {
+      apiService.off('binary', listenerId);
+      if (renderFrame !== null) cancelAnimationFrame(renderFrame);
+      try {
+        apiService.send({ tp: 'req:history:live', enable: false });
+      } catch {
+        // Disconnected: the firmware drops the subscription with the client
+      }
+    };
+  }, [apiService, connected]);
+
+  return shot;
+}
@@ -90,12 +90,13 @@ export function getStatisticsAnalysisSettings(fullShot, matchedProfile) {
 export async function analyzeStatisticsShot({
   fallbackProfileMap,
   loadedProfileCache,
+  preloadedShot,
   profileMap,
   shot,
 }) {
   try {
     const shotId = getStatisticsShotId(shot);
-    const loadedShot = await libraryService.loadShot(shotId, shot.source);
+    const loadedShot = preloadedShot || (await libraryService.loadShot(shotId, shot.source));
     const fullShot = buildFullStatisticsShot({ loadedShot, shot, shotId });
     if (!fullShot?.samples || fullShot.samples.length === 0) return null;
 
@@ -136,11 +137,19 @@ export async function analyzeStatisticsShotBatch({
   loadedProfileCache,
   profileMap,
 }) {
+  // Controller shots come in one batch request instead of one request each
+  const gaggimateIds = batch.filter(shot => shot.source === 'gaggimate').map(getStatisticsShotId);
+  const preloaded = gaggimateIds.length
+    ? await libraryService.loadShots(gaggimateIds).catch(() => new Map())
+    : new Map();
+
   return Promise.all(
     batch.map(shot =>
       analyzeStatisticsShot({
         fallbackProfileMap,
         loadedProfileCache,
+        preloadedShot:
+          shot.source === 'gaggimate' ? preloaded.get(String(getStatisticsShotId(shot))) : null,
         profileMap,
         shot,
       }),
@@ -1,6 +1,10 @@
 import { createContext } from 'preact';
 import { signal } from '@preact/signals';
 import uuidv4 from '../utils/uuid.js';
+import { StatusFrameDecoder, isStatusFrame } from './statusFrame.js';
+
+// Status rate while a process runs (ms); the firmware sends every 500 ms otherwise
+const STATUS_BREW_INTERVAL = 250;
 
 function randomId() {
   return Math.random()
@@ -17,6 +21,7 @@ export default class ApiService {
   baseReconnectDelay = 1000; // Start with 1 second delay
   reconnectTimeout = null;
   isConnecting = false;
+  statusDecoder = new StatusFrameDecoder();
 
   constructor() {
     console.log('Established websocket connection');
@@ -35,6 +40,7 @@ export default class ApiService {
       const apiHost = window.location.host;
       const wsProtocol = window.location.protocol === 'https:' ? 'wss://' : 'ws://';
       this.socket = new WebSocket(`${wsProtocol}${apiHost}/ws`);
+      this.socket.binaryType = 'arraybuffer'; // binary frames go to on('binary', ...)
 
       this.socket.addEventListener('message', this._onMessage.bind(this));
       this.socket.addEventListener('close', this._onClose.bind(this));
@@ -55,6 +61,13 @@ export default class ApiService {
       ...machine.value,
       connected: true,
     };
+    this._subscribeStatus();
+  }
+
+  // Binary delta frames instead of JSON evt:status; the reply is followed by a keyframe
+  _subscribeStatus() {
+    this.statusDecoder.reset();
+    this.send({ tp: 'req:status:subscribe', format: 'binary', brewInterval: STATUS_BREW_INTERVAL });
   }
 
   _onClose() {
@@ -93,6 +106,16 @@ export default class ApiService {
   }
 
   _onMessage(event) {
+    if (event.data instanceof ArrayBuffer) {
+      if (isStatusFrame(event.data)) {
+        this._onStatusFrame(event.data);
+        return;
+      }
+      for (const listener of Object.values(this.listeners.binary || {})) {
+        listener(event.data);
+      }
+      return;
+    }
     let message;
     try {
       message = JSON.parse(event.data);
@@ -108,6 +131,19 @@ export default class ApiService {
     }
   }
 
+  _onStatusFrame(arrayBuffer) {
+    const message = this.statusDecoder.push(arrayBuffer);
+    if (!message) {
+      // Missed a frame (or not yet keyed): ask again for a keyframe
+      if (this.statusDecoder.state) this._subscribeStatus();
+      return;
+    }
+    this._onStatus(message);
+    for (const listener of Object.values(this.listeners['evt:status'] || {})) {
+      listener(message);
+    }
+  }
+
   send(event) {
     if (this.socket && this.socket.readyState === WebSocket.OPEN) {
       this.socket.send(JSON.stringify(event));
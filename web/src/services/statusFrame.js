@@ -0,0 +1,158 @@
+// Decoder for binary status frames (req:status:subscribe with format "binary")
+// Mirrors status_frame.h STATUS_FIELDS (keep in sync, append only)
+
+const HEADER_SIZE = 16;
+const STATUS_MAGIC = 0x54534d47; // 'GMST'
+const STATUS_VERSION = 1;
+const FLAG_KEYFRAME = 0x01;
+const NO_PROCESS = 0xff;
+const NO_BATTERY = 0xff;
+const PROCESS_STATES = ['infusion', 'brew', 'grind'];
+
+// [key, type] in bit order
+const FIELDS = [
+  ['ct', 'f32'],
+  ['tt', 'f32'],
+  ['pr', 'f32'],
+  ['fl', 'f32'],
+  ['pt', 'f32'],
+  ['m', 'u8'],
+  ['p', 'text'],
+  ['puid', 'text'],
+  ['cp', 'u8'],
+  ['cd', 'u8'],
+  ['gp', 'u8'],
+  ['tw', 'f32'],
+  ['bta', 'u8'],
+  ['bt', 'u8'],
+  ['btd', 'f32'],
+  ['led', 'u8'],
+  ['gtd', 'i32'],
+  ['gtv', 'f32'],
+  ['gt', 'u8'],
+  ['gact', 'u8'],
+  ['wl', 'i32'],
+  ['tof', 'i32'],
+  ['rssi', 'i16'],
+  ['lat', 'i32'],
+  ['pw', 'f32'],
+  ['hp', 'f32'],
+  ['bw', 'f32'],
+  ['bc', 'u8'],
+  ['sbat', 'u8'],
+  ['pkr', 'f32'],
+  ['pf', 'f32'],
+  ['tf', 'f32'],
+  ['pa', 'u8'],
+  ['ps', 'u8'],
+  ['pl', 'text'],
+  ['pe', 'u32'],
+  ['ptt', 'u8'],
+  ['ppt', 'f32'],
+  ['ppp', 'f32'],
+];
+
+const textDecoder = new TextDecoder();
+
+// float32 back to the digits the firmware's JSON would have printed
+const f32 = value => Number(value.toPrecision(7));
+
+export function isStatusFrame(arrayBuffer) {
+  return (
+    arrayBuffer.byteLength >= HEADER_SIZE &&
+    new DataView(arrayBuffer).getUint32(0, true) === STATUS_MAGIC
+  );
+}
+
+/**
+ * Applies the binary status frames of one subscription and rebuilds the
+ * evt:status message the JSON path would have sent.
+ */
+export class StatusFrameDecoder {
+  state = null; // field values by key, null until a keyframe
+  seq = null; // seq of the last frame applied
+
+  /**
+   * @param {ArrayBuffer} arrayBuffer - One frame (see isStatusFrame())
+   * @returns {Object|null} The evt:status message, or null if the frame could
+   *   not be applied and a keyframe is needed (call reset() and resubscribe)
+   */
+  push(arrayBuffer) {
+    const view = new DataView(arrayBuffer);
+    if (view.getUint8(4) !== STATUS_VERSION) return null;
+    const flags = view.getUint8(5);
+    const seq = view.getUint16(6, true);
+    const mask = [view.getUint32(8, true), view.getUint32(12, true)];
+    if (flags & FLAG_KEYFRAME) {
+      this.state = {};
+    } else if (!this.state || seq !== ((this.seq + 1) & 0xffff)) {
+      return null; // a frame went missing
+    }
+
+    let pos = HEADER_SIZE;
+    for (let i = 0; i < 64; i++) {
+      if (!((mask[i >> 5] >>> (i & 31)) & 1)) continue;
+      if (i >= FIELDS.length) return null;
+      const [key, type] = FIELDS[i];
+      if (type === 'text') {
+        const length = view.getUint8(pos);
+        this.state[key] = textDecoder.decode(new Uint8Array(arrayBuffer, pos + 1, length));
+        pos += 1 + length;
+      } else if (type === 'f32') {
+        this.state[key] = f32(view.getFloat32(pos, true));
+        pos += 4;
+      } else if (type === 'u32') {
+        this.state[key] = view.getUint32(pos, true);
+        pos += 4;
+      } else if (type === 'i32') {
+        this.state[key] = view.getInt32(pos, true);
+        pos += 4;
+      } else if (type === 'i16') {
+        this.state[key] = view.getInt16(pos, true);
+        pos += 2;
+      } else {
+        this.state[key] = view.getUint8(pos);
+        pos += 1;
+      }
+    }
+    if (pos !== arrayBuffer.byteLength) return null;
+    this.seq = seq;
+    return this.toMessage();
+  }
+
+  reset() {
+    this.state = null;
+    this.seq = null;
+  }
+
+  toMessage() {
+    const { pa, ps, pl, pe, ptt, ppt, ppp, pkr, pf, tf, sbat, ...fields } = this.state;
+    const message = {
+      ...fields,
+      tp: 'evt:status',
+      cp: !!fields.cp,
+      cd: !!fields.cd,
+      gp: !!fields.gp,
+      led: !!fields.led,
+      bc: !!fields.bc,
+      cw: fields.bw,
+    };
+    if (sbat !== NO_BATTERY) message.sbat = sbat;
+    if (pa === NO_PROCESS) return message;
+    message.process = { a: pa };
+    message.pkr = pkr;
+    message.pf = pf;
+    message.tf = tf;
+    if (ps < PROCESS_STATES.length) {
+      Object.assign(message.process, {
+        s: PROCESS_STATES[ps],
+        l: pl,
+        e: pe,
+        tt: ptt ? 'volumetric' : 'time',
+        pt: ppt,
+        pp: ppp,
+      });
+    }
+    return message;
+  }
+}